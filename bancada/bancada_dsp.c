@@ -0,0 +1,654 @@
+/**
+ * @file bancada_dsp.c
+ * @brief Casos, sinais sintéticos e relatório da bancada de DSP (ver bancada_dsp.h).
+ */
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "include/configuracao.h"
+#include "include/dsp_audio.h"
+#include "include/indice_picos.h"
+#include "include/decimador_audio.h"
+#include "include/fft_q15.h"
+#include "inc/ssd1306.h"
+#include "inc/ssd1306_font.h"
+#if BANCADA_INTERP
+#include "include/conversor_pwm.h"
+#endif
+#include "bancada_dsp.h"
+#include "referencias_bancada.h"
+
+#define N_SINAIS 4
+#define REPETICOES 5           // A vazão relatada é a do passe mais rápido
+#define MAIOR_BLOCO FFT_Q15_N  // Os sinais medidos são truncados para múltiplos dele
+#define COLUNAS_ENVELOPE DISPLAY_WIDTH
+#define TOP_PWM_BANCADA 2603   // 125 MHz / 48 kHz - 1, como na reprodução
+#define AMOSTRAS_LACO_BANCADA 1000 // Laço do overdub: não múltiplo do bloco, para a volta cair no meio de um
+#define LIBERACAO_AGC_BANCADA 150  // Blocos: AGC_LIBERACAO_MS a 48 kHz
+
+// Erro máximo do ponto fixo contra a referência em float, em LSB de 12 bits.
+// O filtro em float trunca e o Q15 arredonda: com alfa = 0,2, diante de uma
+// entrada constante o float pode parar até 4 LSB abaixo dela e o Q15 até 2,
+// de qualquer lado.
+#define TOLERANCIA_SUAVIZAR_LSB 5
+#define TOLERANCIA_GANHO_LSB 1
+#define TOLERANCIA_MISTURA_LSB 1
+#define TOLERANCIA_PWM_RECIPROCO 1 // Em níveis de PWM, contra a divisão
+// Bits em 1 do fluxo sigma-delta contra a densidade ideal, no sinal inteiro: os integradores são
+// limitados, então o desvio acumulado também é (sem ele a média do fluxo derivaria da entrada)
+#define TOLERANCIA_SIGMA_DELTA_BITS 4
+// O limitador conta com o arredondamento da rampa: no máximo 1 LSB além do teto
+#define TOLERANCIA_TETO_AGC_LSB 1
+
+// Desenho no display: coordenadas sorteadas até esta distância fora da tela, para o recorte
+#define MARGEM_DISPLAY_BANCADA 8
+#define RETANGULOS_SORTEADOS_BANCADA 2000
+#define CARACTERES_POR_LINHA_BANCADA 16 // Em cada y, de cada deslocamento dentro da página
+
+_Static_assert(BANCADA_AMOSTRAS_SINAL % MAIOR_BLOCO == 0, "sinal sintético fora do bloco dos casos");
+
+// --- Casos ---
+
+// Linhas de referencias_bancada.h (os casos só da placa reaproveitam a do equivalente portátil)
+enum {
+    CASO_SUAVIZAR,
+    CASO_GANHO,
+    CASO_ESCALA_DIVISAO,
+    CASO_ESCALA_RECIPROCO,
+    CASO_RESUMO,
+    CASO_ENVELOPE,
+    CASO_DECIMADOR,
+    CASO_FFT,
+    CASO_SIGMA_DELTA,
+    CASO_MISTURA,
+    CASO_BLOQUEIO_DC,
+    CASO_AGC,
+    N_CASOS_PORTATEIS
+};
+
+typedef struct {
+    const char *nome;
+    int referencia;
+    size_t tamanho_bloco;
+    bool saida_no_trabalho;  // Processa no lugar: o CRC é o do próprio bloco de trabalho
+    void (*preparar)(size_t n_amostras_total);
+    // Processa um bloco; retorna os bytes escritos em `saida` (alinhada a 4)
+    size_t (*processar)(uint16_t *trabalho, size_t n, void *saida);
+    // Fecho do passe, também medido (opcional): retorna os bytes escritos em `saida`
+    size_t (*concluir)(void *saida);
+} caso_bancada_t;
+
+static uint16_t estado_suavizar;
+static dsp_sigma_delta_t modulador;
+static dsp_escala_pwm_t escala_bancada;
+static indice_picos_t indice;
+static decimador_t decimador;
+static int16_t entrada_fft[FFT_Q15_N];
+static uint16_t laco_bancada[AMOSTRAS_LACO_BANCADA];
+static size_t posicao_laco;
+static dsp_bloqueio_dc_t bloqueio_dc;
+static dsp_agc_t agc;
+
+static void preparar_suavizar(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    estado_suavizar = DSP_AMOSTRA_ZERO;
+}
+
+static size_t processar_suavizar(uint16_t *trabalho, size_t n, void *saida) {
+    (void)saida;
+    estado_suavizar = dsp_suavizar_bloco(trabalho, n, estado_suavizar, ALFA_SUAVIZACAO_Q15);
+    return 0;
+}
+
+static size_t processar_ganho(uint16_t *trabalho, size_t n, void *saida) {
+    dsp_ganho_bloco(trabalho, saida, n, GANHO_SAIDA_MAXIMO_Q12);
+    return n * sizeof(uint16_t);
+}
+
+// As escalas saem empacotadas como no registrador CC (reproducao_nivel_cc), como na reprodução
+static size_t processar_escala_divisao(uint16_t *trabalho, size_t n, void *saida) {
+    uint32_t *niveis = saida;
+    for (size_t i = 0; i < n; i++) {
+        niveis[i] = dsp_nivel_pwm(trabalho[i], TOP_PWM_BANCADA) * 0x10001u;
+    }
+    return n * sizeof(uint32_t);
+}
+
+static void preparar_escala(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    dsp_escala_pwm_iniciar(&escala_bancada, TOP_PWM_BANCADA);
+}
+
+static size_t processar_escala_reciproco(uint16_t *trabalho, size_t n, void *saida) {
+    uint32_t *niveis = saida;
+    for (size_t i = 0; i < n; i++) {
+        niveis[i] = dsp_nivel_pwm_reciproco(&escala_bancada, trabalho[i]) * 0x10001u;
+    }
+    return n * sizeof(uint32_t);
+}
+
+#if BANCADA_INTERP
+static size_t processar_escala_interp(uint16_t *trabalho, size_t n, void *saida) {
+    conversor_pwm_bloco(&escala_bancada, trabalho, saida, n);
+    return n * sizeof(uint32_t);
+}
+#endif
+
+static size_t processar_resumo(uint16_t *trabalho, size_t n, void *saida) {
+    dsp_resumir_bloco(trabalho, n, saida);
+    return sizeof(dsp_resumo_bloco_t);
+}
+
+static void preparar_envelope(size_t n_amostras_total) {
+    indice_picos_iniciar(&indice, n_amostras_total);
+}
+
+static size_t processar_envelope(uint16_t *trabalho, size_t n, void *saida) {
+    (void)saida;
+    indice_picos_anexar(&indice, trabalho, n);
+    return 0;
+}
+
+static size_t concluir_envelope(void *saida) {
+    indice_picos_finalizar(&indice);
+    indice_picos_envelope(&indice, 0, indice.n_amostras, COLUNAS_ENVELOPE, saida);
+    return COLUNAS_ENVELOPE * sizeof(pico_t);
+}
+
+static void preparar_decimador(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    decimador_iniciar(&decimador);
+}
+
+static size_t processar_decimador(uint16_t *trabalho, size_t n, void *saida) {
+    return decimador_processar(&decimador, trabalho, n, saida) * sizeof(int16_t);
+}
+
+static size_t processar_fft(uint16_t *trabalho, size_t n, void *saida) {
+    // Mesma faixa de entrada da visão do espectro: +-16384
+    for (size_t i = 0; i < n; i++) {
+        int32_t valor = ((int32_t)trabalho[i] - DSP_AMOSTRA_ZERO) * 8;
+        if (valor > 16384) valor = 16384;
+        entrada_fft[i] = (int16_t)valor;
+    }
+    fft_q15_potencia(entrada_fft, saida);
+    return FFT_Q15_BINS * sizeof(uint32_t);
+}
+
+static void preparar_sigma_delta(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    dsp_sigma_delta_iniciar(&modulador);
+}
+
+static size_t processar_sigma_delta(uint16_t *trabalho, size_t n, void *saida) {
+    dsp_sigma_delta_bloco(&modulador, trabalho, saida, n);
+    return n * sizeof(uint32_t);
+}
+
+static void preparar_mistura(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    for (size_t i = 0; i < AMOSTRAS_LACO_BANCADA; i++) laco_bancada[i] = DSP_AMOSTRA_ZERO;
+    posicao_laco = 0;
+}
+
+// Cada bloco cai sobre o trecho seguinte do laço, como no looper: a saída é o trecho misturado
+static size_t processar_mistura(uint16_t *trabalho, size_t n, void *saida) {
+    uint16_t *misturado = saida;
+    size_t feitos = 0;
+    while (feitos < n) {
+        size_t trecho = AMOSTRAS_LACO_BANCADA - posicao_laco;
+        if (trecho > n - feitos) trecho = n - feitos;
+        dsp_misturar_bloco(laco_bancada + posicao_laco, trabalho + feitos, trecho, REALIMENTACAO_LOOPER_Q15);
+        memcpy(misturado + feitos, laco_bancada + posicao_laco, trecho * sizeof(uint16_t));
+        posicao_laco = (posicao_laco + trecho) % AMOSTRAS_LACO_BANCADA;
+        feitos += trecho;
+    }
+    return n * sizeof(uint16_t);
+}
+
+static void preparar_bloqueio_dc(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    dsp_bloqueio_dc_iniciar(&bloqueio_dc);
+}
+
+static size_t processar_bloqueio_dc(uint16_t *trabalho, size_t n, void *saida) {
+    (void)saida;
+    dsp_bloquear_dc_bloco(&bloqueio_dc, trabalho, n);
+    return 0;
+}
+
+static void preparar_agc(size_t n_amostras_total) {
+    (void)n_amostras_total;
+    dsp_agc_iniciar(&agc, AGC_ALVO_LSB, AGC_TETO_LSB, AGC_PISO_LSB, AGC_GANHO_MAXIMO_Q16, LIBERACAO_AGC_BANCADA);
+}
+
+static size_t processar_agc(uint16_t *trabalho, size_t n, void *saida) {
+    (void)saida;
+    dsp_agc_bloco(&agc, trabalho, n);
+    return 0;
+}
+
+static const caso_bancada_t casos[] = {
+    { "suavizar q15", CASO_SUAVIZAR, 256, true, preparar_suavizar, processar_suavizar, NULL },
+    { "ganho q12", CASO_GANHO, 256, false, NULL, processar_ganho, NULL },
+    { "PWM (divisão)", CASO_ESCALA_DIVISAO, 256, false, NULL, processar_escala_divisao, NULL },
+    { "PWM (recíproco)", CASO_ESCALA_RECIPROCO, 256, false, preparar_escala, processar_escala_reciproco, NULL },
+    { "resumo de bloco", CASO_RESUMO, 256, false, NULL, processar_resumo, NULL },
+    { "envelope", CASO_ENVELOPE, 256, false, preparar_envelope, processar_envelope, concluir_envelope },
+    { "decimador CIC+FIR", CASO_DECIMADOR, 256, false, preparar_decimador, processar_decimador, NULL },
+    { "FFT 512", CASO_FFT, FFT_Q15_N, false, NULL, processar_fft, NULL },
+    { "sigma-delta 2a ord", CASO_SIGMA_DELTA, 256, false, preparar_sigma_delta, processar_sigma_delta, NULL },
+    { "mistura overdub", CASO_MISTURA, 256, false, preparar_mistura, processar_mistura, NULL },
+    { "bloqueio DC", CASO_BLOQUEIO_DC, 256, true, preparar_bloqueio_dc, processar_bloqueio_dc, NULL },
+    { "AGC/limitador", CASO_AGC, 256, true, preparar_agc, processar_agc, NULL },
+#if BANCADA_INTERP
+    { "PWM (interp)", CASO_ESCALA_RECIPROCO, 256, false, preparar_escala, processar_escala_interp, NULL },
+#endif
+};
+
+#define N_CASOS (sizeof(casos) / sizeof(casos[0]))
+
+_Static_assert(N_CASOS_PORTATEIS == REFERENCIAS_BANCADA_CASOS && N_SINAIS == REFERENCIAS_BANCADA_SINAIS,
+               "referencias_bancada.h não corresponde aos casos: regere com --gerar");
+
+// --- Sinais sintéticos (só inteiros, para sair igual em qualquer plataforma) ---
+
+static uint16_t sinais_sinteticos[N_SINAIS][BANCADA_AMOSTRAS_SINAL];
+static const char *const nomes_sinais[N_SINAIS] = { "varredura", "senoide", "ruído", "degraus" };
+
+// Seno aproximado por parábolas: fase de 32 bits por volta -> Q15
+static int32_t seno_q15(uint32_t fase) {
+    int32_t x = (int32_t)fase >> 16; // [-32768, 32767] = [-pi, pi)
+    int32_t modulo = x < 0 ? -x : x;
+    int32_t s = (x * (32768 - modulo)) >> 13;
+    return s > 32767 ? 32767 : s;
+}
+
+static uint16_t centrar(int32_t valor) {
+    int32_t amostra = DSP_AMOSTRA_ZERO + valor;
+    if (amostra < 0) amostra = 0;
+    if (amostra > DSP_AMOSTRA_MAX) amostra = DSP_AMOSTRA_MAX;
+    return (uint16_t)amostra;
+}
+
+static void gerar_sinais(void) {
+    static bool gerados = false;
+    if (gerados) return;
+
+    // Varredura de ~50 Hz a ~20 kHz (a 48 kHz) com 1800 LSB de amplitude
+    uint32_t fase = 0, incremento = 4473924u, aceleracao = 435000u;
+    for (size_t i = 0; i < BANCADA_AMOSTRAS_SINAL; i++) {
+        sinais_sinteticos[0][i] = centrar((seno_q15(fase) * 1800) >> 15);
+        fase += incremento;
+        incremento += aceleracao;
+    }
+
+    // 1 kHz com 1000 LSB
+    fase = 0;
+    for (size_t i = 0; i < BANCADA_AMOSTRAS_SINAL; i++) {
+        sinais_sinteticos[1][i] = centrar((seno_q15(fase) * 1000) >> 15);
+        fase += 89478485u;
+    }
+
+    // Ruído branco na faixa toda (xorshift32)
+    uint32_t estado = 0x12345678u;
+    for (size_t i = 0; i < BANCADA_AMOSTRAS_SINAL; i++) {
+        estado ^= estado << 13;
+        estado ^= estado >> 17;
+        estado ^= estado << 5;
+        sinais_sinteticos[2][i] = (uint16_t)(estado >> 20);
+    }
+
+    // Degraus entre os extremos (saturação do ganho, máximo e mínimo do envelope)
+    for (size_t i = 0; i < BANCADA_AMOSTRAS_SINAL; i++) {
+        sinais_sinteticos[3][i] = ((i / 37) & 1) ? DSP_AMOSTRA_MAX : 0;
+    }
+
+    gerados = true;
+}
+
+// --- Execução ---
+
+// CRC-32 (polinômio do zlib), com tabela de 16 entradas
+static uint32_t crc32_atualizar(uint32_t crc, const void *dados, size_t n) {
+    static const uint32_t tabela[16] = {
+        0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+        0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+    };
+    const uint8_t *bytes = dados;
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ tabela[crc & 0x0F];
+        crc = (crc >> 4) ^ tabela[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static uint16_t trabalho[BANCADA_AMOSTRAS_SINAL];
+static uint32_t saida[BANCADA_AMOSTRAS_SINAL]; // Maior saída: um nível de PWM de 32 bits por amostra
+
+typedef struct {
+    uint64_t unidades; // Passe mais rápido
+    uint32_t crc;      // Do primeiro passe
+} medida_caso_t;
+
+// Passa o caso sobre o sinal em trechos de BANCADA_AMOSTRAS_SINAL; só o processamento é medido
+static medida_caso_t medir_caso(const relogio_bancada_t *relogio, const caso_bancada_t *caso,
+                                const uint16_t *amostras, size_t n_amostras) {
+    medida_caso_t medida = { .unidades = UINT64_MAX, .crc = 0 };
+
+    for (int repeticao = 0; repeticao < REPETICOES; repeticao++) {
+        uint64_t unidades = 0;
+        uint32_t crc = 0;
+        if (caso->preparar) caso->preparar(n_amostras);
+
+        for (size_t inicio = 0; inicio < n_amostras; inicio += BANCADA_AMOSTRAS_SINAL) {
+            size_t n_trecho = n_amostras - inicio;
+            if (n_trecho > BANCADA_AMOSTRAS_SINAL) n_trecho = BANCADA_AMOSTRAS_SINAL;
+            memcpy(trabalho, amostras + inicio, n_trecho * sizeof(uint16_t));
+
+            size_t n_bytes = 0;
+            uint32_t marca = relogio->ler();
+            for (size_t bloco = 0; bloco < n_trecho; bloco += caso->tamanho_bloco) {
+                n_bytes += caso->processar(trabalho + bloco, caso->tamanho_bloco, (uint8_t *)saida + n_bytes);
+            }
+            unidades += relogio->desde(marca);
+
+            if (repeticao == 0) {
+                crc = caso->saida_no_trabalho ? crc32_atualizar(crc, trabalho, n_trecho * sizeof(uint16_t))
+                                              : crc32_atualizar(crc, saida, n_bytes);
+            }
+        }
+
+        if (caso->concluir) {
+            uint32_t marca = relogio->ler();
+            size_t n_bytes = caso->concluir(saida);
+            unidades += relogio->desde(marca);
+            if (repeticao == 0) crc = crc32_atualizar(crc, saida, n_bytes);
+        }
+
+        if (repeticao == 0) medida.crc = crc;
+        if (unidades < medida.unidades) medida.unidades = unidades;
+    }
+    return medida;
+}
+
+static void relatar_vazao(const relogio_bancada_t *relogio, const char *nome, uint64_t unidades, uint64_t n_amostras,
+                          const char *veredito) {
+    if (unidades == 0) unidades = 1;
+    uint64_t centesimos_por_amostra = unidades * 100 / n_amostras;
+    uint64_t amostras_por_segundo = n_amostras * relogio->unidades_por_segundo / unidades;
+    printf("  %-18s %7llu.%02llu %-6s %12llu %s\n", nome, (unsigned long long)(centesimos_por_amostra / 100),
+           (unsigned long long)(centesimos_por_amostra % 100), relogio->unidade, (unsigned long long)amostras_por_segundo,
+           veredito);
+}
+
+// Maior diferença de cada caminho rápido para a sua referência (float ou divisão);
+// retorna o número de falhas
+static int comparar_com_referencias(const char *nome_sinal, const uint16_t *amostras, size_t n_amostras) {
+    const float fator = (float)ALFA_SUAVIZACAO_Q15 / 32768.0f;
+    const float ganho = (float)GANHO_SAIDA_MAXIMO_Q12 / 4096.0f;
+    const float realimentacao = (float)REALIMENTACAO_LOOPER_Q15 / 32768.0f;
+    uint16_t estado_q15 = DSP_AMOSTRA_ZERO, estado_float = DSP_AMOSTRA_ZERO;
+    int erro_suavizar = 0, erro_ganho = 0, erro_pwm = 0, erro_mistura = 0;
+    dsp_escala_pwm_t escala;
+    dsp_escala_pwm_iniciar(&escala, TOP_PWM_BANCADA);
+    dsp_sigma_delta_t sigma_delta;
+    dsp_sigma_delta_iniciar(&sigma_delta);
+    int64_t desvio_densidade = 0; // Em unidades de 1/DSP_SIGMA_DELTA_REALIMENTACAO de bit
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        estado_q15 = dsp_suavizar_q15(amostras[i], estado_q15, ALFA_SUAVIZACAO_Q15);
+        estado_float = dsp_suavizar_float(amostras[i], estado_float, fator);
+        int erro = (int)estado_q15 - (int)estado_float;
+        if (erro < 0) erro = -erro;
+        if (erro > erro_suavizar) erro_suavizar = erro;
+
+        erro = (int)dsp_ganho_q12(amostras[i], GANHO_SAIDA_MAXIMO_Q12) - (int)dsp_ganho_float(amostras[i], ganho);
+        if (erro < 0) erro = -erro;
+        if (erro > erro_ganho) erro_ganho = erro;
+
+        // O laço é o próprio sinal defasado: combinações de toda a faixa, saturação incluída
+        uint16_t laco = amostras[(i + n_amostras / 3) % n_amostras];
+        erro = (int)dsp_misturar_q15(laco, amostras[i], REALIMENTACAO_LOOPER_Q15) -
+               (int)dsp_misturar_float(laco, amostras[i], realimentacao);
+        if (erro < 0) erro = -erro;
+        if (erro > erro_mistura) erro_mistura = erro;
+
+        erro = (int)dsp_nivel_pwm_reciproco(&escala, amostras[i]) - (int)dsp_nivel_pwm(amostras[i], TOP_PWM_BANCADA);
+        if (erro < 0) erro = -erro;
+        if (erro > erro_pwm) erro_pwm = erro;
+
+        // Densidade ideal de bits em 1: (1 + entrada / realimentação) / 2 por bit
+        uint32_t palavra;
+        dsp_sigma_delta_bloco(&sigma_delta, &amostras[i], &palavra, 1);
+        int32_t entrada = ((int32_t)amostras[i] - DSP_AMOSTRA_ZERO) * DSP_SIGMA_DELTA_GANHO;
+        desvio_densidade += (int64_t)__builtin_popcount(palavra) * DSP_SIGMA_DELTA_REALIMENTACAO * 2 -
+                            (int64_t)(DSP_SIGMA_DELTA_REALIMENTACAO + entrada) * DSP_SIGMA_DELTA_BITS;
+    }
+    if (desvio_densidade < 0) desvio_densidade = -desvio_densidade;
+
+    // O pico da saída do AGC contra o teto do limitador, nos blocos da captura
+    dsp_agc_t agc_teto;
+    dsp_agc_iniciar(&agc_teto, AGC_ALVO_LSB, AGC_TETO_LSB, AGC_PISO_LSB, AGC_GANHO_MAXIMO_Q16, LIBERACAO_AGC_BANCADA);
+    int excesso_teto = 0;
+    for (size_t inicio = 0; inicio < n_amostras; inicio += 256) {
+        uint16_t bloco[256];
+        size_t n = (n_amostras - inicio < 256) ? n_amostras - inicio : 256;
+        memcpy(bloco, amostras + inicio, n * sizeof(uint16_t));
+        dsp_agc_bloco(&agc_teto, bloco, n);
+        for (size_t i = 0; i < n; i++) {
+            int desvio = (int)bloco[i] - DSP_AMOSTRA_ZERO;
+            if (desvio < 0) desvio = -desvio;
+            if (desvio - AGC_TETO_LSB > excesso_teto) excesso_teto = desvio - AGC_TETO_LSB;
+        }
+    }
+    int erro_sigma_delta = (int)((desvio_densidade + DSP_SIGMA_DELTA_REALIMENTACAO) / (2 * DSP_SIGMA_DELTA_REALIMENTACAO));
+
+    int falhas = (erro_suavizar > TOLERANCIA_SUAVIZAR_LSB) + (erro_ganho > TOLERANCIA_GANHO_LSB) +
+                 (erro_pwm > TOLERANCIA_PWM_RECIPROCO) + (erro_sigma_delta > TOLERANCIA_SIGMA_DELTA_BITS) +
+                 (erro_mistura > TOLERANCIA_MISTURA_LSB) + (excesso_teto > TOLERANCIA_TETO_AGC_LSB);
+    printf("  %-18s suavizar %d LSB (max %d), ganho %d LSB (max %d), escala PWM %d (max %d), sigma-delta %d bits (max %d), "
+           "mistura %d LSB (max %d), teto AGC %d LSB (max %d)%s\n",
+           nome_sinal, erro_suavizar, TOLERANCIA_SUAVIZAR_LSB, erro_ganho, TOLERANCIA_GANHO_LSB, erro_pwm,
+           TOLERANCIA_PWM_RECIPROCO, erro_sigma_delta, TOLERANCIA_SIGMA_DELTA_BITS, erro_mistura, TOLERANCIA_MISTURA_LSB,
+           excesso_teto, TOLERANCIA_TETO_AGC_LSB, falhas ? "  FALHA" : "");
+    return falhas;
+}
+
+// --- Desenho no display contra ssd1306_set_pixel ---
+
+static uint32_t estado_sorteio_display = 0x2545F491u;
+
+// Inteiro em [minimo, maximo] (xorshift32)
+static int sortear(int minimo, int maximo) {
+    estado_sorteio_display ^= estado_sorteio_display << 13;
+    estado_sorteio_display ^= estado_sorteio_display >> 17;
+    estado_sorteio_display ^= estado_sorteio_display << 5;
+    return minimo + (int)(estado_sorteio_display % (uint32_t)(maximo - minimo + 1));
+}
+
+// Ponto de partida comum às duas versões: pixels sorteados, nenhuma coluna suja
+static void sortear_framebuffer(ssd1306_framebuffer_t *fb) {
+    ssd1306_framebuffer_init(fb);
+    for (size_t i = 0; i < sizeof(fb->pixels); i++) fb->pixels[i] = (uint8_t)sortear(0, 255);
+    ssd1306_mark_clean(fb);
+}
+
+static void retangulo_por_pixels(ssd1306_framebuffer_t *fb, int x_0, int y_0, int x_1, int y_1, bool set) {
+    for (int y = (y_0 < 0 ? 0 : y_0); y <= y_1 && y < ssd1306_height; y++) {
+        for (int x = (x_0 < 0 ? 0 : x_0); x <= x_1 && x < ssd1306_width; x++) {
+            ssd1306_set_pixel(fb, x, y, set);
+        }
+    }
+}
+
+// Célula opaca de 8x8, com o glifo pelo mesmo índice de ssd1306_get_font
+static void caractere_por_pixels(ssd1306_framebuffer_t *fb, int x, int y, uint8_t caractere) {
+    if (x < 0 || y < 0 || x > ssd1306_width - 8 || y > ssd1306_height - 8) return;
+
+    caractere = (uint8_t)toupper(caractere);
+    int indice = 0;
+    if (caractere >= 'A' && caractere <= 'Z') indice = caractere - 'A' + 1;
+    else if (caractere >= '0' && caractere <= '9') indice = caractere - '0' + 27;
+    for (int i = 0; i < 8; i++) {
+        for (int linha = 0; linha < 8; linha++) {
+            ssd1306_set_pixel(fb, x + i, y + linha, (font[indice * 8 + i] >> linha) & 1);
+        }
+    }
+}
+
+// Pixels e faixas sujas: o set_pixel só marca a coluna cujo byte mudou, como os caminhos rápidos
+static bool relatar_divergencia(const char *operacao, const ssd1306_framebuffer_t *rapido,
+                                const ssd1306_framebuffer_t *referencia, bool ja_relatada) {
+    if (memcmp(rapido, referencia, sizeof(*rapido)) == 0) return false;
+    if (!ja_relatada) {
+        for (int pagina = 0; pagina < (int)ssd1306_n_pages; pagina++) {
+            if (memcmp(&rapido->pixels[pagina * ssd1306_width], &referencia->pixels[pagina * ssd1306_width],
+                       ssd1306_width) != 0) {
+                printf("      %s: página %d difere\n", operacao, pagina);
+            }
+            if (rapido->dirty_first[pagina] != referencia->dirty_first[pagina] ||
+                rapido->dirty_last[pagina] != referencia->dirty_last[pagina]) {
+                printf("      %s: página %d suja em %d..%d, esperado %d..%d\n", operacao, pagina,
+                       rapido->dirty_first[pagina], rapido->dirty_last[pagina], referencia->dirty_first[pagina],
+                       referencia->dirty_last[pagina]);
+            }
+        }
+    }
+    return true;
+}
+
+// ssd1306_fill_rect (e por ele vspan e hline) e ssd1306_draw_char contra a escrita pixel a pixel:
+// todos os pares de linhas (as máscaras das bordas de página e os retângulos vazios), retângulos
+// sorteados além das bordas e caracteres em todo y, com e sem a mescla entre duas páginas.
+// Retorna o número de falhas.
+static int conferir_desenho_display(void) {
+    static ssd1306_framebuffer_t rapido, referencia;
+    static const char caracteres[] = "AZMW0189az ?-";
+    int retangulos = 0, retangulos_divergentes = 0;
+    int glifos = 0, glifos_divergentes = 0;
+
+    for (int y_0 = -2; y_0 < ssd1306_height + 2; y_0++) {
+        for (int y_1 = -2; y_1 < ssd1306_height + 2; y_1++) {
+            int x_0 = sortear(-MARGEM_DISPLAY_BANCADA, ssd1306_width - 1);
+            int x_1 = sortear(x_0 - 1, ssd1306_width + MARGEM_DISPLAY_BANCADA);
+            bool set = sortear(0, 1);
+            sortear_framebuffer(&rapido);
+            referencia = rapido;
+            ssd1306_fill_rect(&rapido, x_0, y_0, x_1, y_1, set);
+            retangulo_por_pixels(&referencia, x_0, y_0, x_1, y_1, set);
+            retangulos_divergentes += relatar_divergencia("retângulo", &rapido, &referencia, retangulos_divergentes);
+            retangulos++;
+        }
+    }
+    for (int i = 0; i < RETANGULOS_SORTEADOS_BANCADA; i++) {
+        int x_0 = sortear(-MARGEM_DISPLAY_BANCADA, ssd1306_width + MARGEM_DISPLAY_BANCADA);
+        int x_1 = sortear(-MARGEM_DISPLAY_BANCADA, ssd1306_width + MARGEM_DISPLAY_BANCADA);
+        int y_0 = sortear(-MARGEM_DISPLAY_BANCADA, ssd1306_height + MARGEM_DISPLAY_BANCADA);
+        int y_1 = sortear(-MARGEM_DISPLAY_BANCADA, ssd1306_height + MARGEM_DISPLAY_BANCADA);
+        bool set = sortear(0, 1);
+        sortear_framebuffer(&rapido);
+        referencia = rapido;
+        ssd1306_fill_rect(&rapido, x_0, y_0, x_1, y_1, set);
+        retangulo_por_pixels(&referencia, x_0, y_0, x_1, y_1, set);
+        retangulos_divergentes += relatar_divergencia("retângulo", &rapido, &referencia, retangulos_divergentes);
+        retangulos++;
+    }
+
+    for (int y = -1; y <= ssd1306_height - 7; y++) {
+        for (int i = 0; i < CARACTERES_POR_LINHA_BANCADA; i++) {
+            int x = sortear(-1, ssd1306_width - 7);
+            uint8_t caractere = (uint8_t)caracteres[sortear(0, (int)sizeof(caracteres) - 2)];
+            sortear_framebuffer(&rapido);
+            referencia = rapido;
+            ssd1306_draw_char(&rapido, (int16_t)x, (int16_t)y, caractere);
+            caractere_por_pixels(&referencia, x, y, caractere);
+            glifos_divergentes += relatar_divergencia("caractere", &rapido, &referencia, glifos_divergentes);
+            glifos++;
+        }
+    }
+
+    int falhas = (retangulos_divergentes > 0) + (glifos_divergentes > 0);
+    printf("  %-18s %d de %d divergem%s\n", "fill_rect", retangulos_divergentes, retangulos,
+           retangulos_divergentes ? "  FALHA" : "");
+    printf("  %-18s %d de %d divergem%s\n", "draw_char", glifos_divergentes, glifos, glifos_divergentes ? "  FALHA" : "");
+    return falhas;
+}
+
+int bancada_executar(const relogio_bancada_t *relogio, bool gerar_referencias) {
+    gerar_sinais();
+
+    uint32_t crcs[N_CASOS][N_SINAIS];
+    int falhas = 0;
+
+    if (!gerar_referencias) {
+        printf("Vazão (%d sinais de %d amostras, melhor de %d passes):\n", N_SINAIS, BANCADA_AMOSTRAS_SINAL, REPETICOES);
+        printf("  %-18s %10s/amostra %12s\n", "caso", relogio->unidade, "amostras/s");
+    }
+    for (size_t c = 0; c < N_CASOS; c++) {
+        uint64_t unidades = 0;
+        int divergentes = 0;
+        for (int s = 0; s < N_SINAIS; s++) {
+            medida_caso_t medida = medir_caso(relogio, &casos[c], sinais_sinteticos[s], BANCADA_AMOSTRAS_SINAL);
+            unidades += medida.unidades;
+            crcs[c][s] = medida.crc;
+            if (medida.crc != referencias_bancada[casos[c].referencia][s]) divergentes++;
+        }
+        if (gerar_referencias) continue;
+
+        relatar_vazao(relogio, casos[c].nome, unidades, (uint64_t)N_SINAIS * BANCADA_AMOSTRAS_SINAL,
+                      divergentes ? "FALHA: saída difere da referência" : "ok");
+        for (int s = 0; s < N_SINAIS && divergentes; s++) {
+            if (crcs[c][s] == referencias_bancada[casos[c].referencia][s]) continue;
+            printf("      %s: CRC %08lx, referência %08lx\n", nomes_sinais[s], (unsigned long)crcs[c][s],
+                   (unsigned long)referencias_bancada[casos[c].referencia][s]);
+        }
+        falhas += divergentes;
+    }
+
+    if (gerar_referencias) {
+        printf("/**\n * @file referencias_bancada.h\n * @brief CRC-32 das saídas de cada caso da bancada em cada sinal sintético.\n"
+               " *\n * Gerado por `bancada_dsp --gerar`. Não edite à mão: regere depois de uma\n"
+               " * mudança que altere de propósito a saída de um núcleo.\n */\n");
+        printf("#ifndef REFERENCIAS_BANCADA_H\n#define REFERENCIAS_BANCADA_H\n\n#include <stdint.h>\n\n");
+        printf("#define REFERENCIAS_BANCADA_CASOS %d\n#define REFERENCIAS_BANCADA_SINAIS %d\n\n", N_CASOS_PORTATEIS, N_SINAIS);
+        printf("// Colunas:");
+        for (int s = 0; s < N_SINAIS; s++) printf(" %s%s", nomes_sinais[s], (s < N_SINAIS - 1) ? "," : "\n");
+        printf("static const uint32_t referencias_bancada[REFERENCIAS_BANCADA_CASOS][REFERENCIAS_BANCADA_SINAIS] = {\n");
+        for (size_t c = 0; c < N_CASOS_PORTATEIS; c++) {
+            printf("    {");
+            for (int s = 0; s < N_SINAIS; s++) printf(" 0x%08lXu,", (unsigned long)crcs[c][s]);
+            printf(" }, // %s\n", casos[c].nome);
+        }
+        printf("};\n\n#endif\n");
+        return 0;
+    }
+
+    printf("Caminhos rápidos contra as referências (float, divisão, densidade ideal):\n");
+    for (int s = 0; s < N_SINAIS; s++) {
+        falhas += comparar_com_referencias(nomes_sinais[s], sinais_sinteticos[s], BANCADA_AMOSTRAS_SINAL);
+    }
+
+    printf("Desenho no display contra ssd1306_set_pixel (pixels e colunas sujas):\n");
+    falhas += conferir_desenho_display();
+    return falhas;
+}
+
+int bancada_executar_sinal(const relogio_bancada_t *relogio, const sinal_bancada_t *sinal) {
+    size_t n_amostras = sinal->n_amostras - sinal->n_amostras % MAIOR_BLOCO;
+    if (n_amostras == 0) {
+        printf("%s: curto demais (menos de %d amostras)\n", sinal->nome, MAIOR_BLOCO);
+        return 1;
+    }
+
+    printf("%s (%lu amostras):\n", sinal->nome, (unsigned long)n_amostras);
+    for (size_t c = 0; c < N_CASOS; c++) {
+        medida_caso_t medida = medir_caso(relogio, &casos[c], sinal->amostras, n_amostras);
+        char crc[20];
+        snprintf(crc, sizeof(crc), "CRC %08lx", (unsigned long)medida.crc);
+        relatar_vazao(relogio, casos[c].nome, medida.unidades, n_amostras, crc);
+    }
+    return comparar_com_referencias(sinal->nome, sinal->amostras, n_amostras);
+}
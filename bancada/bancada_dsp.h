@@ -0,0 +1,50 @@
+/**
+ * @file bancada_dsp.h
+ * @brief Bancada dos núcleos de DSP: vazão e comparação com saídas de referência.
+ *
+ * O mesmo conjunto de casos roda no computador (bancada_host.c, medido em ns)
+ * e na placa (bancada_pico.c, medido em ciclos do SysTick). Cada caso passa
+ * sobre sinais sintéticos gerados só com inteiros, de modo que as duas
+ * plataformas produzem os mesmos bytes: o CRC-32 da saída de cada caso em
+ * cada sinal é comparado com referencias_bancada.h. Os caminhos em ponto
+ * fixo que têm versão em float (filtro e ganho) também são comparados com
+ * ela, com tolerância em LSB. Os desenhos rápidos do display (fill_rect e
+ * draw_char) são conferidos contra ssd1306_set_pixel, pixel e coluna suja.
+ *
+ * Uma otimização de um núcleo deve manter os CRCs (ou regerá-los, com o erro
+ * contra o float ainda dentro da tolerância) e baixar as unidades por amostra.
+ */
+#ifndef BANCADA_DSP_H
+#define BANCADA_DSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BANCADA_AMOSTRAS_SINAL 4096 // Por sinal sintético; múltiplo de todos os blocos dos casos
+
+// Fonte de tempo da plataforma; os trechos medidos duram menos de 2^24 unidades
+typedef struct {
+    const char *unidade;           // "ns" ou "ciclos"
+    uint64_t unidades_por_segundo;
+    uint32_t (*ler)(void);
+    uint32_t (*desde)(uint32_t marca);
+} relogio_bancada_t;
+
+// Sinal de 12 bits (centro em DSP_AMOSTRA_ZERO)
+typedef struct {
+    const char *nome;
+    const uint16_t *amostras;
+    size_t n_amostras;
+} sinal_bancada_t;
+
+// Roda todos os casos sobre os sinais sintéticos e confere as referências.
+// Com gerar_referencias, imprime uma nova referencias_bancada.h em vez de conferir.
+// Retorna o número de falhas.
+int bancada_executar(const relogio_bancada_t *relogio, bool gerar_referencias);
+
+// Vazão e erro contra o float num sinal qualquer (uma gravação, por exemplo), sem
+// referência de CRC. O comprimento é truncado para um múltiplo dos blocos dos casos.
+int bancada_executar_sinal(const relogio_bancada_t *relogio, const sinal_bancada_t *sinal);
+
+#endif
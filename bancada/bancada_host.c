@@ -0,0 +1,117 @@
+/**
+ * @file bancada_host.c
+ * @brief Bancada de DSP no computador: tempo em ns e gravações exportadas em WAV.
+ *
+ * Uso:
+ *   bancada_dsp                 sinais sintéticos contra referencias_bancada.h
+ *   bancada_dsp --gerar         imprime uma nova referencias_bancada.h
+ *   bancada_dsp gravacao.wav... também mede gravações (mono, PCM 16, como as
+ *                               exportadas por ferramentas/transferir_gravacao.py)
+ *
+ * O código de saída é o número de falhas (0 = tudo certo), para uso no ctest.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bancada_dsp.h"
+
+static uint32_t ler_ns(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (uint32_t)((uint64_t)agora.tv_sec * 1000000000u + (uint64_t)agora.tv_nsec);
+}
+
+static uint32_t ns_desde(uint32_t marca) {
+    return ler_ns() - marca;
+}
+
+static const relogio_bancada_t relogio_host = {
+    .unidade = "ns",
+    .unidades_por_segundo = 1000000000u,
+    .ler = ler_ns,
+    .desde = ns_desde,
+};
+
+static uint32_t ler_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t ler_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// Lê um WAV mono de 16 bits e o leva a 12 bits centrados em 2048 (inverso da exportação)
+static uint16_t *ler_wav(const char *caminho, size_t *n_amostras) {
+    FILE *arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        perror(caminho);
+        return NULL;
+    }
+
+    uint8_t cabecalho[12];
+    if (fread(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho) || memcmp(cabecalho, "RIFF", 4) != 0 ||
+        memcmp(cabecalho + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "%s: não é um WAV\n", caminho);
+        fclose(arquivo);
+        return NULL;
+    }
+
+    bool formato_ok = false;
+    uint8_t pedaco[8];
+    while (fread(pedaco, 1, sizeof(pedaco), arquivo) == sizeof(pedaco)) {
+        uint32_t tamanho = ler_u32(pedaco + 4);
+        if (memcmp(pedaco, "fmt ", 4) == 0) {
+            uint8_t formato[16];
+            if (tamanho < sizeof(formato) || fread(formato, 1, sizeof(formato), arquivo) != sizeof(formato)) break;
+            formato_ok = ler_u16(formato) == 1 && ler_u16(formato + 2) == 1 && ler_u16(formato + 14) == 16;
+            fseek(arquivo, (long)(tamanho - sizeof(formato) + (tamanho & 1)), SEEK_CUR);
+        } else if (memcmp(pedaco, "data", 4) == 0 && formato_ok) {
+            size_t n = tamanho / 2;
+            uint16_t *amostras = malloc(n * sizeof(uint16_t));
+            uint8_t *dados = malloc(tamanho);
+            if (!amostras || !dados || fread(dados, 1, tamanho, arquivo) != tamanho) {
+                free(amostras);
+                free(dados);
+                break;
+            }
+            for (size_t i = 0; i < n; i++) {
+                int32_t amostra = ((int16_t)ler_u16(dados + 2 * i) >> 4) + 2048;
+                amostras[i] = (uint16_t)(amostra < 0 ? 0 : (amostra > 4095 ? 4095 : amostra));
+            }
+            free(dados);
+            fclose(arquivo);
+            *n_amostras = n;
+            return amostras;
+        } else {
+            fseek(arquivo, (long)(tamanho + (tamanho & 1)), SEEK_CUR);
+        }
+    }
+
+    fprintf(stderr, "%s: esperado WAV mono PCM de 16 bits\n", caminho);
+    fclose(arquivo);
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 2 && strcmp(argv[1], "--gerar") == 0) {
+        return bancada_executar(&relogio_host, true);
+    }
+
+    int falhas = bancada_executar(&relogio_host, false);
+
+    for (int i = 1; i < argc; i++) {
+        size_t n_amostras = 0;
+        uint16_t *amostras = ler_wav(argv[i], &n_amostras);
+        if (!amostras) {
+            falhas++;
+            continue;
+        }
+        sinal_bancada_t sinal = { .nome = argv[i], .amostras = amostras, .n_amostras = n_amostras };
+        falhas += bancada_executar_sinal(&relogio_host, &sinal);
+        free(amostras);
+    }
+
+    printf("%s (%d falha%s)\n", falhas ? "FALHOU" : "OK", falhas, falhas == 1 ? "" : "s");
+    return falhas;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file bancada_pico.c
+ * @brief Bancada de DSP na placa: a mesma suíte, em ciclos do SysTick, pelo console USB.
+ *
+ * Firmware separado (alvo bancada_dsp_pico): roda a suíte ao conectar o
+ * terminal e de novo a cada 'b'. Os ciclos incluem as esperas da XIP; o
+ * melhor de vários passes já é o da cache quente, como no laço de áudio.
+ */
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "include/contador_ciclos.h"
+#include "bancada_dsp.h"
+
+static uint32_t ler_ciclos(void) {
+    return contador_ciclos_ler();
+}
+
+static uint32_t ciclos_desde(uint32_t marca) {
+    return contador_ciclos_desde(marca);
+}
+
+int main(void) {
+    stdio_init_all();
+    contador_ciclos_iniciar();
+
+    const relogio_bancada_t relogio_placa = {
+        .unidade = "ciclos",
+        .unidades_por_segundo = clock_get_hz(clk_sys),
+        .ler = ler_ciclos,
+        .desde = ciclos_desde,
+    };
+
+    while (!stdio_usb_connected()) {
+        sleep_ms(100);
+    }
+    sleep_ms(500); // Dá tempo ao terminal de abrir a porta
+
+    while (true) {
+        printf("\nBancada de DSP (clk_sys %lu Hz)\n", (unsigned long)relogio_placa.unidades_por_segundo);
+        int falhas = bancada_executar(&relogio_placa, false);
+        printf("%s (%d falha%s). 'b' roda de novo.\n", falhas ? "FALHOU" : "OK", falhas, falhas == 1 ? "" : "s");
+
+        while (getchar() != 'b') {
+            tight_loop_contents();
+        }
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file i2c.h
+ * @brief Substituto mínimo de hardware/i2c.h para compilar o framebuffer do SSD1306 no computador.
+ *
+ * O ssd1306_i2c.h só usa o tipo da instância (no ssd1306_t); o I2C em si fica
+ * em ssd1306_i2c.c, que a bancada não compila.
+ */
+#ifndef BANCADA_HOST_HARDWARE_I2C_H
+#define BANCADA_HOST_HARDWARE_I2C_H
+
+typedef struct i2c_inst i2c_inst_t;
+
+#endif
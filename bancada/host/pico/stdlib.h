@@ -0,0 +1,22 @@
+/**
+ * @file stdlib.h
+ * @brief Substituto mínimo de pico/stdlib.h para compilar os núcleos de DSP no computador.
+ *
+ * Só a bancada do computador usa este diretório: os atributos de seção da
+ * placa (código na RAM, expansão forçada) viram código comum, e _u() dá os
+ * literais sem sinal dos registradores do SSD1306.
+ */
+#ifndef BANCADA_HOST_PICO_STDLIB_H
+#define BANCADA_HOST_PICO_STDLIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef unsigned int uint;
+
+#define __not_in_flash_func(nome) nome
+#define __force_inline inline __attribute__((always_inline))
+#define _u(x) x##u
+
+#endif
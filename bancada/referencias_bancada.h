@@ -0,0 +1,32 @@
+/**
+ * @file referencias_bancada.h
+ * @brief CRC-32 das saídas de cada caso da bancada em cada sinal sintético.
+ *
+ * Gerado por `bancada_dsp --gerar`. Não edite à mão: regere depois de uma
+ * mudança que altere de propósito a saída de um núcleo.
+ */
+#ifndef REFERENCIAS_BANCADA_H
+#define REFERENCIAS_BANCADA_H
+
+#include <stdint.h>
+
+#define REFERENCIAS_BANCADA_CASOS 12
+#define REFERENCIAS_BANCADA_SINAIS 4
+
+// Colunas: varredura, senoide, ruído, degraus
+static const uint32_t referencias_bancada[REFERENCIAS_BANCADA_CASOS][REFERENCIAS_BANCADA_SINAIS] = {
+    { 0xA31FC41Cu, 0xCE129817u, 0xB82E5356u, 0xA75E4B53u, }, // suavizar q15
+    { 0x04DDA8E7u, 0x4118E3D9u, 0x7D97227Du, 0xCA7D3853u, }, // ganho q12
+    { 0x5E57D70Bu, 0xA21B2D44u, 0x81DC74DDu, 0x7299E2B5u, }, // PWM (divisão)
+    { 0x2798BDFEu, 0xA21B2D44u, 0x3B01FD26u, 0x7299E2B5u, }, // PWM (recíproco)
+    { 0x376CDA0Eu, 0x457B2E19u, 0xCAD1CABBu, 0x102C9912u, }, // resumo de bloco
+    { 0xB2C50343u, 0xEC4DA479u, 0xF71B7D16u, 0x3C2B106Cu, }, // envelope
+    { 0x76BBD5E8u, 0x58E53AECu, 0x763BB47Eu, 0x979B5966u, }, // decimador CIC+FIR
+    { 0xEB1FCC1Bu, 0xABC1C62Au, 0xCCF72914u, 0xB2636909u, }, // FFT 512
+    { 0x28E3DBA7u, 0x77F4A889u, 0x78E3CFBCu, 0x99716784u, }, // sigma-delta 2a ord
+    { 0x0DA802A2u, 0x743665AAu, 0x113E5BFAu, 0x8AFA44EFu, }, // mistura overdub
+    { 0x5D9B4F43u, 0x73A6A14Fu, 0x193A0F50u, 0x4C286FF9u, }, // bloqueio DC
+    { 0x9AE10734u, 0x25205674u, 0xBAF2CA1Eu, 0x81A66376u, }, // AGC/limitador
+};
+
+#endif
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""Gera as tabelas constantes (em flash) usadas pelo firmware.
+
+Uso: python3 ferramentas/gerar_tabelas.py
+Reescreve os cabeçalhos em include/; rode de novo se mudar algum parâmetro.
+"""
+import math
+import os
+
+RAIZ = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include")
+
+FFT_N = 512           # Pontos da FFT real
+FFT_M = FFT_N // 2    # Pontos da FFT complexa usada internamente
+
+SINTE_TAXA = 48000        # Taxa de amostragem para a qual as tabelas do sintetizador valem
+SINTE_TAMANHO = 256       # Amostras por ciclo de cada tabela de onda
+SINTE_FAIXAS = 6          # Tabelas por forma de onda, uma por oitava de frequência fundamental
+SINTE_OITAVA_BASE = 23    # Faixa 0: incremento de fase < 2^24 (f < 187,5 Hz a 48 kHz)
+SINTE_PICO = 0.95         # Pico das tabelas (fração do fundo de escala Q15)
+
+DECIM_TAXA_SAIDA = 48000  # Taxa depois da decimação
+DECIM_FATOR = 8           # Sobreamostragem do ADC (384 ksps)
+DECIM_FATOR_CIC = 4       # O CIC leva a 96 kHz e o FIR, decimando por 2, a 48 kHz
+DECIM_ORDEM_CIC = 5
+DECIM_TAPS = 47           # FIR de fase linear (tipo I)
+DECIM_BANDA_PASSANTE = 20000.0
+DECIM_BANDA_REJEICAO = 28000.0  # Tudo acima disso dobraria para dentro de 0-20 kHz
+DECIM_PESO_REJEICAO = 30.0
+
+
+def q15(valor):
+    return max(-32768, min(32767, int(round(valor * 32768.0))))
+
+
+def formatar(valores, por_linha=12):
+    linhas = []
+    for i in range(0, len(valores), por_linha):
+        linhas.append("    " + ", ".join(str(v) for v in valores[i:i + por_linha]) + ",")
+    return "\n".join(linhas)
+
+
+def inverter_bits(valor, bits):
+    resultado = 0
+    for _ in range(bits):
+        resultado = (resultado << 1) | (valor & 1)
+        valor >>= 1
+    return resultado
+
+
+def gerar_tabelas_fft():
+    # sin(2*pi*i/N) para i < 3N/4: cobre também cos(x) = sin(x + pi/2) para x < pi
+    seno = [q15(math.sin(2 * math.pi * i / FFT_N)) for i in range(FFT_N * 3 // 4)]
+    # Janela de Hann periódica, simétrica: w[N - n] = w[n], guardada para n <= N/2
+    hann = [q15(0.5 * (1 - math.cos(2 * math.pi * n / FFT_N))) for n in range(FFT_N // 2 + 1)]
+    bits = FFT_M.bit_length() - 1
+    reverso = [inverter_bits(i, bits) for i in range(FFT_M)]
+
+    return f"""/**
+ * @file tabelas_fft.h
+ * @brief Tabelas da FFT real de {FFT_N} pontos (geradas por ferramentas/gerar_tabelas.py).
+ *
+ * Não edite à mão. As tabelas são const e ficam na flash.
+ */
+#ifndef TABELAS_FFT_H
+#define TABELAS_FFT_H
+
+#include <stdint.h>
+
+#define TABELAS_FFT_N {FFT_N}
+
+// sin(2*pi*i/{FFT_N}) em Q15, i < {len(seno)}
+static const int16_t tabela_seno_fft[{len(seno)}] = {{
+{formatar(seno)}
+}};
+
+// Janela de Hann em Q15, n <= {FFT_N // 2} (w[{FFT_N} - n] = w[n])
+static const int16_t tabela_hann_fft[{len(hann)}] = {{
+{formatar(hann)}
+}};
+
+// Permutação por inversão de bits da FFT complexa de {FFT_M} pontos
+static const uint8_t tabela_bits_invertidos_fft[{len(reverso)}] = {{
+{formatar(reverso, 16)}
+}};
+
+#endif
+"""
+
+
+def onda_limitada(harmonicos, amplitude):
+    """Soma de Fourier truncada, com o fator sigma de Lanczos para atenuar o Gibbs."""
+    n_harmonicos = len(harmonicos)
+    valores = []
+    for i in range(SINTE_TAMANHO):
+        fase = 2 * math.pi * i / SINTE_TAMANHO
+        soma = 0.0
+        for h in harmonicos:
+            sigma = 1.0 if h == 1 else math.sin(math.pi * h / (harmonicos[-1] + 1)) / (math.pi * h / (harmonicos[-1] + 1))
+            soma += amplitude(h) * sigma * math.sin(h * fase)
+        valores.append(soma)
+    pico = max(abs(v) for v in valores) if n_harmonicos else 1.0
+    return [q15(SINTE_PICO * v / pico) for v in valores]
+
+
+def harmonicos_da_faixa(faixa):
+    # A faixa vale para incrementos < 2^(OITAVA_BASE + 1 + faixa): abaixo de Nyquist em toda ela
+    f_max = (2 ** (SINTE_OITAVA_BASE + 1 + faixa)) * SINTE_TAXA / 2 ** 32
+    return min(SINTE_TAMANHO // 2 - 1, int(SINTE_TAXA / 2 // f_max))
+
+
+def gerar_tabelas_sintetizador():
+    seno = [q15(SINTE_PICO * math.sin(2 * math.pi * i / SINTE_TAMANHO)) for i in range(SINTE_TAMANHO)]
+    serra = []
+    quadrada = []
+    for faixa in range(SINTE_FAIXAS):
+        h_max = harmonicos_da_faixa(faixa)
+        serra.append(onda_limitada(list(range(1, h_max + 1)), lambda h: (-1) ** (h + 1) / h))
+        quadrada.append(onda_limitada(list(range(1, h_max + 1, 2)), lambda h: 1.0 / h))
+
+    # Incremento de fase por amostra (acumulador de 32 bits) de cada nota MIDI
+    incrementos = [int(round(440.0 * 2 ** ((n - 69) / 12) * 2 ** 32 / SINTE_TAXA)) for n in range(128)]
+
+    def bloco_faixas(nome, tabelas):
+        linhas = [f"static const int16_t {nome}[{SINTE_FAIXAS}][{SINTE_TAMANHO}] = {{"]
+        for faixa, tabela in enumerate(tabelas):
+            linhas.append(f"    {{ // Faixa {faixa}: {harmonicos_da_faixa(faixa)} harmônicos")
+            linhas.append(formatar(tabela).replace("\n    ", "\n        ").replace("    ", "        ", 1))
+            linhas.append("    },")
+        linhas.append("};")
+        return "\n".join(linhas)
+
+    return f"""/**
+ * @file tabelas_sintetizador.h
+ * @brief Tabelas de onda com banda limitada e incrementos de fase das notas
+ *        (geradas por ferramentas/gerar_tabelas.py).
+ *
+ * Não edite à mão. Valem para {SINTE_TAXA} Hz: a faixa f de cada forma de onda
+ * atende incrementos de fase abaixo de 2^({SINTE_OITAVA_BASE + 1} + f) e só tem
+ * harmônicos abaixo de Nyquist em toda a faixa.
+ */
+#ifndef TABELAS_SINTETIZADOR_H
+#define TABELAS_SINTETIZADOR_H
+
+#include <stdint.h>
+
+#define TABELAS_SINTETIZADOR_TAXA {SINTE_TAXA}
+#define TABELAS_SINTETIZADOR_TAMANHO {SINTE_TAMANHO}
+#define TABELAS_SINTETIZADOR_FAIXAS {SINTE_FAIXAS}
+#define TABELAS_SINTETIZADOR_OITAVA_BASE {SINTE_OITAVA_BASE}
+
+static const int16_t tabela_seno_sintetizador[{SINTE_TAMANHO}] = {{
+{formatar(seno)}
+}};
+
+{bloco_faixas("tabela_serra_sintetizador", serra)}
+
+{bloco_faixas("tabela_quadrada_sintetizador", quadrada)}
+
+// Incremento de fase por amostra das notas MIDI 0..127
+static const uint32_t tabela_incremento_notas[128] = {{
+{formatar(incrementos, 6)}
+}};
+
+#endif
+"""
+
+
+def resposta_cic(f):
+    taxa_adc = DECIM_TAXA_SAIDA * DECIM_FATOR
+    if f == 0:
+        return 1.0
+    x = math.pi * f / taxa_adc
+    return abs(math.sin(DECIM_FATOR_CIC * x) / (DECIM_FATOR_CIC * math.sin(x))) ** DECIM_ORDEM_CIC
+
+
+def resolver_sistema(a, b):
+    """Eliminação de Gauss com pivotamento parcial (o sistema é pequeno)."""
+    n = len(b)
+    for i in range(n):
+        pivo = max(range(i, n), key=lambda r: abs(a[r][i]))
+        a[i], a[pivo] = a[pivo], a[i]
+        b[i], b[pivo] = b[pivo], b[i]
+        for r in range(i + 1, n):
+            m = a[r][i] / a[i][i]
+            for c in range(i, n):
+                a[r][c] -= m * a[i][c]
+            b[r] -= m * b[i]
+    x = [0.0] * n
+    for i in reversed(range(n)):
+        x[i] = (b[i] - sum(a[i][c] * x[c] for c in range(i + 1, n))) / a[i][i]
+    return x
+
+
+def gerar_tabelas_decimador():
+    # Mínimos quadrados ponderados: 1/CIC na banda passante (compensa a queda) e zero na rejeição
+    taxa_fir = DECIM_TAXA_SAIDA * DECIM_FATOR // DECIM_FATOR_CIC
+    meio = (DECIM_TAPS - 1) // 2
+    n = meio + 1
+    a = [[0.0] * n for _ in range(n)]
+    b = [0.0] * n
+    for i in range(2001):
+        f = i * (taxa_fir / 2) / 2000
+        if f <= DECIM_BANDA_PASSANTE:
+            desejado, peso = 1.0 / resposta_cic(f), 1.0
+        elif f >= DECIM_BANDA_REJEICAO:
+            desejado, peso = 0.0, DECIM_PESO_REJEICAO
+        else:
+            continue
+        w = 2 * math.pi * f / taxa_fir
+        base = [1.0] + [2 * math.cos(k * w) for k in range(1, n)]
+        for r in range(n):
+            b[r] += peso * base[r] * desejado
+            for c in range(n):
+                a[r][c] += peso * base[r] * base[c]
+    metade = resolver_sistema(a, b)
+    coeficientes = [q15(metade[abs(k - meio)]) for k in range(DECIM_TAPS)]
+
+    return f"""/**
+ * @file tabelas_decimador.h
+ * @brief FIR de compensação do decimador CIC (gerado por ferramentas/gerar_tabelas.py).
+ *
+ * Não edite à mão. ADC a {DECIM_TAXA_SAIDA * DECIM_FATOR // 1000} ksps -> CIC de ordem {DECIM_ORDEM_CIC}
+ * decimando por {DECIM_FATOR_CIC} -> este FIR decimando por {DECIM_FATOR // DECIM_FATOR_CIC} ->
+ * {DECIM_TAXA_SAIDA} Hz. Banda passante plana até {int(DECIM_BANDA_PASSANTE)} Hz (já compensada a queda
+ * do CIC) e rejeição a partir de {int(DECIM_BANDA_REJEICAO)} Hz.
+ */
+#ifndef TABELAS_DECIMADOR_H
+#define TABELAS_DECIMADOR_H
+
+#include <stdint.h>
+
+#define TABELAS_DECIMADOR_TAXA_SAIDA {DECIM_TAXA_SAIDA}
+#define TABELAS_DECIMADOR_FATOR {DECIM_FATOR}
+#define TABELAS_DECIMADOR_FATOR_CIC {DECIM_FATOR_CIC}
+#define TABELAS_DECIMADOR_ORDEM_CIC {DECIM_ORDEM_CIC}
+#define TABELAS_DECIMADOR_TAPS {DECIM_TAPS}
+
+// Coeficientes Q15, simétricos
+static const int16_t tabela_fir_decimador[{DECIM_TAPS}] = {{
+{formatar(coeficientes)}
+}};
+
+#endif
+"""
+
+
+def main():
+    with open(os.path.join(RAIZ, "tabelas_fft.h"), "w", encoding="utf-8") as arquivo:
+        arquivo.write(gerar_tabelas_fft())
+    with open(os.path.join(RAIZ, "tabelas_sintetizador.h"), "w", encoding="utf-8") as arquivo:
+        arquivo.write(gerar_tabelas_sintetizador())
+    with open(os.path.join(RAIZ, "tabelas_decimador.h"), "w", encoding="utf-8") as arquivo:
+        arquivo.write(gerar_tabelas_decimador())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,380 @@
+#!/usr/bin/env python3
+"""Exporta e importa gravações pela porta CDC binária da placa (ver include/transferencia_usb.h).
+
+Uso:
+    python3 ferramentas/transferir_gravacao.py info PORTA
+    python3 ferramentas/transferir_gravacao.py exportar PORTA saida.wav
+    python3 ferramentas/transferir_gravacao.py importar PORTA entrada.wav
+    python3 ferramentas/transferir_gravacao.py perfis PORTA
+    python3 ferramentas/transferir_gravacao.py perfil PORTA N
+    python3 ferramentas/transferir_gravacao.py takes PORTA
+    python3 ferramentas/transferir_gravacao.py take PORTA N
+
+PORTA é a segunda porta serial da placa ("Transferencia"; a primeira é o
+console). A exportação recebe os bytes do take selecionado no banco da placa,
+no codec em que ele está guardado, e os decodifica aqui; o WAV sai em PCM de
+16 bits, mono, na taxa da gravação. A importação aceita WAV PCM de 8 ou 16 bits (canais são somados)
+de 8000 a 48000 Hz: a placa reproduz pela taxa do arquivo. `perfis` lista os
+perfis de taxa da placa e `perfil N` escolhe o da próxima gravação; `takes`
+lista o banco de takes e `take N` escolhe o que é exportado e reproduzido.
+A importação vira um take novo, selecionado.
+
+Requer pyserial (pip install pyserial).
+"""
+import argparse
+import struct
+import sys
+import time
+import wave
+import zlib
+
+SINCRONISMO = b"\xA5\x5A"
+TAMANHO_CABECALHO = 6
+
+CMD_INFO = 0x01
+CMD_EXPORTAR = 0x02
+CMD_IMPORTAR = 0x03
+CMD_AMOSTRAS = 0x04
+CMD_CONCLUIR = 0x05
+CMD_PERFIL = 0x06
+CMD_TAKE = 0x07
+
+RESP_INFO = 0x81
+RESP_DADOS = 0x82
+RESP_FIM = 0x83
+RESP_ACK = 0x84
+RESP_NACK = 0x85
+RESP_PERFIL = 0x86
+RESP_TAKE = 0x87
+
+ERROS = {1: "CRC", 2: "comando inválido", 3: "sem importação em curso", 4: "capacidade", 5: "sequência"}
+
+CODEC_PCM16, CODEC_PACKED12, CODEC_IMA_ADPCM = 0, 1, 2
+NOMES_CODECS = {CODEC_PCM16: "PCM16", CODEC_PACKED12: "PACKED12", CODEC_IMA_ADPCM: "IMA-ADPCM"}
+CABECALHO_ADPCM = 4
+
+# Tabelas padrão do IMA-ADPCM (as mesmas de include/codec_amostras.c)
+PASSOS_ADPCM = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+]
+INDICES_ADPCM = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+class ErroProtocolo(Exception):
+    pass
+
+
+# --- Quadros ---
+
+def montar_quadro(tipo, seq, carga=b""):
+    corpo = struct.pack("<BBH", tipo, seq & 0xFF, len(carga)) + carga
+    return SINCRONISMO + corpo + struct.pack("<I", zlib.crc32(corpo))
+
+
+def ler_exato(porta, n):
+    dados = bytearray()
+    while len(dados) < n:
+        parte = porta.read(n - len(dados))
+        if not parte:
+            raise ErroProtocolo("tempo esgotado esperando a placa")
+        dados += parte
+    return bytes(dados)
+
+
+def ler_quadro(porta):
+    # Procura o sincronismo byte a byte (restos de uma transferência anterior são descartados)
+    anterior = b""
+    while True:
+        byte = ler_exato(porta, 1)
+        if anterior + byte == SINCRONISMO:
+            break
+        anterior = byte
+    tipo, seq, comprimento = struct.unpack("<BBH", ler_exato(porta, 4))
+    carga = ler_exato(porta, comprimento)
+    (crc,) = struct.unpack("<I", ler_exato(porta, 4))
+    if crc != zlib.crc32(struct.pack("<BBH", tipo, seq, comprimento) + carga):
+        raise ErroProtocolo("CRC inválido num quadro do tipo 0x%02X" % tipo)
+    if tipo == RESP_NACK:
+        comando, erro, valor = struct.unpack("<BBI", carga)
+        raise ErroProtocolo("placa recusou o comando 0x%02X: %s (%d)" % (comando, ERROS.get(erro, erro), valor))
+    return tipo, seq, carga
+
+
+def esperar(porta, tipo_esperado):
+    tipo, seq, carga = ler_quadro(porta)
+    if tipo != tipo_esperado:
+        raise ErroProtocolo("esperava quadro 0x%02X, veio 0x%02X" % (tipo_esperado, tipo))
+    return seq, carga
+
+
+def decodificar_info(carga):
+    codec, origem, por_bloco, freq, n_amostras, n_bytes, capacidade = struct.unpack("<BBHIIII", carga)
+    return {
+        "codec": codec, "origem": "flash" if origem else "RAM", "amostras_por_bloco": por_bloco,
+        "freq": freq, "n_amostras": n_amostras, "bytes": n_bytes, "capacidade": capacidade,
+    }
+
+
+def decodificar_perfil(carga):
+    indice, n_perfis, escolhido, taxa, freq_sistema = struct.unpack("<BBBII", carga[:11])
+    return {
+        "indice": indice, "n_perfis": n_perfis, "escolhido": escolhido, "taxa": taxa,
+        "freq_sistema": freq_sistema, "nome": carga[11:].split(b"\0")[0].decode("ascii"),
+    }
+
+
+def decodificar_take(carga):
+    indice, n_takes, selecionado, codec, freq, n_amostras, n_bytes, livre = struct.unpack("<BBBBIIII", carga)
+    return {
+        "indice": indice, "n_takes": n_takes, "selecionado": selecionado, "codec": codec, "freq": freq,
+        "n_amostras": n_amostras, "bytes": n_bytes, "livre": livre,
+    }
+
+
+# --- Codecs (espelham codec_decodificar_bloco) ---
+
+def decodificar_bloco(codec, dados, n):
+    if codec == CODEC_PCM16:
+        return list(struct.unpack("<%dH" % n, dados[:2 * n]))
+
+    if codec == CODEC_PACKED12:
+        amostras = []
+        for i in range(0, n - 1, 2):
+            b0, b1, b2 = dados[3 * (i // 2):3 * (i // 2) + 3]
+            amostras += [b0 | ((b1 & 0x0F) << 8), (b1 >> 4) | (b2 << 4)]
+        if n % 2:
+            b0, b1 = dados[3 * (n // 2):3 * (n // 2) + 2]
+            amostras.append(b0 | ((b1 & 0x0F) << 8))
+        return amostras
+
+    if codec == CODEC_IMA_ADPCM:
+        preditor = struct.unpack("<h", dados[0:2])[0]
+        indice = min(dados[2], 88)
+        amostras = []
+        for i in range(n):
+            byte = dados[CABECALHO_ADPCM + i // 2]
+            codigo = (byte >> 4) if (i & 1) else (byte & 0x0F)
+            passo = PASSOS_ADPCM[indice]
+            delta = passo >> 3
+            if codigo & 4:
+                delta += passo
+            if codigo & 2:
+                delta += passo >> 1
+            if codigo & 1:
+                delta += passo >> 2
+            preditor = max(-32768, min(32767, preditor - delta if codigo & 8 else preditor + delta))
+            indice = max(0, min(88, indice + INDICES_ADPCM[codigo & 7]))
+            amostras.append(max(0, min(4095, (preditor >> 4) + 2048)))
+        return amostras
+
+    raise ErroProtocolo("codec desconhecido: %d" % codec)
+
+
+def bytes_por_bloco(codec, n):
+    if codec == CODEC_PACKED12:
+        return (3 * n + 1) // 2
+    if codec == CODEC_IMA_ADPCM:
+        return CABECALHO_ADPCM + (n + 1) // 2
+    return 2 * n
+
+
+def decodificar_gravacao(info, dados):
+    amostras = []
+    restantes = info["n_amostras"]
+    posicao = 0
+    while restantes > 0:
+        n = min(restantes, info["amostras_por_bloco"])
+        tamanho = bytes_por_bloco(info["codec"], n)
+        amostras += decodificar_bloco(info["codec"], dados[posicao:posicao + tamanho], n)
+        posicao += tamanho
+        restantes -= n
+    return amostras
+
+
+# --- 12 bits (centro em 2048) <-> PCM 16 ---
+
+def para_pcm16(amostras):
+    return struct.pack("<%dh" % len(amostras), *((a - 2048) << 4 for a in amostras))
+
+
+def de_pcm16(valores):
+    return [max(0, min(4095, (v >> 4) + 2048)) for v in valores]
+
+
+# --- Comandos ---
+
+def info(porta):
+    porta.write(montar_quadro(CMD_INFO, 0))
+    _, carga = esperar(porta, RESP_INFO)
+    return decodificar_info(carga)
+
+
+def perfil(porta, indice=None, escolher=False):
+    carga = b"" if indice is None else struct.pack("<BB", indice, 1 if escolher else 0)
+    porta.write(montar_quadro(CMD_PERFIL, 0, carga))
+    _, carga = esperar(porta, RESP_PERFIL)
+    return decodificar_perfil(carga)
+
+
+def perfis(porta):
+    primeiro = perfil(porta, 0)
+    return [primeiro] + [perfil(porta, i) for i in range(1, primeiro["n_perfis"])]
+
+
+def take(porta, indice=None, selecionar=False):
+    carga = b"" if indice is None else struct.pack("<BB", indice, 1 if selecionar else 0)
+    porta.write(montar_quadro(CMD_TAKE, 0, carga))
+    _, carga = esperar(porta, RESP_TAKE)
+    return decodificar_take(carga)
+
+
+def takes(porta):
+    primeiro = take(porta, 0)
+    return [primeiro] + [take(porta, i) for i in range(1, primeiro["n_takes"])]
+
+
+def exportar(porta):
+    inicio = time.monotonic()
+    porta.write(montar_quadro(CMD_EXPORTAR, 0))
+    seq, carga = esperar(porta, RESP_INFO)
+    dados_info = decodificar_info(carga)
+
+    dados = bytearray()
+    while True:
+        tipo, seq_quadro, carga = ler_quadro(porta)
+        seq = (seq + 1) & 0xFF
+        if seq_quadro != seq:
+            raise ErroProtocolo("quadro %d perdido (veio %d)" % (seq, seq_quadro))
+        if tipo == RESP_FIM:
+            total, crc_total = struct.unpack("<II", carga)
+            break
+        if tipo != RESP_DADOS:
+            raise ErroProtocolo("quadro inesperado 0x%02X na exportação" % tipo)
+        (deslocamento,) = struct.unpack("<I", carga[:4])
+        if deslocamento != len(dados):
+            raise ErroProtocolo("deslocamento %d, esperava %d" % (deslocamento, len(dados)))
+        dados += carga[4:]
+
+    if total != len(dados) or crc_total != zlib.crc32(dados):
+        raise ErroProtocolo("gravação recebida não confere com o FIM")
+    return dados_info, bytes(dados), time.monotonic() - inicio
+
+
+def importar(porta, freq, amostras, por_bloco=256):
+    porta.write(montar_quadro(CMD_IMPORTAR, 0, struct.pack("<II", freq, len(amostras))))
+    esperar(porta, RESP_ACK)
+
+    # Os blocos seguem sem esperar resposta; um NACK chega antes do ACK do CONCLUIR
+    quadros = bytearray()
+    seq = 1
+    for inicio in range(0, len(amostras), por_bloco):
+        bloco = amostras[inicio:inicio + por_bloco]
+        carga = struct.pack("<I%dH" % len(bloco), inicio, *bloco)
+        quadros += montar_quadro(CMD_AMOSTRAS, seq, carga)
+        seq += 1
+    porta.write(bytes(quadros))
+    porta.write(montar_quadro(CMD_CONCLUIR, seq))
+    _, carga = esperar(porta, RESP_ACK)
+    return struct.unpack("<BI", carga)[1]
+
+
+# --- WAV ---
+
+def escrever_wav(caminho, freq, amostras):
+    with wave.open(caminho, "wb") as arquivo:
+        arquivo.setnchannels(1)
+        arquivo.setsampwidth(2)
+        arquivo.setframerate(freq)
+        arquivo.writeframes(para_pcm16(amostras))
+
+
+def ler_wav(caminho):
+    with wave.open(caminho, "rb") as arquivo:
+        canais = arquivo.getnchannels()
+        largura = arquivo.getsampwidth()
+        freq = arquivo.getframerate()
+        quadros = arquivo.readframes(arquivo.getnframes())
+
+    if largura == 1:
+        valores = [(b - 128) << 8 for b in quadros]
+    elif largura == 2:
+        valores = list(struct.unpack("<%dh" % (len(quadros) // 2), quadros))
+    else:
+        raise ErroProtocolo("WAV de %d bits não suportado (use 8 ou 16)" % (8 * largura))
+
+    if canais > 1:
+        valores = [sum(valores[i:i + canais]) // canais for i in range(0, len(valores), canais)]
+    return freq, de_pcm16(valores)
+
+
+def principal():
+    analisador = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = analisador.add_subparsers(dest="comando", required=True)
+    sub.add_parser("info").add_argument("porta")
+    p = sub.add_parser("exportar")
+    p.add_argument("porta")
+    p.add_argument("wav")
+    p = sub.add_parser("importar")
+    p.add_argument("porta")
+    p.add_argument("wav")
+    sub.add_parser("perfis").add_argument("porta")
+    p = sub.add_parser("perfil")
+    p.add_argument("porta")
+    p.add_argument("indice", type=int)
+    sub.add_parser("takes").add_argument("porta")
+    p = sub.add_parser("take")
+    p.add_argument("porta")
+    p.add_argument("indice", type=int)
+    args = analisador.parse_args()
+
+    import serial  # Só aqui: as funções acima servem sem a placa
+
+    with serial.Serial(args.porta, timeout=2) as porta:
+        porta.reset_input_buffer()
+        if args.comando == "info":
+            dados = info(porta)
+            print("%d amostras a %d Hz em %s (%s, %d bytes); importação cabe %d amostras"
+                  % (dados["n_amostras"], dados["freq"], NOMES_CODECS.get(dados["codec"], "?"),
+                     dados["origem"], dados["bytes"], dados["capacidade"]))
+
+        elif args.comando == "exportar":
+            dados_info, dados, segundos = exportar(porta)
+            amostras = decodificar_gravacao(dados_info, dados)
+            escrever_wav(args.wav, dados_info["freq"] or 48000, amostras)
+            print("%d bytes (%s, %s) em %.3f s (%.0f KB/s) -> %s: %d amostras a %d Hz"
+                  % (len(dados), NOMES_CODECS.get(dados_info["codec"], "?"), dados_info["origem"], segundos,
+                     len(dados) / 1000.0 / max(segundos, 1e-6), args.wav, len(amostras), dados_info["freq"]))
+
+        elif args.comando in ("perfis", "perfil"):
+            lista = perfis(porta) if args.comando == "perfis" else [perfil(porta, args.indice, escolher=True)]
+            for dados in lista:
+                print("%s %d: %-7s %6d Hz, clk_sys %.1f MHz"
+                      % ("*" if dados["indice"] == dados["escolhido"] else " ", dados["indice"], dados["nome"],
+                         dados["taxa"], dados["freq_sistema"] / 1e6))
+
+        elif args.comando in ("takes", "take"):
+            lista = takes(porta) if args.comando == "takes" else [take(porta, args.indice, selecionar=True)]
+            for dados in lista:
+                print("%s %d: %7d amostras a %5d Hz em %-9s (%d bytes)"
+                      % ("*" if dados["indice"] == dados["selecionado"] else " ", dados["indice"], dados["n_amostras"],
+                         dados["freq"], NOMES_CODECS.get(dados["codec"], "?"), dados["bytes"]))
+            if lista:
+                print("%d bytes livres no banco" % lista[-1]["livre"])
+
+        else:
+            freq, amostras = ler_wav(args.wav)
+            inicio = time.monotonic()
+            n = importar(porta, freq, amostras)
+            print("%d amostras a %d Hz enviadas em %.3f s" % (n, freq, time.monotonic() - inicio))
+
+
+if __name__ == "__main__":
+    try:
+        principal()
+    except ErroProtocolo as erro:
+        sys.exit("Erro: %s" % erro)
@@ -2,14 +2,28 @@
 extern void calculate_render_area_buffer_length(struct render_area *area);
 extern void ssd1306_send_command(uint8_t cmd);
 extern void ssd1306_send_command_list(uint8_t *ssd, int number);
-extern void ssd1306_send_buffer(uint8_t ssd[], int buffer_length);
+extern void ssd1306_framebuffer_init(ssd1306_framebuffer_t *fb);
+extern void ssd1306_mark_all_dirty(ssd1306_framebuffer_t *fb);
+extern void ssd1306_mark_clean(ssd1306_framebuffer_t *fb);
+extern int ssd1306_dirty_areas(const ssd1306_framebuffer_t *fb, struct render_area *areas);
+extern void ssd1306_flush(ssd1306_framebuffer_t *fb);
+extern bool ssd1306_flush_async(ssd1306_framebuffer_t *fb, void (*on_done)(void));
+extern void ssd1306_clear_pages(ssd1306_framebuffer_t *fb, int first_page, int last_page);
 extern void ssd1306_init();
 extern void ssd1306_scroll(bool set);
-extern void render_on_display(uint8_t *ssd, struct render_area *area);
-extern void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set);
-extern void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set);
-extern void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character);
-extern void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string);
+extern void render_on_display(ssd1306_framebuffer_t *fb, struct render_area *area);
+extern void ssd1306_dma_init();
+extern bool render_on_display_async(const ssd1306_framebuffer_t *fb, const struct render_area *area, void (*on_done)(void));
+extern bool ssd1306_dma_busy();
+extern void ssd1306_dma_wait();
+extern uint32_t ssd1306_dma_errors();
+extern void ssd1306_set_pixel(ssd1306_framebuffer_t *fb, int x, int y, bool set);
+extern void ssd1306_fill_rect(ssd1306_framebuffer_t *fb, int x_0, int y_0, int x_1, int y_1, bool set);
+extern void ssd1306_draw_vspan(ssd1306_framebuffer_t *fb, int x, int y_0, int y_1, bool set);
+extern void ssd1306_draw_hline(ssd1306_framebuffer_t *fb, int x_0, int x_1, int y, bool set);
+extern void ssd1306_draw_line(ssd1306_framebuffer_t *fb, int x_0, int y_0, int x_1, int y_1, bool set);
+extern void ssd1306_draw_char(ssd1306_framebuffer_t *fb, int16_t x, int16_t y, uint8_t character);
+extern void ssd1306_draw_string(ssd1306_framebuffer_t *fb, int16_t x, int16_t y, char *string);
 extern void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 extern void ssd1306_config(ssd1306_t *ssd);
 extern void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
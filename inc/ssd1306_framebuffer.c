@@ -0,0 +1,257 @@
+/**
+ * @file ssd1306_framebuffer.c
+ * @brief Desenho e faixas sujas do framebuffer do SSD1306, sem acesso ao I2C.
+ *
+ * Separado de ssd1306_i2c.c para que a bancada do computador compile estas funções
+ * e as compare com ssd1306_set_pixel (ver bancada_dsp.c).
+ */
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "pico/stdlib.h"
+#include "ssd1306_font.h"
+#include "ssd1306.h"
+
+// Calcular quanto do buffer será destinado à área de renderização
+void calculate_render_area_buffer_length(struct render_area *area) {
+    area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
+}
+
+// Prepara o framebuffer: byte de controle de dados e todos os pixels apagados.
+// A RAM do display tem conteúdo indefinido após ligar, então tudo começa sujo.
+void ssd1306_framebuffer_init(ssd1306_framebuffer_t *fb) {
+    fb->control = ssd1306_control_data;
+    memset(fb->pixels, 0, sizeof(fb->pixels));
+    ssd1306_mark_all_dirty(fb);
+}
+
+static inline void ssd1306_mark_dirty(ssd1306_framebuffer_t *fb, int page, int column) {
+    if (column < fb->dirty_first[page]) fb->dirty_first[page] = column;
+    if (column > fb->dirty_last[page]) fb->dirty_last[page] = column;
+}
+
+static inline bool ssd1306_page_dirty(const ssd1306_framebuffer_t *fb, int page) {
+    return fb->dirty_first[page] <= fb->dirty_last[page];
+}
+
+void ssd1306_mark_clean(ssd1306_framebuffer_t *fb) {
+    memset(fb->dirty_first, ssd1306_width, sizeof(fb->dirty_first));
+    memset(fb->dirty_last, 0, sizeof(fb->dirty_last));
+}
+
+void ssd1306_mark_all_dirty(ssd1306_framebuffer_t *fb) {
+    memset(fb->dirty_first, 0, sizeof(fb->dirty_first));
+    memset(fb->dirty_last, ssd1306_width - 1, sizeof(fb->dirty_last));
+}
+
+// Grava um byte do framebuffer, marcando a coluna apenas se o conteúdo mudou
+static inline void ssd1306_write_byte(ssd1306_framebuffer_t *fb, int page, int column, uint8_t value) {
+    uint8_t *byte = &fb->pixels[page * ssd1306_width + column];
+    if (*byte != value) {
+        *byte = value;
+        ssd1306_mark_dirty(fb, page, column);
+    }
+}
+
+// Converte as faixas sujas em áreas de renderização. Páginas vizinhas são unidas num
+// retângulo quando isso custa menos bytes do que enviá-las separadas (cada área tem
+// ssd1306_area_overhead bytes de cabeçalho). Retorna o número de áreas (até ssd1306_n_pages).
+int ssd1306_dirty_areas(const ssd1306_framebuffer_t *fb, struct render_area *areas) {
+    int n_areas = 0;
+    int page = 0;
+
+    while (page < ssd1306_n_pages) {
+        if (!ssd1306_page_dirty(fb, page)) {
+            page++;
+            continue;
+        }
+
+        struct render_area area = {
+            .start_column = fb->dirty_first[page], .end_column = fb->dirty_last[page],
+            .start_page = page, .end_page = page
+        };
+
+        for (page++; page < ssd1306_n_pages && ssd1306_page_dirty(fb, page); page++) {
+            int first = (fb->dirty_first[page] < area.start_column) ? fb->dirty_first[page] : area.start_column;
+            int last = (fb->dirty_last[page] > area.end_column) ? fb->dirty_last[page] : area.end_column;
+            int n_pages = area.end_page - area.start_page + 1;
+
+            int merged_cost = (last - first + 1) * (n_pages + 1);
+            int separate_cost = (area.end_column - area.start_column + 1) * n_pages +
+                                ssd1306_area_overhead + (fb->dirty_last[page] - fb->dirty_first[page] + 1);
+            if (merged_cost > separate_cost) {
+                break;
+            }
+
+            area.start_column = first;
+            area.end_column = last;
+            area.end_page = page;
+        }
+
+        calculate_render_area_buffer_length(&area);
+        areas[n_areas++] = area;
+    }
+
+    return n_areas;
+}
+
+// Apaga páginas inteiras, marcando como sujas apenas as colunas que tinham pixels acesos
+void ssd1306_clear_pages(ssd1306_framebuffer_t *fb, int first_page, int last_page) {
+    for (int page = first_page; page <= last_page; page++) {
+        for (int column = 0; column < ssd1306_width; column++) {
+            ssd1306_write_byte(fb, page, column, 0);
+        }
+    }
+}
+
+// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
+void ssd1306_set_pixel(ssd1306_framebuffer_t *fb, int x, int y, bool set) {
+    assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
+
+    int page = y / 8;
+    uint8_t byte = fb->pixels[page * ssd1306_width + x];
+
+    if (set) {
+        byte |= 1 << (y % 8);
+    }
+    else {
+        byte &= ~(1 << (y % 8));
+    }
+
+    ssd1306_write_byte(fb, page, x, byte);
+}
+
+// Linhas de cada página a partir da linha r (até a 7) e até a linha r (desde a 0), bit 0 no topo
+static const uint8_t ssd1306_mask_from_row[ssd1306_page_height] = {0xFF, 0xFE, 0xFC, 0xF8, 0xF0, 0xE0, 0xC0, 0x80};
+static const uint8_t ssd1306_mask_to_row[ssd1306_page_height] = {0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+
+// Acende ou apaga o retângulo de (x_0, y_0) a (x_1, y_1), inclusive, recortado à tela. Cada
+// página coberta recebe uma máscara só (as das bordas saem das tabelas acima), aplicada
+// byte a byte nas colunas: uma leitura e uma escrita por byte, em vez de uma por pixel.
+void ssd1306_fill_rect(ssd1306_framebuffer_t *fb, int x_0, int y_0, int x_1, int y_1, bool set) {
+    if (x_0 < 0) x_0 = 0;
+    if (y_0 < 0) y_0 = 0;
+    if (x_1 >= ssd1306_width) x_1 = ssd1306_width - 1;
+    if (y_1 >= ssd1306_height) y_1 = ssd1306_height - 1;
+    if (x_0 > x_1 || y_0 > y_1) {
+        return;
+    }
+
+    int first_page = y_0 / ssd1306_page_height;
+    int last_page = y_1 / ssd1306_page_height;
+    for (int page = first_page; page <= last_page; page++) {
+        uint8_t mask = 0xFF;
+        if (page == first_page) mask &= ssd1306_mask_from_row[y_0 % ssd1306_page_height];
+        if (page == last_page) mask &= ssd1306_mask_to_row[y_1 % ssd1306_page_height];
+
+        const uint8_t *row = &fb->pixels[page * ssd1306_width];
+        for (int column = x_0; column <= x_1; column++) {
+            uint8_t byte = set ? (row[column] | mask) : (row[column] & ~mask);
+            ssd1306_write_byte(fb, page, column, byte);
+        }
+    }
+}
+
+// Coluna x de y_0 a y_1 (em qualquer ordem): as barras da onda e do espectro
+void ssd1306_draw_vspan(ssd1306_framebuffer_t *fb, int x, int y_0, int y_1, bool set) {
+    if (y_0 > y_1) {
+        int y = y_0;
+        y_0 = y_1;
+        y_1 = y;
+    }
+    ssd1306_fill_rect(fb, x, y_0, x, y_1, set);
+}
+
+// Linha y de x_0 a x_1 (em qualquer ordem): um bit na mesma página em cada coluna
+void ssd1306_draw_hline(ssd1306_framebuffer_t *fb, int x_0, int x_1, int y, bool set) {
+    if (x_0 > x_1) {
+        int x = x_0;
+        x_0 = x_1;
+        x_1 = x;
+    }
+    ssd1306_fill_rect(fb, x_0, y, x_1, y, set);
+}
+
+// Algoritmo de Bresenham básico
+void ssd1306_draw_line(ssd1306_framebuffer_t *fb, int x_0, int y_0, int x_1, int y_1, bool set) {
+    int dx = abs(x_1 - x_0); // Deslocamentos
+    int dy = -abs(y_1 - y_0);
+    int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
+    int sy = y_0 < y_1 ? 1 : -1;
+    int error = dx + dy; // Erro acumulado
+    int error_2;
+
+    while (true) {
+        ssd1306_set_pixel(fb, x_0, y_0, set); // Acende pixel no ponto atual
+        if (x_0 == x_1 && y_0 == y_1) {
+            break; // Verifica se o ponto final foi alcançado
+        }
+
+        error_2 = 2 * error; // Ajusta o erro acumulado
+
+        if (error_2 >= dy) {
+            error += dy;
+            x_0 += sx; // Avança na direção x
+        }
+        if (error_2 <= dx) {
+            error += dx;
+            y_0 += sy; // Avança na direção y
+        }
+    }
+}
+
+// Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
+inline int ssd1306_get_font(uint8_t character)
+{
+  if (character >= 'A' && character <= 'Z') {
+    return character - 'A' + 1;
+  }
+  else if (character >= '0' && character <= '9') {
+    return character - '0' + 27;
+  }
+  else
+    return 0;
+}
+
+// Desenha um único caractere no display. A célula de 8x8 é opaca: apaga o que estava embaixo.
+// Com y múltiplo de 8 cada coluna do glifo é um byte da página, copiado direto da fonte; fora
+// disso o glifo fica em duas páginas, cada coluna deslocada e mesclada sob máscara nas duas.
+void ssd1306_draw_char(ssd1306_framebuffer_t *fb, int16_t x, int16_t y, uint8_t character) {
+    if (x < 0 || y < 0 || x > ssd1306_width - 8 || y > ssd1306_height - 8) {
+        return;
+    }
+
+    character = toupper(character);
+    const uint8_t *glyph = &font[ssd1306_get_font(character) * 8];
+    int page = y / ssd1306_page_height;
+    int shift = y % ssd1306_page_height;
+
+    if (shift == 0) {
+        for (int i = 0; i < 8; i++) {
+            ssd1306_write_byte(fb, page, x + i, glyph[i]);
+        }
+        return;
+    }
+
+    // Linhas shift..7 da página de cima e 0..shift-1 da de baixo
+    uint8_t upper_mask = ssd1306_mask_from_row[shift];
+    const uint8_t *upper = &fb->pixels[page * ssd1306_width + x];
+    const uint8_t *lower = upper + ssd1306_width;
+    for (int i = 0; i < 8; i++) {
+        ssd1306_write_byte(fb, page, x + i, (upper[i] & ~upper_mask) | (uint8_t)(glyph[i] << shift));
+        ssd1306_write_byte(fb, page + 1, x + i, (lower[i] & upper_mask) | (uint8_t)(glyph[i] >> (8 - shift)));
+    }
+}
+
+// Desenha uma string, chamando a função de desenhar caractere várias vezes
+void ssd1306_draw_string(ssd1306_framebuffer_t *fb, int16_t x, int16_t y, char *string) {
+    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
+        return;
+    }
+
+    while (*string) {
+        ssd1306_draw_char(fb, x, y, *string++);
+        x += 8;
+    }
+}
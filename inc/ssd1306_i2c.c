@@ -1,41 +1,66 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
-#include "ssd1306_font.h"
-#include "ssd1306_i2c.h"
-
-// Calcular quanto do buffer será destinado à área de renderização
-void calculate_render_area_buffer_length(struct render_area *area) {
-    area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
-}
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "ssd1306.h"
+
+// Transferências assíncronas: dois fluxos DATA_CMD (um em envio, um na fila)
+static uint16_t dma_stream[2][ssd1306_dma_stream_length];
+static int dma_stream_words[2];
+static void (*dma_stream_done[2])(void);
+static int dma_channel = -1;
+static dma_channel_config dma_config;
+static volatile int dma_active_stream = -1;
+static volatile int dma_queued_stream = -1;
+static volatile uint32_t dma_transfer_errors = 0;
 
 // Processo de escrita do i2c espera um byte de controle, seguido por dados
 void ssd1306_send_command(uint8_t command) {
     uint8_t buffer[2] = {0x80, command};
+    ssd1306_dma_wait();
     i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
 }
 
-// Envia uma lista de comandos ao hardware
+// Envia uma lista de comandos ao hardware como um único fluxo prefixado por 0x00
 void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
+    uint8_t buffer[ssd1306_max_command_batch + 1];
+    buffer[0] = ssd1306_control_command;
+    ssd1306_dma_wait();
+
+    // Listas longas são divididas; o controlador mantém o estado dos parâmetros entre transações
+    while (number > 0) {
+        int n = (number < ssd1306_max_command_batch) ? number : ssd1306_max_command_batch;
+        memcpy(buffer + 1, ssd, n);
+        i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, n + 1, false);
+        ssd += n;
+        number -= n;
     }
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
-void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
-
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
+// Transmite um trecho do framebuffer sem cópia: o byte anterior ao trecho é trocado
+// pelo byte de controle durante a transação e restaurado em seguida
+static void ssd1306_send_data_in_place(uint8_t *data, int length) {
+    ssd1306_dma_wait();
+    uint8_t saved = data[-1];
+    data[-1] = ssd1306_control_data;
+    i2c_write_blocking(i2c1, ssd1306_i2c_address, data - 1, length + 1, false);
+    data[-1] = saved;
+}
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+// Envia (bloqueando) apenas as áreas alteradas desde o último envio
+void ssd1306_flush(ssd1306_framebuffer_t *fb) {
+    struct render_area areas[ssd1306_n_pages];
+    int n_areas = ssd1306_dirty_areas(fb, areas);
 
-    free(temp_buffer);
+    for (int i = 0; i < n_areas; i++) {
+        render_on_display(fb, &areas[i]);
+    }
+    ssd1306_mark_clean(fb);
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
@@ -74,106 +99,184 @@ void ssd1306_scroll(bool set) {
     ssd1306_send_command_list(commands, count_of(commands));
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
+// Atualiza uma parte do display com a área correspondente do framebuffer
+void render_on_display(ssd1306_framebuffer_t *fb, struct render_area *area) {
     uint8_t commands[] = {
         ssd1306_set_column_address, area->start_column, area->end_column,
         ssd1306_set_page_address, area->start_page, area->end_page
     };
 
     ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+
+    // Com a largura total as páginas são contíguas no framebuffer: uma única transação
+    int width = area->end_column - area->start_column + 1;
+    if (width == ssd1306_width) {
+        int n_pages = area->end_page - area->start_page + 1;
+        ssd1306_send_data_in_place(&fb->pixels[area->start_page * ssd1306_width], n_pages * ssd1306_width);
+        return;
+    }
+
+    // Caso contrário, um trecho por página; o display avança de página ao fim da coluna final
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        ssd1306_send_data_in_place(&fb->pixels[page * ssd1306_width + area->start_column], width);
+    }
 }
 
-// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
-void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
-    assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
+static void ssd1306_dma_start(int stream) {
+    dma_active_stream = stream;
+    dma_channel_configure(dma_channel, &dma_config, &i2c_get_hw(i2c1)->data_cmd,
+                          dma_stream[stream], dma_stream_words[stream], true);
+}
 
-    const int bytes_per_row = ssd1306_width;
+// O fim do DMA libera o fluxo (os últimos bytes ainda saem pela FIFO do I2C) e dispara o próximo
+static void ssd1306_dma_irq_handler(void) {
+    if (!dma_channel_get_irq1_status(dma_channel)) return;
+    dma_channel_acknowledge_irq1(dma_channel);
 
-    int byte_idx = (y / 8) * bytes_per_row + x;
-    uint8_t byte = ssd[byte_idx];
+    // Um NACK do display esvazia a FIFO e mantém o abort até ser limpo
+    i2c_hw_t *hw = i2c_get_hw(i2c1);
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        (void)hw->clr_tx_abrt;
+        dma_transfer_errors++;
+    }
 
-    if (set) {
-        byte |= 1 << (y % 8);
+    void (*on_done)(void) = dma_stream_done[dma_active_stream];
+    dma_active_stream = -1;
+    if (dma_queued_stream >= 0) {
+        int next = dma_queued_stream;
+        dma_queued_stream = -1;
+        ssd1306_dma_start(next);
     }
-    else {
-        byte &= ~(1 << (y % 8));
+    if (on_done) {
+        on_done();
     }
-
-    ssd[byte_idx] = byte;
 }
 
-// Algoritmo de Bresenham básico
-void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
-    int dx = abs(x_1 - x_0); // Deslocamentos
-    int dy = -abs(y_1 - y_0);
-    int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
-    int sy = y_0 < y_1 ? 1 : -1;
-    int error = dx + dy; // Erro acumulado
-    int error_2;
-
-    while (true) {
-        ssd1306_set_pixel(ssd, x_0, y_0, set); // Acende pixel no ponto atual
-        if (x_0 == x_1 && y_0 == y_1) {
-            break; // Verifica se o ponto final foi alcançado
-        }
+// Reserva o canal de DMA do I2C; a interrupção DMA_IRQ_1 fica no núcleo que chamar esta função
+void ssd1306_dma_init() {
+    dma_channel = dma_claim_unused_channel(true);
+    dma_config = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_16);
+    channel_config_set_read_increment(&dma_config, true);
+    channel_config_set_write_increment(&dma_config, false);
+    channel_config_set_dreq(&dma_config, i2c_get_dreq(i2c1, true));
 
-        error_2 = 2 * error; // Ajusta o erro acumulado
+    i2c_get_hw(i2c1)->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
 
-        if (error_2 >= dy) {
-            error += dy;
-            x_0 += sx; // Avança na direção x
-        }
-        if (error_2 <= dx) {
-            error += dx;
-            y_0 += sy; // Avança na direção y
+    dma_channel_set_irq1_enabled(dma_channel, true);
+    irq_add_shared_handler(DMA_IRQ_1, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+// Acrescenta uma área ao fluxo DATA_CMD: cada byte vira uma palavra, com RESTART antes de
+// cada byte de controle após o primeiro
+static int ssd1306_append_area(uint16_t *out, int n, const ssd1306_framebuffer_t *fb, const struct render_area *area) {
+    out[n] = ssd1306_control_command;
+    if (n > 0) {
+        out[n] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    }
+    n++;
+    out[n++] = ssd1306_set_column_address;
+    out[n++] = area->start_column;
+    out[n++] = area->end_column;
+    out[n++] = ssd1306_set_page_address;
+    out[n++] = area->start_page;
+    out[n++] = area->end_page;
+
+    // Os trechos das páginas seguem num só fluxo de dados: o display avança de página sozinho
+    out[n++] = I2C_IC_DATA_CMD_RESTART_BITS | ssd1306_control_data;
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        const uint8_t *row = &fb->pixels[page * ssd1306_width];
+        for (int column = area->start_column; column <= area->end_column; column++) {
+            out[n++] = row[column];
         }
     }
+    return n;
 }
 
-// Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
-{
-  if (character >= 'A' && character <= 'Z') {
-    return character - 'A' + 1;
-  }
-  else if (character >= '0' && character <= '9') {
-    return character - '0' + 27;
-  }
-  else
-    return 0;
-}
+// Enfileira as áreas num único fluxo para envio por DMA e retorna sem esperar. O framebuffer é
+// copiado para o fluxo, então pode ser redesenhado logo em seguida. Retorna false se já houver
+// um envio em andamento e outro na fila.
+static bool ssd1306_submit_areas(const ssd1306_framebuffer_t *fb, const struct render_area *areas, int n_areas,
+                                 void (*on_done)(void)) {
+    if (dma_channel < 0 || n_areas <= 0 || n_areas > ssd1306_n_pages) {
+        return false;
+    }
 
-// Desenha um único caractere no display
-void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
-        return;
+    int stream;
+    uint32_t interrupts = save_and_disable_interrupts();
+    if (dma_queued_stream >= 0) {
+        stream = -1;
+    } else {
+        stream = (dma_active_stream == 0) ? 1 : 0;
+    }
+    restore_interrupts(interrupts);
+    if (stream < 0) {
+        return false;
     }
 
-    y = y / 8;
+    // O fluxo escolhido não é referenciado pela interrupção até ser publicado abaixo
+    // STOP no último byte: o controlador segura o SCL se a FIFO esvaziar sem ele
+    int words = 0;
+    for (int i = 0; i < n_areas; i++) {
+        words = ssd1306_append_area(dma_stream[stream], words, fb, &areas[i]);
+    }
+    dma_stream[stream][words - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    dma_stream_words[stream] = words;
+    dma_stream_done[stream] = on_done;
+
+    interrupts = save_and_disable_interrupts();
+    if (dma_active_stream < 0) {
+        ssd1306_dma_start(stream);
+    } else {
+        dma_queued_stream = stream;
+    }
+    restore_interrupts(interrupts);
+    return true;
+}
 
-    character = toupper(character);
-    int idx = ssd1306_get_font(character);
-    int fb_idx = y * 128 + x;
+bool render_on_display_async(const ssd1306_framebuffer_t *fb, const struct render_area *area, void (*on_done)(void)) {
+    return ssd1306_submit_areas(fb, area, 1, on_done);
+}
 
-    for (int i = 0; i < 8; i++) {
-        ssd[fb_idx++] = font[idx * 8 + i];
+// Versão assíncrona de ssd1306_flush: todas as áreas alteradas seguem num só fluxo de DMA.
+// Sem alterações, retorna true sem enviar nada (on_done não é chamado).
+bool ssd1306_flush_async(ssd1306_framebuffer_t *fb, void (*on_done)(void)) {
+    struct render_area areas[ssd1306_n_pages];
+    int n_areas = ssd1306_dirty_areas(fb, areas);
+    if (n_areas == 0) {
+        return true;
+    }
+    if (!ssd1306_submit_areas(fb, areas, n_areas, on_done)) {
+        return false;
     }
+    ssd1306_mark_clean(fb);
+    return true;
+}
+
+bool ssd1306_dma_busy() {
+    return dma_active_stream >= 0 || dma_queued_stream >= 0;
 }
 
-// Desenha uma string, chamando a função de desenhar caractere várias vezes
-void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
+// Espera os fluxos pendentes e o esvaziamento da FIFO; as escritas bloqueantes desabilitam o
+// I2C para trocar o endereço e abortariam uma transferência em curso
+void ssd1306_dma_wait() {
+    if (dma_channel < 0) {
         return;
     }
-
-    while (*string) {
-        ssd1306_draw_char(ssd, x, y, *string++);
-        x += 8;
+    while (ssd1306_dma_busy()) {
+        tight_loop_contents();
+    }
+    i2c_hw_t *hw = i2c_get_hw(i2c1);
+    while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS)) {
+        tight_loop_contents();
     }
 }
 
+uint32_t ssd1306_dma_errors() {
+    return dma_transfer_errors;
+}
+
 // Comando de configuração com base na estrutura ssd1306_t
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
@@ -247,8 +350,8 @@ void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
 //Apaga o que está no display:
 void ssd1306_clear() 
 {
-    uint8_t clear_buffer[ssd1306_width * (ssd1306_height / 8)];
-    memset(clear_buffer, 0x00, sizeof(clear_buffer));
+    ssd1306_framebuffer_t clear_buffer;
+    ssd1306_framebuffer_init(&clear_buffer);
 
     struct render_area full_area = {
         .start_column = 0,
@@ -258,5 +361,5 @@ void ssd1306_clear()
     };
 
     calculate_render_area_buffer_length(&full_area);
-    render_on_display(clear_buffer, &full_area);
+    render_on_display(&clear_buffer, &full_area);
 }
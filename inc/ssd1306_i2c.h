@@ -44,6 +44,18 @@
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+// Byte de controle que precede cada transação I2C (Co = 0, D/C# = 1 para dados)
+#define ssd1306_control_command _u(0x00)
+#define ssd1306_control_data _u(0x40)
+
+#define ssd1306_max_command_batch 32 // Comandos enviados por transação
+
+// Bytes de cabeçalho de cada área: controle + 6 comandos de endereço + controle de dados
+#define ssd1306_area_overhead 8
+
+// Palavras DATA_CMD de uma transferência por DMA: no pior caso uma área por página
+#define ssd1306_dma_stream_length (ssd1306_n_pages * ssd1306_area_overhead + ssd1306_buffer_length)
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
@@ -56,6 +68,16 @@ struct render_area {
     int buffer_length;
 };
 
+// Framebuffer com o byte de controle reservado antes dos pixels, para que
+// as páginas sejam transmitidas no próprio buffer, sem cópia nem heap.
+// Cada página guarda as colunas alteradas desde o último envio (limpa: first > last).
+typedef struct {
+    uint8_t control;
+    uint8_t pixels[ssd1306_buffer_length];
+    uint8_t dirty_first[ssd1306_n_pages];
+    uint8_t dirty_last[ssd1306_n_pages];
+} ssd1306_framebuffer_t;
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t * i2c_port;
@@ -0,0 +1,362 @@
+/**
+ * @file armazenamento_flash.c
+ * @brief Pipeline de apagar/programar setores da flash (ver armazenamento_flash.h).
+ *
+ * O XIP fica indisponível durante flash_range_erase/flash_range_program, então
+ * nenhum dos núcleos pode executar código da flash nesse intervalo. O SDK
+ * oferece multicore_lockout, mas ele desabilita as interrupções do núcleo
+ * bloqueado e a captura ficaria sem o tratador de DMA; aqui o núcleo 0 estaciona
+ * numa rotina em RAM com interrupções habilitadas (exceto a dos botões, cujo
+ * tratador está na flash) e segue atendendo o DMA_IRQ_0.
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "armazenamento_flash.h"
+
+#define MAGICA_CABECALHO 0x46565247u // "GRVF"
+#define VERSAO_CABECALHO 1u
+
+// Setores mantidos apagados à frente do ponteiro de escrita
+#define SETORES_ANTECIPADOS 2
+
+#define N_SETORES_DADOS ((PICO_FLASH_SIZE_BYTES - FLASH_OFFSET_GRAVACAO) / FLASH_SECTOR_SIZE - 1)
+#define OFFSET_DADOS (FLASH_OFFSET_GRAVACAO + FLASH_SECTOR_SIZE)
+
+_Static_assert(FLASH_OFFSET_GRAVACAO % FLASH_SECTOR_SIZE == 0, "região da gravação fora do alinhamento de setor");
+
+// Gravado na primeira página da região somente quando a gravação termina
+typedef struct {
+    uint32_t magica;
+    uint32_t versao;
+    uint32_t codec;
+    uint32_t freq_amostragem;
+    uint32_t n_amostras;
+    uint32_t bytes_usados;
+    uint32_t verificacao; // Complemento da soma dos campos anteriores
+} cabecalho_flash_t;
+
+typedef enum {
+    FLASH_OCIOSA,
+    FLASH_PREPARANDO,  // Núcleo 1 apaga o cabeçalho e os primeiros setores
+    FLASH_GRAVANDO,
+    FLASH_FINALIZANDO, // Núcleo 1 grava o restante da fila e o cabeçalho
+    FLASH_CONCLUIDA,
+} estado_flash_t;
+
+extern char __flash_binary_end; // Definido pelo linker script do SDK
+
+static volatile estado_flash_t estado = FLASH_OCIOSA;
+
+// Fila de bytes codificados: escrita pelo núcleo 0, drenada pelo núcleo 1
+static uint8_t *fila_bytes = NULL;
+static uint32_t mascara_fila = 0;
+static volatile uint32_t bytes_enfileirados = 0;
+static volatile uint32_t bytes_drenados = 0;
+
+// Estado da codificação (núcleo 0)
+static codec_amostras_t codec_gravacao;
+static uint32_t freq_gravacao;
+static codec_estado_adpcm_t estado_adpcm;
+static uint32_t n_amostras_gravadas = 0;
+static uint8_t bloco_codificado[2 * CODEC_AMOSTRAS_POR_BLOCO];
+
+// Progresso da escrita (núcleo 1)
+static bool cabecalho_apagado = false;
+static uint32_t setores_apagados = 0;
+static uint32_t setores_programados = 0;
+static uint32_t inicio_gravacao_us = 0;
+static uint8_t pagina_auxiliar[FLASH_PAGE_SIZE];
+
+// Protocolo de estacionamento do núcleo 0
+static volatile bool pedido_pausa = false;
+static volatile bool nucleo0_estacionado = false;
+
+static estatisticas_flash_t estatisticas;
+
+// =================================================================================
+// Lado do núcleo 0
+// =================================================================================
+
+bool armazenamento_flash_inicializar(void) {
+    uintptr_t fim_programa = (uintptr_t)&__flash_binary_end - XIP_BASE;
+    return fim_programa <= FLASH_OFFSET_GRAVACAO;
+}
+
+size_t armazenamento_flash_capacidade_amostras(codec_amostras_t codec) {
+    return codec_capacidade_amostras(codec, (size_t)N_SETORES_DADOS * FLASH_SECTOR_SIZE);
+}
+
+void armazenamento_flash_iniciar_gravacao(codec_amostras_t codec, uint32_t freq_amostragem,
+                                          uint8_t *memoria_fila, size_t tamanho_fila) {
+    fila_bytes = memoria_fila;
+    mascara_fila = (uint32_t)tamanho_fila - 1;
+    bytes_enfileirados = 0;
+    bytes_drenados = 0;
+
+    codec_gravacao = codec;
+    freq_gravacao = freq_amostragem;
+    estado_adpcm.preditor = 0;
+    estado_adpcm.indice_passo = 0;
+    n_amostras_gravadas = 0;
+
+    cabecalho_apagado = false;
+    setores_apagados = 0;
+    setores_programados = 0;
+    memset(&estatisticas, 0, sizeof(estatisticas));
+
+    __dmb();
+    estado = FLASH_PREPARANDO;
+    __sev();
+}
+
+bool armazenamento_flash_pronto(void) {
+    return estado == FLASH_GRAVANDO;
+}
+
+bool armazenamento_flash_anexar_bloco(const uint16_t *amostras, size_t n_amostras) {
+    // Como na RAM, apenas o último bloco pode ser parcial
+    bool aceito = estado == FLASH_GRAVANDO && n_amostras > 0 && n_amostras <= CODEC_AMOSTRAS_POR_BLOCO &&
+                  n_amostras_gravadas % CODEC_AMOSTRAS_POR_BLOCO == 0;
+
+    size_t bytes = codec_bytes_por_bloco(codec_gravacao, n_amostras);
+    uint32_t ocupados = bytes_enfileirados - bytes_drenados;
+    if (!aceito ||
+        bytes_enfileirados + bytes > (uint32_t)N_SETORES_DADOS * FLASH_SECTOR_SIZE ||
+        ocupados + bytes > mascara_fila + 1) {
+        estatisticas.blocos_descartados++;
+        return false;
+    }
+
+    // Mesma semeadura do preditor feita por gravacao_anexar_bloco()
+    if (n_amostras_gravadas == 0) {
+        estado_adpcm.preditor = (int16_t)(((int32_t)amostras[0] - 2048) << 4);
+    }
+    codec_codificar_bloco(codec_gravacao, amostras, n_amostras, bloco_codificado, &estado_adpcm);
+
+    // Copia para a fila circular, dividindo a cópia na volta do anel
+    uint32_t posicao = bytes_enfileirados & mascara_fila;
+    size_t ate_o_fim = mascara_fila + 1 - posicao;
+    if (bytes <= ate_o_fim) {
+        memcpy(fila_bytes + posicao, bloco_codificado, bytes);
+    } else {
+        memcpy(fila_bytes + posicao, bloco_codificado, ate_o_fim);
+        memcpy(fila_bytes, bloco_codificado + ate_o_fim, bytes - ate_o_fim);
+    }
+
+    __dmb(); // Os bytes precisam estar visíveis antes do contador
+    bytes_enfileirados += bytes;
+    n_amostras_gravadas += n_amostras;
+    __sev();
+
+    if (ocupados + bytes > estatisticas.ocupacao_max_fila) {
+        estatisticas.ocupacao_max_fila = ocupados + bytes;
+    }
+    return true;
+}
+
+void armazenamento_flash_finalizar_gravacao(void) {
+    __dmb();
+    estado = FLASH_FINALIZANDO;
+    __sev();
+}
+
+bool armazenamento_flash_concluida(void) {
+    return estado == FLASH_CONCLUIDA;
+}
+
+// Executa da RAM enquanto o núcleo 1 opera a flash; o DMA_IRQ_0 continua sendo atendido
+static void __not_in_flash_func(estacionar_nucleo0)(void) {
+    nucleo0_estacionado = true;
+    __sev();
+    while (pedido_pausa) {
+        __wfe();
+    }
+    nucleo0_estacionado = false;
+    __sev();
+}
+
+void armazenamento_flash_servico_nucleo0(void) {
+    if (!pedido_pausa) return;
+
+    // O tratador dos botões está na flash e não pode rodar durante a operação
+    bool botoes_habilitados = irq_is_enabled(IO_IRQ_BANK0);
+    irq_set_enabled(IO_IRQ_BANK0, false);
+    estacionar_nucleo0();
+    irq_set_enabled(IO_IRQ_BANK0, botoes_habilitados);
+}
+
+bool armazenamento_flash_carregar(gravacao_codificada_t *gravacao) {
+    const cabecalho_flash_t *cabecalho = (const cabecalho_flash_t *)(XIP_BASE + FLASH_OFFSET_GRAVACAO);
+    uint32_t soma = cabecalho->magica + cabecalho->versao + cabecalho->codec +
+                    cabecalho->freq_amostragem + cabecalho->n_amostras + cabecalho->bytes_usados;
+
+    if (cabecalho->magica != MAGICA_CABECALHO || cabecalho->versao != VERSAO_CABECALHO ||
+        cabecalho->verificacao != ~soma || cabecalho->codec > CODEC_IMA_ADPCM ||
+        cabecalho->bytes_usados > (uint32_t)N_SETORES_DADOS * FLASH_SECTOR_SIZE) {
+        return false;
+    }
+
+    // Os dados são lidos direto pelo XIP; o codec decodifica no mesmo caminho da RAM
+    gravacao_iniciar(gravacao, (codec_amostras_t)cabecalho->codec, cabecalho->freq_amostragem,
+                     (uint8_t *)(XIP_BASE + OFFSET_DADOS), cabecalho->bytes_usados);
+    gravacao->bytes_usados = cabecalho->bytes_usados;
+    gravacao->n_amostras = cabecalho->n_amostras;
+    return true;
+}
+
+estatisticas_flash_t armazenamento_flash_estatisticas(void) {
+    return estatisticas;
+}
+
+// =================================================================================
+// Lado do núcleo 1
+// =================================================================================
+
+// Garante que o núcleo 0 esteja na RAM, executa a operação e o libera
+static void pausar_nucleo0(void) {
+    pedido_pausa = true;
+    __sev();
+    while (!nucleo0_estacionado) {
+        tight_loop_contents();
+    }
+}
+
+static void liberar_nucleo0(void) {
+    pedido_pausa = false;
+    __sev();
+    while (nucleo0_estacionado) {
+        tight_loop_contents();
+    }
+}
+
+static void apagar_setor(uint32_t offset) {
+    uint32_t inicio = time_us_32();
+    pausar_nucleo0();
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
+    restore_interrupts(interrupcoes);
+    liberar_nucleo0();
+
+    uint32_t duracao = time_us_32() - inicio;
+    estatisticas.tempo_flash_us += duracao;
+    if (duracao > estatisticas.maior_pausa_us) estatisticas.maior_pausa_us = duracao;
+    estatisticas.setores_apagados++;
+}
+
+static void programar(uint32_t offset, const uint8_t *dados, size_t n_bytes) {
+    uint32_t inicio = time_us_32();
+    pausar_nucleo0();
+    uint32_t interrupcoes = save_and_disable_interrupts();
+    flash_range_program(offset, dados, n_bytes);
+    restore_interrupts(interrupcoes);
+    liberar_nucleo0();
+
+    uint32_t duracao = time_us_32() - inicio;
+    estatisticas.tempo_flash_us += duracao;
+    if (duracao > estatisticas.maior_pausa_us) estatisticas.maior_pausa_us = duracao;
+    estatisticas.bytes_programados += n_bytes;
+}
+
+static bool apagar_proximo_setor_se_preciso(void) {
+    if (setores_apagados >= setores_programados + SETORES_ANTECIPADOS || setores_apagados >= N_SETORES_DADOS) {
+        return false;
+    }
+    apagar_setor(OFFSET_DADOS + setores_apagados * FLASH_SECTOR_SIZE);
+    setores_apagados++;
+    return true;
+}
+
+// Programa os bytes restantes (menos de um setor) completando a última página com 0xFF
+static void programar_setor_parcial(uint32_t n_bytes) {
+    const uint8_t *origem = fila_bytes + (bytes_drenados & mascara_fila);
+    uint32_t offset = OFFSET_DADOS + setores_programados * FLASH_SECTOR_SIZE;
+    uint32_t paginas_inteiras = n_bytes / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE;
+
+    if (paginas_inteiras > 0) {
+        programar(offset, origem, paginas_inteiras);
+    }
+    if (n_bytes > paginas_inteiras) {
+        memset(pagina_auxiliar, 0xFF, sizeof(pagina_auxiliar));
+        memcpy(pagina_auxiliar, origem + paginas_inteiras, n_bytes - paginas_inteiras);
+        programar(offset + paginas_inteiras, pagina_auxiliar, sizeof(pagina_auxiliar));
+    }
+    bytes_drenados += n_bytes;
+    setores_programados++;
+}
+
+static void programar_cabecalho(void) {
+    cabecalho_flash_t cabecalho = {
+        .magica = MAGICA_CABECALHO,
+        .versao = VERSAO_CABECALHO,
+        .codec = (uint32_t)codec_gravacao,
+        .freq_amostragem = freq_gravacao,
+        .n_amostras = n_amostras_gravadas,
+        .bytes_usados = bytes_enfileirados,
+    };
+    cabecalho.verificacao = ~(cabecalho.magica + cabecalho.versao + cabecalho.codec +
+                              cabecalho.freq_amostragem + cabecalho.n_amostras + cabecalho.bytes_usados);
+
+    memset(pagina_auxiliar, 0xFF, sizeof(pagina_auxiliar));
+    memcpy(pagina_auxiliar, &cabecalho, sizeof(cabecalho));
+    programar(FLASH_OFFSET_GRAVACAO, pagina_auxiliar, sizeof(pagina_auxiliar));
+}
+
+bool armazenamento_flash_tarefa(void) {
+    switch (estado) {
+        case FLASH_PREPARANDO:
+            // Invalida a gravação anterior antes de sobrescrever seus dados
+            if (!cabecalho_apagado) {
+                apagar_setor(FLASH_OFFSET_GRAVACAO);
+                cabecalho_apagado = true;
+                return true;
+            }
+            if (apagar_proximo_setor_se_preciso()) {
+                return true;
+            }
+            inicio_gravacao_us = time_us_32();
+            estatisticas.tempo_flash_us = 0;
+            estatisticas.maior_pausa_us = 0;
+            __dmb();
+            estado = FLASH_GRAVANDO;
+            __sev();
+            return true;
+
+        case FLASH_GRAVANDO:
+        case FLASH_FINALIZANDO: {
+            bool finalizando = (estado == FLASH_FINALIZANDO);
+            __dmb();
+            uint32_t disponiveis = bytes_enfileirados - bytes_drenados;
+
+            // Prioriza programar: a fila em RAM é o recurso escasso
+            if (disponiveis >= FLASH_SECTOR_SIZE && setores_programados < setores_apagados) {
+                programar(OFFSET_DADOS + setores_programados * FLASH_SECTOR_SIZE,
+                          fila_bytes + (bytes_drenados & mascara_fila), FLASH_SECTOR_SIZE);
+                bytes_drenados += FLASH_SECTOR_SIZE;
+                setores_programados++;
+                return true;
+            }
+            if (apagar_proximo_setor_se_preciso()) {
+                return true;
+            }
+            if (!finalizando) {
+                return false;
+            }
+
+            if (disponiveis > 0) {
+                programar_setor_parcial(disponiveis);
+            }
+            programar_cabecalho();
+            estatisticas.tempo_gravacao_us = time_us_32() - inicio_gravacao_us;
+            __dmb();
+            estado = FLASH_CONCLUIDA;
+            __sev();
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file armazenamento_flash.h
+ * @brief Gravação longa na flash QSPI com apagamento antecipado de setores.
+ *
+ * O núcleo 0 codifica os blocos capturados numa fila de bytes em RAM; o
+ * núcleo 1 drena essa fila para a flash, um setor de 4 KB por vez, mantendo
+ * setores já apagados à frente do ponteiro de escrita. Durante cada operação
+ * de apagar/programar o XIP fica indisponível, então o núcleo 1 pede ao núcleo 0
+ * que estacione numa rotina em RAM; a captura continua pelo DMA, cujo
+ * tratador de interrupção também roda da RAM.
+ *
+ * Um cabeçalho no primeiro setor da região descreve a gravação, que assim
+ * sobrevive a um ciclo de energia; a reprodução lê os blocos direto pelo XIP.
+ */
+#ifndef ARMAZENAMENTO_FLASH_H
+#define ARMAZENAMENTO_FLASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec_amostras.h"
+
+// Região da flash reservada às gravações (a partir de 512 KB até o fim do chip)
+#define FLASH_OFFSET_GRAVACAO (512u * 1024u)
+
+// Estatísticas de escrita para avaliar a folga a 48 kHz
+typedef struct {
+    uint32_t bytes_programados;
+    uint32_t setores_apagados;
+    uint32_t tempo_gravacao_us;     // Do início da captura ao último setor programado
+    uint32_t tempo_flash_us;        // Tempo total com o XIP desligado
+    uint32_t maior_pausa_us;        // Pior estacionamento do núcleo 0
+    uint32_t ocupacao_max_fila;     // Pico da fila de bytes entre os núcleos
+    uint32_t blocos_descartados;    // Blocos perdidos por fila ou região cheia
+} estatisticas_flash_t;
+
+// Verifica se a região não se sobrepõe ao programa. Deve ser chamada no núcleo 0.
+bool armazenamento_flash_inicializar(void);
+
+// Capacidade da região em amostras para o codec indicado
+size_t armazenamento_flash_capacidade_amostras(codec_amostras_t codec);
+
+// --- Lado do núcleo 0 (captura) ---
+
+// Prepara uma nova gravação usando `memoria_fila` como fila de bytes entre os núcleos
+// (potência de 2, múltiplo de FLASH_SECTOR_SIZE) e invalida a gravação anterior.
+void armazenamento_flash_iniciar_gravacao(codec_amostras_t codec, uint32_t freq_amostragem,
+                                          uint8_t *memoria_fila, size_t tamanho_fila);
+
+// true quando os primeiros setores já foram apagados e a captura pode começar
+bool armazenamento_flash_pronto(void);
+
+// Codifica e enfileira um bloco; retorna false se ele precisou ser descartado
+bool armazenamento_flash_anexar_bloco(const uint16_t *amostras, size_t n_amostras);
+
+// Encerra a gravação: o núcleo 1 grava o restante da fila e o cabeçalho
+void armazenamento_flash_finalizar_gravacao(void);
+
+// true quando a gravação finalizada já está inteira na flash
+bool armazenamento_flash_concluida(void);
+
+// Estaciona o núcleo 0 na RAM se o núcleo 1 pediu acesso exclusivo à flash.
+// Deve ser chamada com frequência em todo laço do núcleo 0 enquanto houver gravação ativa.
+void armazenamento_flash_servico_nucleo0(void);
+
+// Preenche `gravacao` para leitura via XIP se houver uma gravação válida na flash
+bool armazenamento_flash_carregar(gravacao_codificada_t *gravacao);
+
+estatisticas_flash_t armazenamento_flash_estatisticas(void);
+
+// --- Lado do núcleo 1 (escrita) ---
+
+// Executa no máximo uma operação de flash; retorna true se ainda houver trabalho pendente
+bool armazenamento_flash_tarefa(void);
+
+#endif
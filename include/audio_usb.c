@@ -0,0 +1,250 @@
+/**
+ * @file audio_usb.c
+ * @brief Callbacks UAC2 do TinyUSB (núcleo 1) e filas de amostras com o núcleo 0 (ver audio_usb.h).
+ */
+#include <string.h>
+#include "tusb.h"
+#include "hardware/sync.h"
+#include "dsp_audio.h"
+#include "efeitos_audio.h"
+#include "fila_spsc.h"
+#include "usb_descritores.h"
+#include "audio_usb.h"
+
+#define AMOSTRAS_POR_QUADRO (AUDIO_USB_TAXA / 1000)
+#define REALIMENTACAO_NOMINAL ((uint32_t)AMOSTRAS_POR_QUADRO << 16)
+#define REALIMENTACAO_MAX_DESVIO (1 << 15)  // +-0,5 amostra por quadro
+#define TOLERANCIA_MICROFONE 64             // Amostras de folga em torno do alvo antes de mudar o pacote
+#define SUAVIZACAO_NIVEL 5                  // Média exponencial do nível sobre ~32 quadros
+
+_Static_assert(AUDIO_USB_TAXA == AUDIO_USB_FREQ_AMOSTRAGEM, "taxa difere da anunciada nos descritores");
+_Static_assert(AUDIO_USB_ALVO_MICROFONE + TOLERANCIA_MICROFONE + AUDIO_USB_MAX_BLOCO < AUDIO_USB_CAPACIDADE_FILA,
+               "fila do microfone pequena para o alvo");
+_Static_assert(AUDIO_USB_ALVO_ALTO_FALANTE + AUDIO_USB_MAX_BLOCO < AUDIO_USB_CAPACIDADE_FILA,
+               "fila do alto-falante pequena para o alvo");
+
+// Microfone: núcleo 0 produz, núcleo 1 consome. Alto-falante: o contrário.
+static int16_t armazenamento_microfone[AUDIO_USB_CAPACIDADE_FILA];
+static int16_t armazenamento_alto_falante[AUDIO_USB_CAPACIDADE_FILA];
+static fila_spsc_t fila_microfone;
+static fila_spsc_t fila_alto_falante;
+
+// Escritos no núcleo 1, lidos no núcleo 0
+static volatile bool microfone_ativo = false;
+static volatile bool alto_falante_ativo = false;
+
+// Estado de cada lado (cada campo tem um único escritor)
+static bool microfone_preenchido = false;   // Núcleo 1
+static int32_t nivel_medio_microfone_q8 = 0; // Núcleo 1
+static int32_t nivel_medio_alto_falante_q8 = 0; // Núcleo 1
+static bool alto_falante_preenchido = false; // Núcleo 0
+static estatisticas_audio_usb_t estatisticas;
+
+void audio_usb_iniciar(void) {
+    fila_spsc_iniciar(&fila_microfone, armazenamento_microfone, sizeof(int16_t), AUDIO_USB_CAPACIDADE_FILA);
+    fila_spsc_iniciar(&fila_alto_falante, armazenamento_alto_falante, sizeof(int16_t), AUDIO_USB_CAPACIDADE_FILA);
+    estatisticas.realimentacao_16_16 = REALIMENTACAO_NOMINAL;
+    tusb_init();
+}
+
+// =================================================================================
+// Núcleo 1: callbacks do TinyUSB (contexto do tud_task)
+// =================================================================================
+
+static void suavizar_nivel(int32_t *media_q8, uint32_t nivel) {
+    *media_q8 += ((int32_t)(nivel << 8) - *media_q8) >> SUAVIZACAO_NIVEL;
+}
+
+static void abrir_stream(uint8_t interface, bool aberto) {
+    if (interface == ITF_NUM_AUDIO_MICROFONE) {
+        if (aberto) {
+            // O consumidor pode esvaziar a fila: o host recebe só áudio novo
+            int16_t descarte[64];
+            while (fila_spsc_remover_varios(&fila_microfone, descarte, 64) > 0) {
+            }
+            microfone_preenchido = false;
+        }
+        microfone_ativo = aberto;
+    } else if (interface == ITF_NUM_AUDIO_ALTO_FALANTE) {
+        if (aberto) {
+            nivel_medio_alto_falante_q8 = (int32_t)fila_spsc_ocupacao(&fila_alto_falante) << 8;
+            estatisticas.realimentacao_16_16 = REALIMENTACAO_NOMINAL;
+            tud_audio_fb_set(REALIMENTACAO_NOMINAL);
+        }
+        alto_falante_ativo = aberto;
+    }
+    __sev(); // O núcleo 0 espera o host em __wfe
+}
+
+bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const *requisicao) {
+    (void)rhport;
+    abrir_stream(tu_u16_low(requisicao->wIndex), tu_u16_low(requisicao->wValue) != 0);
+    return true;
+}
+
+bool tud_audio_set_itf_close_EP_cb(uint8_t rhport, tusb_control_request_t const *requisicao) {
+    (void)rhport;
+    abrir_stream(tu_u16_low(requisicao->wIndex), false);
+    return true;
+}
+
+// O único controle é o clock fixo: frequência atual, faixa (um único valor) e validade
+bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const *requisicao) {
+    uint8_t seletor = tu_u16_high(requisicao->wValue);
+    uint8_t entidade = tu_u16_high(requisicao->wIndex);
+    if (entidade != UAC2_ENTIDADE_CLOCK) return false;
+
+    if (seletor == AUDIO_CS_CTRL_SAM_FREQ && requisicao->bRequest == AUDIO_CS_REQ_CUR) {
+        audio_control_cur_4_t frequencia = { .bCur = (int32_t)tu_htole32(AUDIO_USB_TAXA) };
+        return tud_audio_buffer_and_schedule_control_xfer(rhport, requisicao, &frequencia, sizeof(frequencia));
+    }
+    if (seletor == AUDIO_CS_CTRL_SAM_FREQ && requisicao->bRequest == AUDIO_CS_REQ_RANGE) {
+        audio_control_range_4_n_t(1) faixa = {
+            .wNumSubRanges = tu_htole16(1),
+            .subrange[0] = { .bMin = (int32_t)AUDIO_USB_TAXA, .bMax = (int32_t)AUDIO_USB_TAXA, .bRes = 0 },
+        };
+        return tud_audio_buffer_and_schedule_control_xfer(rhport, requisicao, &faixa, sizeof(faixa));
+    }
+    if (seletor == AUDIO_CS_CTRL_CLK_VALID && requisicao->bRequest == AUDIO_CS_REQ_CUR) {
+        audio_control_cur_1_t valido = { .bCur = 1 };
+        return tud_audio_buffer_and_schedule_control_xfer(rhport, requisicao, &valido, sizeof(valido));
+    }
+    return false; // STALL
+}
+
+bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const *requisicao, uint8_t *dados) {
+    (void)rhport;
+    (void)requisicao;
+    (void)dados;
+    return false; // Nada é configurável: o clock é fixo
+}
+
+// Antes de cada quadro do microfone: 48 amostras, ou 47/49 para puxar o nível médio ao alvo
+bool tud_audio_tx_done_pre_load_cb(uint8_t rhport, uint8_t funcao, uint8_t ep_entrada, uint8_t alternativa) {
+    (void)rhport;
+    (void)funcao;
+    (void)ep_entrada;
+    (void)alternativa;
+    static int16_t pacote[AMOSTRAS_POR_QUADRO + 1];
+
+    uint32_t nivel = fila_spsc_ocupacao(&fila_microfone);
+    if (!microfone_preenchido && nivel >= AUDIO_USB_ALVO_MICROFONE) {
+        microfone_preenchido = true;
+        nivel_medio_microfone_q8 = (int32_t)nivel << 8;
+    }
+    suavizar_nivel(&nivel_medio_microfone_q8, nivel);
+
+    size_t n = AMOSTRAS_POR_QUADRO;
+    int32_t nivel_medio = nivel_medio_microfone_q8 >> 8;
+    if (nivel_medio > AUDIO_USB_ALVO_MICROFONE + TOLERANCIA_MICROFONE) n++;
+    if (nivel_medio < AUDIO_USB_ALVO_MICROFONE - TOLERANCIA_MICROFONE) n--;
+
+    if (microfone_preenchido && nivel < n) {
+        microfone_preenchido = false;
+        estatisticas.faltas_microfone++;
+    }
+    if (microfone_preenchido) {
+        fila_spsc_remover_varios(&fila_microfone, pacote, n);
+    } else {
+        n = AMOSTRAS_POR_QUADRO;
+        memset(pacote, 0, n * sizeof(int16_t));
+    }
+
+    tud_audio_write(pacote, (uint16_t)(n * sizeof(int16_t)));
+    return true;
+}
+
+// Realimentação = taxa nominal corrigida pelo erro do nível médio (1/256 amostra por quadro a cada amostra).
+// Fica em 16.16; a conversão para 10.14 em full speed é do TinyUSB (tusb_config.h).
+static void atualizar_realimentacao(void) {
+    suavizar_nivel(&nivel_medio_alto_falante_q8, fila_spsc_ocupacao(&fila_alto_falante));
+
+    int32_t desvio = ((int32_t)AUDIO_USB_ALVO_ALTO_FALANTE << 8) - nivel_medio_alto_falante_q8;
+    if (desvio > REALIMENTACAO_MAX_DESVIO) desvio = REALIMENTACAO_MAX_DESVIO;
+    if (desvio < -REALIMENTACAO_MAX_DESVIO) desvio = -REALIMENTACAO_MAX_DESVIO;
+
+    uint32_t realimentacao = (uint32_t)((int32_t)REALIMENTACAO_NOMINAL + desvio);
+    estatisticas.realimentacao_16_16 = realimentacao;
+    tud_audio_fb_set(realimentacao);
+}
+
+bool tud_audio_rx_done_post_read_cb(uint8_t rhport, uint16_t n_bytes_recebidos, uint8_t funcao,
+                                    uint8_t ep_saida, uint8_t alternativa) {
+    (void)rhport;
+    (void)n_bytes_recebidos;
+    (void)funcao;
+    (void)ep_saida;
+    (void)alternativa;
+    static int16_t pacote[CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX / sizeof(int16_t)];
+
+    uint16_t n_bytes;
+    while ((n_bytes = tud_audio_read(pacote, sizeof(pacote))) > 0) {
+        size_t n = n_bytes / sizeof(int16_t);
+        size_t inseridas = fila_spsc_inserir_varios(&fila_alto_falante, pacote, n);
+        estatisticas.amostras_descartadas_alto_falante += (uint32_t)(n - inseridas);
+    }
+    atualizar_realimentacao();
+    return true;
+}
+
+// =================================================================================
+// Núcleo 0
+// =================================================================================
+
+bool audio_usb_microfone_ativo(void) {
+    return microfone_ativo;
+}
+
+bool audio_usb_alto_falante_ativo(void) {
+    return alto_falante_ativo;
+}
+
+void audio_usb_enviar_microfone(const uint16_t *amostras, size_t n_amostras) {
+    if (!microfone_ativo) return;
+
+    static int16_t bloco[AUDIO_USB_MAX_BLOCO];
+    while (n_amostras > 0) {
+        size_t n = (n_amostras < AUDIO_USB_MAX_BLOCO) ? n_amostras : AUDIO_USB_MAX_BLOCO;
+        efeitos_para_q15(amostras, bloco, n);
+        size_t inseridas = fila_spsc_inserir_varios(&fila_microfone, bloco, n);
+        estatisticas.amostras_descartadas_microfone += (uint32_t)(n - inseridas);
+        amostras += n;
+        n_amostras -= n;
+    }
+}
+
+void audio_usb_reiniciar_alto_falante(void) {
+    int16_t descarte[64];
+    while (fila_spsc_remover_varios(&fila_alto_falante, descarte, 64) > 0) {
+    }
+    alto_falante_preenchido = false;
+}
+
+bool audio_usb_receber_alto_falante(uint16_t *amostras, size_t n_amostras) {
+    static int16_t bloco[AUDIO_USB_MAX_BLOCO];
+    if (n_amostras > AUDIO_USB_MAX_BLOCO) n_amostras = AUDIO_USB_MAX_BLOCO;
+
+    uint32_t nivel = alto_falante_ativo ? fila_spsc_ocupacao(&fila_alto_falante) : 0;
+    if (!alto_falante_preenchido && nivel >= AUDIO_USB_ALVO_ALTO_FALANTE) {
+        alto_falante_preenchido = true;
+    }
+    if (alto_falante_preenchido && nivel < n_amostras) {
+        alto_falante_preenchido = false;
+        estatisticas.faltas_alto_falante++;
+    }
+
+    if (!alto_falante_preenchido) {
+        for (size_t i = 0; i < n_amostras; i++) {
+            amostras[i] = DSP_AMOSTRA_ZERO;
+        }
+        return false;
+    }
+
+    fila_spsc_remover_varios(&fila_alto_falante, bloco, n_amostras);
+    efeitos_para_12_bits(bloco, amostras, n_amostras);
+    return true;
+}
+
+estatisticas_audio_usb_t audio_usb_estatisticas(void) {
+    return estatisticas;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file audio_usb.h
+ * @brief Áudio USB (UAC2): a captura vai ao host como microfone, e o host toca no buzzer.
+ *
+ * O TinyUSB roda no núcleo 1 (o laço dele chama o tud_task(), ver console_usb.h); o áudio
+ * é produzido e consumido no núcleo 0. Cada sentido cruza os núcleos por uma
+ * fila SPSC de amostras de 16 bits, que é também o buffer de jitter:
+ *
+ * - Microfone: o endpoint é assíncrono e o relógio é o do ADC. Cada quadro de
+ *   1 ms leva 48 amostras, ou 47/49 quando o nível médio da fila se afasta do
+ *   alvo, o que informa ao host a taxa real da placa. Latência ~ alvo + um
+ *   bloco de captura (5,3 ms) + 1 ms.
+ * - Alto-falante: assíncrono com endpoint de realimentação. O valor enviado
+ *   (amostras por quadro, 16.16) é o nominal corrigido pelo erro do nível
+ *   médio da fila em relação ao alvo, então o host acompanha o relógio do PWM.
+ *   Latência ~ alvo + a fila do PWM (N_BLOCOS_FILA_REPRODUCAO blocos).
+ *
+ * Amostras que não cabem na fila são descartadas e contadas; a fila nunca
+ * cresce além de AUDIO_USB_CAPACIDADE_FILA, o que limita a latência.
+ */
+#ifndef AUDIO_USB_H
+#define AUDIO_USB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AUDIO_USB_TAXA 48000
+#define AUDIO_USB_CAPACIDADE_FILA 1024      // Amostras por sentido (21 ms)
+#define AUDIO_USB_ALVO_MICROFONE 384        // Nível da fila a partir do qual o microfone envia áudio
+#define AUDIO_USB_ALVO_ALTO_FALANTE 512     // Nível que a realimentação procura manter (10,7 ms)
+
+#define AUDIO_USB_MAX_BLOCO 256 // Amostras por chamada do lado do núcleo 0
+
+// Uma "falta" é a fila esvaziando: o sentido volta ao silêncio até a fila atingir o alvo de novo
+typedef struct {
+    uint32_t amostras_descartadas_microfone;    // Fila cheia no núcleo 0 (host não está lendo)
+    uint32_t faltas_microfone;
+    uint32_t amostras_descartadas_alto_falante; // Fila cheia no núcleo 1 (host adiantado)
+    uint32_t faltas_alto_falante;
+    uint32_t realimentacao_16_16;               // Último valor enviado ao host (amostras por quadro)
+} estatisticas_audio_usb_t;
+
+// --- Núcleo 1 ---
+
+// Inicializa o TinyUSB; deve preceder console_usb_iniciar()
+void audio_usb_iniciar(void);
+
+// --- Núcleo 0 ---
+
+// true enquanto o host mantiver o stream correspondente aberto
+bool audio_usb_microfone_ativo(void);
+bool audio_usb_alto_falante_ativo(void);
+
+// Envia amostras de 12 bits ao host (sem efeito com o microfone fechado)
+void audio_usb_enviar_microfone(const uint16_t *amostras, size_t n_amostras);
+
+// Descarta o que restou de um stream anterior do host; chamar ao ligar a saída
+void audio_usb_reiniciar_alto_falante(void);
+
+// Preenche n_amostras (<= AUDIO_USB_MAX_BLOCO) de 12 bits com o áudio do host; devolve
+// false (e silêncio) enquanto a fila ainda não atingiu o alvo ou se esvaziou
+bool audio_usb_receber_alto_falante(uint16_t *amostras, size_t n_amostras);
+
+estatisticas_audio_usb_t audio_usb_estatisticas(void);
+
+#endif
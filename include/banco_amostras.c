@@ -0,0 +1,156 @@
+/**
+ * @file banco_amostras.c
+ * @brief Arena de takes com compactação na remoção (ver banco_amostras.h).
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "banco_amostras.h"
+
+static uint8_t *memoria_arena;
+static size_t capacidade_arena;
+static size_t ocupado; // Bytes do início da arena tomados pelos takes fechados
+
+// Em ordem de alocação; o take aberto fica na entrada n_takes até fechar
+static take_banco_t takes[N_TAKES_BANCO];
+static size_t n_takes = 0;
+static bool take_aberto = false;
+static int selecionado = -1;
+static uint16_t proximo_numero = 1;
+static estatisticas_banco_t estatisticas;
+
+static size_t alinhar(size_t bytes) {
+    return (bytes + BANCO_ALINHAMENTO - 1) & ~(size_t)(BANCO_ALINHAMENTO - 1);
+}
+
+void banco_iniciar(uint8_t *memoria, size_t capacidade_bytes) {
+    memoria_arena = memoria;
+    capacidade_arena = capacidade_bytes & ~(size_t)(BANCO_ALINHAMENTO - 1);
+    ocupado = 0;
+    n_takes = 0;
+    take_aberto = false;
+    selecionado = -1;
+    estatisticas = (estatisticas_banco_t){ 0 };
+}
+
+size_t banco_capacidade_bytes(void) {
+    return capacidade_arena;
+}
+
+size_t banco_livre_bytes(void) {
+    return capacidade_arena - ocupado;
+}
+
+bool banco_reservar(size_t bytes) {
+    if (take_aberto || alinhar(bytes) > capacidade_arena) return false;
+
+    while (banco_livre_bytes() < alinhar(bytes) || n_takes == N_TAKES_BANCO) {
+        // O mais antigo da arena; os externos não ocupam espaço nela e ficam
+        size_t vitima = 0;
+        while (vitima < n_takes && takes[vitima].externo) vitima++;
+        if (vitima == n_takes) return false;
+        banco_remover(vitima);
+    }
+    return true;
+}
+
+gravacao_codificada_t *banco_abrir_take(codec_amostras_t codec, uint32_t freq_amostragem) {
+    if (take_aberto || n_takes == N_TAKES_BANCO) return NULL;
+
+    take_banco_t *take = &takes[n_takes];
+    gravacao_iniciar(&take->gravacao, codec, freq_amostragem, memoria_arena + ocupado, banco_livre_bytes());
+    take->resumo.n_colunas = 0;
+    take->externo = false;
+    take->numero = proximo_numero;
+    take_aberto = true;
+    return &take->gravacao;
+}
+
+int banco_fechar_take(void) {
+    if (!take_aberto) return -1;
+    take_aberto = false;
+
+    take_banco_t *take = &takes[n_takes];
+    if (take->gravacao.n_amostras == 0) return -1;
+
+    take->gravacao.capacidade_bytes = alinhar(take->gravacao.bytes_usados);
+    ocupado += take->gravacao.capacidade_bytes;
+    proximo_numero++;
+    selecionado = (int)n_takes;
+    return (int)n_takes++;
+}
+
+void banco_descartar_take_aberto(void) {
+    take_aberto = false;
+}
+
+int banco_adicionar_externo(const gravacao_codificada_t *gravacao) {
+    if (take_aberto || n_takes == N_TAKES_BANCO) return -1;
+
+    take_banco_t *take = &takes[n_takes];
+    take->gravacao = *gravacao;
+    take->gravacao.capacidade_bytes = 0;
+    take->resumo.n_colunas = 0;
+    take->externo = true;
+    take->numero = proximo_numero++;
+    selecionado = (int)n_takes;
+    return (int)n_takes++;
+}
+
+bool banco_remover(size_t indice) {
+    if (take_aberto || indice >= n_takes) return false;
+
+    take_banco_t *removido = &takes[indice];
+    size_t tamanho = removido->gravacao.capacidade_bytes;
+    if (!removido->externo && tamanho > 0) {
+        // Tudo o que vem depois na arena desce `tamanho` bytes de uma vez
+        uint32_t inicio_us = time_us_32();
+        uint8_t *destino = removido->gravacao.dados;
+        size_t deslocados = ocupado - (size_t)(destino + tamanho - memoria_arena);
+        memmove(destino, destino + tamanho, deslocados);
+        ocupado -= tamanho;
+
+        for (size_t i = indice + 1; i < n_takes; i++) {
+            if (!takes[i].externo) takes[i].gravacao.dados -= tamanho;
+        }
+
+        estatisticas.compactacoes++;
+        estatisticas.ultima_compactacao_bytes = (uint32_t)deslocados;
+        estatisticas.ultima_compactacao_us = time_us_32() - inicio_us;
+    }
+
+    memmove(&takes[indice], &takes[indice + 1], (n_takes - indice - 1) * sizeof(take_banco_t));
+    n_takes--;
+
+    if (selecionado > (int)indice || selecionado == (int)n_takes) selecionado--;
+    return true;
+}
+
+void banco_remover_externos(void) {
+    for (size_t i = n_takes; i-- > 0;) {
+        if (takes[i].externo) banco_remover(i);
+    }
+}
+
+size_t banco_n_takes(void) {
+    return n_takes;
+}
+
+take_banco_t *banco_take(size_t indice) {
+    return (indice < n_takes) ? &takes[indice] : NULL;
+}
+
+int banco_selecionado(void) {
+    return selecionado;
+}
+
+void banco_selecionar(size_t indice) {
+    if (indice < n_takes) selecionado = (int)indice;
+}
+
+uint8_t *banco_area_livre(void) {
+    return memoria_arena + ocupado;
+}
+
+estatisticas_banco_t banco_estatisticas(void) {
+    return estatisticas;
+}
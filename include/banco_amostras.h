@@ -0,0 +1,89 @@
+/**
+ * @file banco_amostras.h
+ * @brief Banco de takes: várias gravações residentes numa arena sobre a memória de áudio.
+ *
+ * Os takes da arena ficam contíguos a partir do início, na ordem em que
+ * foram alocados, e o espaço livre é sempre um trecho só, no fim. Alocar é
+ * avançar o fim (não há fragmentação) e remover um take desloca os seguintes
+ * de uma vez com memmove, corrigindo os ponteiros deles. Um take aberto (em
+ * gravação ou importação) recebe todo o espaço livre e é encolhido ao
+ * tamanho usado quando fecha.
+ *
+ * Os metadados (taxa, codec e comprimento, no gravacao_codificada_t, e o
+ * resumo do índice de picos) ficam numa tabela fixa de N_TAKES_BANCO
+ * entradas: nada vai para o heap e a reprodução lê o take onde ele está.
+ * Takes externos (a gravação da flash, lida por XIP) entram na tabela sem
+ * ocupar a arena.
+ *
+ * Tudo roda no núcleo 0 com o áudio parado. Um ponteiro para um take (ou
+ * para os dados dele) só vale até a próxima remoção.
+ */
+#ifndef BANCO_AMOSTRAS_H
+#define BANCO_AMOSTRAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec_amostras.h"
+#include "interface_usuario.h"
+
+#define N_TAKES_BANCO 8
+#define BANCO_ALINHAMENTO 4 // Bytes; o início de cada take na arena
+
+typedef struct {
+    gravacao_codificada_t gravacao; // capacidade_bytes = espaço ocupado na arena (0 se externo)
+    resumo_onda_t resumo;           // Envelope do display, tirado do índice de picos
+    bool externo;                   // Dados fora da arena (flash)
+    uint16_t numero;                // Crescente a cada take, para os logs
+} take_banco_t;
+
+typedef struct {
+    uint32_t compactacoes;
+    uint32_t ultima_compactacao_bytes; // Deslocados pelo memmove
+    uint32_t ultima_compactacao_us;
+} estatisticas_banco_t;
+
+// A arena ocupa `memoria` inteira; o banco começa vazio
+void banco_iniciar(uint8_t *memoria, size_t capacidade_bytes);
+
+size_t banco_capacidade_bytes(void);
+size_t banco_livre_bytes(void);
+
+// Remove takes da arena, do mais antigo, até haver `bytes` livres e uma entrada na tabela.
+// Retorna false se nem com a arena vazia houver espaço (nada é removido nesse caso).
+bool banco_reservar(size_t bytes);
+
+// Abre um take com todo o espaço livre; NULL se a tabela estiver cheia ou já houver um aberto
+gravacao_codificada_t *banco_abrir_take(codec_amostras_t codec, uint32_t freq_amostragem);
+
+// Encolhe o take aberto ao tamanho usado e o seleciona; retorna o índice dele, ou -1 se
+// ficou vazio (é descartado)
+int banco_fechar_take(void);
+
+// Abandona o take aberto (importação cancelada)
+void banco_descartar_take_aberto(void);
+
+// Registra uma gravação fora da arena e a seleciona; retorna o índice, ou -1 com a tabela cheia
+// ou um take aberto
+int banco_adicionar_externo(const gravacao_codificada_t *gravacao);
+
+// Remove o take e compacta a arena ao redor dele; false com um take aberto
+bool banco_remover(size_t indice);
+
+// Remove os takes externos (a região da flash vai ser regravada)
+void banco_remover_externos(void);
+
+size_t banco_n_takes(void);
+take_banco_t *banco_take(size_t indice);
+
+// Take escolhido para reprodução e exportação; -1 com o banco vazio
+int banco_selecionado(void);
+void banco_selecionar(size_t indice);
+
+// Início do espaço livre, para uso temporário (a fila da gravação na flash); vale até a
+// próxima alocação e não conta como take
+uint8_t *banco_area_livre(void);
+
+estatisticas_banco_t banco_estatisticas(void);
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file cadeia_efeitos.c
+ * @brief Etapas ligadas em cadeia_efeitos.h e a medição de ciclos de cada uma.
+ */
+#include "contador_ciclos.h"
+#include "efeitos_audio.h"
+#include "cadeia_efeitos.h"
+
+// As macros precisam ficar visíveis ao pré-processador; os índices vêm dos enums
+#define N_ETAPAS_GRAVACAO (EFEITO_GRAVACAO_PASSA_ALTA + EFEITO_GRAVACAO_PRESENCA)
+#define N_ETAPAS_REPRODUCAO (EFEITO_REPRODUCAO_PASSA_BAIXA + EFEITO_REPRODUCAO_ECO + EFEITO_REPRODUCAO_SATURACAO)
+
+enum {
+#if EFEITO_GRAVACAO_PASSA_ALTA
+    ETAPA_GRAVACAO_PASSA_ALTA,
+#endif
+#if EFEITO_GRAVACAO_PRESENCA
+    ETAPA_GRAVACAO_PRESENCA,
+#endif
+    FIM_ETAPAS_GRAVACAO
+};
+
+enum {
+#if EFEITO_REPRODUCAO_PASSA_BAIXA
+    ETAPA_REPRODUCAO_PASSA_BAIXA,
+#endif
+#if EFEITO_REPRODUCAO_ECO
+    ETAPA_REPRODUCAO_ECO,
+#endif
+#if EFEITO_REPRODUCAO_SATURACAO
+    ETAPA_REPRODUCAO_SATURACAO,
+#endif
+    FIM_ETAPAS_REPRODUCAO
+};
+
+_Static_assert(FIM_ETAPAS_GRAVACAO == N_ETAPAS_GRAVACAO, "N_ETAPAS_GRAVACAO desatualizado");
+_Static_assert(FIM_ETAPAS_REPRODUCAO == N_ETAPAS_REPRODUCAO, "N_ETAPAS_REPRODUCAO desatualizado");
+
+// Executa a chamada e soma os ciclos gastos nas estatísticas da etapa
+#define EXECUTAR_ETAPA(estatisticas, chamada)               \
+    do {                                                     \
+        uint32_t inicio_etapa = contador_ciclos_ler();       \
+        chamada;                                             \
+        registrar_ciclos(&(estatisticas), contador_ciclos_desde(inicio_etapa)); \
+    } while (0)
+
+#if N_ETAPAS_GRAVACAO > 0 || N_ETAPAS_REPRODUCAO > 0
+// As duas cadeias rodam no mesmo núcleo e nunca ao mesmo tempo
+static int16_t bloco_q15[CADEIA_MAX_BLOCO];
+#endif
+
+#if EFEITO_GRAVACAO_PASSA_ALTA
+static biquad_t passa_alta_gravacao;
+#endif
+#if EFEITO_GRAVACAO_PRESENCA
+static biquad_t presenca_gravacao;
+#endif
+#if EFEITO_REPRODUCAO_PASSA_BAIXA
+static biquad_t passa_baixa_reproducao;
+#endif
+#if EFEITO_REPRODUCAO_ECO
+static eco_t eco_reproducao;
+static int16_t linha_eco[ATRASO_ECO_MS * 48]; // Dimensionada para até 48 kHz
+#endif
+#if EFEITO_REPRODUCAO_SATURACAO
+static saturacao_t saturacao_reproducao;
+#endif
+
+static estatisticas_etapa_t etapas_gravacao[N_ETAPAS_GRAVACAO + 1];     // +1: vetor nunca vazio
+static estatisticas_etapa_t etapas_reproducao[N_ETAPAS_REPRODUCAO + 1];
+
+static inline void registrar_ciclos(estatisticas_etapa_t *etapa, uint32_t ciclos) {
+    etapa->n_blocos++;
+    etapa->ciclos_total += ciclos;
+    if (ciclos > etapa->ciclos_max) etapa->ciclos_max = ciclos;
+}
+
+static void zerar_estatisticas(estatisticas_etapa_t *etapa, const char *nome) {
+    *etapa = (estatisticas_etapa_t){ .nome = nome };
+}
+
+// =================================================================================
+// Gravação
+// =================================================================================
+
+void cadeia_gravacao_iniciar(uint32_t freq_amostragem) {
+#if EFEITO_GRAVACAO_PASSA_ALTA
+    biquad_configurar(&passa_alta_gravacao, BIQUAD_PASSA_ALTA, FREQ_PASSA_ALTA_GRAVACAO_HZ, 0.707f, 0.0f, freq_amostragem);
+    zerar_estatisticas(&etapas_gravacao[ETAPA_GRAVACAO_PASSA_ALTA], "passa-alta");
+#endif
+#if EFEITO_GRAVACAO_PRESENCA
+    biquad_configurar(&presenca_gravacao, BIQUAD_PICO, FREQ_PRESENCA_GRAVACAO_HZ, 1.0f, GANHO_PRESENCA_GRAVACAO_DB, freq_amostragem);
+    zerar_estatisticas(&etapas_gravacao[ETAPA_GRAVACAO_PRESENCA], "presenca");
+#endif
+    (void)freq_amostragem;
+    contador_ciclos_iniciar();
+}
+
+void cadeia_gravacao_processar(uint16_t *amostras, size_t n_amostras) {
+#if N_ETAPAS_GRAVACAO > 0
+    while (n_amostras > 0) {
+        size_t n = (n_amostras < CADEIA_MAX_BLOCO) ? n_amostras : CADEIA_MAX_BLOCO;
+        efeitos_para_q15(amostras, bloco_q15, n);
+#if EFEITO_GRAVACAO_PASSA_ALTA
+        EXECUTAR_ETAPA(etapas_gravacao[ETAPA_GRAVACAO_PASSA_ALTA], biquad_processar(&passa_alta_gravacao, bloco_q15, n));
+#endif
+#if EFEITO_GRAVACAO_PRESENCA
+        EXECUTAR_ETAPA(etapas_gravacao[ETAPA_GRAVACAO_PRESENCA], biquad_processar(&presenca_gravacao, bloco_q15, n));
+#endif
+        efeitos_para_12_bits(bloco_q15, amostras, n);
+        amostras += n;
+        n_amostras -= n;
+    }
+#else
+    (void)amostras;
+    (void)n_amostras;
+#endif
+}
+
+size_t cadeia_gravacao_estatisticas(const estatisticas_etapa_t **etapas) {
+    *etapas = etapas_gravacao;
+    return N_ETAPAS_GRAVACAO;
+}
+
+// =================================================================================
+// Reprodução
+// =================================================================================
+
+void cadeia_reproducao_iniciar(uint32_t freq_amostragem) {
+#if EFEITO_REPRODUCAO_PASSA_BAIXA
+    biquad_configurar(&passa_baixa_reproducao, BIQUAD_PASSA_BAIXA, FREQ_PASSA_BAIXA_REPRODUCAO_HZ, 0.707f, 0.0f, freq_amostragem);
+    zerar_estatisticas(&etapas_reproducao[ETAPA_REPRODUCAO_PASSA_BAIXA], "passa-baixa");
+#endif
+#if EFEITO_REPRODUCAO_ECO
+    uint32_t atraso = ATRASO_ECO_MS * (freq_amostragem / 1000);
+    if (atraso > sizeof(linha_eco) / sizeof(linha_eco[0])) atraso = sizeof(linha_eco) / sizeof(linha_eco[0]);
+    eco_configurar(&eco_reproducao, linha_eco, atraso, REALIMENTACAO_ECO, MISTURA_ECO);
+    zerar_estatisticas(&etapas_reproducao[ETAPA_REPRODUCAO_ECO], "eco");
+#endif
+#if EFEITO_REPRODUCAO_SATURACAO
+    saturacao_configurar(&saturacao_reproducao, GANHO_SATURACAO);
+    zerar_estatisticas(&etapas_reproducao[ETAPA_REPRODUCAO_SATURACAO], "saturacao");
+#endif
+    (void)freq_amostragem;
+    contador_ciclos_iniciar();
+}
+
+void cadeia_reproducao_processar(uint16_t *amostras, size_t n_amostras) {
+#if N_ETAPAS_REPRODUCAO > 0
+    while (n_amostras > 0) {
+        size_t n = (n_amostras < CADEIA_MAX_BLOCO) ? n_amostras : CADEIA_MAX_BLOCO;
+        efeitos_para_q15(amostras, bloco_q15, n);
+#if EFEITO_REPRODUCAO_PASSA_BAIXA
+        EXECUTAR_ETAPA(etapas_reproducao[ETAPA_REPRODUCAO_PASSA_BAIXA], biquad_processar(&passa_baixa_reproducao, bloco_q15, n));
+#endif
+#if EFEITO_REPRODUCAO_ECO
+        EXECUTAR_ETAPA(etapas_reproducao[ETAPA_REPRODUCAO_ECO], eco_processar(&eco_reproducao, bloco_q15, n));
+#endif
+#if EFEITO_REPRODUCAO_SATURACAO
+        EXECUTAR_ETAPA(etapas_reproducao[ETAPA_REPRODUCAO_SATURACAO], saturacao_processar(&saturacao_reproducao, bloco_q15, n));
+#endif
+        efeitos_para_12_bits(bloco_q15, amostras, n);
+        amostras += n;
+        n_amostras -= n;
+    }
+#else
+    (void)amostras;
+    (void)n_amostras;
+#endif
+}
+
+size_t cadeia_reproducao_estatisticas(const estatisticas_etapa_t **etapas) {
+    *etapas = etapas_reproducao;
+    return N_ETAPAS_REPRODUCAO;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file cadeia_efeitos.h
+ * @brief Cadeias de efeitos da gravação e da reprodução, montadas em tempo de compilação.
+ *
+ * Cada etapa é ligada por uma macro abaixo (0/1, ou -D no build). Etapas
+ * desligadas não geram código nem estado, e uma cadeia vazia devolve o bloco
+ * intocado, sem nem converter o formato. A ordem das etapas é a da lista.
+ *
+ * - Gravação: entre a captura (após a suavização) e o armazenamento.
+ * - Reprodução: entre a leitura da gravação (ou o sintetizador) e o PWM.
+ *
+ * Cada etapa tem os ciclos por bloco medidos pelo SysTick do núcleo.
+ */
+#ifndef CADEIA_EFEITOS_H
+#define CADEIA_EFEITOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Gravação ---
+#ifndef EFEITO_GRAVACAO_PASSA_ALTA
+#define EFEITO_GRAVACAO_PASSA_ALTA 0 // Corta o ronco abaixo de ~80 Hz (a polarização sai antes, no bloqueio de DC)
+#endif
+#ifndef EFEITO_GRAVACAO_PRESENCA
+#define EFEITO_GRAVACAO_PRESENCA 0   // Realce de voz (pico em 3 kHz)
+#endif
+
+// --- Reprodução ---
+#ifndef EFEITO_REPRODUCAO_PASSA_BAIXA
+#define EFEITO_REPRODUCAO_PASSA_BAIXA 0 // Suaviza o chiado do PWM no buzzer
+#endif
+#ifndef EFEITO_REPRODUCAO_ECO
+#define EFEITO_REPRODUCAO_ECO 0
+#endif
+#ifndef EFEITO_REPRODUCAO_SATURACAO
+#define EFEITO_REPRODUCAO_SATURACAO 0
+#endif
+
+// --- Parâmetros ---
+#define FREQ_PASSA_ALTA_GRAVACAO_HZ 80.0f
+#define FREQ_PRESENCA_GRAVACAO_HZ 3000.0f
+#define GANHO_PRESENCA_GRAVACAO_DB 4.0f
+#define FREQ_PASSA_BAIXA_REPRODUCAO_HZ 6000.0f
+#define ATRASO_ECO_MS 150
+#define REALIMENTACAO_ECO 0.45f
+#define MISTURA_ECO 0.5f
+#define GANHO_SATURACAO 2.0f
+
+#define CADEIA_MAX_BLOCO 256 // Blocos maiores são processados em partes
+
+typedef struct {
+    const char *nome;
+    uint32_t n_blocos;
+    uint32_t ciclos_max;
+    uint64_t ciclos_total;
+} estatisticas_etapa_t;
+
+// Zeram o estado dos filtros e da linha de atraso e as estatísticas
+void cadeia_gravacao_iniciar(uint32_t freq_amostragem);
+void cadeia_reproducao_iniciar(uint32_t freq_amostragem);
+
+// Processam no lugar um bloco de amostras de 12 bits
+void cadeia_gravacao_processar(uint16_t *amostras, size_t n_amostras);
+void cadeia_reproducao_processar(uint16_t *amostras, size_t n_amostras);
+
+// Estatísticas por etapa, na ordem da cadeia; retorna o número de etapas ligadas
+size_t cadeia_gravacao_estatisticas(const estatisticas_etapa_t **etapas);
+size_t cadeia_reproducao_estatisticas(const estatisticas_etapa_t **etapas);
+
+#endif
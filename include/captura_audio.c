@@ -0,0 +1,264 @@
+/**
+ * @file captura_audio.c
+ * @brief Implementação do motor de captura ping-pong (ver captura_audio.h).
+ */
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "dsp_audio.h"
+#include "captura_audio.h"
+
+#if CAPTURA_SOBREAMOSTRADA
+#include "contador_ciclos.h"
+#include "perfil_desempenho.h"
+#include "decimador_audio.h"
+
+#define AMOSTRAS_POR_PARTE (TAMANHO_BLOCO_CAPTURA / PARTES_POR_BLOCO_CAPTURA)
+#define TAMANHO_PARTE_BRUTA (AMOSTRAS_POR_PARTE * CAPTURA_FATOR_ADC) // Amostras do ADC por transferência
+
+_Static_assert(CAPTURA_FATOR_ADC == DECIMADOR_FATOR, "fator do ADC difere do fator do decimador");
+_Static_assert(TAMANHO_BLOCO_CAPTURA % PARTES_POR_BLOCO_CAPTURA == 0, "bloco de captura não divide em partes iguais");
+#endif
+
+// Anel de blocos preenchidos pelo DMA e bloco de descarte usado em caso de overrun
+static uint16_t anel_captura[N_BLOCOS_ANEL_CAPTURA][TAMANHO_BLOCO_CAPTURA];
+static uint16_t bloco_descarte[TAMANHO_BLOCO_CAPTURA];
+
+static uint canal_dma[2];
+static dma_channel_config config_canal[2];
+
+// Contadores sequenciais do anel (o índice no anel é contador % N_BLOCOS_ANEL_CAPTURA)
+static volatile uint32_t blocos_publicados = 0;
+static volatile uint32_t blocos_consumidos = 0;
+static uint32_t proximo_bloco_livre = 0;
+static volatile uint32_t blocos_perdidos = 0;
+static volatile uint32_t perdidos_antes_do_bloco[N_BLOCOS_ANEL_CAPTURA]; // blocos_perdidos ao publicar cada um
+
+static captura_callback_bloco_t callback_bloco = NULL;
+
+#if CAPTURA_SOBREAMOSTRADA
+// Cada canal tem a própria parte bruta; enquanto um canal enche a sua, a do outro é decimada
+static uint16_t partes_brutas[2][TAMANHO_PARTE_BRUTA];
+static int16_t parte_decimada[AMOSTRAS_POR_PARTE];
+static decimador_t decimador;
+
+// Bloco do anel sendo montado (-1 indica o bloco de descarte) e quantas partes já recebeu
+static int32_t bloco_em_montagem;
+static uint32_t partes_montadas;
+static uint canal_esperado; // Próximo canal a terminar, para decimar na ordem da captura
+static estatisticas_decimacao_t estatisticas_decimacao;
+#else
+// Índice sequencial (não modular) do bloco de destino de cada canal; -1 indica o bloco de descarte
+static volatile int32_t bloco_do_canal[2];
+#endif
+
+// Reserva o próximo bloco livre do anel; -1 se o anel estiver cheio (overrun)
+static int32_t __not_in_flash_func(reservar_bloco)(void) {
+    if (proximo_bloco_livre - blocos_consumidos >= N_BLOCOS_ANEL_CAPTURA) {
+        return -1;
+    }
+    return (int32_t)proximo_bloco_livre++;
+}
+
+static uint16_t *__not_in_flash_func(endereco_bloco)(int32_t bloco) {
+    return (bloco >= 0) ? anel_captura[(uint32_t)bloco % N_BLOCOS_ANEL_CAPTURA] : bloco_descarte;
+}
+
+// Entrega um bloco completo ao consumidor (ou contabiliza a perda)
+static void __not_in_flash_func(publicar_bloco)(int32_t bloco) {
+    if (bloco < 0) {
+        blocos_perdidos++;
+        PERFIL_XRUN(PERFIL_XRUN_CAPTURA);
+        return;
+    }
+    perdidos_antes_do_bloco[(uint32_t)bloco % N_BLOCOS_ANEL_CAPTURA] = blocos_perdidos;
+    blocos_publicados = (uint32_t)bloco + 1;
+    if (callback_bloco) {
+        callback_bloco(endereco_bloco(bloco), TAMANHO_BLOCO_CAPTURA, (uint32_t)bloco);
+    }
+}
+
+#if CAPTURA_SOBREAMOSTRADA
+
+static void __not_in_flash_func(programar_destino_canal)(uint indice_canal, bool disparar) {
+    dma_channel_set_trans_count(canal_dma[indice_canal], TAMANHO_PARTE_BRUTA, false);
+    dma_channel_set_write_addr(canal_dma[indice_canal], partes_brutas[indice_canal], disparar);
+}
+
+// Decima a parte bruta do canal para dentro do bloco em montagem, já em 12 bits
+static void __not_in_flash_func(decimar_parte)(uint indice_canal) {
+    uint32_t inicio = contador_ciclos_ler();
+
+    if (partes_montadas == 0) {
+        bloco_em_montagem = reservar_bloco();
+    }
+
+    // Mesmo indo para o descarte, a parte passa pelo decimador para manter o estado contínuo
+    decimador_processar(&decimador, partes_brutas[indice_canal], TAMANHO_PARTE_BRUTA, parte_decimada);
+    uint16_t *destino = endereco_bloco(bloco_em_montagem) + partes_montadas * AMOSTRAS_POR_PARTE;
+    for (uint32_t k = 0; k < AMOSTRAS_POR_PARTE; k++) {
+        int32_t valor = DSP_AMOSTRA_ZERO + ((parte_decimada[k] + 8) >> 4);
+        destino[k] = (uint16_t)(valor > DSP_AMOSTRA_MAX ? DSP_AMOSTRA_MAX : valor);
+    }
+
+    uint32_t ciclos = contador_ciclos_desde(inicio);
+    estatisticas_decimacao.n_partes++;
+    estatisticas_decimacao.ciclos_total += ciclos;
+    if (ciclos > estatisticas_decimacao.ciclos_max) estatisticas_decimacao.ciclos_max = ciclos;
+    PERFIL_REGISTRAR(PERFIL_DECIMACAO, ciclos);
+
+    if (++partes_montadas == PARTES_POR_BLOCO_CAPTURA) {
+        partes_montadas = 0;
+        publicar_bloco(bloco_em_montagem);
+    }
+}
+
+// Roda da RAM para continuar atendendo o DMA enquanto a flash está sendo apagada/programada
+static void __not_in_flash_func(tratador_irq_dma_captura)(void) {
+    // Os canais se alternam: se os dois estiverem pendentes, o esperado é o mais antigo
+    for (uint n = 0; n < 2; n++) {
+        uint i = canal_esperado;
+        if (!dma_channel_get_irq0_status(canal_dma[i])) break;
+        dma_channel_acknowledge_irq0(canal_dma[i]);
+
+        // Decima antes de reprogramar: o canal só volta a escrever na parte quando o outro terminar
+        decimar_parte(i);
+        programar_destino_canal(i, false);
+        canal_esperado = i ^ 1;
+    }
+}
+
+#else
+
+// Escolhe o próximo destino de um canal: um bloco livre do anel ou o bloco de descarte
+static void __not_in_flash_func(programar_destino_canal)(uint indice_canal, bool disparar) {
+    int32_t bloco = reservar_bloco();
+    bloco_do_canal[indice_canal] = bloco;
+
+    dma_channel_set_trans_count(canal_dma[indice_canal], TAMANHO_BLOCO_CAPTURA, false);
+    dma_channel_set_write_addr(canal_dma[indice_canal], endereco_bloco(bloco), disparar);
+}
+
+// Roda da RAM para continuar atendendo o DMA enquanto a flash está sendo apagada/programada
+static void __not_in_flash_func(tratador_irq_dma_captura)(void) {
+    for (uint i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq0_status(canal_dma[i])) continue;
+        dma_channel_acknowledge_irq0(canal_dma[i]);
+
+        // O outro canal já assumiu a captura via chain_to; publica o bloco recém-preenchido
+        publicar_bloco(bloco_do_canal[i]);
+
+        // Reprograma o canal ocioso; ele só será disparado quando o outro terminar
+        programar_destino_canal(i, false);
+    }
+}
+
+#endif
+
+void captura_inicializar(void) {
+    for (uint i = 0; i < 2; i++) {
+        canal_dma[i] = dma_claim_unused_channel(true);
+    }
+
+    for (uint i = 0; i < 2; i++) {
+        config_canal[i] = dma_channel_get_default_config(canal_dma[i]);
+        channel_config_set_transfer_data_size(&config_canal[i], DMA_SIZE_16);
+        channel_config_set_read_increment(&config_canal[i], false);
+        channel_config_set_write_increment(&config_canal[i], true);
+        channel_config_set_dreq(&config_canal[i], DREQ_ADC);
+        channel_config_set_chain_to(&config_canal[i], canal_dma[i ^ 1]); // Ping-pong entre os canais
+    }
+
+    irq_add_shared_handler(DMA_IRQ_0, tratador_irq_dma_captura, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void captura_iniciar(captura_callback_bloco_t callback) {
+    adc_run(false);
+    adc_fifo_drain();
+
+    callback_bloco = callback;
+    blocos_publicados = 0;
+    blocos_consumidos = 0;
+    proximo_bloco_livre = 0;
+    blocos_perdidos = 0;
+
+#if CAPTURA_SOBREAMOSTRADA
+    decimador_iniciar(&decimador);
+    partes_montadas = 0;
+    canal_esperado = 0;
+    estatisticas_decimacao = (estatisticas_decimacao_t){ .amostras_por_parte = AMOSTRAS_POR_PARTE };
+    contador_ciclos_iniciar();
+#endif
+
+    for (uint i = 0; i < 2; i++) {
+        dma_channel_configure(canal_dma[i], &config_canal[i], NULL, &(adc_hw->fifo), TAMANHO_BLOCO_CAPTURA, false);
+        programar_destino_canal(i, false);
+        dma_channel_set_irq0_enabled(canal_dma[i], true);
+    }
+
+    dma_channel_start(canal_dma[0]);
+    adc_run(true);
+}
+
+void captura_parar(void) {
+    adc_run(false);
+
+    // Desfaz o encadeamento antes de abortar, para que um canal não dispare o outro
+    for (uint i = 0; i < 2; i++) {
+        dma_channel_set_irq0_enabled(canal_dma[i], false);
+        dma_channel_config config = config_canal[i];
+        channel_config_set_chain_to(&config, canal_dma[i]);
+        dma_channel_set_config(canal_dma[i], &config, false);
+    }
+    for (uint i = 0; i < 2; i++) {
+        dma_channel_abort(canal_dma[i]);
+        dma_channel_acknowledge_irq0(canal_dma[i]);
+    }
+
+    adc_fifo_drain();
+}
+
+uint16_t *captura_proximo_bloco(void) {
+    if (blocos_consumidos == blocos_publicados) {
+        return NULL;
+    }
+    return anel_captura[blocos_consumidos % N_BLOCOS_ANEL_CAPTURA];
+}
+
+void captura_liberar_bloco(void) {
+    if (blocos_consumidos != blocos_publicados) {
+        blocos_consumidos++;
+    }
+}
+
+size_t captura_blocos_pendentes(void) {
+    return (size_t)(blocos_publicados - blocos_consumidos);
+}
+
+uint16_t *captura_bloco_pendente(size_t indice) {
+    if (indice >= captura_blocos_pendentes()) {
+        return NULL;
+    }
+    return anel_captura[(blocos_consumidos + (uint32_t)indice) % N_BLOCOS_ANEL_CAPTURA];
+}
+
+uint32_t captura_blocos_perdidos(void) {
+    return blocos_perdidos;
+}
+
+uint32_t captura_perdidos_antes_do_proximo(void) {
+    if (blocos_consumidos == blocos_publicados) {
+        return blocos_perdidos;
+    }
+    return perdidos_antes_do_bloco[blocos_consumidos % N_BLOCOS_ANEL_CAPTURA];
+}
+
+estatisticas_decimacao_t captura_estatisticas_decimacao(void) {
+#if CAPTURA_SOBREAMOSTRADA
+    return estatisticas_decimacao;
+#else
+    return (estatisticas_decimacao_t){ 0 };
+#endif
+}
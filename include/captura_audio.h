@@ -0,0 +1,87 @@
+/**
+ * @file captura_audio.h
+ * @brief Motor de captura contínua do ADC via DMA em blocos (ping-pong).
+ *
+ * Dois canais de DMA encadeados se revezam preenchendo blocos de tamanho fixo
+ * de um anel circular. Cada bloco completo é publicado para o consumidor (e,
+ * opcionalmente, entregue a um callback na interrupção), permitindo processar
+ * o bloco N enquanto o bloco N+1 ainda está sendo capturado.
+ *
+ * Com CAPTURA_SOBREAMOSTRADA, o ADC roda CAPTURA_FATOR_ADC vezes mais rápido:
+ * o DMA preenche partes brutas menores e a própria interrupção as decima
+ * (decimador_audio.h) para dentro do anel. O consumidor continua recebendo
+ * blocos de TAMANHO_BLOCO_CAPTURA amostras de 12 bits na taxa final.
+ */
+#ifndef CAPTURA_AUDIO_H
+#define CAPTURA_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/types.h"
+
+// --- Parâmetros do Anel de Captura ---
+#define TAMANHO_BLOCO_CAPTURA 256 // Amostras por bloco (5,3 ms a 48 kHz)
+#define N_BLOCOS_ANEL_CAPTURA 32  // Blocos no anel (170 ms: cobre o apagamento de um setor da flash)
+#define CAPTURA_MAX_BLOCOS_RETIDOS (N_BLOCOS_ANEL_CAPTURA / 2) // Pré-disparo; a outra metade segue cobrindo a flash
+
+#ifndef CAPTURA_SOBREAMOSTRADA
+#define CAPTURA_SOBREAMOSTRADA 1 // 1 = ADC sobreamostrado + decimação CIC/FIR; 0 = ADC na taxa final
+#endif
+
+#if CAPTURA_SOBREAMOSTRADA
+#define CAPTURA_FATOR_ADC 8             // Deve coincidir com DECIMADOR_FATOR
+#define PARTES_POR_BLOCO_CAPTURA 4      // Cada bloco decimado junta 4 partes brutas (IRQs mais curtas, menos RAM)
+#define CAPTURA_ATRASO_AMOSTRAS 12      // Atraso de grupo do decimador na taxa final: CIC ~0,9 + FIR 11,5
+#else
+#define CAPTURA_FATOR_ADC 1
+#define CAPTURA_ATRASO_AMOSTRAS 0
+#endif
+
+// Custo da decimação medido na interrupção, por parte bruta
+typedef struct {
+    uint32_t n_partes;
+    uint32_t amostras_por_parte; // Amostras de saída produzidas em cada parte
+    uint32_t ciclos_max;
+    uint64_t ciclos_total;
+} estatisticas_decimacao_t;
+
+// Callback chamado (em contexto de interrupção) a cada bloco completo
+typedef void (*captura_callback_bloco_t)(const uint16_t *bloco, size_t n_amostras, uint32_t indice_bloco);
+
+// Reserva os canais de DMA e registra o tratador de interrupção. O ADC já deve estar configurado.
+void captura_inicializar(void);
+
+// Dispara a captura contínua; o ADC deve estar a CAPTURA_FATOR_ADC vezes a taxa final.
+// O callback é opcional (pode ser NULL).
+void captura_iniciar(captura_callback_bloco_t callback);
+
+// Interrompe o ADC e os dois canais de DMA
+void captura_parar(void);
+
+// Retorna o bloco completo mais antigo ainda não consumido, ou NULL se não houver.
+// O bloco pertence ao consumidor (pode ser processado no lugar) até captura_liberar_bloco().
+uint16_t *captura_proximo_bloco(void);
+
+// Devolve ao anel o bloco obtido por captura_proximo_bloco()
+void captura_liberar_bloco(void);
+
+// Blocos completos ainda não liberados (o de captura_proximo_bloco() e os que vieram depois dele)
+size_t captura_blocos_pendentes(void);
+
+// O pendente de posição `indice` (0 é o de captura_proximo_bloco()), ou NULL se ainda não chegou.
+// Permite olhar os blocos novos mantendo os anteriores no anel, como histórico.
+uint16_t *captura_bloco_pendente(size_t indice);
+
+// Quantidade de blocos descartados por falta de espaço no anel (overrun)
+uint32_t captura_blocos_perdidos(void);
+
+// Blocos descartados antes do bloco de captura_proximo_bloco() (o total, sem bloco pendente).
+// A perda acontece com o anel cheio, depois dos blocos ainda nele: quem conta amostras avança
+// a diferença ao chegar ao bloco que veio depois do buraco.
+uint32_t captura_perdidos_antes_do_proximo(void);
+
+// Ciclos gastos decimando desde captura_iniciar() (tudo zero sem sobreamostragem)
+estatisticas_decimacao_t captura_estatisticas_decimacao(void);
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file codec_amostras.c
+ * @brief Implementação dos codecs de armazenamento (ver codec_amostras.h).
+ */
+#include <string.h>
+#include "codec_amostras.h"
+
+#define TAMANHO_CABECALHO_ADPCM 4
+
+// Tabelas padrão do IMA-ADPCM
+static const int16_t tabela_passos_adpcm[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t tabela_indices_adpcm[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// As amostras de 12 bits (centradas em 2048) são levadas à escala de 16 bits do ADPCM
+static inline int32_t amostra_para_s16(uint16_t amostra) {
+    return ((int32_t)amostra - 2048) << 4;
+}
+
+static inline uint16_t s16_para_amostra(int32_t valor) {
+    int32_t amostra = (valor >> 4) + 2048;
+    if (amostra < 0) amostra = 0;
+    if (amostra > 4095) amostra = 4095;
+    return (uint16_t)amostra;
+}
+
+// Atualiza preditor e índice a partir de um código de 4 bits (comum a codificador e decodificador)
+static inline void adpcm_aplicar_codigo(codec_estado_adpcm_t *estado, uint8_t codigo) {
+    int32_t passo = tabela_passos_adpcm[estado->indice_passo];
+    int32_t delta = passo >> 3;
+    if (codigo & 4) delta += passo;
+    if (codigo & 2) delta += passo >> 1;
+    if (codigo & 1) delta += passo >> 2;
+
+    int32_t preditor = estado->preditor + ((codigo & 8) ? -delta : delta);
+    if (preditor > 32767) preditor = 32767;
+    if (preditor < -32768) preditor = -32768;
+    estado->preditor = (int16_t)preditor;
+
+    int32_t indice = estado->indice_passo + tabela_indices_adpcm[codigo & 7];
+    if (indice < 0) indice = 0;
+    if (indice > 88) indice = 88;
+    estado->indice_passo = (uint8_t)indice;
+}
+
+static inline uint8_t adpcm_codificar_amostra(codec_estado_adpcm_t *estado, int32_t valor) {
+    int32_t passo = tabela_passos_adpcm[estado->indice_passo];
+    int32_t diferenca = valor - estado->preditor;
+    uint8_t codigo = 0;
+
+    if (diferenca < 0) {
+        codigo = 8;
+        diferenca = -diferenca;
+    }
+    if (diferenca >= passo) { codigo |= 4; diferenca -= passo; }
+    passo >>= 1;
+    if (diferenca >= passo) { codigo |= 2; diferenca -= passo; }
+    passo >>= 1;
+    if (diferenca >= passo) { codigo |= 1; }
+
+    adpcm_aplicar_codigo(estado, codigo);
+    return codigo;
+}
+
+size_t codec_bytes_por_bloco(codec_amostras_t codec, size_t n_amostras) {
+    switch (codec) {
+        case CODEC_PACKED12:  return (3 * n_amostras + 1) / 2;
+        case CODEC_IMA_ADPCM: return TAMANHO_CABECALHO_ADPCM + (n_amostras + 1) / 2;
+        case CODEC_PCM16:
+        default:              return 2 * n_amostras;
+    }
+}
+
+size_t codec_capacidade_amostras(codec_amostras_t codec, size_t capacidade_bytes) {
+    return (capacidade_bytes / codec_bytes_por_bloco(codec, CODEC_AMOSTRAS_POR_BLOCO)) * CODEC_AMOSTRAS_POR_BLOCO;
+}
+
+size_t codec_bytes_para_amostras(codec_amostras_t codec, size_t n_amostras) {
+    size_t completos = n_amostras / CODEC_AMOSTRAS_POR_BLOCO;
+    size_t resto = n_amostras % CODEC_AMOSTRAS_POR_BLOCO;
+    return completos * codec_bytes_por_bloco(codec, CODEC_AMOSTRAS_POR_BLOCO) +
+           ((resto > 0) ? codec_bytes_por_bloco(codec, resto) : 0);
+}
+
+size_t codec_codificar_bloco(codec_amostras_t codec, const uint16_t *amostras, size_t n_amostras,
+                             uint8_t *destino, codec_estado_adpcm_t *estado) {
+    switch (codec) {
+        case CODEC_PACKED12: {
+            uint8_t *saida = destino;
+            size_t i = 0;
+            for (; i + 1 < n_amostras; i += 2) {
+                uint16_t a = amostras[i] & 0x0FFF;
+                uint16_t b = amostras[i + 1] & 0x0FFF;
+                *saida++ = (uint8_t)a;
+                *saida++ = (uint8_t)((a >> 8) | (b << 4));
+                *saida++ = (uint8_t)(b >> 4);
+            }
+            if (i < n_amostras) { // Amostra ímpar final ocupa 2 bytes
+                uint16_t a = amostras[i] & 0x0FFF;
+                *saida++ = (uint8_t)a;
+                *saida++ = (uint8_t)(a >> 8);
+            }
+            return (size_t)(saida - destino);
+        }
+
+        case CODEC_IMA_ADPCM: {
+            // Cabeçalho: estado do preditor antes do primeiro código do bloco
+            destino[0] = (uint8_t)estado->preditor;
+            destino[1] = (uint8_t)((uint16_t)estado->preditor >> 8);
+            destino[2] = estado->indice_passo;
+            destino[3] = 0;
+
+            uint8_t *saida = destino + TAMANHO_CABECALHO_ADPCM;
+            for (size_t i = 0; i < n_amostras; i += 2) {
+                uint8_t byte = adpcm_codificar_amostra(estado, amostra_para_s16(amostras[i]));
+                if (i + 1 < n_amostras) {
+                    byte |= adpcm_codificar_amostra(estado, amostra_para_s16(amostras[i + 1])) << 4;
+                }
+                *saida++ = byte;
+            }
+            return (size_t)(saida - destino);
+        }
+
+        case CODEC_PCM16:
+        default:
+            memcpy(destino, amostras, 2 * n_amostras);
+            return 2 * n_amostras;
+    }
+}
+
+void codec_decodificar_bloco(codec_amostras_t codec, const uint8_t *origem, size_t n_amostras, uint16_t *destino) {
+    switch (codec) {
+        case CODEC_PACKED12: {
+            size_t i = 0;
+            for (; i + 1 < n_amostras; i += 2) {
+                destino[i] = (uint16_t)(origem[0] | ((origem[1] & 0x0F) << 8));
+                destino[i + 1] = (uint16_t)((origem[1] >> 4) | (origem[2] << 4));
+                origem += 3;
+            }
+            if (i < n_amostras) {
+                destino[i] = (uint16_t)(origem[0] | ((origem[1] & 0x0F) << 8));
+            }
+            break;
+        }
+
+        case CODEC_IMA_ADPCM: {
+            codec_estado_adpcm_t estado = {
+                .preditor = (int16_t)(origem[0] | (origem[1] << 8)),
+                .indice_passo = origem[2] > 88 ? 88 : origem[2],
+            };
+            const uint8_t *entrada = origem + TAMANHO_CABECALHO_ADPCM;
+            for (size_t i = 0; i < n_amostras; i++) {
+                uint8_t codigo = (i & 1) ? (*entrada++ >> 4) : (*entrada & 0x0F);
+                adpcm_aplicar_codigo(&estado, codigo);
+                destino[i] = s16_para_amostra(estado.preditor);
+            }
+            break;
+        }
+
+        case CODEC_PCM16:
+        default:
+            memcpy(destino, origem, 2 * n_amostras);
+            break;
+    }
+}
+
+void gravacao_iniciar(gravacao_codificada_t *gravacao, codec_amostras_t codec, uint32_t freq_amostragem,
+                     uint8_t *memoria, size_t capacidade_bytes) {
+    gravacao->codec = codec;
+    gravacao->freq_amostragem = freq_amostragem;
+    gravacao->dados = memoria;
+    gravacao->capacidade_bytes = capacidade_bytes;
+    gravacao->bytes_usados = 0;
+    gravacao->n_amostras = 0;
+    gravacao->estado_adpcm.preditor = 0;
+    gravacao->estado_adpcm.indice_passo = 0;
+}
+
+bool gravacao_anexar_bloco(gravacao_codificada_t *gravacao, const uint16_t *amostras, size_t n_amostras) {
+    // Apenas o último bloco pode ser parcial, para que o deslocamento de cada bloco seja fixo
+    if (gravacao->n_amostras % CODEC_AMOSTRAS_POR_BLOCO != 0 || n_amostras > CODEC_AMOSTRAS_POR_BLOCO) {
+        return false;
+    }
+
+    size_t bytes = codec_bytes_por_bloco(gravacao->codec, n_amostras);
+    if (gravacao->bytes_usados + bytes > gravacao->capacidade_bytes) {
+        return false;
+    }
+
+    // O preditor parte da primeira amostra para evitar o transitório inicial do ADPCM
+    if (gravacao->n_amostras == 0 && n_amostras > 0) {
+        gravacao->estado_adpcm.preditor = (int16_t)amostra_para_s16(amostras[0]);
+    }
+
+    codec_codificar_bloco(gravacao->codec, amostras, n_amostras,
+                          gravacao->dados + gravacao->bytes_usados, &gravacao->estado_adpcm);
+    gravacao->bytes_usados += bytes;
+    gravacao->n_amostras += n_amostras;
+    return true;
+}
+
+bool gravacao_adotar_pcm16(gravacao_codificada_t *gravacao, size_t n_amostras) {
+    size_t bytes = codec_bytes_para_amostras(CODEC_PCM16, n_amostras);
+    if (gravacao->codec != CODEC_PCM16 || bytes > gravacao->capacidade_bytes) {
+        return false;
+    }
+
+    gravacao->bytes_usados = bytes;
+    gravacao->n_amostras = n_amostras;
+    return true;
+}
+
+size_t gravacao_ler_bloco(const gravacao_codificada_t *gravacao, size_t indice_bloco, uint16_t *destino) {
+    size_t inicio = indice_bloco * CODEC_AMOSTRAS_POR_BLOCO;
+    if (inicio >= gravacao->n_amostras) {
+        return 0;
+    }
+
+    size_t restantes = gravacao->n_amostras - inicio;
+    size_t n = (restantes < CODEC_AMOSTRAS_POR_BLOCO) ? restantes : CODEC_AMOSTRAS_POR_BLOCO;
+    size_t deslocamento = indice_bloco * codec_bytes_por_bloco(gravacao->codec, CODEC_AMOSTRAS_POR_BLOCO);
+
+    codec_decodificar_bloco(gravacao->codec, gravacao->dados + deslocamento, n, destino);
+    return n;
+}
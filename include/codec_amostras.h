@@ -0,0 +1,78 @@
+/**
+ * @file codec_amostras.h
+ * @brief Codecs de armazenamento das amostras (PCM 16, 12 bits empacotado e IMA-ADPCM).
+ *
+ * A gravação é guardada como uma sequência de blocos de CODEC_AMOSTRAS_POR_BLOCO
+ * amostras, cada um codificado de forma independente (o bloco ADPCM carrega seu
+ * próprio preditor no cabeçalho). Assim a codificação acontece bloco a bloco
+ * durante a captura e qualquer bloco pode ser decodificado isoladamente na
+ * reprodução, sem varrer a gravação desde o início.
+ */
+#ifndef CODEC_AMOSTRAS_H
+#define CODEC_AMOSTRAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CODEC_AMOSTRAS_POR_BLOCO 256
+
+typedef enum {
+    CODEC_PCM16,     // uint16_t por amostra (2 bytes)
+    CODEC_PACKED12,  // 12 bits empacotados: 3 bytes a cada 2 amostras (1,33x)
+    CODEC_IMA_ADPCM, // 4 bits por amostra + 4 bytes de cabeçalho por bloco (~3,9x)
+} codec_amostras_t;
+
+// Estado do codificador ADPCM propagado entre blocos
+typedef struct {
+    int16_t preditor;
+    uint8_t indice_passo;
+} codec_estado_adpcm_t;
+
+// Gravação codificada numa região de memória fornecida pelo chamador
+typedef struct {
+    codec_amostras_t codec;
+    uint8_t *dados;
+    size_t capacidade_bytes;
+    size_t bytes_usados;
+    size_t n_amostras;
+    uint32_t freq_amostragem; // Taxa em que foi capturada (Hz)
+    codec_estado_adpcm_t estado_adpcm;
+} gravacao_codificada_t;
+
+// Bytes ocupados por um bloco de n amostras
+size_t codec_bytes_por_bloco(codec_amostras_t codec, size_t n_amostras);
+
+// Quantas amostras (em blocos completos) cabem em `capacidade_bytes`
+size_t codec_capacidade_amostras(codec_amostras_t codec, size_t capacidade_bytes);
+
+// Bytes de uma gravação de n amostras (blocos completos e o último, parcial)
+size_t codec_bytes_para_amostras(codec_amostras_t codec, size_t n_amostras);
+
+// Codifica um bloco de amostras de 12 bits; retorna os bytes escritos
+size_t codec_codificar_bloco(codec_amostras_t codec, const uint16_t *amostras, size_t n_amostras,
+                             uint8_t *destino, codec_estado_adpcm_t *estado);
+
+// Decodifica um bloco de n amostras para o formato de 12 bits do ADC
+void codec_decodificar_bloco(codec_amostras_t codec, const uint8_t *origem, size_t n_amostras, uint16_t *destino);
+
+// --- Gravação em blocos ---
+
+void gravacao_iniciar(gravacao_codificada_t *gravacao, codec_amostras_t codec, uint32_t freq_amostragem,
+                     uint8_t *memoria, size_t capacidade_bytes);
+
+// Codifica e anexa um bloco ao fim da gravação; retorna false se não houver espaço
+bool gravacao_anexar_bloco(gravacao_codificada_t *gravacao, const uint16_t *amostras, size_t n_amostras);
+
+static inline size_t gravacao_numero_de_blocos(const gravacao_codificada_t *gravacao) {
+    return (gravacao->n_amostras + CODEC_AMOSTRAS_POR_BLOCO - 1) / CODEC_AMOSTRAS_POR_BLOCO;
+}
+
+// Dá como gravadas as n primeiras amostras, escritas direto na memória de uma gravação PCM16 (sem
+// passar pelo codec); false em outro codec ou se não couberem
+bool gravacao_adotar_pcm16(gravacao_codificada_t *gravacao, size_t n_amostras);
+
+// Decodifica o bloco `indice_bloco`; retorna a quantidade de amostras escritas em `destino`
+size_t gravacao_ler_bloco(const gravacao_codificada_t *gravacao, size_t indice_bloco, uint16_t *destino);
+
+#endif
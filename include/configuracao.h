@@ -0,0 +1,45 @@
+/**
+ * @file configuracao.h
+ * @brief Mapeamento de pinos e parâmetros de hardware compartilhados entre os módulos.
+ */
+#ifndef CONFIGURACAO_H
+#define CONFIGURACAO_H
+
+// --- Mapeamento de Pinos ---
+#define PINO_BOTAO_GRAVAR 5
+#define PINO_BOTAO_REPRODUZIR 6
+#define PINO_LED_VERMELHO 13
+#define PINO_LED_VERDE 11
+#define PINO_LED_AZUL 12
+#define PINO_I2C_SDA 14
+#define PINO_I2C_SCL 15
+#define PINO_BUZZER_1 21
+#define PINO_BUZZER_2 10
+#define CANAL_ADC_MIC 2
+#define PINO_MICROFONE (26 + CANAL_ADC_MIC) // GP28
+
+// --- Parâmetros do Display ---
+#define DISPLAY_WIDTH 128
+#define DISPLAY_HEIGHT 64
+
+// --- Parâmetros do DSP (compartilhados com a bancada, em bancada/) ---
+#define FATOR_SUAVIZACAO 0.2f // Alpha para o filtro
+#define REALIMENTACAO_LOOPER 0.85f // Parte do laço mantida a cada passada com overdub
+
+// Nível automático: a captura tira o DC e passa por AGC e limitador; a reprodução leva o pico
+// medido do take (no resumo do índice de picos) ao teto da saída. Níveis em LSB a partir do centro.
+#define AGC_ALVO_LSB 1400       // Envelope de pico procurado pelo AGC (~-3 dB do fundo de escala)
+#define AGC_TETO_LSB 1900       // Limitador: nenhuma amostra gravada passa disto (~-0,6 dB)
+#define AGC_PISO_LSB 32         // Envelope abaixo disto é ruído de fundo e o ganho não sobe
+#define AGC_GANHO_MAXIMO 4.0f   // +12 dB (até 8)
+#define AGC_LIBERACAO_MS 800    // Queda do envelope depois de um pico
+#define TETO_SAIDA_LSB 2000
+#define GANHO_SAIDA_MAXIMO 4.0f // Um take quase mudo não vira só ruído nos buzzers
+
+// Constantes equivalentes em ponto fixo (calculadas em tempo de compilação; DSP_Q15/DSP_Q12/DSP_Q16 vêm de dsp_audio.h)
+#define ALFA_SUAVIZACAO_Q15 DSP_Q15(FATOR_SUAVIZACAO)
+#define REALIMENTACAO_LOOPER_Q15 DSP_Q15(REALIMENTACAO_LOOPER)
+#define AGC_GANHO_MAXIMO_Q16 DSP_Q16(AGC_GANHO_MAXIMO)
+#define GANHO_SAIDA_MAXIMO_Q12 DSP_Q12(GANHO_SAIDA_MAXIMO)
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file console_usb.c
+ * @brief Driver de stdio sobre o CDC 0, com o tud_task() no laço do núcleo 1 (ver console_usb.h).
+ */
+#include "pico/stdlib.h"
+#include "pico/stdio/driver.h"
+#include "hardware/structs/scb.h"
+#include "tusb.h"
+#include "console_usb.h"
+
+#define INSTANCIA 0 // Primeira porta serial (ver usb_descritores.c)
+
+// Só o núcleo 1 escreve: o tud_task() pode ser chamado daqui quando a FIFO enche.
+// Nenhum callback do TinyUSB usa o printf, então não há reentrada.
+static void escrever_caracteres(const char *texto, int n) {
+    uint32_t inicio = time_us_32();
+    while (n > 0 && tud_cdc_n_connected(INSTANCIA)) {
+        uint32_t escritos = tud_cdc_n_write(INSTANCIA, texto, (uint32_t)n);
+        texto += escritos;
+        n -= (int)escritos;
+        if (n == 0) break;
+
+        tud_task(); // FIFO cheia: envia o que já está nela
+        if (time_us_32() - inicio >= CONSOLE_USB_ESPERA_SAIDA_US) break; // Terminal parado
+    }
+}
+
+static void esvaziar_saida(void) {
+    if (tud_cdc_n_connected(INSTANCIA)) tud_cdc_n_write_flush(INSTANCIA);
+}
+
+static int ler_caracteres(char *destino, int n) {
+    if (!tud_cdc_n_available(INSTANCIA)) return PICO_ERROR_NO_DATA;
+    return (int)tud_cdc_n_read(INSTANCIA, destino, (uint32_t)n);
+}
+
+static stdio_driver_t driver_console = {
+    .out_chars = escrever_caracteres,
+    .out_flush = esvaziar_saida,
+    .in_chars = ler_caracteres,
+#if PICO_STDIO_ENABLE_CRLF_SUPPORT
+    .crlf_enabled = PICO_STDIO_DEFAULT_CRLF,
+#endif
+};
+
+void console_usb_iniciar(void) {
+    // Interrupção que fica pendente também arma o evento: a que chega entre o
+    // tud_task() e o __wfe do laço não deixa o núcleo dormindo com trabalho
+    hw_set_bits(&scb_hw->scr, M0PLUS_SCR_SEVONPEND_BITS);
+    stdio_set_driver_enabled(&driver_console, true);
+}
+
+void console_usb_atender(void) {
+    tud_task();
+}
+
+void console_usb_aguardar_conexao(uint32_t ms) {
+    absolute_time_t fim = make_timeout_time_ms(ms);
+    while (!time_reached(fim)) {
+        console_usb_atender();
+    }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file console_usb.h
+ * @brief Console do printf/getchar na primeira porta CDC, atendido pelo núcleo 1.
+ *
+ * O stdio USB do SDK só inicia no núcleo do alarm pool padrão (o 0) e ali
+ * chama o tud_task() por interrupção, com tratadores na flash que não podem
+ * rodar enquanto o núcleo 0 está estacionado (ver armazenamento_flash.c).
+ * Por isso o TinyUSB fica inteiro no núcleo 1: este driver de stdio escreve
+ * direto na FIFO do CDC e o laço do núcleo 1 chama console_usb_atender() a
+ * cada volta. A interrupção do USB, também no núcleo 1, acorda o __wfe do laço.
+ */
+#ifndef CONSOLE_USB_H
+#define CONSOLE_USB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Espera máxima por espaço na FIFO antes de descartar o resto de um printf
+#define CONSOLE_USB_ESPERA_SAIDA_US 500000
+
+// --- Núcleo 1 ---
+
+// Registra o driver no stdio; chamar depois de audio_usb_iniciar()
+void console_usb_iniciar(void);
+
+// Executa o tud_task(): enumeração, callbacks do áudio e FIFOs dos dois CDC
+void console_usb_atender(void);
+
+// Atende o USB por ms milissegundos, para dar tempo ao terminal de abrir a porta
+void console_usb_aguardar_conexao(uint32_t ms);
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file contador_ciclos.h
+ * @brief Medição de ciclos de CPU com o SysTick do núcleo que chama.
+ *
+ * Cada núcleo do RP2040 tem o próprio SysTick, e o SDK não o usa: aqui ele
+ * conta livremente para baixo a partir de 2^24 - 1 no clock do processador.
+ * Trechos medidos devem durar menos de 2^24 ciclos (~134 ms a 125 MHz).
+ * As funções são sempre expandidas no chamador, o que permite usá-las em
+ * tratadores que rodam da RAM.
+ */
+#ifndef CONTADOR_CICLOS_H
+#define CONTADOR_CICLOS_H
+
+#include <stdint.h>
+#include "hardware/structs/systick.h"
+
+#define CONTADOR_CICLOS_MASCARA 0x00FFFFFFu
+
+// Idempotente: com o SysTick já contando, não toca no RVR nem no CVR, e uma
+// medição em andamento (o PERFIL_INICIO em volta de um *_iniciar) segue válida
+static __force_inline void contador_ciclos_iniciar(void) {
+    if (systick_hw->csr & M0PLUS_SYST_CSR_ENABLE_BITS) return;
+    systick_hw->rvr = CONTADOR_CICLOS_MASCARA;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+static __force_inline uint32_t contador_ciclos_ler(void) {
+    return systick_hw->cvr;
+}
+
+// Ciclos decorridos desde a leitura `inicio` (o contador é decrescente)
+static __force_inline uint32_t contador_ciclos_desde(uint32_t inicio) {
+    return (inicio - systick_hw->cvr) & CONTADOR_CICLOS_MASCARA;
+}
+
+#endif
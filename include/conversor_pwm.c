@@ -0,0 +1,24 @@
+/**
+ * @file conversor_pwm.c
+ * @brief Laço de conversão para o PWM sobre o interp0 (ver conversor_pwm.h).
+ */
+#include "hardware/interp.h"
+#include "reproducao_audio.h"
+#include "conversor_pwm.h"
+
+void conversor_pwm_bloco(const dsp_escala_pwm_t *escala, const uint16_t *amostras, uint32_t *bloco, size_t n_amostras) {
+    // Lane 0: (ACCUM0 >> deslocamento) saturado entre BASE0 e BASE1, sem sinal
+    interp_config configuracao = interp_default_config();
+    interp_config_set_shift(&configuracao, escala->deslocamento);
+    interp_config_set_mask(&configuracao, 0, 31);
+    interp_config_set_clamp(&configuracao, true);
+    interp_set_config(interp0, 0, &configuracao);
+    interp0->base[0] = 0;
+    interp0->base[1] = escala->valor_max_pwm;
+
+    const uint32_t reciproco = escala->reciproco;
+    for (size_t j = 0; j < n_amostras; j++) {
+        interp0->accum[0] = (uint32_t)amostras[j] * reciproco;
+        bloco[j] = reproducao_nivel_cc(interp0->peek[0]);
+    }
+}
@@ -0,0 +1,25 @@
+/**
+ * @file conversor_pwm.h
+ * @brief Conversão de blocos de amostras de 12 bits em níveis de PWM com o interpolador do SIO.
+ *
+ * A divisão por DSP_AMOSTRA_MAX de cada amostra vira uma multiplicação pelo
+ * recíproco (dsp_escala_pwm_t, calculado uma vez por reprodução). O
+ * interpolador 0 do núcleo que chama faz o deslocamento e, no modo clamp da
+ * lane 0, a saturação em [0, TOP]: por amostra sobram uma multiplicação, uma
+ * escrita e uma leitura no SIO (de um ciclo cada) e o empacotamento dos dois
+ * canais. O resultado é igual ao de dsp_nivel_pwm_reciproco.
+ *
+ * O interp0 é reconfigurado a cada bloco e não é salvo: nenhuma interrupção
+ * do firmware o usa. Uma que passe a usá-lo deve salvá-lo (interp_save).
+ */
+#ifndef CONVERSOR_PWM_H
+#define CONVERSOR_PWM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dsp_audio.h"
+
+// Converte n_amostras de 12 bits em palavras do registrador CC (mesmo nível nos canais A e B)
+void conversor_pwm_bloco(const dsp_escala_pwm_t *escala, const uint16_t *amostras, uint32_t *bloco, size_t n_amostras);
+
+#endif
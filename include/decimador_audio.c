@@ -0,0 +1,102 @@
+/**
+ * @file decimador_audio.c
+ * @brief CIC de ordem 5 seguido do FIR de compensação (ver decimador_audio.h).
+ */
+#include "pico/stdlib.h"
+#include "tabelas_decimador.h"
+#include "dsp_audio.h"
+#include "decimador_audio.h"
+
+#define MEIO_FIR ((DECIMADOR_TAPS_FIR - 1) / 2)
+#define FATOR_CIC TABELAS_DECIMADOR_FATOR_CIC
+#define FATOR_FIR (DECIMADOR_FATOR / FATOR_CIC)
+
+// Ganho do CIC: FATOR_CIC^ORDEM = 2^10, sobre +-2^11 da entrada -> +-2^21; o FIR recebe +-2^14
+#define DESLOCAMENTO_CIC 7
+// Coeficientes Q15 com ganho unitário em DC: +-2^14 * 2^15 >> 14 leva o fundo de escala a +-2^15
+#define DESLOCAMENTO_FIR 14
+
+_Static_assert(TABELAS_DECIMADOR_FATOR == DECIMADOR_FATOR, "tabelas_decimador.h gerada para outro fator");
+_Static_assert(TABELAS_DECIMADOR_ORDEM_CIC == DECIMADOR_ORDEM_CIC, "tabelas_decimador.h gerada para outra ordem de CIC");
+_Static_assert(TABELAS_DECIMADOR_TAPS == DECIMADOR_TAPS_FIR, "tabelas_decimador.h gerada com outro número de taps");
+_Static_assert(FATOR_CIC == 4 && FATOR_FIR == 2, "o laço abaixo supõe CIC por 4 e FIR por 2");
+
+// Cópia na RAM: a tabela const fica na flash, inacessível com a XIP desligada
+static int16_t coeficientes[DECIMADOR_TAPS_FIR];
+static bool coeficientes_copiados = false;
+
+void decimador_iniciar(decimador_t *decimador) {
+    if (!coeficientes_copiados) {
+        for (int k = 0; k < DECIMADOR_TAPS_FIR; k++) {
+            coeficientes[k] = tabela_fir_decimador[k];
+        }
+        coeficientes_copiados = true;
+    }
+
+    for (int k = 0; k < DECIMADOR_ORDEM_CIC; k++) {
+        decimador->integradores[k] = 0;
+        decimador->atrasos_pentes[k] = 0;
+    }
+    decimador->fase_fir = 0;
+    decimador->posicao = 0;
+    for (int k = 0; k < 2 * DECIMADOR_TAPS_FIR; k++) {
+        decimador->historico[k] = 0;
+    }
+}
+
+// FIR simétrico: cada coeficiente multiplica a soma do par de amostras espelhadas
+static int16_t __not_in_flash_func(calcular_fir)(const int16_t *janela) {
+    int32_t acumulado = coeficientes[MEIO_FIR] * janela[MEIO_FIR];
+    for (int k = 0; k < MEIO_FIR; k++) {
+        acumulado += coeficientes[k] * (janela[k] + janela[DECIMADOR_TAPS_FIR - 1 - k]);
+    }
+
+    int32_t saida = (acumulado + (1 << (DESLOCAMENTO_FIR - 1))) >> DESLOCAMENTO_FIR;
+    if (saida > 32767) saida = 32767;
+    if (saida < -32768) saida = -32768;
+    return (int16_t)saida;
+}
+
+size_t __not_in_flash_func(decimador_processar)(decimador_t *decimador, const uint16_t *entrada, size_t n_entrada, int16_t *saida) {
+    uint32_t i0 = decimador->integradores[0], i1 = decimador->integradores[1], i2 = decimador->integradores[2];
+    uint32_t i3 = decimador->integradores[3], i4 = decimador->integradores[4];
+    size_t n_saida = 0;
+
+    for (size_t i = 0; i + FATOR_CIC <= n_entrada; i += FATOR_CIC) {
+        // Integradores à taxa do ADC, quatro amostras por vez
+        for (size_t j = i; j < i + FATOR_CIC; j++) {
+            i0 += (uint32_t)((int32_t)entrada[j] - DSP_AMOSTRA_ZERO);
+            i1 += i0;
+            i2 += i1;
+            i3 += i2;
+            i4 += i3;
+        }
+
+        // Pentes à taxa intermediária
+        uint32_t valor = i4;
+        for (int k = 0; k < DECIMADOR_ORDEM_CIC; k++) {
+            uint32_t anterior = decimador->atrasos_pentes[k];
+            decimador->atrasos_pentes[k] = valor;
+            valor -= anterior;
+        }
+
+        uint32_t posicao = decimador->posicao;
+        int16_t amostra = (int16_t)((int32_t)valor >> DESLOCAMENTO_CIC);
+        decimador->historico[posicao] = amostra;
+        decimador->historico[posicao + DECIMADOR_TAPS_FIR] = amostra;
+        decimador->posicao = (posicao + 1 == DECIMADOR_TAPS_FIR) ? 0 : posicao + 1;
+
+        // Uma saída a cada FATOR_FIR amostras do CIC
+        if (++decimador->fase_fir == FATOR_FIR) {
+            decimador->fase_fir = 0;
+            saida[n_saida++] = calcular_fir(&decimador->historico[decimador->posicao]);
+        }
+    }
+
+    decimador->integradores[0] = i0;
+    decimador->integradores[1] = i1;
+    decimador->integradores[2] = i2;
+    decimador->integradores[3] = i3;
+    decimador->integradores[4] = i4;
+    return n_saida;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file decimador_audio.h
+ * @brief Decimador CIC + FIR de compensação para a captura sobreamostrada.
+ *
+ * O ADC roda a DECIMADOR_FATOR vezes a taxa final. Um CIC de ordem 5 reduz a
+ * taxa por 4 só com somas e subtrações; o FIR de fase linear (tabelas_decimador.h)
+ * corrige a queda do CIC na banda passante, serve de filtro anti-aliasing e
+ * reduz a taxa por mais 2. A média das amostras extras baixa o ruído do ADC.
+ *
+ * Todo o código e os coeficientes ficam na RAM: o decimador roda na interrupção
+ * do DMA da captura, que continua sendo atendida com a flash ocupada.
+ */
+#ifndef DECIMADOR_AUDIO_H
+#define DECIMADOR_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DECIMADOR_FATOR 8 // Amostras do ADC por amostra de saída
+#define DECIMADOR_ORDEM_CIC 5
+#define DECIMADOR_TAPS_FIR 47
+
+typedef struct {
+    uint32_t integradores[DECIMADOR_ORDEM_CIC]; // Aritmética modular: o estouro é esperado e se cancela nos pentes
+    uint32_t atrasos_pentes[DECIMADOR_ORDEM_CIC];
+    uint32_t fase_fir;
+    int16_t historico[2 * DECIMADOR_TAPS_FIR]; // Duplicado: a janela do FIR é sempre contígua
+    uint32_t posicao;
+} decimador_t;
+
+// Zera o estado (e, na primeira chamada, copia os coeficientes para a RAM)
+void decimador_iniciar(decimador_t *decimador);
+
+// Consome n_entrada amostras de 12 bits do ADC (múltiplo de DECIMADOR_FATOR) e escreve
+// n_entrada / DECIMADOR_FATOR amostras Q15 com sinal (fundo de escala do ADC = +-32768)
+size_t decimador_processar(decimador_t *decimador, const uint16_t *entrada, size_t n_entrada, int16_t *saida);
+
+#endif
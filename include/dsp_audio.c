@@ -0,0 +1,238 @@
+/**
+ * @file dsp_audio.c
+ * @brief Implementação dos núcleos de DSP em bloco (ver dsp_audio.h).
+ */
+#include "dsp_audio.h"
+
+uint16_t dsp_suavizar_float(uint16_t amostra_atual, uint16_t amostra_anterior, float fator) {
+    // Filtro IIR simples (média móvel exponencial)
+    return (uint16_t)(fator * amostra_atual + (1.0f - fator) * amostra_anterior);
+}
+
+uint16_t dsp_suavizar_bloco(uint16_t *amostras, size_t n_amostras, uint16_t estado, int32_t alfa_q15) {
+#if DSP_REFERENCIA_FLOAT
+    const float fator = (float)alfa_q15 / 32768.0f;
+    for (size_t i = 0; i < n_amostras; i++) {
+        estado = dsp_suavizar_float(amostras[i], estado, fator);
+        amostras[i] = estado;
+    }
+#else
+    for (size_t i = 0; i < n_amostras; i++) {
+        estado = dsp_suavizar_q15(amostras[i], estado, alfa_q15);
+        amostras[i] = estado;
+    }
+#endif
+    return estado;
+}
+
+uint16_t dsp_ganho_float(uint16_t amostra, float ganho) {
+    // Deslocada para positivo antes de truncar, como na mistura
+    float amplificada = ((float)amostra - DSP_AMOSTRA_ZERO) * ganho + DSP_AMOSTRA_ZERO;
+    int32_t arredondada = (int32_t)(amplificada + DSP_AMOSTRA_MAX + 1 + 0.5f) - (DSP_AMOSTRA_MAX + 1);
+    if (arredondada < 0) arredondada = 0;
+    if (arredondada > DSP_AMOSTRA_MAX) arredondada = DSP_AMOSTRA_MAX;
+    return (uint16_t)arredondada;
+}
+
+void dsp_ganho_bloco(const uint16_t *entrada, uint16_t *saida, size_t n_amostras, int32_t ganho_q12) {
+#if DSP_REFERENCIA_FLOAT
+    const float ganho = (float)ganho_q12 / 4096.0f;
+    for (size_t i = 0; i < n_amostras; i++) {
+        saida[i] = dsp_ganho_float(entrada[i], ganho);
+    }
+#else
+    for (size_t i = 0; i < n_amostras; i++) {
+        saida[i] = dsp_ganho_q12(entrada[i], ganho_q12);
+    }
+#endif
+}
+
+void dsp_bloqueio_dc_iniciar(dsp_bloqueio_dc_t *bloqueio) {
+    bloqueio->media_q16 = DSP_AMOSTRA_ZERO << 16;
+    bloqueio->iniciado = false;
+}
+
+void dsp_bloquear_dc_bloco(dsp_bloqueio_dc_t *bloqueio, uint16_t *amostras, size_t n_amostras) {
+    if (n_amostras == 0) return;
+    if (!bloqueio->iniciado) {
+        bloqueio->media_q16 = (int32_t)amostras[0] << 16;
+        bloqueio->iniciado = true;
+    }
+
+    int32_t media = bloqueio->media_q16;
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t amostra = amostras[i];
+        media += ((amostra << 16) - media) >> DSP_DC_DESLOCAMENTO;
+        int32_t saida = amostra - ((media + (1 << 15)) >> 16) + DSP_AMOSTRA_ZERO;
+        if (saida < 0) saida = 0;
+        if (saida > DSP_AMOSTRA_MAX) saida = DSP_AMOSTRA_MAX;
+        amostras[i] = (uint16_t)saida;
+    }
+    bloqueio->media_q16 = media;
+}
+
+void dsp_agc_iniciar(dsp_agc_t *agc, int32_t alvo_lsb, int32_t teto_lsb, int32_t piso_lsb, int32_t ganho_maximo_q16,
+                     int32_t liberacao_blocos) {
+    agc->alvo_lsb = alvo_lsb;
+    agc->teto_lsb = teto_lsb;
+    agc->piso_lsb = (piso_lsb > 0) ? piso_lsb : 1;
+    agc->ganho_maximo_q16 = (ganho_maximo_q16 < DSP_AGC_GANHO_TETO_Q16) ? ganho_maximo_q16 : DSP_AGC_GANHO_TETO_Q16;
+    agc->liberacao_blocos = (liberacao_blocos > 0) ? liberacao_blocos : 1;
+    agc->envelope_lsb = 0;
+    agc->ganho_q16 = 1 << 16;
+    agc->blocos_limitados = 0;
+}
+
+void dsp_agc_bloco(dsp_agc_t *agc, uint16_t *amostras, size_t n_amostras) {
+    if (n_amostras == 0) return;
+
+    // Passada 1: o pico do bloco, antes de qualquer ganho
+    int32_t pico = 0;
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t desvio = (int32_t)amostras[i] - DSP_AMOSTRA_ZERO;
+        if (desvio < 0) desvio = -desvio;
+        if (desvio > pico) pico = desvio;
+    }
+
+    if (pico >= agc->envelope_lsb) {
+        agc->envelope_lsb = pico;
+    } else {
+        agc->envelope_lsb -= (agc->envelope_lsb + agc->liberacao_blocos - 1) / agc->liberacao_blocos;
+    }
+
+    int32_t fim = agc->ganho_q16;
+    if (agc->envelope_lsb >= agc->piso_lsb) {
+        fim = (agc->alvo_lsb << 16) / agc->envelope_lsb;
+        if (fim > agc->ganho_maximo_q16) fim = agc->ganho_maximo_q16;
+        if (fim < DSP_AGC_GANHO_MINIMO_Q16) fim = DSP_AGC_GANHO_MINIMO_Q16;
+    }
+
+    int32_t inicio = agc->ganho_q16;
+    if (pico > 0) {
+        int32_t limite = (agc->teto_lsb << 16) / pico;
+        if (fim > limite) fim = limite;
+        if (inicio > limite) {
+            inicio = limite;
+            agc->blocos_limitados++;
+        }
+    }
+
+    // Passada 2: rampa linear de ganho (Q16); a entrada de 12 bits vezes o ganho cabe em 32 bits
+    int32_t passo = (fim - inicio) / (int32_t)n_amostras;
+    int32_t ganho = inicio;
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t saida = DSP_AMOSTRA_ZERO + ((((int32_t)amostras[i] - DSP_AMOSTRA_ZERO) * ganho + (1 << 15)) >> 16);
+        if (saida < 0) saida = 0;
+        if (saida > DSP_AMOSTRA_MAX) saida = DSP_AMOSTRA_MAX;
+        amostras[i] = (uint16_t)saida;
+        ganho += passo;
+    }
+    agc->ganho_q16 = ganho;
+}
+
+uint16_t dsp_misturar_float(uint16_t laco, uint16_t entrada, float realimentacao) {
+    // Deslocada para positivo antes de truncar, para arredondar igual dos dois lados do zero
+    float mistura = ((float)laco - DSP_AMOSTRA_ZERO) * realimentacao + (float)entrada;
+    int32_t arredondada = (int32_t)(mistura + DSP_AMOSTRA_MAX + 1 + 0.5f) - (DSP_AMOSTRA_MAX + 1);
+    if (arredondada < 0) arredondada = 0;
+    if (arredondada > DSP_AMOSTRA_MAX) arredondada = DSP_AMOSTRA_MAX;
+    return (uint16_t)arredondada;
+}
+
+void dsp_misturar_bloco(uint16_t *laco, const uint16_t *entrada, size_t n_amostras, int32_t realimentacao_q15) {
+#if DSP_REFERENCIA_FLOAT
+    const float realimentacao = (float)realimentacao_q15 / 32768.0f;
+    for (size_t i = 0; i < n_amostras; i++) {
+        laco[i] = dsp_misturar_float(laco[i], entrada[i], realimentacao);
+    }
+#else
+    for (size_t i = 0; i < n_amostras; i++) {
+        laco[i] = dsp_misturar_q15(laco[i], entrada[i], realimentacao_q15);
+    }
+#endif
+}
+
+void dsp_escala_pwm_iniciar(dsp_escala_pwm_t *escala, uint32_t valor_max_pwm) {
+    // Com o teto, DSP_AMOSTRA_MAX * reciproco >= valor_max_pwm << deslocamento e o erro
+    // fica abaixo de DSP_AMOSTRA_MAX / 2^deslocamento: a amostra máxima dá exatamente o TOP
+    uint32_t deslocamento = 31;
+    uint64_t reciproco;
+    do {
+        reciproco = (((uint64_t)valor_max_pwm << deslocamento) + DSP_AMOSTRA_MAX - 1) / DSP_AMOSTRA_MAX;
+    } while (reciproco * DSP_AMOSTRA_MAX > UINT32_MAX && --deslocamento > 0);
+
+    escala->reciproco = (uint32_t)reciproco;
+    escala->deslocamento = deslocamento;
+    escala->valor_max_pwm = valor_max_pwm;
+}
+
+void dsp_sigma_delta_iniciar(dsp_sigma_delta_t *modulador) {
+    modulador->integrador1 = 0;
+    modulador->integrador2 = 0;
+}
+
+void dsp_sigma_delta_bloco(dsp_sigma_delta_t *modulador, const uint16_t *amostras, uint32_t *palavras, size_t n_amostras) {
+    int32_t integrador1 = modulador->integrador1;
+    int32_t integrador2 = modulador->integrador2;
+
+    for (size_t j = 0; j < n_amostras; j++) {
+        int32_t entrada = ((int32_t)amostras[j] - DSP_AMOSTRA_ZERO) * DSP_SIGMA_DELTA_GANHO;
+        uint32_t palavra = 0;
+        for (int b = 0; b < DSP_SIGMA_DELTA_BITS; b++) {
+            // Bit 1 com o segundo integrador não negativo; realimenta +-DSP_SIGMA_DELTA_REALIMENTACAO sem desvio
+            uint32_t bit = ~(uint32_t)integrador2 >> 31;
+            int32_t realimentacao = (int32_t)(bit << 16) - DSP_SIGMA_DELTA_REALIMENTACAO;
+            palavra = (palavra << 1) | bit;
+            integrador1 += entrada - realimentacao;
+            integrador2 += integrador1 - realimentacao;
+        }
+        palavras[j] = palavra;
+    }
+
+    modulador->integrador1 = integrador1;
+    modulador->integrador2 = integrador2;
+}
+
+void dsp_resumir_bloco(const uint16_t *amostras, size_t n_amostras, dsp_resumo_bloco_t *resumo) {
+    uint16_t minimo = DSP_AMOSTRA_MAX, maximo = 0;
+    uint32_t soma_quadrados = 0;
+    int32_t soma = 0;
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        uint16_t amostra = amostras[i];
+        if (amostra < minimo) minimo = amostra;
+        if (amostra > maximo) maximo = amostra;
+        int32_t centrada = (int32_t)amostra - DSP_AMOSTRA_ZERO;
+        soma_quadrados += (uint32_t)(centrada * centrada);
+        soma += centrada;
+    }
+
+    resumo->minimo = minimo;
+    resumo->maximo = maximo;
+    resumo->soma_quadrados = soma_quadrados;
+    resumo->soma = soma;
+    resumo->n_amostras = (uint32_t)n_amostras;
+}
+
+void dsp_detector_nivel_iniciar(dsp_detector_nivel_t *detector, uint32_t limiar_liga_lsb, uint32_t limiar_desliga_lsb) {
+    if (limiar_desliga_lsb > limiar_liga_lsb) limiar_desliga_lsb = limiar_liga_lsb;
+    detector->limiar_liga_quadrado = limiar_liga_lsb * limiar_liga_lsb;
+    detector->limiar_desliga_quadrado = limiar_desliga_lsb * limiar_desliga_lsb;
+    detector->ativo = false;
+}
+
+bool dsp_detector_nivel_atualizar(dsp_detector_nivel_t *detector, const dsp_resumo_bloco_t *resumo) {
+    // As duas energias vêm multiplicadas por n. O limite de n é o do resumo (soma_quadrados de 32 bits,
+    // até 1023 amostras); com ele, n·Σx², (Σx)² e limiar²·n² (limiar até 2048) ficam abaixo de 2^42
+    uint32_t limiar = detector->ativo ? detector->limiar_desliga_quadrado : detector->limiar_liga_quadrado;
+    uint64_t n = resumo->n_amostras;
+    uint64_t referencia = (uint64_t)limiar * n * n;
+    uint64_t soma_quadrada = (uint64_t)((int64_t)resumo->soma * resumo->soma);
+    uint64_t total = (uint64_t)resumo->soma_quadrados * n;
+    uint64_t energia = (total > soma_quadrada) ? total - soma_quadrada : 0;
+
+    if (resumo->n_amostras > 0) {
+        detector->ativo = detector->ativo ? (energia >= referencia) : (energia > referencia);
+    }
+    return detector->ativo;
+}
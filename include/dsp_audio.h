@@ -0,0 +1,205 @@
+/**
+ * @file dsp_audio.h
+ * @brief Núcleos de DSP em ponto fixo (Q15/Q12) para o Cortex-M0+ sem FPU.
+ *
+ * As amostras seguem o formato do ADC: 12 bits sem sinal (0-4095). As versões
+ * em ponto flutuante são mantidas como referência para validar o caminho em
+ * ponto fixo; DSP_REFERENCIA_FLOAT=1 faz as funções de bloco usarem-nas.
+ */
+#ifndef DSP_AUDIO_H
+#define DSP_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef DSP_REFERENCIA_FLOAT
+#define DSP_REFERENCIA_FLOAT 0
+#endif
+
+#define DSP_AMOSTRA_MAX 4095
+#define DSP_AMOSTRA_ZERO 2048 // Silêncio: o meio da faixa do ADC
+
+// Conversão em tempo de compilação de constantes reais para ponto fixo
+#define DSP_Q15(x) ((int32_t)((x) * 32768.0f + 0.5f))
+#define DSP_Q12(x) ((int32_t)((x) * 4096.0f + 0.5f))
+#define DSP_Q16(x) ((int32_t)((x) * 65536.0f + 0.5f))
+
+// --- Filtro passa-baixa (média móvel exponencial) ---
+
+// y = y_anterior + alfa * (x - y_anterior), com alfa em Q15
+static inline uint16_t dsp_suavizar_q15(uint16_t amostra_atual, uint16_t amostra_anterior, int32_t alfa_q15) {
+    int32_t delta = (int32_t)amostra_atual - (int32_t)amostra_anterior;
+    return (uint16_t)((int32_t)amostra_anterior + ((delta * alfa_q15 + (1 << 14)) >> 15));
+}
+
+// Versão de referência (equivalente ao filtro original em float)
+uint16_t dsp_suavizar_float(uint16_t amostra_atual, uint16_t amostra_anterior, float fator);
+
+// Filtra um bloco no lugar; recebe e devolve a última saída do filtro (estado entre blocos)
+uint16_t dsp_suavizar_bloco(uint16_t *amostras, size_t n_amostras, uint16_t estado, int32_t alfa_q15);
+
+// --- Remoção do nível DC (passa-alta de 1 polo) ---
+
+// Média lenta com constante de tempo de 2^DSP_DC_DESLOCAMENTO amostras: corte em
+// fs / (2 * pi * 1024), ~7,5 Hz a 48 kHz e ~1,2 Hz a 8 kHz
+#define DSP_DC_DESLOCAMENTO 10
+
+typedef struct {
+    int32_t media_q16; // Nível DC medido (a polarização do microfone), em LSB com 16 bits de fração
+    bool iniciado;
+} dsp_bloqueio_dc_t;
+
+void dsp_bloqueio_dc_iniciar(dsp_bloqueio_dc_t *bloqueio);
+
+// Subtrai a média do bloco, no lugar, e recentra em DSP_AMOSTRA_ZERO. A primeira amostra depois
+// de iniciar vira a média, então a saída não tem o transitório de carga do filtro.
+void dsp_bloquear_dc_bloco(dsp_bloqueio_dc_t *bloqueio, uint16_t *amostras, size_t n_amostras);
+
+static inline uint16_t dsp_nivel_dc(const dsp_bloqueio_dc_t *bloqueio) {
+    return (uint16_t)((bloqueio->media_q16 + (1 << 15)) >> 16);
+}
+
+// --- Controle automático de ganho com limitador ---
+
+// O envelope segue o pico de cada bloco (sobe na hora, desce em `liberacao_blocos`) e o ganho o
+// leva a alvo_lsb, até ganho_maximo; com o envelope abaixo de piso_lsb (ruído de fundo) o ganho
+// só é mantido. O limitador olha o bloco inteiro antes de aplicá-lo: o ganho vai em rampa do
+// valor do fim do bloco anterior ao novo e nenhum dos dois leva o pico do bloco além de teto_lsb.
+// Se o ganho anterior já passaria do teto, o bloco começa direto no ganho limitado.
+typedef struct {
+    int32_t alvo_lsb;
+    int32_t teto_lsb;
+    int32_t piso_lsb;
+    int32_t ganho_maximo_q16;
+    int32_t liberacao_blocos;
+    int32_t envelope_lsb;
+    int32_t ganho_q16;         // No fim do último bloco
+    uint32_t blocos_limitados; // Blocos em que o limitador cortou o ganho de uma vez
+} dsp_agc_t;
+
+#define DSP_AGC_GANHO_MINIMO_Q16 (1 << 12) // 1/16: atenua entrada forte até o alvo
+#define DSP_AGC_GANHO_TETO_Q16 (8 << 16)   // Maior ganho_maximo aceito: 2048 * 8 * 2^16 ainda cabe em 32 bits
+
+void dsp_agc_iniciar(dsp_agc_t *agc, int32_t alvo_lsb, int32_t teto_lsb, int32_t piso_lsb, int32_t ganho_maximo_q16,
+                     int32_t liberacao_blocos);
+
+// Processa um bloco no lugar (duas passadas: pico e rampa de ganho)
+void dsp_agc_bloco(dsp_agc_t *agc, uint16_t *amostras, size_t n_amostras);
+
+// --- Ganho com saturação ---
+
+// Aplica o ganho em Q12 em torno de DSP_AMOSTRA_ZERO e satura em 0..DSP_AMOSTRA_MAX
+static inline uint16_t dsp_ganho_q12(uint16_t amostra, int32_t ganho_q12) {
+    int32_t amplificada = DSP_AMOSTRA_ZERO + ((((int32_t)amostra - DSP_AMOSTRA_ZERO) * ganho_q12 + (1 << 11)) >> 12);
+    if (amplificada < 0) amplificada = 0;
+    if (amplificada > DSP_AMOSTRA_MAX) amplificada = DSP_AMOSTRA_MAX;
+    return (uint16_t)amplificada;
+}
+
+// Versão de referência em float
+uint16_t dsp_ganho_float(uint16_t amostra, float ganho);
+
+// Aplica o ganho a um bloco (entrada e saída podem coincidir)
+void dsp_ganho_bloco(const uint16_t *entrada, uint16_t *saida, size_t n_amostras, int32_t ganho_q12);
+
+// --- Mistura com realimentação (overdub do looper) ---
+
+// Soma a entrada ao laço já atenuado pela realimentação (Q15), os dois centrados em
+// DSP_AMOSTRA_ZERO, e satura em 0..DSP_AMOSTRA_MAX. Realimentação 1,0 mantém as passadas
+// anteriores inteiras; abaixo disso elas decaem a cada volta.
+static inline uint16_t dsp_misturar_q15(uint16_t laco, uint16_t entrada, int32_t realimentacao_q15) {
+    int32_t atenuado = (((int32_t)laco - DSP_AMOSTRA_ZERO) * realimentacao_q15 + (1 << 14)) >> 15;
+    int32_t mistura = atenuado + (int32_t)entrada;
+    if (mistura < 0) mistura = 0;
+    if (mistura > DSP_AMOSTRA_MAX) mistura = DSP_AMOSTRA_MAX;
+    return (uint16_t)mistura;
+}
+
+// Versão de referência em float
+uint16_t dsp_misturar_float(uint16_t laco, uint16_t entrada, float realimentacao);
+
+// Mistura um bloco de entrada no laço, no lugar
+void dsp_misturar_bloco(uint16_t *laco, const uint16_t *entrada, size_t n_amostras, int32_t realimentacao_q15);
+
+// --- Escala para o PWM ---
+
+// Amostra de 12 bits -> nível do PWM, de 0 a valor_max_pwm (o TOP do contador).
+// Referência: uma divisão por amostra.
+static inline uint32_t dsp_nivel_pwm(uint16_t amostra, uint32_t valor_max_pwm) {
+    return ((uint32_t)amostra * valor_max_pwm) / DSP_AMOSTRA_MAX;
+}
+
+// A mesma escala com o recíproco calculado uma vez: nível = (amostra * reciproco) >> deslocamento.
+// Difere de dsp_nivel_pwm em no máximo 1 nível (em poucas amostras) e não passa de valor_max_pwm.
+typedef struct {
+    uint32_t reciproco;     // ceil(valor_max_pwm * 2^deslocamento / DSP_AMOSTRA_MAX)
+    uint32_t deslocamento;  // O maior que mantém DSP_AMOSTRA_MAX * reciproco em 32 bits
+    uint32_t valor_max_pwm;
+} dsp_escala_pwm_t;
+
+void dsp_escala_pwm_iniciar(dsp_escala_pwm_t *escala, uint32_t valor_max_pwm);
+
+// Só para amostras de 12 bits (acima disso o produto transborda)
+static inline uint32_t dsp_nivel_pwm_reciproco(const dsp_escala_pwm_t *escala, uint16_t amostra) {
+    return ((uint32_t)amostra * escala->reciproco) >> escala->deslocamento;
+}
+
+// --- Modulador sigma-delta de 2ª ordem (saída de 1 bit) ---
+
+#define DSP_SIGMA_DELTA_BITS 32                // Bits por amostra: 32x de sobreamostragem, uma palavra por amostra
+#define DSP_SIGMA_DELTA_REALIMENTACAO (1 << 15)
+#define DSP_SIGMA_DELTA_GANHO 12               // 12 bits -> +-24576: 0,75 da realimentação, com margem de estabilidade
+
+// Dois integradores em cascata com realimentação do bit (CIFB); o ruído de
+// quantização sai moldado em 40 dB/década, para fora da banda de áudio
+typedef struct {
+    int32_t integrador1;
+    int32_t integrador2;
+} dsp_sigma_delta_t;
+
+void dsp_sigma_delta_iniciar(dsp_sigma_delta_t *modulador);
+
+// Uma palavra por amostra de 12 bits, bit mais antigo no MSB; o estado passa de um bloco ao outro
+void dsp_sigma_delta_bloco(dsp_sigma_delta_t *modulador, const uint16_t *amostras, uint32_t *palavras, size_t n_amostras);
+
+// --- Resumo de bloco (medidores) ---
+
+// Mínimo, máximo e energia de um bloco; a raiz do RMS fica para quem exibe
+typedef struct {
+    uint16_t minimo;
+    uint16_t maximo;
+    uint32_t soma_quadrados; // Soma de (x - DSP_AMOSTRA_ZERO)^2; cabe em 32 bits até 1023 amostras (1024 * 2048^2 = 2^32)
+    int32_t soma;            // Soma de (x - DSP_AMOSTRA_ZERO): o nível DC do bloco é soma / n
+    uint32_t n_amostras;
+} dsp_resumo_bloco_t;
+
+// Percorre o bloco uma única vez (n_amostras <= 1023)
+void dsp_resumir_bloco(const uint16_t *amostras, size_t n_amostras, dsp_resumo_bloco_t *resumo);
+
+// Soma dos quadrados sem o DC do próprio bloco (n vezes a variância): o RMS de um microfone
+// fora do centro não inclui a polarização
+static inline uint32_t dsp_resumo_energia_ac(const dsp_resumo_bloco_t *resumo) {
+    if (resumo->n_amostras == 0) return 0;
+    uint64_t dc = (uint64_t)((int64_t)resumo->soma * resumo->soma) / resumo->n_amostras;
+    return (resumo->soma_quadrados > dc) ? resumo->soma_quadrados - (uint32_t)dc : 0;
+}
+
+// --- Detector de nível com histerese (disparo da gravação) ---
+
+// Compara o RMS de cada bloco, sem o DC dele, com dois limiares e sem raiz nem divisão:
+// n * soma dos quadrados - soma^2 contra (limiar * n)^2. Liga acima de limiar_liga e só
+// desliga abaixo de limiar_desliga.
+typedef struct {
+    uint32_t limiar_liga_quadrado;    // LSB^2 por amostra
+    uint32_t limiar_desliga_quadrado;
+    bool ativo;
+} dsp_detector_nivel_t;
+
+// Limiares de RMS em LSB a partir do silêncio (limiar_desliga <= limiar_liga); começa desligado
+void dsp_detector_nivel_iniciar(dsp_detector_nivel_t *detector, uint32_t limiar_liga_lsb, uint32_t limiar_desliga_lsb);
+
+// Atualiza com o resumo de um bloco e retorna se há som
+bool dsp_detector_nivel_atualizar(dsp_detector_nivel_t *detector, const dsp_resumo_bloco_t *resumo);
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * @file efeitos_audio.c
+ * @brief Implementação dos efeitos em bloco (ver efeitos_audio.h).
+ */
+#include <math.h>
+#include "dsp_audio.h"
+#include "efeitos_audio.h"
+
+#define PI_F 3.14159265f
+#define GANHO_PICO_MAX_DB 6.0f // Acima disso b0 pode passar de 2
+
+static inline int16_t saturar_q15(int32_t valor) {
+    if (valor > 32767) return 32767;
+    if (valor < -32768) return -32768;
+    return (int16_t)valor;
+}
+
+// --- Conversão de formato ---
+
+void efeitos_para_q15(const uint16_t *entrada, int16_t *saida, size_t n_amostras) {
+    for (size_t i = 0; i < n_amostras; i++) {
+        saida[i] = (int16_t)(((int32_t)entrada[i] - DSP_AMOSTRA_ZERO) << 4);
+    }
+}
+
+void efeitos_para_12_bits(const int16_t *entrada, uint16_t *saida, size_t n_amostras) {
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t valor = DSP_AMOSTRA_ZERO + ((entrada[i] + 8) >> 4);
+        saida[i] = (uint16_t)(valor > DSP_AMOSTRA_MAX ? DSP_AMOSTRA_MAX : valor);
+    }
+}
+
+// --- Biquad ---
+
+static int32_t coeficiente_q29(float valor) {
+    const float limite = 2.0f - 1.0f / 16384.0f;
+    if (valor > limite) valor = limite;
+    if (valor < -limite) valor = -limite;
+    return (int32_t)lroundf(valor * 536870912.0f);
+}
+
+static coeficiente_biquad_t dividir_coeficiente(int32_t q29) {
+    return (coeficiente_biquad_t){ .alto = q29 >> 15, .baixo = q29 & 0x7FFF };
+}
+
+// c * x em Q29 (x em Q15): parte alta mais a contribuição dos 15 bits baixos
+static inline int32_t multiplicar_coeficiente(coeficiente_biquad_t c, int32_t x) {
+    return c.alto * x + ((c.baixo * x) >> 15);
+}
+
+void biquad_configurar(biquad_t *filtro, tipo_biquad_t tipo, float frequencia_hz, float q,
+                       float ganho_db, uint32_t freq_amostragem) {
+    float w0 = 2.0f * PI_F * frequencia_hz / (float)freq_amostragem;
+    float cosseno = cosf(w0);
+    float alfa = sinf(w0) / (2.0f * q);
+    float b0, b1, b2, a0, a1, a2;
+
+    switch (tipo) {
+        case BIQUAD_PASSA_BAIXA:
+            b0 = (1.0f - cosseno) * 0.5f;
+            b1 = 1.0f - cosseno;
+            b2 = b0;
+            a0 = 1.0f + alfa;
+            a1 = -2.0f * cosseno;
+            a2 = 1.0f - alfa;
+            break;
+        case BIQUAD_PASSA_ALTA:
+            b0 = (1.0f + cosseno) * 0.5f;
+            b1 = -(1.0f + cosseno);
+            b2 = b0;
+            a0 = 1.0f + alfa;
+            a1 = -2.0f * cosseno;
+            a2 = 1.0f - alfa;
+            break;
+        case BIQUAD_PASSA_FAIXA: // Ganho 0 dB no pico
+            b0 = alfa;
+            b1 = 0.0f;
+            b2 = -alfa;
+            a0 = 1.0f + alfa;
+            a1 = -2.0f * cosseno;
+            a2 = 1.0f - alfa;
+            break;
+        case BIQUAD_PICO:
+        default: {
+            if (ganho_db > GANHO_PICO_MAX_DB) ganho_db = GANHO_PICO_MAX_DB;
+            if (ganho_db < -GANHO_PICO_MAX_DB) ganho_db = -GANHO_PICO_MAX_DB;
+            float a = powf(10.0f, ganho_db / 40.0f);
+            b0 = 1.0f + alfa * a;
+            b1 = -2.0f * cosseno;
+            b2 = 1.0f - alfa * a;
+            a0 = 1.0f + alfa / a;
+            a1 = -2.0f * cosseno;
+            a2 = 1.0f - alfa / a;
+            break;
+        }
+    }
+
+    int32_t q_b0 = coeficiente_q29(b0 / a0);
+    int32_t q_b1 = coeficiente_q29(b1 / a0);
+    int32_t q_b2 = coeficiente_q29(b2 / a0);
+
+    // Zeros exatos em DC (passa-alta) ou em Nyquist (passa-baixa), apesar do arredondamento
+    if (tipo == BIQUAD_PASSA_ALTA || tipo == BIQUAD_PASSA_BAIXA) {
+        q_b2 = q_b0;
+        q_b1 = (tipo == BIQUAD_PASSA_ALTA) ? -2 * q_b0 : 2 * q_b0;
+    }
+
+    filtro->b0 = dividir_coeficiente(q_b0);
+    filtro->b1 = dividir_coeficiente(q_b1);
+    filtro->b2 = dividir_coeficiente(q_b2);
+    filtro->a1 = dividir_coeficiente(coeficiente_q29(a1 / a0));
+    filtro->a2 = dividir_coeficiente(coeficiente_q29(a2 / a0));
+    filtro->s1 = 0;
+    filtro->s2 = 0;
+}
+
+void biquad_processar(biquad_t *filtro, int16_t *amostras, size_t n_amostras) {
+    const coeficiente_biquad_t b0 = filtro->b0, b1 = filtro->b1, b2 = filtro->b2;
+    const coeficiente_biquad_t a1 = filtro->a1, a2 = filtro->a2;
+    int32_t s1 = filtro->s1, s2 = filtro->s2;
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t x = amostras[i];
+        int32_t acumulado = multiplicar_coeficiente(b0, x) + s1; // y em Q29
+
+        // A realimentação usa y com 14 bits de fração: arredondar y para 16 bits
+        // antes dela amplificaria o erro pelo ganho dos polos (enorme nos graves)
+        int32_t y = acumulado >> 14;
+        int32_t fracao = acumulado & 0x3FFF;
+        if (y > 32767 || y < -32768) {
+            y = saturar_q15(y);
+            fracao = 0;
+        }
+        s1 = multiplicar_coeficiente(b1, x) - multiplicar_coeficiente(a1, y) - ((a1.alto * fracao) >> 14) + s2;
+        s2 = multiplicar_coeficiente(b2, x) - multiplicar_coeficiente(a2, y) - ((a2.alto * fracao) >> 14);
+        amostras[i] = saturar_q15((acumulado + (1 << 13)) >> 14);
+    }
+
+    filtro->s1 = s1;
+    filtro->s2 = s2;
+}
+
+// --- Eco ---
+
+void eco_configurar(eco_t *eco, int16_t *memoria, uint32_t n_amostras_atraso, float realimentacao, float mistura) {
+    eco->linha = memoria;
+    eco->tamanho = n_amostras_atraso;
+    eco->posicao = 0;
+    eco->realimentacao_q15 = DSP_Q15(realimentacao);
+    eco->mistura_q15 = DSP_Q15(mistura);
+    for (uint32_t i = 0; i < n_amostras_atraso; i++) {
+        memoria[i] = 0;
+    }
+}
+
+void eco_processar(eco_t *eco, int16_t *amostras, size_t n_amostras) {
+    if (eco->tamanho == 0) return;
+
+    int16_t *linha = eco->linha;
+    uint32_t posicao = eco->posicao;
+    const int32_t realimentacao = eco->realimentacao_q15;
+    const int32_t mistura = eco->mistura_q15;
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t x = amostras[i];
+        int32_t atrasada = linha[posicao];
+
+        linha[posicao] = saturar_q15(x + ((atrasada * realimentacao) >> 15));
+        amostras[i] = saturar_q15(x + ((atrasada * mistura) >> 15));
+
+        if (++posicao == eco->tamanho) posicao = 0;
+    }
+    eco->posicao = posicao;
+}
+
+// --- Saturação ---
+
+void saturacao_configurar(saturacao_t *saturacao, float ganho) {
+    saturacao->ganho_q12 = DSP_Q12(ganho);
+}
+
+void saturacao_processar(saturacao_t *saturacao, int16_t *amostras, size_t n_amostras) {
+    const int32_t ganho = saturacao->ganho_q12;
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t x = (amostras[i] * ganho) >> 12;
+        if (x > 32767) x = 32767;
+        if (x < -32767) x = -32767;
+
+        // 1,5 x - 0,5 x^3 (Q15): derivada zero em +-1, sem o degrau do corte seco
+        int32_t x3 = (((x * x) >> 15) * x) >> 15;
+        amostras[i] = saturar_q15((3 * x - x3) >> 1);
+    }
+}
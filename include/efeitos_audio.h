@@ -0,0 +1,80 @@
+/**
+ * @file efeitos_audio.h
+ * @brief Efeitos processados em bloco: biquad, eco com realimentação e saturação suave.
+ *
+ * Todos seguem a mesma forma: um estado próprio, configurado uma vez (em float,
+ * fora do laço de áudio), e uma função efeito_processar(estado, amostras, n)
+ * que trabalha no lugar sobre amostras Q15 com sinal. A conversão de/para o
+ * formato do ADC (12 bits, centro em 2048) é feita uma vez por cadeia, nas
+ * pontas (ver cadeia_efeitos.h).
+ */
+#ifndef EFEITOS_AUDIO_H
+#define EFEITOS_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Conversão de formato ---
+
+// 12 bits sem sinal -> Q15 com sinal
+void efeitos_para_q15(const uint16_t *entrada, int16_t *saida, size_t n_amostras);
+
+// Q15 com sinal -> 12 bits sem sinal (arredondado e saturado)
+void efeitos_para_12_bits(const int16_t *entrada, uint16_t *saida, size_t n_amostras);
+
+// --- Biquad (forma direta II transposta) ---
+
+typedef enum {
+    BIQUAD_PASSA_BAIXA,
+    BIQUAD_PASSA_ALTA,
+    BIQUAD_PASSA_FAIXA,
+    BIQUAD_PICO, // Realce/corte em torno da frequência central
+} tipo_biquad_t;
+
+// Coeficiente Q29 (|c| < 2, com a0 normalizado) dividido em parte alta (Q14) e
+// baixa (15 bits): c * x sai de duas multiplicações 32x32, sem aritmética de
+// 64 bits. Só Q14 não basta para polos perto de z = 1 (filtros de graves).
+typedef struct {
+    int32_t alto;
+    int32_t baixo;
+} coeficiente_biquad_t;
+
+// Estado em Q29
+typedef struct {
+    coeficiente_biquad_t b0, b1, b2, a1, a2;
+    int32_t s1, s2;
+} biquad_t;
+
+// Projeto pelas fórmulas do "Audio EQ Cookbook" (RBJ); ganho_db só vale para BIQUAD_PICO
+void biquad_configurar(biquad_t *filtro, tipo_biquad_t tipo, float frequencia_hz, float q,
+                       float ganho_db, uint32_t freq_amostragem);
+
+void biquad_processar(biquad_t *filtro, int16_t *amostras, size_t n_amostras);
+
+// --- Eco (linha de atraso circular com realimentação) ---
+
+typedef struct {
+    int16_t *linha;
+    uint32_t tamanho;   // Atraso em amostras
+    uint32_t posicao;
+    int32_t realimentacao_q15;
+    int32_t mistura_q15; // Quanto do atraso é somado à saída
+} eco_t;
+
+// `memoria` (n_amostras_atraso elementos) pertence ao chamador e é zerada aqui
+void eco_configurar(eco_t *eco, int16_t *memoria, uint32_t n_amostras_atraso, float realimentacao, float mistura);
+
+void eco_processar(eco_t *eco, int16_t *amostras, size_t n_amostras);
+
+// --- Saturação suave (cúbica) ---
+
+typedef struct {
+    int32_t ganho_q12; // Ganho de entrada (drive)
+} saturacao_t;
+
+// y = 1,5 x - 0,5 x^3 sobre x = ganho * entrada limitado a +-1
+void saturacao_configurar(saturacao_t *saturacao, float ganho);
+
+void saturacao_processar(saturacao_t *saturacao, int16_t *amostras, size_t n_amostras);
+
+#endif
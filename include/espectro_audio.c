@@ -0,0 +1,99 @@
+/**
+ * @file espectro_audio.c
+ * @brief Janela deslizante, FFT e conversão para dBFS (ver espectro_audio.h).
+ */
+#include "contador_ciclos.h"
+#include "espectro_audio.h"
+
+#define MASCARA_JANELA (ESPECTRO_N_AMOSTRAS - 1)
+#define BINS_POR_COLUNA (FFT_Q15_BINS / ESPECTRO_N_COLUNAS)
+#define LIMITE_ENTRADA_FFT 16383
+#define LOG2_FUNDO_ESCALA_Q8 (24 * 256) // Potência de um seno de fundo de escala: 2^24
+
+_Static_assert((ESPECTRO_N_AMOSTRAS & MASCARA_JANELA) == 0, "janela deve ser potência de 2");
+_Static_assert(FFT_Q15_BINS % ESPECTRO_N_COLUNAS == 0, "bins devem se dividir igualmente entre as colunas");
+
+static uint16_t janela[ESPECTRO_N_AMOSTRAS];
+static uint32_t proxima_amostra = 0;
+static uint32_t amostras_validas = 0;
+
+static int16_t entrada_fft[ESPECTRO_N_AMOSTRAS];
+static uint32_t potencia[FFT_Q15_BINS];
+
+static estatisticas_espectro_t estatisticas;
+
+void espectro_iniciar(void) {
+    proxima_amostra = 0;
+    amostras_validas = 0;
+    estatisticas = (estatisticas_espectro_t){ 0 };
+    contador_ciclos_iniciar();
+}
+
+void espectro_anexar(const uint16_t *amostras, size_t n_amostras) {
+    for (size_t i = 0; i < n_amostras; i++) {
+        janela[proxima_amostra] = amostras[i];
+        proxima_amostra = (proxima_amostra + 1) & MASCARA_JANELA;
+    }
+    amostras_validas += n_amostras;
+    if (amostras_validas > ESPECTRO_N_AMOSTRAS) amostras_validas = ESPECTRO_N_AMOSTRAS;
+}
+
+bool espectro_pronto(void) {
+    return amostras_validas == ESPECTRO_N_AMOSTRAS;
+}
+
+// log2(x) em Q8: parte inteira pela posição do bit mais alto e fração pela
+// aproximação log2(1 + f) ~ f + 0,344 f (1 - f) (erro < 0,01)
+static int32_t log2_q8(uint32_t x) {
+    if (x == 0) return 0;
+
+    uint32_t zeros = __builtin_clz(x);
+    int32_t inteiro = 31 - (int32_t)zeros;
+    int32_t fracao = (int32_t)(((x << zeros) >> 23) & 0xFF);
+    return inteiro * 256 + fracao + ((fracao * (256 - fracao) * 88) >> 16);
+}
+
+uint32_t espectro_calcular(int8_t *colunas_dbfs) {
+    uint32_t inicio = contador_ciclos_ler();
+
+    // Remove o nível médio (polarização do microfone) e leva a amostra a +-16384
+    uint32_t soma = 0;
+    for (uint32_t i = 0; i < ESPECTRO_N_AMOSTRAS; i++) {
+        soma += janela[i];
+    }
+    int32_t media = (int32_t)(soma / ESPECTRO_N_AMOSTRAS);
+
+    uint32_t mais_antiga = proxima_amostra; // A janela está cheia: a próxima posição é a mais antiga
+    for (uint32_t i = 0; i < ESPECTRO_N_AMOSTRAS; i++) {
+        int32_t valor = ((int32_t)janela[(mais_antiga + i) & MASCARA_JANELA] - media) * 8;
+        if (valor > LIMITE_ENTRADA_FFT) valor = LIMITE_ENTRADA_FFT;
+        if (valor < -LIMITE_ENTRADA_FFT) valor = -LIMITE_ENTRADA_FFT;
+        entrada_fft[i] = (int16_t)valor;
+    }
+
+    fft_q15_potencia(entrada_fft, potencia);
+
+    // Maior bin de cada coluna, convertido para dBFS: 10 log10(p) = 3,0103 log2(p)
+    for (uint32_t coluna = 0; coluna < ESPECTRO_N_COLUNAS; coluna++) {
+        uint32_t maior = 0;
+        for (uint32_t k = coluna * BINS_POR_COLUNA; k < (coluna + 1) * BINS_POR_COLUNA; k++) {
+            if (potencia[k] > maior) maior = potencia[k];
+        }
+
+        int32_t db = (maior == 0) ? ESPECTRO_DB_MINIMO : ((log2_q8(maior) - LOG2_FUNDO_ESCALA_Q8) * 771) >> 16;
+        if (db < ESPECTRO_DB_MINIMO) db = ESPECTRO_DB_MINIMO;
+        if (db > 0) db = 0;
+        colunas_dbfs[coluna] = (int8_t)db;
+    }
+
+    uint32_t ciclos = contador_ciclos_desde(inicio);
+    estatisticas.n_espectros++;
+    estatisticas.ciclos_ultimo = ciclos;
+    estatisticas.ciclos_total += ciclos;
+    if (ciclos > estatisticas.ciclos_max) estatisticas.ciclos_max = ciclos;
+    return ciclos;
+}
+
+estatisticas_espectro_t espectro_estatisticas(void) {
+    return estatisticas;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file espectro_audio.h
+ * @brief Analisador de espectro ao vivo (núcleo 1) sobre a FFT em ponto fixo.
+ *
+ * Guarda as últimas ESPECTRO_N_AMOSTRAS amostras recebidas e, quando pedido,
+ * calcula o espectro dessa janela em dBFS, já reduzido às colunas do display.
+ * Cada cálculo tem os ciclos medidos pelo SysTick do núcleo.
+ */
+#ifndef ESPECTRO_AUDIO_H
+#define ESPECTRO_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuracao.h"
+#include "fft_q15.h"
+
+#define ESPECTRO_N_AMOSTRAS FFT_Q15_N
+#define ESPECTRO_N_COLUNAS DISPLAY_WIDTH
+#define ESPECTRO_DB_MINIMO -127 // Piso das colunas (dBFS)
+
+typedef struct {
+    uint32_t n_espectros;
+    uint32_t ciclos_ultimo;
+    uint32_t ciclos_max;
+    uint64_t ciclos_total;
+} estatisticas_espectro_t;
+
+// Esvazia a janela e zera as estatísticas
+void espectro_iniciar(void);
+
+// Acrescenta amostras de 12 bits (centro em 2048) à janela deslizante
+void espectro_anexar(const uint16_t *amostras, size_t n_amostras);
+
+// Já há amostras suficientes para uma janela completa
+bool espectro_pronto(void);
+
+// Calcula o espectro da janela atual: nível em dBFS (ESPECTRO_DB_MINIMO..0) de
+// cada coluna, com a faixa 0..fs/2 distribuída linearmente. Retorna os ciclos gastos.
+uint32_t espectro_calcular(int8_t *colunas_dbfs);
+
+estatisticas_espectro_t espectro_estatisticas(void);
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file eventos_sistema.c
+ * @brief Fila de eventos do núcleo 0 e relógio reduzido em espera (ver eventos_sistema.h).
+ */
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "fila_spsc.h"
+#include "eventos_sistema.h"
+
+#define FREQ_PLL_USB_HZ (48 * MHZ)
+
+static evento_sistema_t armazenamento_eventos[N_EVENTOS_FILA_SISTEMA];
+static fila_spsc_t fila_eventos;
+static volatile uint32_t eventos_descartados = 0;
+
+static bool relogio_reduzido_habilitado = false;
+static bool relogio_reduzido = false;
+static uint32_t freq_sistema_hz = 0; // clk_sys pleno, vindo da PLL do sistema
+
+void eventos_sistema_iniciar(bool relogio_ocioso_reduzido) {
+    fila_spsc_iniciar(&fila_eventos, armazenamento_eventos, sizeof(evento_sistema_t), N_EVENTOS_FILA_SISTEMA);
+
+    relogio_reduzido_habilitado = relogio_ocioso_reduzido;
+    freq_sistema_hz = clock_get_hz(clk_sys);
+}
+
+void eventos_sistema_definir_relogio_pleno(uint32_t freq_hz) {
+    freq_sistema_hz = freq_hz;
+}
+
+void eventos_sistema_publicar(tipo_evento_sistema_t tipo) {
+    evento_sistema_t evento = { .tipo = tipo, .instante_us = time_us_32() };
+    if (!fila_spsc_inserir(&fila_eventos, &evento)) {
+        eventos_descartados++;
+    }
+    // A própria interrupção já acorda o __wfe deste núcleo
+}
+
+bool eventos_sistema_obter(evento_sistema_t *evento) {
+    return fila_spsc_remover(&fila_eventos, evento);
+}
+
+bool eventos_sistema_pendentes(void) {
+    return !fila_spsc_vazia(&fila_eventos);
+}
+
+void eventos_sistema_descartar(void) {
+    evento_sistema_t evento;
+    while (fila_spsc_remover(&fila_eventos, &evento)) {
+    }
+}
+
+void eventos_sistema_aguardar(uint32_t prazo_ms) {
+    // Uma interrupção entre o teste e o __wfe deixa o evento do núcleo sinalizado: a espera não se perde
+    if (eventos_sistema_pendentes()) return;
+    if (prazo_ms == 0) {
+        __wfe();
+    } else {
+        best_effort_wfe_or_timeout(make_timeout_time_ms(prazo_ms));
+    }
+}
+
+void eventos_sistema_relogio_ocioso(bool ocioso) {
+    if (!relogio_reduzido_habilitado || ocioso == relogio_reduzido) return;
+
+    // O clock_configure passa o clk_sys pelo clk_ref enquanto troca a fonte auxiliar, sem glitch
+    if (ocioso) {
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                        CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, FREQ_PLL_USB_HZ, FREQ_PLL_USB_HZ);
+    } else {
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                        CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, freq_sistema_hz, freq_sistema_hz);
+    }
+    relogio_reduzido = ocioso;
+}
+
+uint32_t eventos_sistema_descartados(void) {
+    return eventos_descartados;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file eventos_sistema.h
+ * @brief Fila de eventos do núcleo 0 e a espera de baixo consumo entre eles.
+ *
+ * A interrupção dos botões publica cada toque (com o instante em que
+ * aconteceu) numa fila SPSC lida pelo laço principal, que dorme em __wfe
+ * entre um evento e outro. Acordam o núcleo 0: as próprias interrupções dele
+ * (botões, DMA da captura e da reprodução) e o __sev do núcleo 1 (fila da
+ * flash, streams de áudio USB abertos pelo host).
+ *
+ * Com o áudio parado, o clk_sys pode cair para os 48 MHz da PLL do USB; o
+ * clk_peri já está nessa PLL (perfis_taxa_iniciar), de modo que I2C e UART
+ * não sentem a troca. A PLL do sistema continua travada e a volta leva
+ * poucos microssegundos.
+ */
+#ifndef EVENTOS_SISTEMA_H
+#define EVENTOS_SISTEMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define N_EVENTOS_FILA_SISTEMA 8
+
+typedef enum {
+    EVENTO_BOTAO_GRAVAR,
+    EVENTO_BOTAO_REPRODUZIR,
+} tipo_evento_sistema_t;
+
+typedef struct {
+    tipo_evento_sistema_t tipo;
+    uint32_t instante_us; // time_us_32() na interrupção
+} evento_sistema_t;
+
+// Guarda o clk_sys atual como o relógio pleno, ao qual eventos_sistema_relogio_ocioso(false) volta
+void eventos_sistema_iniciar(bool relogio_ocioso_reduzido);
+
+// Novo relógio pleno, depois que um perfil de taxa reprogramou a PLL do sistema
+void eventos_sistema_definir_relogio_pleno(uint32_t freq_hz);
+
+// Chamado pela interrupção (núcleo 0); com a fila cheia o evento é descartado e contabilizado
+void eventos_sistema_publicar(tipo_evento_sistema_t tipo);
+
+// Retira o evento mais antigo; retorna false se não houver
+bool eventos_sistema_obter(evento_sistema_t *evento);
+
+// Há evento esperando, sem retirá-lo
+bool eventos_sistema_pendentes(void);
+
+// Esvazia a fila (toques usados por um modo que lê os botões por conta própria)
+void eventos_sistema_descartar(void);
+
+// Dorme até um evento, uma interrupção, um __sev do núcleo 1 ou o prazo (0 = sem prazo)
+void eventos_sistema_aguardar(uint32_t prazo_ms);
+
+// Entra/sai do relógio reduzido; sem efeito se desabilitado ou já no modo pedido.
+// Sair antes de ligar o áudio: PWM, PIO e DMA são cadenciados pelo clk_sys.
+void eventos_sistema_relogio_ocioso(bool ocioso);
+
+uint32_t eventos_sistema_descartados(void);
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file fft_q15.c
+ * @brief Implementação da FFT real em Q15 (ver fft_q15.h).
+ */
+#include "tabelas_fft.h"
+#include "fft_q15.h"
+
+#define FFT_M (FFT_Q15_N / 2) // Pontos da FFT complexa interna
+
+_Static_assert(TABELAS_FFT_N == FFT_Q15_N, "tabelas_fft.h gerada para outro tamanho de FFT");
+
+static int16_t parte_real[FFT_M];
+static int16_t parte_imag[FFT_M];
+
+// W_N^i = cos(2*pi*i/N) - j sin(2*pi*i/N), com i em unidades de 1/FFT_Q15_N de volta
+static inline int32_t cosseno_q15(uint32_t i) { return tabela_seno_fft[i + FFT_Q15_N / 4]; }
+static inline int32_t seno_q15(uint32_t i) { return tabela_seno_fft[i]; }
+
+static inline int16_t janelar(const int16_t *entrada, uint32_t n) {
+    int32_t w = tabela_hann_fft[(n <= FFT_Q15_N / 2) ? n : FFT_Q15_N - n];
+    return (int16_t)((w * entrada[n]) >> 15);
+}
+
+// FFT complexa de FFT_M pontos no lugar; cada estágio divide por 2 (total 1/FFT_M)
+static void fft_complexa(void) {
+    for (uint32_t tamanho = 2; tamanho <= FFT_M; tamanho <<= 1) {
+        uint32_t meio = tamanho >> 1;
+        uint32_t passo = FFT_Q15_N / tamanho; // W_tamanho^k = W_N^(k * N / tamanho)
+
+        for (uint32_t k = 0; k < meio; k++) {
+            int32_t wr = cosseno_q15(k * passo);
+            int32_t wi = -seno_q15(k * passo);
+
+            for (uint32_t i = k; i < FFT_M; i += tamanho) {
+                uint32_t j = i + meio;
+                int32_t tr = (wr * parte_real[j] - wi * parte_imag[j]) >> 15;
+                int32_t ti = (wr * parte_imag[j] + wi * parte_real[j]) >> 15;
+                int32_t ar = parte_real[i];
+                int32_t ai = parte_imag[i];
+
+                parte_real[j] = (int16_t)((ar - tr) >> 1);
+                parte_imag[j] = (int16_t)((ai - ti) >> 1);
+                parte_real[i] = (int16_t)((ar + tr) >> 1);
+                parte_imag[i] = (int16_t)((ai + ti) >> 1);
+            }
+        }
+    }
+}
+
+void fft_q15_potencia(const int16_t *entrada, uint32_t *potencia) {
+    // Amostras pares na parte real e ímpares na imaginária, já janeladas e na
+    // ordem de bits invertidos
+    for (uint32_t m = 0; m < FFT_M; m++) {
+        uint32_t destino = tabela_bits_invertidos_fft[m];
+        parte_real[destino] = janelar(entrada, 2 * m);
+        parte_imag[destino] = janelar(entrada, 2 * m + 1);
+    }
+
+    fft_complexa();
+
+    // Separa os espectros par/ímpar: X[k] = Fe[k] + W_N^k Fo[k]
+    for (uint32_t k = 0; k < FFT_M; k++) {
+        uint32_t espelho = (FFT_M - k) & (FFT_M - 1);
+        int32_t zr = parte_real[k], zi = parte_imag[k];
+        int32_t cr = parte_real[espelho], ci = -parte_imag[espelho]; // conj(Z[M - k])
+
+        int32_t fer = (zr + cr) >> 1, fei = (zi + ci) >> 1;
+        int32_t forr = (zi - ci) >> 1, foi = (cr - zr) >> 1; // (Z - conj) / 2j
+
+        int32_t wr = cosseno_q15(k);
+        int32_t wi = -seno_q15(k);
+        int32_t xr = fer + ((wr * forr - wi * foi) >> 15);
+        int32_t xi = fei + ((wr * foi + wi * forr) >> 15);
+
+        // Meio bit a menos para que a soma dos quadrados caiba em 32 bits
+        xr >>= 1;
+        xi >>= 1;
+        potencia[k] = (uint32_t)(xr * xr) + (uint32_t)(xi * xi);
+    }
+}
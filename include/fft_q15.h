@@ -0,0 +1,25 @@
+/**
+ * @file fft_q15.h
+ * @brief FFT real de 512 pontos em ponto fixo (Q15) para o Cortex-M0+.
+ *
+ * A entrada real é empacotada numa FFT complexa de 256 pontos (radix-2,
+ * decimação no tempo, com escala de 1/2 por estágio para não saturar) e
+ * separada no fim. Só usa multiplicações 32x32, e as tabelas de seno, janela
+ * e inversão de bits vêm de tabelas_fft.h (geradas, em flash).
+ *
+ * Usa buffers estáticos: não é reentrante (chamar sempre do mesmo núcleo).
+ */
+#ifndef FFT_Q15_H
+#define FFT_Q15_H
+
+#include <stdint.h>
+
+#define FFT_Q15_N 512
+#define FFT_Q15_BINS (FFT_Q15_N / 2)
+
+// Aplica a janela de Hann a FFT_Q15_N amostras e calcula a potência |X[k]|^2
+// dos bins 0..FFT_Q15_BINS-1. A entrada deve caber em +-16384 (para que
+// |x[2m] + j x[2m+1]| < 32768); a saída vem escalada por 1/FFT_Q15_N.
+void fft_q15_potencia(const int16_t *entrada, uint32_t *potencia);
+
+#endif
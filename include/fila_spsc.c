@@ -0,0 +1,92 @@
+/**
+ * @file fila_spsc.c
+ * @brief Implementação da fila SPSC entre núcleos (ver fila_spsc.h).
+ */
+#include <string.h>
+#include "hardware/sync.h"
+#include "fila_spsc.h"
+
+void fila_spsc_iniciar(fila_spsc_t *fila, void *armazenamento, size_t tamanho_elemento, uint32_t capacidade) {
+    fila->elementos = armazenamento;
+    fila->tamanho_elemento = tamanho_elemento;
+    fila->capacidade = capacidade;
+    fila->escritos = 0;
+    fila->lidos = 0;
+}
+
+bool fila_spsc_inserir(fila_spsc_t *fila, const void *elemento) {
+    uint32_t escritos = fila->escritos;
+    if (escritos - fila->lidos >= fila->capacidade) {
+        return false;
+    }
+
+    uint32_t posicao = escritos & (fila->capacidade - 1);
+    memcpy(fila->elementos + posicao * fila->tamanho_elemento, elemento, fila->tamanho_elemento);
+
+    __dmb(); // O conteúdo precisa estar visível antes do índice
+    fila->escritos = escritos + 1;
+    return true;
+}
+
+bool fila_spsc_remover(fila_spsc_t *fila, void *destino) {
+    uint32_t lidos = fila->lidos;
+    if (fila->escritos == lidos) {
+        return false;
+    }
+    __dmb();
+
+    uint32_t posicao = lidos & (fila->capacidade - 1);
+    memcpy(destino, fila->elementos + posicao * fila->tamanho_elemento, fila->tamanho_elemento);
+
+    __dmb(); // Termina a cópia antes de liberar a posição para o produtor
+    fila->lidos = lidos + 1;
+    return true;
+}
+
+// Copia n elementos a partir da posição `inicio` do anel, em no máximo dois trechos
+static void copiar_do_anel(const fila_spsc_t *fila, uint32_t inicio, void *destino, size_t n) {
+    uint32_t posicao = inicio & (fila->capacidade - 1);
+    size_t ate_o_fim = fila->capacidade - posicao;
+    size_t primeiro = (n < ate_o_fim) ? n : ate_o_fim;
+
+    memcpy(destino, fila->elementos + posicao * fila->tamanho_elemento, primeiro * fila->tamanho_elemento);
+    memcpy((uint8_t *)destino + primeiro * fila->tamanho_elemento, fila->elementos,
+           (n - primeiro) * fila->tamanho_elemento);
+}
+
+static void copiar_para_o_anel(fila_spsc_t *fila, uint32_t inicio, const void *origem, size_t n) {
+    uint32_t posicao = inicio & (fila->capacidade - 1);
+    size_t ate_o_fim = fila->capacidade - posicao;
+    size_t primeiro = (n < ate_o_fim) ? n : ate_o_fim;
+
+    memcpy(fila->elementos + posicao * fila->tamanho_elemento, origem, primeiro * fila->tamanho_elemento);
+    memcpy(fila->elementos, (const uint8_t *)origem + primeiro * fila->tamanho_elemento,
+           (n - primeiro) * fila->tamanho_elemento);
+}
+
+size_t fila_spsc_inserir_varios(fila_spsc_t *fila, const void *elementos, size_t n) {
+    uint32_t escritos = fila->escritos;
+    size_t livres = fila->capacidade - (escritos - fila->lidos);
+    if (n > livres) n = livres;
+    if (n == 0) return 0;
+
+    copiar_para_o_anel(fila, escritos, elementos, n);
+
+    __dmb(); // O conteúdo precisa estar visível antes do índice
+    fila->escritos = escritos + (uint32_t)n;
+    return n;
+}
+
+size_t fila_spsc_remover_varios(fila_spsc_t *fila, void *destino, size_t n) {
+    uint32_t lidos = fila->lidos;
+    size_t disponiveis = fila->escritos - lidos;
+    if (n > disponiveis) n = disponiveis;
+    if (n == 0) return 0;
+    __dmb();
+
+    copiar_do_anel(fila, lidos, destino, n);
+
+    __dmb(); // Termina a cópia antes de liberar as posições para o produtor
+    fila->lidos = lidos + (uint32_t)n;
+    return n;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file fila_spsc.h
+ * @brief Fila circular sem trava para um produtor e um consumidor (SPSC).
+ *
+ * Usada para trocar mensagens entre os dois núcleos do RP2040: cada índice só
+ * é escrito por um dos lados, e as barreiras de memória garantem que o
+ * elemento esteja completo antes de o índice ser publicado.
+ */
+#ifndef FILA_SPSC_H
+#define FILA_SPSC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint8_t *elementos;
+    size_t tamanho_elemento;
+    uint32_t capacidade;        // Potência de 2
+    volatile uint32_t escritos; // Atualizado apenas pelo produtor
+    volatile uint32_t lidos;    // Atualizado apenas pelo consumidor
+} fila_spsc_t;
+
+// Associa a fila a um armazenamento de `capacidade` elementos (capacidade deve ser potência de 2)
+void fila_spsc_iniciar(fila_spsc_t *fila, void *armazenamento, size_t tamanho_elemento, uint32_t capacidade);
+
+// Copia o elemento para a fila; retorna false se ela estiver cheia
+bool fila_spsc_inserir(fila_spsc_t *fila, const void *elemento);
+
+// Copia o elemento mais antigo para `destino`; retorna false se a fila estiver vazia
+bool fila_spsc_remover(fila_spsc_t *fila, void *destino);
+
+// Copia até n elementos (um trecho contíguo de `elementos`); retorna quantos couberam
+size_t fila_spsc_inserir_varios(fila_spsc_t *fila, const void *elementos, size_t n);
+
+// Retira até n elementos para `destino`; retorna quantos havia
+size_t fila_spsc_remover_varios(fila_spsc_t *fila, void *destino, size_t n);
+
+static inline bool fila_spsc_vazia(const fila_spsc_t *fila) {
+    return fila->escritos == fila->lidos;
+}
+
+// Elementos na fila; do outro lado o valor só pode ter crescido (produtor) ou diminuído (consumidor)
+static inline uint32_t fila_spsc_ocupacao(const fila_spsc_t *fila) {
+    return fila->escritos - fila->lidos;
+}
+
+#endif
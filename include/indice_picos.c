@@ -0,0 +1,140 @@
+/**
+ * @file indice_picos.c
+ * @brief Construção incremental e consulta do índice de picos (ver indice_picos.h).
+ */
+#include "indice_picos.h"
+
+#define PICO_VAZIO ((pico_t){ .minimo = 255, .maximo = 0 })
+#define PICO_CENTRO ((pico_t){ .minimo = 128, .maximo = 128 })
+
+// Os níveis ficam em sequência no mesmo vetor: 4096, 1024, 256, 64 e 16 entradas
+static inline uint32_t capacidade_nivel(uint32_t nivel) {
+    return INDICE_PICOS_ENTRADAS_BASE >> (2 * nivel);
+}
+
+static inline pico_t *entradas_nivel(indice_picos_t *indice, uint32_t nivel) {
+    uint32_t deslocamento = 0;
+    for (uint32_t k = 0; k < nivel; k++) {
+        deslocamento += capacidade_nivel(k);
+    }
+    return &indice->entradas[deslocamento];
+}
+
+static inline const pico_t *entradas_nivel_const(const indice_picos_t *indice, uint32_t nivel) {
+    return entradas_nivel((indice_picos_t *)indice, nivel);
+}
+
+static inline void juntar(pico_t *destino, pico_t origem) {
+    if (origem.minimo < destino->minimo) destino->minimo = origem.minimo;
+    if (origem.maximo > destino->maximo) destino->maximo = origem.maximo;
+}
+
+// Fecha a entrada em formação do nível e a propaga para o nível de cima
+static void fechar_entrada(indice_picos_t *indice, uint32_t nivel) {
+    if (indice->n_acumulados[nivel] == 0) return;
+
+    pico_t entrada = indice->acumulado[nivel];
+    if (indice->n_entradas[nivel] < capacidade_nivel(nivel)) {
+        entradas_nivel(indice, nivel)[indice->n_entradas[nivel]++] = entrada;
+    }
+    indice->acumulado[nivel] = PICO_VAZIO;
+    indice->n_acumulados[nivel] = 0;
+
+    if (nivel + 1 < INDICE_PICOS_NIVEIS) {
+        juntar(&indice->acumulado[nivel + 1], entrada);
+        if (++indice->n_acumulados[nivel + 1] == INDICE_PICOS_FATOR) {
+            fechar_entrada(indice, nivel + 1);
+        }
+    }
+}
+
+void indice_picos_iniciar(indice_picos_t *indice, size_t total_amostras) {
+    uint32_t granularidade = INDICE_PICOS_GRANULARIDADE_MIN;
+    while ((uint64_t)granularidade * INDICE_PICOS_ENTRADAS_BASE < total_amostras) {
+        granularidade *= INDICE_PICOS_FATOR;
+    }
+
+    indice->amostras_por_entrada = granularidade;
+    indice->n_amostras = 0;
+    for (uint32_t k = 0; k < INDICE_PICOS_NIVEIS; k++) {
+        indice->n_entradas[k] = 0;
+        indice->acumulado[k] = PICO_VAZIO;
+        indice->n_acumulados[k] = 0;
+    }
+}
+
+void indice_picos_anexar(indice_picos_t *indice, const uint16_t *amostras, size_t n_amostras) {
+    uint32_t limite = indice->amostras_por_entrada * INDICE_PICOS_ENTRADAS_BASE;
+
+    size_t i = 0;
+    while (i < n_amostras && indice->n_amostras < limite) {
+        // Processa de uma vez o trecho que cabe na entrada atual do nível 0
+        uint32_t faltam = indice->amostras_por_entrada - indice->n_acumulados[0];
+        size_t n = n_amostras - i;
+        if (n > faltam) n = faltam;
+
+        uint16_t minimo = 0xFFFF, maximo = 0;
+        for (size_t j = i; j < i + n; j++) {
+            if (amostras[j] < minimo) minimo = amostras[j];
+            if (amostras[j] > maximo) maximo = amostras[j];
+        }
+        pico_t trecho = { .minimo = (uint8_t)(minimo >> 4), .maximo = (uint8_t)(maximo >> 4) };
+        juntar(&indice->acumulado[0], trecho);
+
+        indice->n_acumulados[0] += n;
+        indice->n_amostras += n;
+        i += n;
+
+        if (indice->n_acumulados[0] == indice->amostras_por_entrada) {
+            fechar_entrada(indice, 0);
+        }
+    }
+}
+
+void indice_picos_finalizar(indice_picos_t *indice) {
+    // De baixo para cima, para que cada nível receba a entrada parcial do anterior
+    for (uint32_t k = 0; k < INDICE_PICOS_NIVEIS; k++) {
+        fechar_entrada(indice, k);
+    }
+}
+
+void indice_picos_envelope(const indice_picos_t *indice, size_t inicio, size_t n_amostras_janela,
+                           size_t n_colunas, pico_t *saida) {
+    if (n_colunas == 0) return;
+
+    // Nível mais grosso cujas entradas ainda são menores que uma coluna
+    uint32_t nivel = 0;
+    uint32_t amostras_entrada = indice->amostras_por_entrada;
+    while (nivel + 1 < INDICE_PICOS_NIVEIS &&
+           (uint64_t)amostras_entrada * INDICE_PICOS_FATOR * n_colunas <= n_amostras_janela) {
+        amostras_entrada *= INDICE_PICOS_FATOR;
+        nivel++;
+    }
+
+    const pico_t *entradas = entradas_nivel_const(indice, nivel);
+    uint32_t n_entradas = indice->n_entradas[nivel];
+
+    for (size_t x = 0; x < n_colunas; x++) {
+        size_t a = inicio + x * n_amostras_janela / n_colunas;
+        size_t b = inicio + (x + 1) * n_amostras_janela / n_colunas;
+        size_t primeira = a / amostras_entrada;
+        size_t ultima = (b > a) ? (b - 1) / amostras_entrada : primeira;
+
+        pico_t coluna = PICO_VAZIO;
+        for (size_t e = primeira; e <= ultima && e < n_entradas; e++) {
+            juntar(&coluna, entradas[e]);
+        }
+        saida[x] = (coluna.minimo > coluna.maximo) ? PICO_CENTRO : coluna;
+    }
+}
+
+nivel_picos_t indice_picos_nivel(const pico_t *picos, size_t n_picos) {
+    pico_t extremos = PICO_VAZIO;
+    for (size_t x = 0; x < n_picos; x++) {
+        juntar(&extremos, picos[x]);
+    }
+    if (extremos.minimo > extremos.maximo) return (nivel_picos_t){ .centro = PICO_CENTRO.maximo, .excursao = 0 };
+
+    return (nivel_picos_t){ .centro = (uint8_t)((extremos.minimo + extremos.maximo + 1) / 2),
+                            .excursao = (uint8_t)((extremos.maximo - extremos.minimo + 1) / 2) };
+}
@@ -0,0 +1,63 @@
+/**
+ * @file indice_picos.h
+ * @brief Índice de picos (mínimo/máximo) em vários níveis de zoom.
+ *
+ * Construído bloco a bloco durante a captura: cada entrada do nível 0 resume
+ * `amostras_por_entrada` amostras e cada nível acima junta INDICE_PICOS_FATOR
+ * entradas do nível anterior. As visões (o resumo completo, zoom ou rolagem)
+ * saem do nível mais adequado em O(colunas), sem reler a gravação.
+ */
+#ifndef INDICE_PICOS_H
+#define INDICE_PICOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define INDICE_PICOS_NIVEIS 5
+#define INDICE_PICOS_FATOR 4
+#define INDICE_PICOS_GRANULARIDADE_MIN 32 // Menor quantidade de amostras por entrada do nível 0
+#define INDICE_PICOS_ENTRADAS_BASE 4096   // Entradas do nível 0 (os demais são 4x menores)
+
+// Envelope de um trecho, com as amostras de 12 bits reduzidas a 8 bits
+typedef struct {
+    uint8_t minimo;
+    uint8_t maximo;
+} pico_t;
+
+typedef struct {
+    uint32_t amostras_por_entrada; // Granularidade do nível 0
+    uint32_t n_amostras;
+    uint32_t n_entradas[INDICE_PICOS_NIVEIS];
+
+    // Entrada em formação de cada nível (amostras no nível 0, entradas filhas nos demais)
+    pico_t acumulado[INDICE_PICOS_NIVEIS];
+    uint32_t n_acumulados[INDICE_PICOS_NIVEIS];
+
+    pico_t entradas[INDICE_PICOS_ENTRADAS_BASE * 4 / 3 + INDICE_PICOS_NIVEIS];
+} indice_picos_t;
+
+// Prepara o índice para até `total_amostras`; a granularidade do nível 0 cresce em
+// potências de INDICE_PICOS_FATOR até que o nível 0 caiba em INDICE_PICOS_ENTRADAS_BASE
+void indice_picos_iniciar(indice_picos_t *indice, size_t total_amostras);
+
+// Acumula um bloco de amostras de 12 bits. Amostras além da capacidade são ignoradas.
+void indice_picos_anexar(indice_picos_t *indice, const uint16_t *amostras, size_t n_amostras);
+
+// Fecha as entradas parciais de todos os níveis (chamar ao fim da gravação)
+void indice_picos_finalizar(indice_picos_t *indice);
+
+// Envelope de `n_colunas` colunas cobrindo [inicio, inicio + n_amostras_janela).
+// Colunas além das amostras gravadas ficam centradas (128/128).
+void indice_picos_envelope(const indice_picos_t *indice, size_t inicio, size_t n_amostras_janela,
+                           size_t n_colunas, pico_t *saida);
+
+// Nível medido de um envelope (as colunas de um resumo), nos mesmos 8 bits: o centro fica entre
+// os extremos e a excursão vai dele ao mais afastado (0 sem colunas)
+typedef struct {
+    uint8_t centro;
+    uint8_t excursao;
+} nivel_picos_t;
+
+nivel_picos_t indice_picos_nivel(const pico_t *picos, size_t n_picos);
+
+#endif
@@ -0,0 +1,480 @@
+/**
+ * @file interface_usuario.c
+ * @brief Laço do núcleo 1: display OLED, LED RGB e log (ver interface_usuario.h).
+ */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#include "ssd1306.h"
+#include "fila_spsc.h"
+#include "visualizacao_ao_vivo.h"
+#include "espectro_audio.h"
+#include "audio_usb.h"
+#include "console_usb.h"
+#include "perfil_desempenho.h"
+#include "interface_usuario.h"
+
+// Zoom máximo da onda de um take, sobre a excursão medida: um take quase mudo não vira ruído em
+// tela cheia (excursão em níveis de 8 bits)
+#define GANHO_VISUAL_MAXIMO 8
+#define EXCURSAO_VISUAL_MINIMA (128 / GANHO_VISUAL_MAXIMO)
+
+static evento_interface_t armazenamento_eventos[N_EVENTOS_FILA_INTERFACE];
+_Static_assert(TAMANHO_TEXTO_LOG <= sizeof(resumo_onda_t), "texto do log aumenta os eventos da fila");
+static fila_spsc_t fila_eventos;
+static volatile uint32_t eventos_descartados = 0;
+static volatile uint32_t quadros_enviados = 0;
+static volatile uint32_t quadros_pulados = 0;
+
+static dsp_resumo_bloco_t armazenamento_resumos[N_RESUMOS_FILA_AO_VIVO];
+static fila_spsc_t fila_resumos;
+
+typedef struct {
+    uint16_t n_amostras;
+    uint16_t amostras[TAMANHO_BLOCO_ESPECTRO];
+} bloco_espectro_t;
+
+static bloco_espectro_t armazenamento_blocos_espectro[N_BLOCOS_FILA_ESPECTRO];
+static fila_spsc_t fila_blocos_espectro;
+static volatile uint32_t blocos_espectro_descartados = 0;
+
+// Cópia do modo no núcleo 0, para não copiar blocos que o núcleo 1 não usaria
+static visualizacao_t visualizacao_publicada = VISUALIZACAO_ONDA;
+
+// Estado da visualização ao vivo (núcleo 1)
+static bool ao_vivo_ativo = false;
+static uint32_t proximo_quadro_us = 0;
+static bool espectro_ativo = false;
+static uint32_t inicio_ao_vivo_us = 0;
+static uint32_t descartados_inicio_ao_vivo = 0;
+static bool (*volatile tarefa_fundo)(void) = NULL;
+
+// Framebuffer do display, acessado apenas pelo núcleo 1
+static ssd1306_framebuffer_t frame_buffer_display;
+
+#if PERFIL_HABILITADO
+#define PAGINA_SOBREPOSICAO_PERFIL 6 // Duas linhas de texto no pé da tela
+static bool sobreposicao_perfil = false;
+#endif
+
+// =================================================================================
+// Lado do núcleo 0: publicação de eventos
+// =================================================================================
+
+static void publicar_evento(const evento_interface_t *evento) {
+    if (fila_spsc_inserir(&fila_eventos, evento)) {
+        __sev(); // Acorda o núcleo 1 se ele estiver em __wfe()
+    } else {
+        eventos_descartados++;
+    }
+}
+
+void interface_log(const char *formato, ...) {
+    evento_interface_t evento = { .tipo = EVENTO_LOG };
+    va_list argumentos;
+    va_start(argumentos, formato);
+    vsnprintf(evento.texto, sizeof(evento.texto), formato, argumentos);
+    va_end(argumentos);
+    publicar_evento(&evento);
+}
+
+void interface_definir_led(bool vermelho, bool verde, bool azul) {
+    evento_interface_t evento = { .tipo = EVENTO_LED };
+    evento.led.vermelho = vermelho;
+    evento.led.verde = verde;
+    evento.led.azul = azul;
+    publicar_evento(&evento);
+}
+
+void interface_mostrar_resumo(const resumo_onda_t *resumo) {
+    evento_interface_t evento = { .tipo = EVENTO_MOSTRAR_ONDA };
+    evento.onda = *resumo;
+    publicar_evento(&evento);
+}
+
+void interface_apagar_tela(void) {
+    evento_interface_t evento = { .tipo = EVENTO_APAGAR_TELA };
+    publicar_evento(&evento);
+}
+
+void interface_ao_vivo(bool ativo) {
+    evento_interface_t evento = { .tipo = EVENTO_AO_VIVO };
+    evento.ao_vivo = ativo;
+    publicar_evento(&evento);
+}
+
+void interface_publicar_resumo_bloco(const dsp_resumo_bloco_t *resumo) {
+    if (fila_spsc_inserir(&fila_resumos, resumo)) {
+        __sev();
+    }
+}
+
+void interface_definir_visualizacao(visualizacao_t visualizacao) {
+    visualizacao_publicada = visualizacao;
+
+    evento_interface_t evento = { .tipo = EVENTO_VISUALIZACAO };
+    evento.visualizacao = visualizacao;
+    publicar_evento(&evento);
+}
+
+visualizacao_t interface_visualizacao(void) {
+    return visualizacao_publicada;
+}
+
+void interface_publicar_bloco_espectro(const uint16_t *amostras, size_t n_amostras) {
+    if (visualizacao_publicada != VISUALIZACAO_ESPECTRO) return;
+
+    static bloco_espectro_t bloco; // Só o núcleo 0 publica; fora da pilha, que é pequena
+    while (n_amostras > 0) {
+        size_t n = (n_amostras < TAMANHO_BLOCO_ESPECTRO) ? n_amostras : TAMANHO_BLOCO_ESPECTRO;
+        bloco.n_amostras = (uint16_t)n;
+        memcpy(bloco.amostras, amostras, n * sizeof(uint16_t));
+        if (!fila_spsc_inserir(&fila_blocos_espectro, &bloco)) {
+            blocos_espectro_descartados++;
+            return;
+        }
+        amostras += n;
+        n_amostras -= n;
+    }
+    __sev();
+}
+
+void interface_registrar_tarefa_fundo(bool (*tarefa)(void)) {
+    tarefa_fundo = tarefa;
+    __sev();
+}
+
+uint32_t interface_eventos_descartados(void) {
+    return eventos_descartados;
+}
+
+uint32_t interface_quadros_enviados(void) {
+    return quadros_enviados;
+}
+
+uint32_t interface_quadros_pulados(void) {
+    return quadros_pulados;
+}
+
+// =================================================================================
+// Lado do núcleo 1: periféricos da interface
+// =================================================================================
+
+static void inicializar_leds(void) {
+    gpio_init(PINO_LED_VERMELHO);
+    gpio_init(PINO_LED_VERDE);
+    gpio_init(PINO_LED_AZUL);
+    gpio_set_dir(PINO_LED_VERMELHO, GPIO_OUT);
+    gpio_set_dir(PINO_LED_VERDE, GPIO_OUT);
+    gpio_set_dir(PINO_LED_AZUL, GPIO_OUT);
+}
+
+static void definir_cor_led(bool vermelho, bool verde, bool azul) {
+    gpio_put(PINO_LED_VERMELHO, vermelho);
+    gpio_put(PINO_LED_VERDE, verde);
+    gpio_put(PINO_LED_AZUL, azul);
+}
+
+static void inicializar_comunicacao_i2c(void) {
+    i2c_init(i2c1, ssd1306_i2c_clock * 1000);
+    gpio_set_function(PINO_I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(PINO_I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(PINO_I2C_SDA);
+    gpio_pull_up(PINO_I2C_SCL);
+}
+
+// Chamado na interrupção do DMA quando um quadro termina de ser transferido
+static void quadro_enviado(void) {
+    quadros_enviados++;
+}
+
+// Envia por DMA só o que mudou; o framebuffer fica livre para o próximo desenho assim que a função retorna
+static void atualizar_display(ssd1306_framebuffer_t *framebuffer) {
+    PERFIL_INICIO(marca_envio);
+    while (!ssd1306_flush_async(framebuffer, quadro_enviado)) {
+        tight_loop_contents(); // Um envio em andamento e outro na fila: aguarda uma vaga
+    }
+    PERFIL_FIM(PERFIL_ENVIO_I2C, marca_envio);
+}
+
+#if PERFIL_HABILITADO
+// Carga dos núcleos e xruns sobre o que estiver na tela (a fonte só tem letras e dígitos)
+static void desenhar_sobreposicao_perfil(ssd1306_framebuffer_t *framebuffer) {
+    if (!sobreposicao_perfil) return;
+
+    medida_perfil_t medidas[PERFIL_N_ETAPAS];
+    uint32_t xruns[PERFIL_N_XRUNS];
+    perfil_ler(medidas, xruns);
+
+    char linha[17];
+    ssd1306_clear_pages(framebuffer, PAGINA_SOBREPOSICAO_PERFIL, PAGINA_SOBREPOSICAO_PERFIL + 1);
+    snprintf(linha, sizeof(linha), "CPU %3lu %3lu", (unsigned long)(perfil_carga_permil(0) / 10),
+             (unsigned long)(perfil_carga_permil(1) / 10));
+    ssd1306_draw_string(framebuffer, 0, 8 * PAGINA_SOBREPOSICAO_PERFIL, linha);
+    snprintf(linha, sizeof(linha), "XRUN %lu %lu", (unsigned long)xruns[PERFIL_XRUN_CAPTURA],
+             (unsigned long)xruns[PERFIL_XRUN_REPRODUCAO]);
+    ssd1306_draw_string(framebuffer, 0, 8 * (PAGINA_SOBREPOSICAO_PERFIL + 1), linha);
+}
+
+static void relatar_perfil(void) {
+    medida_perfil_t medidas[PERFIL_N_ETAPAS];
+    uint32_t xruns[PERFIL_N_XRUNS];
+    perfil_ler(medidas, xruns);
+
+    printf("Perfil (ciclos): etapa, n, min, med, max\n");
+    for (int i = 0; i < PERFIL_N_ETAPAS; i++) {
+        if (medidas[i].n == 0) continue;
+        printf("  %-16s %8lu %8lu %8lu %8lu\n", perfil_nome_etapa((etapa_perfil_t)i), (unsigned long)medidas[i].n,
+               (unsigned long)medidas[i].minimo, (unsigned long)(medidas[i].total / medidas[i].n),
+               (unsigned long)medidas[i].maximo);
+    }
+    printf("Carga: núcleo 0 %lu.%lu%%, núcleo 1 %lu.%lu%%\n",
+           (unsigned long)(perfil_carga_permil(0) / 10), (unsigned long)(perfil_carga_permil(0) % 10),
+           (unsigned long)(perfil_carga_permil(1) / 10), (unsigned long)(perfil_carga_permil(1) % 10));
+    printf("Xruns: captura %lu (overrun), reprodução %lu (underrun); display: %lu quadros pulados\n",
+           (unsigned long)xruns[PERFIL_XRUN_CAPTURA], (unsigned long)xruns[PERFIL_XRUN_REPRODUCAO],
+           (unsigned long)quadros_pulados);
+}
+
+// Comandos de uma tecla no console USB
+static void atender_console(void) {
+    int caractere = getchar_timeout_us(0);
+    switch (caractere) {
+        case 'p':
+            relatar_perfil();
+            break;
+        case 'o':
+            sobreposicao_perfil = !sobreposicao_perfil;
+            if (!sobreposicao_perfil) {
+                ssd1306_clear_pages(&frame_buffer_display, PAGINA_SOBREPOSICAO_PERFIL, PAGINA_SOBREPOSICAO_PERFIL + 1);
+            }
+            desenhar_sobreposicao_perfil(&frame_buffer_display);
+            atualizar_display(&frame_buffer_display);
+            break;
+        case 'z':
+            perfil_zerar();
+            printf("Perfil zerado.\n");
+            break;
+        default:
+            break;
+    }
+}
+#endif
+
+// Mapeia um nível de pico de 8 bits para a linha do display: a excursão medida do take ocupa a
+// meia altura, em torno do centro medido (a polarização que sobrar não desloca a onda)
+static int y_para_nivel_de_pico(uint8_t nivel, nivel_picos_t medido, int y_centro, int altura_desenho) {
+    int amplitude = (int)nivel - (int)medido.centro;
+    return y_centro - amplitude * (altura_desenho / 2) / medido.excursao;
+}
+
+static void mostrar_waveform_display(ssd1306_framebuffer_t *framebuffer, const resumo_onda_t *resumo) {
+    PERFIL_INICIO(marca_desenho);
+
+    // O título (página 0) não muda; apenas as páginas da onda são apagadas
+    ssd1306_draw_string(framebuffer, 10, 0, "Onda capturada"); // Título Alterado
+    ssd1306_clear_pages(framebuffer, 1, ssd1306_n_pages - 1);
+
+    // Define a área de desenho e o centro vertical
+    int y_offset = 12; // Espaço para o título (fora da página 0)
+    int altura_desenho = DISPLAY_HEIGHT - y_offset;
+    int y_centro = y_offset + (altura_desenho / 2);
+
+    // A escala sai do nível do próprio take, com zoom limitado a GANHO_VISUAL_MAXIMO
+    nivel_picos_t medido = indice_picos_nivel(resumo->picos, resumo->n_colunas);
+    if (medido.excursao < EXCURSAO_VISUAL_MINIMA) medido.excursao = EXCURSAO_VISUAL_MINIMA;
+
+    for (size_t x = 0; x < resumo->n_colunas; x++) {
+        // O máximo fica em cima: menor y na tela
+        int y_topo = y_para_nivel_de_pico(resumo->picos[x].maximo, medido, y_centro, altura_desenho);
+        int y_base = y_para_nivel_de_pico(resumo->picos[x].minimo, medido, y_centro, altura_desenho);
+
+        // Garante que o desenho não saia da área útil (clipping)
+        if (y_topo < y_offset) y_topo = y_offset;
+        if (y_topo >= DISPLAY_HEIGHT) y_topo = DISPLAY_HEIGHT - 1;
+        if (y_base < y_offset) y_base = y_offset;
+        if (y_base >= DISPLAY_HEIGHT) y_base = DISPLAY_HEIGHT - 1;
+
+        // Desenha o envelope da coluna, do mínimo ao máximo (uma máscara por página)
+        ssd1306_draw_vspan(framebuffer, (int)x, y_topo, y_base, true);
+    }
+
+#if PERFIL_HABILITADO
+    desenhar_sobreposicao_perfil(framebuffer);
+#endif
+    PERFIL_FIM(PERFIL_DESENHO, marca_desenho);
+
+    // Envia ao display apenas as colunas alteradas de cada página
+    atualizar_display(framebuffer);
+}
+
+static void apagar_tela(void) {
+    ssd1306_clear_pages(&frame_buffer_display, 0, ssd1306_n_pages - 1);
+    atualizar_display(&frame_buffer_display);
+}
+
+// Custo medido do analisador, ao fim de cada sessão ao vivo em que ele rodou
+static void relatar_espectro(void) {
+    estatisticas_espectro_t estatisticas = espectro_estatisticas();
+    uint32_t duracao_us = time_us_32() - inicio_ao_vivo_us;
+    if (estatisticas.n_espectros == 0 || duracao_us == 0) return;
+
+    uint32_t ciclos_medios = (uint32_t)(estatisticas.ciclos_total / estatisticas.n_espectros);
+    uint32_t espectros_por_s_x10 = (uint32_t)((uint64_t)estatisticas.n_espectros * 10000000u / duracao_us);
+    printf("Espectro: %lu calculados, %lu.%lu/s, %lu ciclos em media (max %lu), %lu blocos perdidos\n",
+           (unsigned long)estatisticas.n_espectros, (unsigned long)(espectros_por_s_x10 / 10),
+           (unsigned long)(espectros_por_s_x10 % 10), (unsigned long)ciclos_medios,
+           (unsigned long)estatisticas.ciclos_max,
+           (unsigned long)(blocos_espectro_descartados - descartados_inicio_ao_vivo));
+}
+
+static void tratar_evento(const evento_interface_t *evento) {
+    switch (evento->tipo) {
+        case EVENTO_LOG:
+            fputs(evento->texto, stdout);
+            break;
+        case EVENTO_LED:
+            definir_cor_led(evento->led.vermelho, evento->led.verde, evento->led.azul);
+            break;
+        case EVENTO_MOSTRAR_ONDA:
+            mostrar_waveform_display(&frame_buffer_display, &evento->onda);
+            break;
+        case EVENTO_APAGAR_TELA:
+            apagar_tela();
+            break;
+        case EVENTO_AO_VIVO:
+            ao_vivo_ativo = evento->ao_vivo;
+            if (ao_vivo_ativo) {
+                ao_vivo_iniciar();
+                espectro_iniciar();
+                proximo_quadro_us = inicio_ao_vivo_us = time_us_32();
+                descartados_inicio_ao_vivo = blocos_espectro_descartados;
+            } else {
+                relatar_espectro();
+                apagar_tela();
+            }
+            break;
+        case EVENTO_VISUALIZACAO:
+            espectro_ativo = (evento->visualizacao == VISUALIZACAO_ESPECTRO);
+            ao_vivo_mostrar_espectro(espectro_ativo);
+            break;
+    }
+}
+
+// Consome os resumos e blocos pendentes e, no ritmo de TAXA_QUADROS_AO_VIVO, desenha um
+// quadro. Se o quadro anterior ainda estiver saindo pelo I2C o novo é pulado: o trabalho
+// por quadro é limitado e as filas nunca esperam pelo display.
+static void servir_ao_vivo(void) {
+    dsp_resumo_bloco_t resumo;
+    while (fila_spsc_remover(&fila_resumos, &resumo)) {
+        if (ao_vivo_ativo) {
+            ao_vivo_consumir(&resumo);
+        }
+    }
+    static bloco_espectro_t bloco; // Fora da pilha, como no lado do núcleo 0
+    while (fila_spsc_remover(&fila_blocos_espectro, &bloco)) {
+        if (ao_vivo_ativo && espectro_ativo) {
+            espectro_anexar(bloco.amostras, bloco.n_amostras);
+        }
+    }
+    if (!ao_vivo_ativo) return;
+
+    uint32_t agora = time_us_32();
+    if ((int32_t)(agora - proximo_quadro_us) < 0) return;
+
+    proximo_quadro_us += 1000000u / TAXA_QUADROS_AO_VIVO;
+    if ((int32_t)(agora - proximo_quadro_us) >= 0) {
+        proximo_quadro_us = agora + 1000000u / TAXA_QUADROS_AO_VIVO; // Atrasado: não acumula quadros
+    }
+
+    // Um espectro por quadro, calculado mesmo quando o desenho é pulado
+    if (espectro_ativo && espectro_pronto()) {
+        int8_t colunas_dbfs[ESPECTRO_N_COLUNAS];
+        espectro_calcular(colunas_dbfs);
+        ao_vivo_consumir_espectro(colunas_dbfs);
+    }
+
+    if (ssd1306_dma_busy()) {
+        quadros_pulados++;
+        return;
+    }
+    PERFIL_INICIO(marca_desenho);
+    ao_vivo_desenhar(&frame_buffer_display);
+#if PERFIL_HABILITADO
+    desenhar_sobreposicao_perfil(&frame_buffer_display);
+#endif
+    PERFIL_FIM(PERFIL_DESENHO, marca_desenho);
+    atualizar_display(&frame_buffer_display);
+}
+
+#if PERFIL_HABILITADO
+// Fecha a janela de carga e, com a sobreposição ligada fora do modo ao vivo, a redesenha
+static void servir_perfil(void) {
+    uint32_t carga_anterior = perfil_carga_permil(0) ^ (perfil_carga_permil(1) << 16);
+    perfil_atualizar_carga();
+    bool janela_nova = carga_anterior != (perfil_carga_permil(0) ^ (perfil_carga_permil(1) << 16));
+
+    if (sobreposicao_perfil && janela_nova && !ao_vivo_ativo && !ssd1306_dma_busy()) {
+        desenhar_sobreposicao_perfil(&frame_buffer_display);
+        atualizar_display(&frame_buffer_display);
+    }
+}
+#endif
+
+static void nucleo1_principal(void) {
+    PERFIL_INICIAR_NUCLEO();
+    audio_usb_iniciar(); // O TinyUSB (e sua interrupção) fica neste núcleo, atendido pelo laço abaixo
+    console_usb_iniciar();
+    console_usb_aguardar_conexao(2000); // Pausa para permitir a conexão do terminal serial
+
+    inicializar_leds();
+    definir_cor_led(0, 0, 0); // Garante que os LEDs comecem apagados
+
+    inicializar_comunicacao_i2c();
+    ssd1306_init(); // Inicializa o controlador do display
+    ssd1306_framebuffer_init(&frame_buffer_display);
+    ssd1306_dma_init(); // Transferências do display por DMA, com interrupção neste núcleo
+    apagar_tela();
+#if PERFIL_HABILITADO
+    printf("Perfil: 'p' relatório, 'o' sobreposição no display, 'z' zera as medidas\n");
+#endif
+
+    evento_interface_t evento;
+    while (true) {
+        console_usb_atender();
+        while (fila_spsc_remover(&fila_eventos, &evento)) {
+            tratar_evento(&evento);
+        }
+        servir_ao_vivo();
+#if PERFIL_HABILITADO
+        atender_console();
+        servir_perfil();
+#endif
+
+        bool (*tarefa)(void) = tarefa_fundo;
+        if (tarefa && tarefa()) {
+            continue; // Ainda há trabalho: volta a checar a fila antes da próxima etapa
+        }
+        PERFIL_OCIOSO_INICIO();
+#if PERFIL_HABILITADO
+        // Uma tecla no console chega pela interrupção do USB, que também acorda o __wfe;
+        // o limite de tempo só garante uma janela de carga por segundo
+        best_effort_wfe_or_timeout(make_timeout_time_ms(PERFIL_JANELA_CARGA_MS));
+#else
+        __wfe(); // Dorme até o núcleo 0 publicar um novo evento ou o USB pedir o tud_task()
+#endif
+        PERFIL_OCIOSO_FIM();
+    }
+}
+
+void interface_iniciar(void) {
+    fila_spsc_iniciar(&fila_eventos, armazenamento_eventos, sizeof(evento_interface_t), N_EVENTOS_FILA_INTERFACE);
+    fila_spsc_iniciar(&fila_resumos, armazenamento_resumos, sizeof(dsp_resumo_bloco_t), N_RESUMOS_FILA_AO_VIVO);
+    fila_spsc_iniciar(&fila_blocos_espectro, armazenamento_blocos_espectro, sizeof(bloco_espectro_t), N_BLOCOS_FILA_ESPECTRO);
+    multicore_launch_core1(nucleo1_principal);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file interface_usuario.h
+ * @brief Interface com o usuário (display, LEDs e stdio) executada no núcleo 1.
+ *
+ * O núcleo 0 fica dedicado ao áudio (ADC/DMA/PWM e DSP) e apenas publica
+ * eventos numa fila SPSC; o núcleo 1 os consome e faz o trabalho lento
+ * (I2C do SSD1306, printf via USB), que assim nunca atrasa o áudio.
+ * As funções abaixo são chamadas pelo núcleo 0 e nunca bloqueiam: se a fila
+ * estiver cheia, o evento é descartado e contabilizado.
+ */
+#ifndef INTERFACE_USUARIO_H
+#define INTERFACE_USUARIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuracao.h"
+#include "indice_picos.h"
+#include "dsp_audio.h"
+
+#define TAMANHO_TEXTO_LOG 256 // Cabe no evento sem aumentá-lo: o resumo da onda da união já é maior
+#define N_EVENTOS_FILA_INTERFACE 16
+#define N_RESUMOS_FILA_AO_VIVO 32 // ~170 ms de blocos a 48 kHz
+#define TAMANHO_BLOCO_ESPECTRO 256 // Amostras por elemento da fila do espectro
+#define N_BLOCOS_FILA_ESPECTRO 8   // ~43 ms a 48 kHz
+
+typedef enum {
+    EVENTO_LOG,
+    EVENTO_LED,
+    EVENTO_MOSTRAR_ONDA,
+    EVENTO_APAGAR_TELA,
+    EVENTO_AO_VIVO,
+    EVENTO_VISUALIZACAO,
+} tipo_evento_interface_t;
+
+// O que a visualização ao vivo mostra abaixo do medidor
+typedef enum {
+    VISUALIZACAO_ONDA,
+    VISUALIZACAO_ESPECTRO,
+} visualizacao_t;
+
+// Resumo da forma de onda: envelope mínimo/máximo (8 bits) de cada coluna do display
+typedef struct {
+    uint16_t n_colunas;
+    pico_t picos[DISPLAY_WIDTH];
+} resumo_onda_t;
+
+typedef struct {
+    tipo_evento_interface_t tipo;
+    union {
+        char texto[TAMANHO_TEXTO_LOG];
+        struct { bool vermelho, verde, azul; } led;
+        resumo_onda_t onda;
+        bool ao_vivo;
+        visualizacao_t visualizacao;
+    };
+} evento_interface_t;
+
+// Lança o núcleo 1, que inicializa stdio, LEDs e display e passa a consumir a fila
+void interface_iniciar(void);
+
+// Equivalente a printf, executado pelo núcleo 1 (texto truncado em TAMANHO_TEXTO_LOG)
+void interface_log(const char *formato, ...);
+
+void interface_definir_led(bool vermelho, bool verde, bool azul);
+
+// Pede ao núcleo 1 o desenho de um resumo da onda montado pelo chamador
+void interface_mostrar_resumo(const resumo_onda_t *resumo);
+
+void interface_apagar_tela(void);
+
+// Liga/desliga o osciloscópio e o medidor ao vivo (desligar apaga a tela)
+void interface_ao_vivo(bool ativo);
+
+// Entrega o resumo de um bloco de áudio à visualização ao vivo. Fila própria,
+// separada dos eventos; descartado se cheia.
+void interface_publicar_resumo_bloco(const dsp_resumo_bloco_t *resumo);
+
+// Escolhe entre onda e espectro na visualização ao vivo (vale para a próxima também)
+void interface_definir_visualizacao(visualizacao_t visualizacao);
+
+visualizacao_t interface_visualizacao(void);
+
+// Entrega amostras brutas ao analisador de espectro do núcleo 1. Só copia algo
+// no modo espectro; blocos que não couberem na fila são descartados.
+void interface_publicar_bloco_espectro(const uint16_t *amostras, size_t n_amostras);
+
+// Registra uma tarefa executada pelo núcleo 1 entre os eventos (ex.: escrita na flash).
+// Ela deve retornar true enquanto tiver trabalho pendente; caso contrário o núcleo 1
+// dorme até o próximo __sev() do núcleo 0.
+void interface_registrar_tarefa_fundo(bool (*tarefa)(void));
+
+// Eventos perdidos por fila cheia
+uint32_t interface_eventos_descartados(void);
+
+// Quadros já transferidos ao display (contados na conclusão do DMA)
+uint32_t interface_quadros_enviados(void);
+
+// Quadros ao vivo pulados porque o envio anterior ao display ainda não havia terminado
+uint32_t interface_quadros_pulados(void);
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file looper_audio.c
+ * @brief Leitura e overdub do laço com as posições das duas pontas (ver looper_audio.h).
+ */
+#include <string.h>
+#include "dsp_audio.h"
+#include "looper_audio.h"
+
+void looper_iniciar(looper_t *looper, uint16_t *memoria, size_t capacidade, int32_t realimentacao_q15) {
+    looper->laco = memoria;
+    looper->capacidade = capacidade;
+    looper->comprimento = 0;
+    looper->gravadas = 0;
+    looper->posicao_saida = 0;
+    looper->posicao_entrada = 0;
+    looper->deslocamento = 0;
+    looper->realimentacao_q15 = realimentacao_q15;
+    looper->sobrepondo = false;
+    looper->blocos_misturados = 0;
+}
+
+void looper_alinhar(looper_t *looper, int32_t deslocamento) {
+    looper->deslocamento = deslocamento;
+
+    // Entrada atrasada em relação à saída: o começo do laço nunca é escrito e fica em silêncio
+    looper->gravadas = 0;
+    while (deslocamento > 0 && looper->gravadas < looper->capacidade && looper->gravadas < (size_t)deslocamento) {
+        looper->laco[looper->gravadas++] = DSP_AMOSTRA_ZERO;
+    }
+}
+
+void looper_ler_bloco(looper_t *looper, uint16_t *saida, size_t n_amostras) {
+    if (!looper_fechado(looper)) {
+        for (size_t i = 0; i < n_amostras; i++) saida[i] = DSP_AMOSTRA_ZERO;
+    } else {
+        size_t posicao = looper->posicao_saida % looper->comprimento;
+        size_t feitas = 0;
+        while (feitas < n_amostras) {
+            size_t trecho = looper->comprimento - posicao;
+            if (trecho > n_amostras - feitas) trecho = n_amostras - feitas;
+            memcpy(saida + feitas, looper->laco + posicao, trecho * sizeof(uint16_t));
+            feitas += trecho;
+            posicao = 0;
+        }
+    }
+    looper->posicao_saida += (uint32_t)n_amostras;
+}
+
+// Primeira passada: a amostra de entrada vai para a posição de saída em que teria sido ouvida
+static void gravar_primeira_passada(looper_t *looper, const uint16_t *entrada, size_t n_amostras) {
+    // O laço é escrito sem lacunas: a primeira amostra útil cai em `gravadas`
+    int32_t destino = (int32_t)looper->posicao_entrada + looper->deslocamento;
+    size_t inicio = 0;
+    if (destino < 0) {
+        // Amostras de antes do disparo da saída (o atraso do decimador) ficam de fora
+        inicio = ((size_t)-destino < n_amostras) ? (size_t)-destino : n_amostras;
+    }
+
+    size_t n = n_amostras - inicio;
+    if (n > looper->capacidade - looper->gravadas) n = looper->capacidade - looper->gravadas;
+    memcpy(looper->laco + looper->gravadas, entrada + inicio, n * sizeof(uint16_t));
+    looper->gravadas += n;
+
+    // Sem espaço para mais uma amostra, o laço fecha com a memória inteira
+    if (looper->gravadas == looper->capacidade) {
+        looper->comprimento = looper->capacidade;
+    }
+}
+
+void looper_escrever_bloco(looper_t *looper, const uint16_t *entrada, size_t n_amostras) {
+    if (!looper_fechado(looper)) {
+        gravar_primeira_passada(looper, entrada, n_amostras);
+    } else if (looper->sobrepondo) {
+        uint32_t destino = (uint32_t)((int32_t)looper->posicao_entrada + looper->deslocamento);
+        size_t posicao = destino % looper->comprimento;
+        size_t feitas = 0;
+        while (feitas < n_amostras) {
+            size_t trecho = looper->comprimento - posicao;
+            if (trecho > n_amostras - feitas) trecho = n_amostras - feitas;
+            dsp_misturar_bloco(looper->laco + posicao, entrada + feitas, trecho, looper->realimentacao_q15);
+            feitas += trecho;
+            posicao = 0;
+        }
+        looper->blocos_misturados++;
+    }
+    looper->posicao_entrada += (uint32_t)n_amostras;
+}
+
+bool looper_fechar(looper_t *looper) {
+    if (looper_fechado(looper) || looper->gravadas < LOOPER_MINIMO_AMOSTRAS) return false;
+    looper->comprimento = looper->gravadas;
+    return true;
+}
+
+void looper_sobrepor(looper_t *looper, bool sobrepor) {
+    looper->sobrepondo = sobrepor && looper_fechado(looper);
+}
+
+void looper_pular_saida(looper_t *looper, uint32_t n_amostras) {
+    looper->posicao_saida += n_amostras;
+}
+
+void looper_pular_entrada(looper_t *looper, uint32_t n_amostras) {
+    if (!looper_fechado(looper)) {
+        // Mantém `gravadas` na posição de saída da próxima amostra de entrada, como em looper_alinhar
+        int32_t fim = (int32_t)(looper->posicao_entrada + n_amostras) + looper->deslocamento;
+        while (fim > 0 && looper->gravadas < looper->capacidade && looper->gravadas < (size_t)fim) {
+            looper->laco[looper->gravadas++] = DSP_AMOSTRA_ZERO;
+        }
+        if (looper->gravadas == looper->capacidade) {
+            looper->comprimento = looper->capacidade;
+        }
+    }
+    looper->posicao_entrada += n_amostras;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file looper_audio.h
+ * @brief Looper com overdub: a saída toca um laço na memória enquanto a captura grava por cima.
+ *
+ * As duas pontas trabalham em blocos sobre o mesmo laço. A saída lê à frente
+ * (a fila de reprodução tem N_BLOCOS_FILA_REPRODUCAO blocos) e a captura
+ * escreve atrás (o bloco só chega depois de completo), então uma amostra
+ * misturada agora é ouvida na próxima volta. Com o overdub ligado, cada bloco
+ * capturado é somado ao laço com dsp_misturar_bloco: a passada anterior decai
+ * pela realimentação e tudo satura em 12 bits.
+ *
+ * As posições contam amostras desde o disparo de cada DMA. A amostra de
+ * entrada i cai na posição de saída i + deslocamento, o que alinha o que se
+ * grava com o que tocava quando foi ouvido: o deslocamento é a diferença
+ * entre os disparos da captura e da saída, menos o atraso do decimador
+ * (CAPTURA_ATRASO_AMOSTRAS).
+ *
+ * Na primeira passada a saída fica em silêncio e a entrada é copiada a partir
+ * do início do laço; looper_fechar() fixa o comprimento no que já foi gravado.
+ * Tudo roda no núcleo 0, fora de interrupção.
+ */
+#ifndef LOOPER_AUDIO_H
+#define LOOPER_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Por baixo disto a leitura à frente alcançaria a escrita atrasada na mesma volta
+#define LOOPER_MINIMO_AMOSTRAS 2048
+
+typedef struct {
+    uint16_t *laco;
+    size_t capacidade;         // Amostras de 12 bits na memória do laço
+    size_t comprimento;        // 0 até fechar
+    size_t gravadas;           // Primeira passada: amostras escritas desde o início do laço
+    uint32_t posicao_saida;    // Amostras entregues à saída desde o disparo dela
+    uint32_t posicao_entrada;  // Amostras recebidas da captura desde o disparo dela
+    int32_t deslocamento;      // Posição de saída da amostra de entrada 0
+    int32_t realimentacao_q15;
+    bool sobrepondo;
+    uint32_t blocos_misturados;
+} looper_t;
+
+// O laço ocupa `memoria` (capacidade em amostras); começa na primeira passada, sem deslocamento
+void looper_iniciar(looper_t *looper, uint16_t *memoria, size_t capacidade, int32_t realimentacao_q15);
+
+// Fixa o deslocamento da entrada em relação à saída (antes do primeiro bloco capturado)
+void looper_alinhar(looper_t *looper, int32_t deslocamento);
+
+// Próximo bloco da saída: silêncio na primeira passada, depois o laço em volta
+void looper_ler_bloco(looper_t *looper, uint16_t *saida, size_t n_amostras);
+
+// Bloco capturado: copiado na primeira passada (que fecha sozinha com o laço cheio), misturado
+// com o overdub ligado e só contado com ele desligado
+void looper_escrever_bloco(looper_t *looper, const uint16_t *entrada, size_t n_amostras);
+
+// Encerra a primeira passada; false se ela ainda tem menos de LOOPER_MINIMO_AMOSTRAS
+bool looper_fechar(looper_t *looper);
+
+static inline bool looper_fechado(const looper_t *looper) {
+    return looper->comprimento > 0;
+}
+
+// Liga ou desliga o overdub (só depois de fechado)
+void looper_sobrepor(looper_t *looper, bool sobrepor);
+
+// A saída inseriu silêncio por falta de blocos: os seguintes tocam `n_amostras` mais tarde
+void looper_pular_saida(looper_t *looper, uint32_t n_amostras);
+
+// A captura perdeu blocos: o próximo foi ouvido `n_amostras` mais tarde. Na primeira passada o
+// trecho vira silêncio no laço; depois, o overdub só retoma na posição certa.
+void looper_pular_entrada(looper_t *looper, uint32_t n_amostras);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file perfil_desempenho.c
+ * @brief Acúmulo das medidas de desempenho (ver perfil_desempenho.h).
+ */
+#include "perfil_desempenho.h"
+
+#if PERFIL_HABILITADO
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    medida_perfil_t medida;
+    volatile bool zerar; // Posto pelo leitor; atendido por quem escreve
+} etapa_t;
+
+// Tempo ocioso acumulado por núcleo (µs do timer, que é comum aos dois)
+typedef struct {
+    volatile bool ocioso;
+    volatile uint32_t inicio_us;
+    volatile uint32_t total_us;
+    // Janela de carga (só o núcleo que chama perfil_atualizar_carga mexe aqui)
+    uint32_t ocioso_anterior_us;
+    uint32_t carga_permil;
+} nucleo_t;
+
+static etapa_t etapas[PERFIL_N_ETAPAS];
+static volatile uint32_t xruns[PERFIL_N_XRUNS];
+static nucleo_t nucleos[2];
+static uint32_t inicio_janela_us = 0;
+
+static const char *const nomes_etapas[PERFIL_N_ETAPAS] = {
+    [PERFIL_CAPTURA_INICIO] = "captura (início)",
+    [PERFIL_DECIMACAO] = "decimação",
+    [PERFIL_FILTRO] = "filtro",
+    [PERFIL_BLOQUEIO_DC] = "bloqueio DC",
+    [PERFIL_AGC] = "AGC",
+    [PERFIL_CODIFICACAO] = "codificação",
+    [PERFIL_BLOCO_GRAVACAO] = "bloco gravação",
+    [PERFIL_REAMOSTRAGEM] = "reamostragem",
+    [PERFIL_GANHO] = "ganho",
+    [PERFIL_CONVERSAO_SAIDA] = "conversão saída",
+    [PERFIL_BLOCO_REPRODUCAO] = "bloco reprodução",
+    [PERFIL_MISTURA_LOOPER] = "mistura looper",
+    [PERFIL_DETECTOR_DISPARO] = "detector disparo",
+    [PERFIL_DESENHO] = "desenho",
+    [PERFIL_ENVIO_I2C] = "envio I2C",
+};
+
+void perfil_iniciar_nucleo(void) {
+    contador_ciclos_iniciar();
+    nucleo_t *nucleo = &nucleos[get_core_num()];
+    nucleo->ocioso = false;
+    nucleo->ocioso_anterior_us = nucleo->total_us;
+    if (inicio_janela_us == 0) inicio_janela_us = time_us_32();
+}
+
+void __not_in_flash_func(perfil_registrar)(etapa_perfil_t etapa, uint32_t ciclos) {
+    etapa_t *e = &etapas[etapa];
+    if (e->zerar || e->medida.n == 0) {
+        e->medida = (medida_perfil_t){ .minimo = UINT32_MAX };
+        e->zerar = false;
+    }
+    e->medida.n++;
+    e->medida.total += ciclos;
+    if (ciclos < e->medida.minimo) e->medida.minimo = ciclos;
+    if (ciclos > e->medida.maximo) e->medida.maximo = ciclos;
+}
+
+void __not_in_flash_func(perfil_contar_xrun)(xrun_perfil_t tipo) {
+    xruns[tipo]++;
+}
+
+void __not_in_flash_func(perfil_ocioso_inicio)(void) {
+    nucleo_t *nucleo = &nucleos[get_core_num()];
+    if (nucleo->ocioso) return; // Polling: só a primeira volta da espera marca o início
+    nucleo->inicio_us = time_us_32();
+    nucleo->ocioso = true;
+}
+
+void __not_in_flash_func(perfil_ocioso_fim)(void) {
+    nucleo_t *nucleo = &nucleos[get_core_num()];
+    if (!nucleo->ocioso) return;
+    nucleo->total_us += time_us_32() - nucleo->inicio_us;
+    nucleo->ocioso = false;
+}
+
+// Ocioso até agora, incluindo uma espera ainda em curso (o __wfe do núcleo 1 pode durar a janela toda)
+static uint32_t ocioso_ate(const nucleo_t *nucleo, uint32_t agora) {
+    uint32_t total = nucleo->total_us;
+    bool ocioso = nucleo->ocioso;
+    uint32_t inicio = nucleo->inicio_us;
+    // Se o total mudou entre as leituras a espera acabou enquanto líamos, e ele já a inclui
+    if (ocioso && total == nucleo->total_us) total += agora - inicio;
+    return total;
+}
+
+void perfil_atualizar_carga(void) {
+    uint32_t agora = time_us_32();
+    uint32_t janela = agora - inicio_janela_us;
+    if (janela < PERFIL_JANELA_CARGA_MS * 1000u) return;
+
+    for (int i = 0; i < 2; i++) {
+        uint32_t ocioso = ocioso_ate(&nucleos[i], agora);
+        uint32_t ocioso_janela = ocioso - nucleos[i].ocioso_anterior_us;
+        nucleos[i].ocioso_anterior_us = ocioso;
+        if (ocioso_janela > janela) ocioso_janela = janela;
+        nucleos[i].carga_permil = 1000u - (uint32_t)((uint64_t)ocioso_janela * 1000u / janela);
+    }
+    inicio_janela_us = agora;
+}
+
+uint32_t perfil_carga_permil(uint32_t nucleo) {
+    return (nucleo < 2) ? nucleos[nucleo].carga_permil : 0;
+}
+
+void perfil_ler(medida_perfil_t medidas[PERFIL_N_ETAPAS], uint32_t contadores_xrun[PERFIL_N_XRUNS]) {
+    for (int i = 0; i < PERFIL_N_ETAPAS; i++) {
+        medidas[i] = etapas[i].zerar ? (medida_perfil_t){ 0 } : etapas[i].medida;
+        if (medidas[i].n == 0) medidas[i].minimo = 0;
+    }
+    for (int i = 0; i < PERFIL_N_XRUNS; i++) {
+        contadores_xrun[i] = xruns[i];
+    }
+}
+
+const char *perfil_nome_etapa(etapa_perfil_t etapa) {
+    return (etapa < PERFIL_N_ETAPAS) ? nomes_etapas[etapa] : "?";
+}
+
+void perfil_zerar(void) {
+    for (int i = 0; i < PERFIL_N_ETAPAS; i++) {
+        etapas[i].zerar = true;
+    }
+    // Um xrun contado ao mesmo tempo pode se perder; não há como zerá-los pelo dono (são raros)
+    for (int i = 0; i < PERFIL_N_XRUNS; i++) {
+        xruns[i] = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file perfil_desempenho.h
+ * @brief Perfil de desempenho: ciclos por etapa, xruns e carga de CPU de cada núcleo.
+ *
+ * As etapas são medidas com o SysTick do núcleo que as executa (ver
+ * contador_ciclos.h) e acumulam n, mínimo, médio e máximo. A carga vem do
+ * tempo ocioso, marcado em volta das esperas de cada núcleo (polling do
+ * núcleo 0, __wfe do núcleo 1). Interrupções atendidas durante uma espera
+ * contam como ociosas.
+ *
+ * Cada etapa é escrita por um só núcleo e lida pelo outro sem trava: uma
+ * leitura pode pegar um acúmulo pela metade, o que basta para diagnóstico.
+ *
+ * Com PERFIL_HABILITADO 0 (padrão nos builds com NDEBUG, como o Release do
+ * SDK) as macros não geram código e o módulo fica vazio.
+ */
+#ifndef PERFIL_DESEMPENHO_H
+#define PERFIL_DESEMPENHO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PERFIL_HABILITADO
+#ifdef NDEBUG
+#define PERFIL_HABILITADO 0
+#else
+#define PERFIL_HABILITADO 1
+#endif
+#endif
+
+#define PERFIL_JANELA_CARGA_MS 1000
+
+typedef enum {
+    // Núcleo 0
+    PERFIL_CAPTURA_INICIO,   // Clock do ADC e disparo do DMA, uma vez por gravação
+    PERFIL_DECIMACAO,        // Interrupção da captura, por parte bruta
+    PERFIL_FILTRO,           // Suavização do bloco capturado
+    PERFIL_BLOQUEIO_DC,      // Remoção do nível DC do bloco capturado
+    PERFIL_AGC,              // Controle automático de ganho e limitador da captura
+    PERFIL_CODIFICACAO,      // Codec do bloco (RAM) ou entrega à fila da flash
+    PERFIL_BLOCO_GRAVACAO,   // Bloco capturado inteiro, com as duas anteriores
+    PERFIL_REAMOSTRAGEM,     // Leitura da gravação pelo reamostrador
+    PERFIL_GANHO,            // Ganho de saída
+    PERFIL_CONVERSAO_SAIDA,  // Amostras de 12 bits -> palavras da saída (PWM ou sigma-delta)
+    PERFIL_BLOCO_REPRODUCAO, // Alimentação da saída: bloco inteiro, com as três anteriores
+    PERFIL_MISTURA_LOOPER,   // Bloco capturado misturado no laço do looper (overdub)
+    PERFIL_DETECTOR_DISPARO, // Nível do bloco contra os limiares da gravação armada
+    // Núcleo 1
+    PERFIL_DESENHO,          // Quadro no framebuffer
+    PERFIL_ENVIO_I2C,        // Entrega do quadro ao DMA do I2C (espera por vaga incluída)
+    PERFIL_N_ETAPAS
+} etapa_perfil_t;
+
+typedef enum {
+    PERFIL_XRUN_CAPTURA,    // Bloco descartado com o anel de captura cheio (overrun)
+    PERFIL_XRUN_REPRODUCAO, // Silêncio inserido com a fila do PWM vazia (underrun)
+    PERFIL_N_XRUNS
+} xrun_perfil_t;
+
+typedef struct {
+    uint32_t n;
+    uint32_t minimo;
+    uint32_t maximo;
+    uint64_t total;
+} medida_perfil_t;
+
+#if PERFIL_HABILITADO
+
+#include "contador_ciclos.h"
+
+#define PERFIL_INICIAR_NUCLEO() perfil_iniciar_nucleo()
+#define PERFIL_INICIO(marca) uint32_t marca = contador_ciclos_ler()
+#define PERFIL_FIM(etapa, marca) perfil_registrar((etapa), contador_ciclos_desde(marca))
+#define PERFIL_REGISTRAR(etapa, ciclos) perfil_registrar((etapa), (ciclos))
+#define PERFIL_XRUN(tipo) perfil_contar_xrun(tipo)
+#define PERFIL_OCIOSO_INICIO() perfil_ocioso_inicio()
+#define PERFIL_OCIOSO_FIM() perfil_ocioso_fim()
+
+// Liga o SysTick do núcleo que chama e abre a janela de carga dele
+void perfil_iniciar_nucleo(void);
+
+// As quatro abaixo rodam da RAM (são chamadas de tratadores de interrupção)
+void perfil_registrar(etapa_perfil_t etapa, uint32_t ciclos);
+void perfil_contar_xrun(xrun_perfil_t tipo);
+void perfil_ocioso_inicio(void);
+void perfil_ocioso_fim(void);
+
+// Fecha a janela de carga se PERFIL_JANELA_CARGA_MS passou (chamar periodicamente, num núcleo só)
+void perfil_atualizar_carga(void);
+
+// Carga da última janela completa, em milésimos
+uint32_t perfil_carga_permil(uint32_t nucleo);
+
+// Cópia das medidas (mínimo 0 nas etapas sem amostras) e dos contadores de xrun
+void perfil_ler(medida_perfil_t medidas[PERFIL_N_ETAPAS], uint32_t xruns[PERFIL_N_XRUNS]);
+
+const char *perfil_nome_etapa(etapa_perfil_t etapa);
+
+// Pede que cada etapa recomece do zero na próxima medida (quem escreve zera, sem corrida)
+void perfil_zerar(void);
+
+#else
+
+#define PERFIL_INICIAR_NUCLEO() ((void)0)
+#define PERFIL_INICIO(marca) ((void)0)
+#define PERFIL_FIM(etapa, marca) ((void)0)
+#define PERFIL_REGISTRAR(etapa, ciclos) ((void)0)
+#define PERFIL_XRUN(tipo) ((void)0)
+#define PERFIL_OCIOSO_INICIO() ((void)0)
+#define PERFIL_OCIOSO_FIM() ((void)0)
+
+#endif
+
+#endif
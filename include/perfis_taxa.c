@@ -0,0 +1,141 @@
+/**
+ * @file perfis_taxa.c
+ * @brief Tabela de perfis com os divisores calculados na compilação (ver perfis_taxa.h).
+ */
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/vreg.h"
+#include "captura_audio.h"
+#include "dsp_audio.h"
+#include "perfis_taxa.h"
+
+#define FREQ_XOSC_HZ (12u * MHZ)
+#define FREQ_PLL_USB_HZ (48u * MHZ)
+#define TEMPO_ESTABILIZACAO_VREG_US 1000 // Antes de subir o clk_sys para a tensão nova
+
+// Limites do RP2040: VCO de 750 a 1600 MHz com referência de pelo menos 5 MHz; clk_adc de 48 MHz
+// e conversão de 96 ciclos no mínimo
+#define VCO_MIN_HZ 750000000u
+#define VCO_MAX_HZ 1600000000u
+#define REFERENCIA_PLL_MIN_HZ 5000000u
+#define FREQ_ADC_MAX_HZ (48u * MHZ)
+#define CICLOS_CONVERSAO_ADC_MIN 96
+
+// Filas e atrasos da cadeia de efeitos são dimensionados para 48 kHz
+#define TAXA_MAXIMA_PERFIL 48000
+
+#define FREQ_SISTEMA(VCO, PD1, PD2) ((VCO) / ((PD1) * (PD2)))
+#define FREQ_ADC(VCO, PD1, PD2, ADC_PLL, DIV_ADC) \
+    ((ADC_PLL) ? FREQ_SISTEMA(VCO, PD1, PD2) / (DIV_ADC) : FREQ_PLL_USB_HZ / (DIV_ADC))
+#define TAXA_ADC(TAXA) ((TAXA) * CAPTURA_FATOR_ADC)
+#define BITS_POR_SEGUNDO(TAXA) ((uint64_t)(TAXA) * DSP_SIGMA_DELTA_BITS)
+#define SISTEMA_Q8(VCO, PD1, PD2) ((uint64_t)FREQ_SISTEMA(VCO, PD1, PD2) << 8)
+
+// Expande o relógio (uma macro com vários campos) antes de entregá-lo à macro da entrada
+#define CHAMAR(MACRO, ...) MACRO(__VA_ARGS__)
+
+#define ENTRADA_(NOME, TAXA, VCO, REFDIV, PD1, PD2, TENSAO, ADC_PLL, DIV_ADC)                     \
+    {                                                                                              \
+        .nome = NOME,                                                                              \
+        .taxa = TAXA,                                                                              \
+        .freq_vco_hz = VCO,                                                                        \
+        .refdiv = REFDIV,                                                                          \
+        .pos_div1 = PD1,                                                                           \
+        .pos_div2 = PD2,                                                                           \
+        .adc_pela_pll_sistema = ADC_PLL,                                                           \
+        .tensao = TENSAO,                                                                          \
+        .freq_sistema_hz = FREQ_SISTEMA(VCO, PD1, PD2),                                            \
+        .freq_adc_hz = FREQ_ADC(VCO, PD1, PD2, ADC_PLL, DIV_ADC),                                  \
+        .ciclos_conversao_adc = FREQ_ADC(VCO, PD1, PD2, ADC_PLL, DIV_ADC) / TAXA_ADC(TAXA),        \
+        .topo_pwm = FREQ_SISTEMA(VCO, PD1, PD2) / (TAXA) - 1,                                      \
+        .divisor_sigma_delta_q8 = (uint32_t)(SISTEMA_Q8(VCO, PD1, PD2) / BITS_POR_SEGUNDO(TAXA)),    \
+    },
+#define ENTRADA(ID, NOME, TAXA, RELOGIO) CHAMAR(ENTRADA_, NOME, TAXA, RELOGIO)
+
+const perfil_taxa_t perfis_taxa[N_PERFIS_TAXA] = { PERFIS_TAXA(ENTRADA) };
+
+// Um perfil que não divida exatamente (ou fora dos limites do chip) para a compilação
+#define CONFERIR_(NOME, TAXA, VCO, REFDIV, PD1, PD2, TENSAO, ADC_PLL, DIV_ADC)                                       \
+    _Static_assert((TAXA) <= TAXA_MAXIMA_PERFIL, "perfil " NOME ": taxa acima da cadeia de efeitos");               \
+    _Static_assert(sizeof(NOME) <= TAMANHO_NOME_PERFIL_TAXA, "perfil " NOME ": nome longo demais");                 \
+    _Static_assert(FREQ_XOSC_HZ / (REFDIV) >= REFERENCIA_PLL_MIN_HZ && (VCO) % (FREQ_XOSC_HZ / (REFDIV)) == 0,       \
+                   "perfil " NOME ": VCO não é múltiplo inteiro da referência");                                    \
+    _Static_assert((VCO) >= VCO_MIN_HZ && (VCO) <= VCO_MAX_HZ, "perfil " NOME ": VCO fora da faixa");               \
+    _Static_assert((PD1) >= (PD2) && (PD1) <= 7 && (VCO) % ((PD1) * (PD2)) == 0,                                    \
+                   "perfil " NOME ": pós-divisores inválidos");                                                     \
+    _Static_assert(FREQ_SISTEMA(VCO, PD1, PD2) % (TAXA) == 0, "perfil " NOME ": período do PWM não é inteiro");     \
+    _Static_assert(FREQ_SISTEMA(VCO, PD1, PD2) / (TAXA) <= 65536, "perfil " NOME ": período do PWM excede 16 bits"); \
+    _Static_assert(SISTEMA_Q8(VCO, PD1, PD2) % BITS_POR_SEGUNDO(TAXA) == 0,                                         \
+                   "perfil " NOME ": divisor do sigma-delta não cabe em 8 bits de fração");                         \
+    _Static_assert(FREQ_ADC(VCO, PD1, PD2, ADC_PLL, DIV_ADC) <= FREQ_ADC_MAX_HZ && (DIV_ADC) >= 1 && (DIV_ADC) <= 3, \
+                   "perfil " NOME ": clk_adc inválido");                                                            \
+    _Static_assert(FREQ_ADC(VCO, PD1, PD2, ADC_PLL, DIV_ADC) % TAXA_ADC(TAXA) == 0,                                 \
+                   "perfil " NOME ": período do ADC não é inteiro");                                                \
+    _Static_assert(FREQ_ADC(VCO, PD1, PD2, ADC_PLL, DIV_ADC) / TAXA_ADC(TAXA) >= CICLOS_CONVERSAO_ADC_MIN,          \
+                   "perfil " NOME ": ADC acima de 500 ksps");
+#define CONFERIR(ID, NOME, TAXA, RELOGIO) CHAMAR(CONFERIR_, NOME, TAXA, RELOGIO)
+
+PERFIS_TAXA(CONFERIR)
+
+static indice_perfil_taxa_t perfil_escolhido = PERFIL_TAXA_PADRAO;
+static const perfil_taxa_t *relogio_aplicado = NULL; // NULL: ainda o relógio do boot
+static enum vreg_voltage tensao_aplicada = VREG_VOLTAGE_DEFAULT;
+
+void perfis_taxa_iniciar(void) {
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, FREQ_PLL_USB_HZ, FREQ_PLL_USB_HZ);
+    perfil_escolhido = PERFIL_TAXA_PADRAO;
+}
+
+static bool mesma_pll(const perfil_taxa_t *a, const perfil_taxa_t *b) {
+    return a->freq_vco_hz == b->freq_vco_hz && a->refdiv == b->refdiv && a->pos_div1 == b->pos_div1 &&
+           a->pos_div2 == b->pos_div2;
+}
+
+void perfis_taxa_aplicar_relogios(const perfil_taxa_t *perfil) {
+    if (relogio_aplicado == NULL || !mesma_pll(relogio_aplicado, perfil)) {
+        // Tensão sobe antes do relógio e só desce depois dele
+        if (perfil->tensao > tensao_aplicada) {
+            vreg_set_voltage(perfil->tensao);
+            busy_wait_us(TEMPO_ESTABILIZACAO_VREG_US);
+        }
+
+        // O clk_sys fica na PLL do USB enquanto a do sistema trava na nova frequência
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                        CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, FREQ_PLL_USB_HZ, FREQ_PLL_USB_HZ);
+        pll_init(pll_sys, perfil->refdiv, perfil->freq_vco_hz, perfil->pos_div1, perfil->pos_div2);
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                        CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, perfil->freq_sistema_hz,
+                        perfil->freq_sistema_hz);
+
+        if (perfil->tensao < tensao_aplicada) {
+            vreg_set_voltage(perfil->tensao);
+        }
+        tensao_aplicada = perfil->tensao;
+    }
+
+    if (perfil->adc_pela_pll_sistema) {
+        clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, perfil->freq_sistema_hz,
+                        perfil->freq_adc_hz);
+    } else {
+        clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, FREQ_PLL_USB_HZ,
+                        perfil->freq_adc_hz);
+    }
+    relogio_aplicado = perfil;
+}
+
+indice_perfil_taxa_t perfis_taxa_escolhido(void) {
+    return perfil_escolhido;
+}
+
+void perfis_taxa_escolher(indice_perfil_taxa_t indice) {
+    if (indice < N_PERFIS_TAXA) perfil_escolhido = indice;
+}
+
+indice_perfil_taxa_t perfis_taxa_para(uint32_t taxa) {
+    if (perfis_taxa[perfil_escolhido].taxa == taxa) return perfil_escolhido;
+    for (uint i = 0; i < N_PERFIS_TAXA; i++) {
+        if (perfis_taxa[i].taxa == taxa) return (indice_perfil_taxa_t)i;
+    }
+    return perfil_escolhido;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file perfis_taxa.h
+ * @brief Perfis de taxa de amostragem e de relógio, escolhidos em tempo de execução.
+ *
+ * Cada perfil fixa a taxa da captura e da saída e a PLL do sistema que a
+ * atende. Os relógios foram escolhidos para que tudo divida exatamente:
+ * clk_sys / taxa dá o período inteiro do PWM, clk_sys / (32 x taxa) o
+ * divisor do PIO sigma-delta (com a fração de 8 bits dele) e
+ * clk_adc / (CAPTURA_FATOR_ADC x taxa) o período inteiro do ADC. A família
+ * de 48 kHz usa o clk_adc de 48 MHz da PLL do USB; a de 44,1 kHz não tem
+ * divisor exato de 48 MHz e tira o clk_adc da PLL do sistema (VCO de 882 MHz).
+ *
+ * Os divisores são calculados na compilação e conferidos por _Static_assert
+ * em perfis_taxa.c: um perfil inexato não compila.
+ */
+#ifndef PERFIS_TAXA_H
+#define PERFIS_TAXA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/vreg.h"
+
+// Relógios: VCO (Hz), refdiv, pós-divisores 1 e 2, tensão do núcleo, clk_adc pela PLL do sistema,
+// divisor do clk_adc
+#define RELOGIO_120M 1440000000u, 1, 6, 2, VREG_VOLTAGE_1_10, false, 1
+#define RELOGIO_88M2 882000000u, 2, 5, 2, VREG_VOLTAGE_1_10, true, 2    // VCO = 6 MHz x 147
+#define RELOGIO_153M6 1536000000u, 1, 5, 2, VREG_VOLTAGE_1_15, false, 1 // Acima dos 133 MHz nominais
+
+// Identificador, nome (log e porta USB, até TAMANHO_NOME_PERFIL_TAXA - 1 caracteres), taxa (Hz), relógio
+#define PERFIS_TAXA(X)                                 \
+    X(8K, "8K", 8000, RELOGIO_120M)                    \
+    X(16K, "16K", 16000, RELOGIO_120M)                 \
+    X(22K05, "22K05", 22050, RELOGIO_88M2)             \
+    X(44K1, "44K1", 44100, RELOGIO_88M2)               \
+    X(48K, "48K", 48000, RELOGIO_120M)                 \
+    X(48K_OC, "48K OC", 48000, RELOGIO_153M6)
+
+#define PERFIL_TAXA_INDICE(ID, NOME, TAXA, RELOGIO) PERFIL_TAXA_##ID,
+typedef enum {
+    PERFIS_TAXA(PERFIL_TAXA_INDICE)
+    N_PERFIS_TAXA
+} indice_perfil_taxa_t;
+#undef PERFIL_TAXA_INDICE
+
+// Taxa de cada perfil como constante, para os _Static_assert de quem depende de uma taxa fixa
+#define PERFIL_TAXA_HZ(ID, NOME, TAXA, RELOGIO) TAXA_PERFIL_##ID = TAXA,
+enum { PERFIS_TAXA(PERFIL_TAXA_HZ) };
+#undef PERFIL_TAXA_HZ
+
+// Sintetizador e áudio USB rodam sempre neste (as tabelas e os descritores são de 48 kHz)
+#define PERFIL_TAXA_PADRAO PERFIL_TAXA_48K
+#define TAXA_PERFIL_PADRAO TAXA_PERFIL_48K
+
+#define TAMANHO_NOME_PERFIL_TAXA 8
+
+typedef struct {
+    const char *nome;
+    uint32_t taxa;                   // Hz, na captura e na saída
+    uint32_t freq_vco_hz;            // VCO = 12 MHz / refdiv x fbdiv
+    uint8_t refdiv;
+    uint8_t pos_div1;
+    uint8_t pos_div2;
+    bool adc_pela_pll_sistema;       // Senão, PLL do USB (48 MHz)
+    enum vreg_voltage tensao;
+    uint32_t freq_sistema_hz;        // VCO / (pos_div1 x pos_div2)
+    uint32_t freq_adc_hz;
+    uint16_t ciclos_conversao_adc;   // clk_adc por conversão, na taxa sobreamostrada
+    uint16_t topo_pwm;               // clk_sys / taxa - 1
+    uint32_t divisor_sigma_delta_q8; // clk_sys / (32 x taxa), com 8 bits de fração
+} perfil_taxa_t;
+
+extern const perfil_taxa_t perfis_taxa[N_PERFIS_TAXA];
+
+// Move o clk_peri para a PLL do USB (I2C e UART deixam de depender do clk_sys) e
+// escolhe o perfil padrão. Chamar antes de interface_iniciar().
+void perfis_taxa_iniciar(void);
+
+// Reprograma a PLL do sistema, a tensão do núcleo e o clk_adc do perfil (só o que mudou).
+// Com o áudio parado: por algumas centenas de microssegundos, o clk_sys fica nos 48 MHz do USB.
+void perfis_taxa_aplicar_relogios(const perfil_taxa_t *perfil);
+
+// Perfil usado pela próxima gravação (a escolha não mexe no hardware)
+indice_perfil_taxa_t perfis_taxa_escolhido(void);
+void perfis_taxa_escolher(indice_perfil_taxa_t indice);
+
+// Perfil para tocar uma gravação feita a taxa: o escolhido se tiver essa taxa, senão o primeiro que a
+// tenha; sem nenhum, o escolhido (o reamostrador converte)
+indice_perfil_taxa_t perfis_taxa_para(uint32_t taxa);
+
+#endif
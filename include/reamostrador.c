@@ -0,0 +1,120 @@
+/**
+ * @file reamostrador.c
+ * @brief Acumulador de fase 32.32 e interpolação linear/cúbica (ver reamostrador.h).
+ */
+#include <string.h>
+#include "contador_ciclos.h"
+#include "dsp_audio.h"
+#include "reamostrador.h"
+
+#define N_BLOCO CODEC_AMOSTRAS_POR_BLOCO
+
+// Decodifica um bloco na janela; além do fim da gravação repete a última amostra
+static void carregar_bloco(reamostrador_t *reamostrador, size_t indice_bloco, uint16_t *destino) {
+    size_t n = 0;
+    if (indice_bloco < gravacao_numero_de_blocos(reamostrador->gravacao)) {
+        n = gravacao_ler_bloco(reamostrador->gravacao, indice_bloco, destino);
+        reamostrador->estatisticas.n_blocos_decodificados++;
+    }
+
+    // destino[-1] é sempre válido: janela[0] ou o fim do bloco anterior
+    uint16_t ultima = (n > 0) ? destino[n - 1] : destino[-1];
+    for (size_t i = n; i < N_BLOCO; i++) {
+        destino[i] = ultima;
+    }
+}
+
+// Desliza a janela um bloco: o bloco seguinte vira a base e o próximo é decodificado
+static void avancar_janela(reamostrador_t *reamostrador) {
+    reamostrador->janela[0] = reamostrador->janela[N_BLOCO];
+    memcpy(&reamostrador->janela[1], &reamostrador->janela[1 + N_BLOCO], N_BLOCO * sizeof(uint16_t));
+    reamostrador->bloco_base++;
+    carregar_bloco(reamostrador, reamostrador->bloco_base + 1, &reamostrador->janela[1 + N_BLOCO]);
+}
+
+void reamostrador_iniciar(reamostrador_t *reamostrador, const gravacao_codificada_t *gravacao,
+                          uint32_t freq_saida, interpolacao_t interpolacao) {
+    reamostrador->gravacao = gravacao;
+    reamostrador->interpolacao = interpolacao;
+    reamostrador->freq_saida = freq_saida;
+    reamostrador->posicao = 0;
+    reamostrador->fracao = 0;
+    reamostrador->estatisticas = (estatisticas_reamostrador_t){ 0 };
+
+    reamostrador->bloco_base = 0;
+    reamostrador->janela[0] = DSP_AMOSTRA_ZERO;
+    carregar_bloco(reamostrador, 0, &reamostrador->janela[1]);
+    reamostrador->janela[0] = reamostrador->janela[1]; // Sem amostra anterior, repete a primeira
+    carregar_bloco(reamostrador, 1, &reamostrador->janela[1 + N_BLOCO]);
+
+    reamostrador_definir_velocidade(reamostrador, REAMOSTRADOR_VELOCIDADE_UNITARIA);
+    contador_ciclos_iniciar();
+}
+
+void reamostrador_definir_velocidade(reamostrador_t *reamostrador, uint32_t velocidade_q16) {
+    if (velocidade_q16 < REAMOSTRADOR_VELOCIDADE_MIN) velocidade_q16 = REAMOSTRADOR_VELOCIDADE_MIN;
+    if (velocidade_q16 > REAMOSTRADOR_VELOCIDADE_MAX) velocidade_q16 = REAMOSTRADOR_VELOCIDADE_MAX;
+
+    uint32_t freq_origem = reamostrador->gravacao->freq_amostragem;
+    if (freq_origem == 0) freq_origem = reamostrador->freq_saida;
+
+    // Razão das taxas em 32.32 vezes a velocidade em Q16 (divisão de 64 bits só aqui, fora do laço)
+    uint64_t razao = ((uint64_t)freq_origem << 32) / reamostrador->freq_saida;
+    uint64_t passo = (razao * velocidade_q16) >> 16;
+    reamostrador->passo_inteiro = (uint32_t)(passo >> 32);
+    reamostrador->passo_fracao = (uint32_t)passo;
+}
+
+// Catmull-Rom entre x[0] e x[1], com t em Q15; os termos cabem em 32 bits para amostras de 12 bits
+static inline int32_t interpolar_cubica(const uint16_t *x, int32_t t) {
+    int32_t x0 = x[-1], x1 = x[0], x2 = x[1], x3 = x[2];
+    int32_t c1 = x2 - x0;
+    int32_t c2 = 2 * x0 - 5 * x1 + 4 * x2 - x3;
+    int32_t c3 = 3 * (x1 - x2) + x3 - x0;
+    return x1 + ((t * (c1 + ((t * (c2 + ((t * c3) >> 15))) >> 15))) >> 16);
+}
+
+static inline int32_t interpolar_linear(const uint16_t *x, int32_t t) {
+    return x[0] + (((x[1] - x[0]) * t) >> 15);
+}
+
+size_t reamostrador_ler(reamostrador_t *reamostrador, uint16_t *saida, size_t n_amostras) {
+    uint32_t inicio = contador_ciclos_ler();
+
+    const uint32_t total = (uint32_t)reamostrador->gravacao->n_amostras;
+    const uint32_t passo_inteiro = reamostrador->passo_inteiro;
+    const uint32_t passo_fracao = reamostrador->passo_fracao;
+    const bool cubica = (reamostrador->interpolacao == INTERPOLACAO_CUBICA);
+    uint32_t posicao = reamostrador->posicao;
+    uint32_t fracao = reamostrador->fracao;
+    uint32_t inicio_janela = (uint32_t)reamostrador->bloco_base * N_BLOCO;
+
+    size_t i = 0;
+    for (; i < n_amostras && posicao < total; i++) {
+        while (posicao - inicio_janela >= N_BLOCO) {
+            avancar_janela(reamostrador);
+            inicio_janela += N_BLOCO;
+        }
+
+        const uint16_t *x = &reamostrador->janela[1 + (posicao - inicio_janela)];
+        int32_t t = (int32_t)(fracao >> 17);
+        int32_t valor = cubica ? interpolar_cubica(x, t) : interpolar_linear(x, t);
+        if (valor < 0) valor = 0;
+        if (valor > DSP_AMOSTRA_MAX) valor = DSP_AMOSTRA_MAX; // A cúbica pode ultrapassar as amostras vizinhas
+        saida[i] = (uint16_t)valor;
+
+        // Soma de 64 bits em duas palavras
+        uint32_t nova_fracao = fracao + passo_fracao;
+        posicao += passo_inteiro + (nova_fracao < fracao);
+        fracao = nova_fracao;
+    }
+
+    reamostrador->posicao = posicao;
+    reamostrador->fracao = fracao;
+
+    uint32_t ciclos = contador_ciclos_desde(inicio);
+    reamostrador->estatisticas.n_amostras_saida += i;
+    reamostrador->estatisticas.ciclos_total += ciclos;
+    if (ciclos > reamostrador->estatisticas.ciclos_max) reamostrador->estatisticas.ciclos_max = ciclos;
+    return i;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file reamostrador.h
+ * @brief Reamostrador em ponto fixo: lê uma gravação com passo fracionário.
+ *
+ * Um acumulador de fase 32.32 (parte inteira = amostra da gravação, parte
+ * fracionária = posição entre ela e a seguinte) avança `passo` por amostra de
+ * saída, com interpolação linear ou cúbica (Catmull-Rom). O passo junta a
+ * conversão de taxa (gravação a 22050 Hz tocada a 48 kHz, por exemplo) e a
+ * velocidade pedida; como é varispeed, tom e duração mudam juntos.
+ *
+ * Faixa: velocidades de REAMOSTRADOR_VELOCIDADE_MIN a _MAX (passo final de
+ * 1/4 a 4 para a mesma taxa). Passos acima de 1 descartam amostras sem
+ * filtro anti-aliasing: as frequências acima da nova Nyquist rebatem.
+ *
+ * Custo por amostra de saída: o laço só usa somas, deslocamentos e
+ * multiplicações de 32 bits (uma na linear, três na cúbica). Contando as
+ * instruções do Cortex-M0+ (multiplicação de 1 ciclo, load de 2), a
+ * interpolação com a saturação e o passo 32.32 fica em ~25 ciclos na linear
+ * e ~40 na cúbica. Somam-se, vezes o passo, a cópia da janela (~2 ciclos por
+ * amostra da gravação) e a decodificação do bloco: de ~2 (PCM16) a ~30
+ * (IMA ADPCM) ciclos por amostra. A 48 kHz com passo 1, PACKED12 e cúbica:
+ * ~50 dos 2500 ciclos por amostra a 120 MHz. As contas são estimativas, ainda
+ * não medidas no dispositivo; os ciclos reais por amostra saem de
+ * reamostrador_t.estatisticas e são relatados ao fim de cada reprodução.
+ */
+#ifndef REAMOSTRADOR_H
+#define REAMOSTRADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "codec_amostras.h"
+
+#define REAMOSTRADOR_VELOCIDADE_UNITARIA (1u << 16) // Velocidades em Q16
+#define REAMOSTRADOR_VELOCIDADE_MIN (REAMOSTRADOR_VELOCIDADE_UNITARIA / 4)
+#define REAMOSTRADOR_VELOCIDADE_MAX (REAMOSTRADOR_VELOCIDADE_UNITARIA * 4)
+
+typedef enum {
+    INTERPOLACAO_LINEAR,
+    INTERPOLACAO_CUBICA,
+} interpolacao_t;
+
+typedef struct {
+    uint32_t n_amostras_saida;
+    uint32_t n_blocos_decodificados;
+    uint32_t ciclos_max;        // Pior chamada de reamostrador_ler
+    uint64_t ciclos_total;      // Inclui a decodificação dos blocos
+} estatisticas_reamostrador_t;
+
+typedef struct {
+    const gravacao_codificada_t *gravacao;
+    interpolacao_t interpolacao;
+    uint32_t freq_saida;
+
+    // Fase 32.32 em duas palavras, com o vai-um feito à mão (o M0+ não tem 64x64)
+    uint32_t posicao;
+    uint32_t fracao;
+    uint32_t passo_inteiro;
+    uint32_t passo_fracao;
+
+    // janela[0] é a última amostra do bloco anterior; seguem os blocos base e base + 1
+    size_t bloco_base;
+    uint16_t janela[1 + 2 * CODEC_AMOSTRAS_POR_BLOCO];
+
+    estatisticas_reamostrador_t estatisticas;
+} reamostrador_t;
+
+// Posiciona no início da gravação, com velocidade unitária e estatísticas zeradas.
+// Gravações sem taxa conhecida (0) são tratadas como gravadas a freq_saida.
+void reamostrador_iniciar(reamostrador_t *reamostrador, const gravacao_codificada_t *gravacao,
+                          uint32_t freq_saida, interpolacao_t interpolacao);
+
+// Velocidade de leitura em Q16 (limitada à faixa suportada); vale a partir da próxima leitura
+void reamostrador_definir_velocidade(reamostrador_t *reamostrador, uint32_t velocidade_q16);
+
+// Produz até n_amostras de 12 bits a freq_saida; retorna menos que isso ao fim da gravação
+size_t reamostrador_ler(reamostrador_t *reamostrador, uint16_t *saida, size_t n_amostras);
+
+#endif
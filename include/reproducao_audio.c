@@ -0,0 +1,296 @@
+/**
+ * @file reproducao_audio.c
+ * @brief Implementação do motor de reprodução via DMA (ver reproducao_audio.h).
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "saida_sigma_delta.pio.h"
+#include "dsp_audio.h"
+#include "conversor_pwm.h"
+#include "perfil_desempenho.h"
+#include "reproducao_audio.h"
+
+#define N_MAX_SAIDAS 2
+#define PIO_SAIDA pio0
+
+// Fila circular de blocos e bloco de silêncio usado quando a fila esvazia (nível 0 ou só zeros)
+static uint32_t fila_reproducao[N_BLOCOS_FILA_REPRODUCAO][TAMANHO_BLOCO_REPRODUCAO];
+static uint32_t bloco_silencio[TAMANHO_BLOCO_REPRODUCAO];
+
+static saida_audio_t saida_audio;
+static uint32_t topo_pwm;               // clk_sys / taxa - 1
+static uint32_t divisor_sigma_delta_q8; // clk_sys / (32 x taxa), 8 bits de fração
+static dsp_escala_pwm_t escala_pwm;
+static dsp_sigma_delta_t modulador;
+
+// Um par de canais em ping-pong por saída; apenas a saída 0 gera interrupções
+static uint canal_dma[N_MAX_SAIDAS][2];
+static dma_channel_config config_canal[N_MAX_SAIDAS][2];
+static uint pino_saida[N_MAX_SAIDAS];
+static uint slice_saida[N_MAX_SAIDAS];       // Saída PWM
+static uint maquina_saida[N_MAX_SAIDAS];     // Saída sigma-delta
+static volatile void *destino_saida[N_MAX_SAIDAS];
+static uint dreq_saida[N_MAX_SAIDAS];
+static uint n_saidas = 0;
+
+// Índice sequencial do bloco em cada canal do par; -1 indica o bloco de silêncio
+static volatile int32_t bloco_do_canal[2];
+
+static volatile uint32_t blocos_enviados = 0;
+static volatile uint32_t blocos_liberados = 0;
+static uint32_t proximo_bloco_a_tocar = 0;
+static volatile uint32_t blocos_em_falta = 0;
+
+static volatile bool em_execucao = false;
+static volatile bool finalizando = false;
+
+// Aponta o canal i de cada saída para o próximo bloco da fila (ou silêncio)
+static void __not_in_flash_func(programar_origem_canal)(uint i) {
+    const uint32_t *origem;
+
+    if (proximo_bloco_a_tocar < blocos_enviados) {
+        bloco_do_canal[i] = (int32_t)proximo_bloco_a_tocar;
+        origem = fila_reproducao[proximo_bloco_a_tocar % N_BLOCOS_FILA_REPRODUCAO];
+        proximo_bloco_a_tocar++;
+    } else {
+        bloco_do_canal[i] = -1;
+        origem = bloco_silencio;
+        if (em_execucao && !finalizando) {
+            blocos_em_falta++;
+            PERFIL_XRUN(PERFIL_XRUN_REPRODUCAO);
+        }
+    }
+
+    for (uint s = 0; s < n_saidas; s++) {
+        // As saídas compartilham a cadência; a transferência final da saída 1 termina em poucos ciclos
+        while (dma_channel_is_busy(canal_dma[s][i])) tight_loop_contents();
+        dma_channel_set_trans_count(canal_dma[s][i], TAMANHO_BLOCO_REPRODUCAO, false);
+        dma_channel_set_read_addr(canal_dma[s][i], origem, false);
+    }
+}
+
+// Compartilha o DMA_IRQ_0 com a captura, então também precisa rodar da RAM
+static void __not_in_flash_func(tratador_irq_dma_reproducao)(void) {
+    for (uint i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq0_status(canal_dma[0][i])) continue;
+        dma_channel_acknowledge_irq0(canal_dma[0][i]);
+
+        int32_t bloco = bloco_do_canal[i];
+        if (bloco >= 0) {
+            blocos_liberados = (uint32_t)bloco + 1;
+        }
+        programar_origem_canal(i);
+    }
+}
+
+// Programa os dois pares, sincroniza as saídas e dispara o DMA
+static void disparar_reproducao(void) {
+    uint32_t mascara_saidas = 0;
+    uint32_t mascara_canais = 0;
+
+    for (uint s = 0; s < n_saidas; s++) {
+        if (saida_audio == SAIDA_AUDIO_PWM) {
+            pwm_set_enabled(slice_saida[s], false);
+            pwm_set_counter(slice_saida[s], 0);
+            mascara_saidas |= 1u << slice_saida[s];
+        } else {
+            pio_sm_set_enabled(PIO_SAIDA, maquina_saida[s], false);
+            pio_sm_clear_fifos(PIO_SAIDA, maquina_saida[s]);
+            pio_sm_restart(PIO_SAIDA, maquina_saida[s]);
+            mascara_saidas |= 1u << maquina_saida[s];
+        }
+        mascara_canais |= 1u << canal_dma[s][0];
+        for (uint i = 0; i < 2; i++) {
+            dma_channel_configure(canal_dma[s][i], &config_canal[s][i], destino_saida[s], bloco_silencio,
+                                  TAMANHO_BLOCO_REPRODUCAO, false);
+        }
+    }
+
+    em_execucao = true;
+    for (uint i = 0; i < 2; i++) {
+        programar_origem_canal(i);
+        dma_channel_acknowledge_irq0(canal_dma[0][i]);
+        dma_channel_set_irq0_enabled(canal_dma[0][i], true);
+    }
+
+    // Os canais aguardam o primeiro DREQ (o PIO já pede o FIFO cheio); as saídas partem juntas
+    dma_start_channel_mask(mascara_canais);
+    if (saida_audio == SAIDA_AUDIO_PWM) {
+        hw_set_bits(&pwm_hw->en, mascara_saidas);
+    } else {
+        pio_enable_sm_mask_in_sync(PIO_SAIDA, mascara_saidas);
+    }
+}
+
+static void parar_dma_reproducao(void) {
+    for (uint s = 0; s < n_saidas; s++) {
+        for (uint i = 0; i < 2; i++) {
+            dma_channel_set_irq0_enabled(canal_dma[s][i], false);
+            dma_channel_config config = config_canal[s][i];
+            channel_config_set_chain_to(&config, canal_dma[s][i]);
+            dma_channel_set_config(canal_dma[s][i], &config, false);
+        }
+    }
+    for (uint s = 0; s < n_saidas; s++) {
+        for (uint i = 0; i < 2; i++) {
+            dma_channel_abort(canal_dma[s][i]);
+            dma_channel_acknowledge_irq0(canal_dma[s][i]);
+        }
+    }
+    em_execucao = false;
+}
+
+// Aplica os divisores do perfil atual às saídas já configuradas
+static void aplicar_divisores(void) {
+    if (saida_audio == SAIDA_AUDIO_PWM) {
+        pwm_set_wrap(slice_saida[0], topo_pwm);
+        pwm_set_wrap(slice_saida[1], topo_pwm);
+        dsp_escala_pwm_iniciar(&escala_pwm, topo_pwm);
+    } else {
+        for (uint s = 0; s < n_saidas; s++) {
+            pio_sm_set_clkdiv_int_frac(PIO_SAIDA, maquina_saida[s], (uint16_t)(divisor_sigma_delta_q8 >> 8),
+                                       (uint8_t)(divisor_sigma_delta_q8 & 0xFF));
+        }
+    }
+}
+
+static void configurar_saida_pwm(uint s) {
+    gpio_set_function(pino_saida[s], GPIO_FUNC_PWM);
+    slice_saida[s] = pwm_gpio_to_slice_num(pino_saida[s]);
+
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_wrap(&config, topo_pwm);
+    pwm_init(slice_saida[s], &config, true);
+    pwm_set_gpio_level(pino_saida[s], 0); // Inicia com o som desligado
+
+    destino_saida[s] = &pwm_hw->slice[slice_saida[s]].cc;
+    dreq_saida[s] = DREQ_PWM_WRAP0 + slice_saida[s];
+    if (s == 0) dsp_escala_pwm_iniciar(&escala_pwm, topo_pwm);
+}
+
+static void configurar_saida_sigma_delta(uint s, uint offset_programa) {
+    maquina_saida[s] = (uint)pio_claim_unused_sm(PIO_SAIDA, true);
+    saida_sigma_delta_program_init(PIO_SAIDA, maquina_saida[s], offset_programa, pino_saida[s],
+                                   (float)divisor_sigma_delta_q8 / 256.0f);
+    pio_sm_set_pins_with_mask(PIO_SAIDA, maquina_saida[s], 0, 1u << pino_saida[s]);
+
+    destino_saida[s] = &PIO_SAIDA->txf[maquina_saida[s]];
+    dreq_saida[s] = pio_get_dreq(PIO_SAIDA, maquina_saida[s], true);
+}
+
+void reproducao_definir_taxa(uint32_t topo, uint32_t divisor_q8) {
+    topo_pwm = (topo == 0) ? 1 : topo;
+    divisor_sigma_delta_q8 = divisor_q8;
+}
+
+void reproducao_inicializar(saida_audio_t saida, uint pino_a, uint pino_b) {
+    saida_audio = saida;
+    pino_saida[0] = pino_a;
+    pino_saida[1] = pino_b;
+    if (saida == SAIDA_AUDIO_PWM) {
+        // Pinos no mesmo slice recebem o nível juntos, pelos dois canais do registrador CC
+        n_saidas = (pwm_gpio_to_slice_num(pino_a) == pwm_gpio_to_slice_num(pino_b)) ? 1 : 2;
+        configurar_saida_pwm(0);
+        configurar_saida_pwm(1);
+    } else {
+        n_saidas = (pino_a == pino_b) ? 1 : 2;
+        uint offset_programa = pio_add_program(PIO_SAIDA, &saida_sigma_delta_program);
+        for (uint s = 0; s < n_saidas; s++) {
+            configurar_saida_sigma_delta(s, offset_programa);
+        }
+    }
+
+    // Só os pares das saídas em uso: os demais canais ficam livres para a captura e o display
+    for (uint s = 0; s < n_saidas; s++) {
+        for (uint i = 0; i < 2; i++) {
+            canal_dma[s][i] = dma_claim_unused_channel(true);
+        }
+    }
+    for (uint s = 0; s < n_saidas; s++) {
+        for (uint i = 0; i < 2; i++) {
+            dma_channel_config *config = &config_canal[s][i];
+            *config = dma_channel_get_default_config(canal_dma[s][i]);
+            channel_config_set_transfer_data_size(config, DMA_SIZE_32);
+            channel_config_set_read_increment(config, true);
+            channel_config_set_write_increment(config, false);
+            channel_config_set_dreq(config, dreq_saida[s]);
+            channel_config_set_chain_to(config, canal_dma[s][i ^ 1]);
+        }
+    }
+    memset(bloco_silencio, 0, sizeof(bloco_silencio));
+
+    irq_add_shared_handler(DMA_IRQ_0, tratador_irq_dma_reproducao, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void reproducao_iniciar(void) {
+    // O perfil de taxa pode ter mudado desde a última reprodução
+    aplicar_divisores();
+
+    blocos_enviados = 0;
+    blocos_liberados = 0;
+    proximo_bloco_a_tocar = 0;
+    blocos_em_falta = 0;
+    finalizando = false;
+    dsp_sigma_delta_iniciar(&modulador);
+}
+
+uint32_t *reproducao_obter_bloco_livre(void) {
+    if (blocos_enviados - blocos_liberados >= N_BLOCOS_FILA_REPRODUCAO) {
+        return NULL;
+    }
+    return fila_reproducao[blocos_enviados % N_BLOCOS_FILA_REPRODUCAO];
+}
+
+void reproducao_converter_bloco(const uint16_t *amostras, uint32_t *bloco, size_t n_amostras) {
+    if (saida_audio == SAIDA_AUDIO_PWM) {
+        conversor_pwm_bloco(&escala_pwm, amostras, bloco, n_amostras);
+    } else {
+        dsp_sigma_delta_bloco(&modulador, amostras, bloco, n_amostras);
+    }
+}
+
+void reproducao_enviar_bloco(size_t n_palavras) {
+    uint32_t *bloco = fila_reproducao[blocos_enviados % N_BLOCOS_FILA_REPRODUCAO];
+    for (size_t i = n_palavras; i < TAMANHO_BLOCO_REPRODUCAO; i++) {
+        bloco[i] = 0; // Nível 0 no PWM, pino em nível baixo no sigma-delta
+    }
+
+    blocos_enviados++;
+    if (!em_execucao && blocos_enviados - blocos_liberados >= N_BLOCOS_FILA_REPRODUCAO) {
+        disparar_reproducao();
+    }
+}
+
+void reproducao_finalizar(void) {
+    finalizando = true;
+    if (!em_execucao && blocos_enviados > 0) {
+        disparar_reproducao();
+    }
+    while (em_execucao && blocos_liberados != blocos_enviados) {
+        tight_loop_contents();
+    }
+    if (em_execucao) {
+        parar_dma_reproducao();
+    }
+
+    for (uint s = 0; s < n_saidas; s++) {
+        if (saida_audio == SAIDA_AUDIO_PWM) {
+            pwm_hw->slice[slice_saida[s]].cc = reproducao_nivel_cc(0);
+        } else {
+            // As últimas palavras ainda saem do FIFO; depois a máquina para com o pino em nível baixo
+            while (!pio_sm_is_tx_fifo_empty(PIO_SAIDA, maquina_saida[s])) tight_loop_contents();
+            busy_wait_us(100);
+            pio_sm_set_enabled(PIO_SAIDA, maquina_saida[s], false);
+            pio_sm_set_pins_with_mask(PIO_SAIDA, maquina_saida[s], 0, 1u << pino_saida[s]);
+        }
+    }
+}
+
+uint32_t reproducao_blocos_em_falta(void) {
+    return blocos_em_falta;
+}
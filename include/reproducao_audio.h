@@ -0,0 +1,73 @@
+/**
+ * @file reproducao_audio.h
+ * @brief Motor de reprodução cadenciado por hardware (DMA de uma fila de blocos).
+ *
+ * As amostras são convertidas em blocos para o formato da saída e
+ * enfileiradas; dois canais de DMA encadeados por saída entregam uma palavra
+ * por amostra, sem intervenção da CPU entre as amostras. Duas saídas:
+ *
+ * - PWM: um nível por amostra no registrador CC do slice, a cada wrap do
+ *   contador (portadora na própria taxa, TOP 2499 a 120 MHz e 48 kHz: ~11 bits).
+ * - Sigma-delta: a palavra é o fluxo de 1 bit de 32 períodos do modulador de
+ *   2ª ordem (dsp_sigma_delta_bloco), que uma máquina do PIO põe no pino a
+ *   32x a taxa (1,536 MHz a 48 kHz). O ruído de quantização fica acima da
+ *   banda de áudio e não há a distorção do PWM de amostragem uniforme; em
+ *   troca, a modulação custa ~10 ciclos por bit (~320 por amostra) na
+ *   conversão do bloco, e a excursão fica em 0,75 do fundo de escala
+ *   (margem de estabilidade).
+ *
+ * O PWM é a saída padrão (SAIDA_AUDIO em main.c). Os números do sigma-delta
+ * acima vêm da bancada no computador e da simulação do modulador; ainda não
+ * foram medidos no dispositivo (ciclos por bloco com PERFIL_CONVERSAO_SAIDA,
+ * ruído e distorção no pino com o filtro RC da placa).
+ */
+#ifndef REPRODUCAO_AUDIO_H
+#define REPRODUCAO_AUDIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/types.h"
+
+// --- Parâmetros da Fila de Reprodução ---
+#define TAMANHO_BLOCO_REPRODUCAO 256 // Níveis de PWM por bloco
+#define N_BLOCOS_FILA_REPRODUCAO 4   // Blocos na fila circular
+
+typedef enum {
+    SAIDA_AUDIO_PWM,         // Slices de PWM, portadora na taxa de amostragem
+    SAIDA_AUDIO_SIGMA_DELTA, // PIO com o fluxo de 1 bit do modulador de 2ª ordem
+} saida_audio_t;
+
+// Divisores da saída para o perfil de taxa ativo (perfil_taxa_t): só guardados, aplicados por
+// reproducao_inicializar e reproducao_iniciar
+void reproducao_definir_taxa(uint32_t topo_pwm, uint32_t divisor_sigma_delta_q8);
+
+// Configura os dois pinos para a saída escolhida, com os divisores definidos antes, reserva os
+// canais de DMA e registra o tratador de interrupção
+void reproducao_inicializar(saida_audio_t saida, uint pino_a, uint pino_b);
+
+// Prepara a fila para uma nova reprodução e aplica os divisores definidos por último
+void reproducao_iniciar(void);
+
+// Retorna um bloco livre para ser preenchido por reproducao_converter_bloco, ou NULL se a fila estiver cheia
+uint32_t *reproducao_obter_bloco_livre(void);
+
+// Converte amostras de 12 bits para o formato da saída, uma palavra por amostra
+void reproducao_converter_bloco(const uint16_t *amostras, uint32_t *bloco, size_t n_amostras);
+
+// Publica o bloco obtido; blocos parciais são completados com silêncio.
+// O DMA é disparado automaticamente quando a fila enche pela primeira vez.
+void reproducao_enviar_bloco(size_t n_palavras);
+
+// Aguarda o fim dos blocos enfileirados e desliga as saídas
+void reproducao_finalizar(void);
+
+// Empacota um nível de PWM no formato do registrador CC (canais A e B)
+static inline uint32_t reproducao_nivel_cc(uint32_t nivel_pwm) {
+    return nivel_pwm | (nivel_pwm << 16);
+}
+
+// Quantidade de blocos de silêncio inseridos por atraso do produtor (underrun)
+uint32_t reproducao_blocos_em_falta(void);
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * @file sintetizador.c
+ * @brief Osciladores, envelopes e mixagem do sintetizador (ver sintetizador.h).
+ */
+#include "tabelas_sintetizador.h"
+#include "contador_ciclos.h"
+#include "dsp_audio.h"
+#include "sintetizador.h"
+
+#define ENVELOPE_MAXIMO (1 << 30)  // Nível de envelope em Q30
+#define DESLOCAMENTO_MIXAGEM 6     // Uma voz no máximo ocupa ~1/4 da excursão: 4 vozes antes de saturar
+#define AMOSTRAS_POR_MS (SINTETIZADOR_TAXA_AMOSTRAGEM / 1000)
+#define MASCARA_TABELA (TABELAS_SINTETIZADOR_TAMANHO - 1)
+
+_Static_assert(TABELAS_SINTETIZADOR_TAXA == SINTETIZADOR_TAXA_AMOSTRAGEM, "tabelas_sintetizador.h gerada para outra taxa");
+_Static_assert(TABELAS_SINTETIZADOR_TAMANHO == 256, "o índice da tabela usa os 8 bits altos da fase");
+
+typedef enum {
+    ESTAGIO_LIVRE,
+    ESTAGIO_ATAQUE,
+    ESTAGIO_DECAIMENTO,
+    ESTAGIO_SUSTENTACAO,
+    ESTAGIO_LIBERACAO,
+} estagio_envelope_t;
+
+typedef struct {
+    estagio_envelope_t estagio;
+    uint8_t nota;
+    uint32_t idade;            // Ordem de início, para o roubo de vozes
+    uint32_t fase;
+    uint32_t incremento;
+    const int16_t *tabela;
+    int32_t ganho_q15;         // Velocidade
+    int32_t nivel;             // Envelope atual (Q30)
+    // Passos por amostra (Q30), fixados no início da nota
+    int32_t passo_ataque;
+    int32_t passo_decaimento;
+    int32_t passo_liberacao;
+    int32_t nivel_sustentacao;
+} voz_t;
+
+static voz_t vozes[SINTETIZADOR_N_VOZES];
+static uint32_t contador_notas = 0;
+
+static forma_onda_t forma_atual = FORMA_DENTE_DE_SERRA;
+static envelope_adsr_t envelope_atual = { .ataque_ms = 5, .decaimento_ms = 150, .sustentacao_q15 = 20000, .liberacao_ms = 300 };
+
+static int32_t mistura[SINTETIZADOR_MAX_BLOCO];
+static estatisticas_sintetizador_t estatisticas;
+
+void sintetizador_iniciar(void) {
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        vozes[i].estagio = ESTAGIO_LIVRE;
+        vozes[i].nivel = 0;
+    }
+    estatisticas = (estatisticas_sintetizador_t){ 0 };
+    contador_ciclos_iniciar();
+}
+
+void sintetizador_configurar(forma_onda_t forma, const envelope_adsr_t *envelope) {
+    forma_atual = forma;
+    envelope_atual = *envelope;
+}
+
+// Tabela com banda limitada para a oitava do incremento; acima da última faixa, só o seno cabe
+static const int16_t *tabela_para(forma_onda_t forma, uint32_t incremento) {
+    int32_t faixa = (31 - (int32_t)__builtin_clz(incremento | 1)) - TABELAS_SINTETIZADOR_OITAVA_BASE;
+    if (faixa < 0) faixa = 0;
+
+    if (forma == FORMA_SENO || faixa >= TABELAS_SINTETIZADOR_FAIXAS) return tabela_seno_sintetizador;
+    if (forma == FORMA_QUADRADA) return tabela_quadrada_sintetizador[faixa];
+    return tabela_serra_sintetizador[faixa];
+}
+
+static int32_t passo_por_amostra(int32_t excursao, uint32_t tempo_ms) {
+    uint32_t amostras = tempo_ms * AMOSTRAS_POR_MS;
+    if (amostras == 0) amostras = 1;
+    int32_t passo = excursao / (int32_t)amostras;
+    return (passo > 0) ? passo : 1;
+}
+
+static voz_t *escolher_voz(uint8_t nota) {
+    voz_t *escolhida = NULL;
+
+    // A mesma nota reaproveita a própria voz; depois, qualquer voz livre
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        if (vozes[i].estagio != ESTAGIO_LIVRE && vozes[i].nota == nota) return &vozes[i];
+    }
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        if (vozes[i].estagio == ESTAGIO_LIVRE) return &vozes[i];
+    }
+
+    // Roubo: a mais silenciosa em liberação ou, se nenhuma estiver, a mais antiga
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        if (vozes[i].estagio == ESTAGIO_LIBERACAO && (escolhida == NULL || vozes[i].nivel < escolhida->nivel)) {
+            escolhida = &vozes[i];
+        }
+    }
+    if (escolhida != NULL) return escolhida;
+
+    escolhida = &vozes[0];
+    for (int i = 1; i < SINTETIZADOR_N_VOZES; i++) {
+        if ((int32_t)(vozes[i].idade - escolhida->idade) < 0) escolhida = &vozes[i];
+    }
+    return escolhida;
+}
+
+void sintetizador_nota_ligar(uint8_t nota, uint8_t velocidade) {
+    if (nota > 127 || velocidade == 0) return;
+    if (velocidade > 127) velocidade = 127;
+
+    voz_t *voz = escolher_voz(nota);
+    int32_t sustentacao = (int32_t)envelope_atual.sustentacao_q15 << 15;
+
+    // Uma voz reaproveitada sobe a partir do nível atual (sem degrau) e mantém a fase
+    voz->nota = nota;
+    voz->idade = contador_notas++;
+    voz->incremento = tabela_incremento_notas[nota];
+    voz->tabela = tabela_para(forma_atual, voz->incremento);
+    voz->ganho_q15 = (int32_t)velocidade * 258; // 127 -> 32766
+    voz->passo_ataque = passo_por_amostra(ENVELOPE_MAXIMO, envelope_atual.ataque_ms);
+    voz->passo_decaimento = passo_por_amostra(ENVELOPE_MAXIMO - sustentacao, envelope_atual.decaimento_ms);
+    voz->passo_liberacao = passo_por_amostra(ENVELOPE_MAXIMO, envelope_atual.liberacao_ms);
+    voz->nivel_sustentacao = sustentacao;
+    if (voz->estagio == ESTAGIO_LIVRE) {
+        voz->fase = 0;
+        voz->nivel = 0;
+    }
+    voz->estagio = ESTAGIO_ATAQUE;
+}
+
+void sintetizador_nota_desligar(uint8_t nota) {
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        if (vozes[i].estagio != ESTAGIO_LIVRE && vozes[i].estagio != ESTAGIO_LIBERACAO && vozes[i].nota == nota) {
+            vozes[i].estagio = ESTAGIO_LIBERACAO;
+        }
+    }
+}
+
+void sintetizador_desligar_todas(void) {
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        if (vozes[i].estagio != ESTAGIO_LIVRE) vozes[i].estagio = ESTAGIO_LIBERACAO;
+    }
+}
+
+uint32_t sintetizador_vozes_ativas(void) {
+    uint32_t ativas = 0;
+    for (int i = 0; i < SINTETIZADOR_N_VOZES; i++) {
+        if (vozes[i].estagio != ESTAGIO_LIVRE) ativas++;
+    }
+    return ativas;
+}
+
+// Avança o envelope um bloco inteiro; trocas de estágio caem na fronteira do bloco
+static void avancar_envelope(voz_t *voz, size_t n_amostras) {
+    int64_t nivel = voz->nivel;
+
+    switch (voz->estagio) {
+        case ESTAGIO_ATAQUE:
+            nivel += (int64_t)voz->passo_ataque * n_amostras;
+            if (nivel >= ENVELOPE_MAXIMO) {
+                nivel = ENVELOPE_MAXIMO;
+                voz->estagio = ESTAGIO_DECAIMENTO;
+            }
+            break;
+        case ESTAGIO_DECAIMENTO:
+            nivel -= (int64_t)voz->passo_decaimento * n_amostras;
+            if (nivel <= voz->nivel_sustentacao) {
+                nivel = voz->nivel_sustentacao;
+                voz->estagio = ESTAGIO_SUSTENTACAO;
+            }
+            break;
+        case ESTAGIO_LIBERACAO:
+            nivel -= (int64_t)voz->passo_liberacao * n_amostras;
+            if (nivel <= 0) {
+                nivel = 0;
+                voz->estagio = ESTAGIO_LIVRE;
+            }
+            break;
+        case ESTAGIO_SUSTENTACAO:
+        case ESTAGIO_LIVRE:
+            break;
+    }
+    voz->nivel = (int32_t)nivel;
+}
+
+// Soma a voz na mistura: tabela com interpolação linear e ganho em rampa ao longo do bloco
+static void renderizar_voz(voz_t *voz, size_t n_amostras) {
+    int32_t ganho_inicio = ((voz->nivel >> 15) * voz->ganho_q15) >> 15;
+    avancar_envelope(voz, n_amostras);
+    int32_t ganho_fim = ((voz->nivel >> 15) * voz->ganho_q15) >> 15;
+
+    int32_t ganho = ganho_inicio << 15; // Q30
+    int32_t passo_ganho = ((ganho_fim - ganho_inicio) << 15) / (int32_t)n_amostras;
+    const int16_t *tabela = voz->tabela;
+    uint32_t fase = voz->fase;
+    uint32_t incremento = voz->incremento;
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        uint32_t indice = fase >> 24;
+        int32_t fracao = (int32_t)((fase >> 9) & 0x7FFF);
+        int32_t a = tabela[indice];
+        int32_t b = tabela[(indice + 1) & MASCARA_TABELA];
+        int32_t amostra = a + (((b - a) * fracao) >> 15);
+
+        mistura[i] += (amostra * (ganho >> 15)) >> 15;
+        ganho += passo_ganho;
+        fase += incremento;
+    }
+    voz->fase = fase;
+}
+
+void sintetizador_renderizar(uint16_t *saida, size_t n_amostras) {
+    if (n_amostras > SINTETIZADOR_MAX_BLOCO) n_amostras = SINTETIZADOR_MAX_BLOCO;
+    if (n_amostras == 0) return;
+
+    uint32_t inicio = contador_ciclos_ler();
+
+    for (size_t i = 0; i < n_amostras; i++) {
+        mistura[i] = 0;
+    }
+
+    uint32_t inicio_vozes = contador_ciclos_ler();
+    uint32_t vozes_no_bloco = 0;
+    for (int v = 0; v < SINTETIZADOR_N_VOZES; v++) {
+        if (vozes[v].estagio == ESTAGIO_LIVRE) continue;
+        renderizar_voz(&vozes[v], n_amostras);
+        vozes_no_bloco++;
+    }
+    uint32_t ciclos_vozes = contador_ciclos_desde(inicio_vozes);
+
+    // Centraliza em 2048 e satura nos 12 bits, como uma amostra do ADC
+    for (size_t i = 0; i < n_amostras; i++) {
+        int32_t valor = DSP_AMOSTRA_ZERO + (mistura[i] >> DESLOCAMENTO_MIXAGEM);
+        if (valor < 0) valor = 0;
+        if (valor > 4095) valor = 4095;
+        saida[i] = (uint16_t)valor;
+    }
+
+    uint32_t ciclos = contador_ciclos_desde(inicio);
+    estatisticas.n_blocos++;
+    estatisticas.ciclos_total += ciclos;
+    estatisticas.ciclos_vozes += ciclos_vozes;
+    estatisticas.vozes_renderizadas += vozes_no_bloco;
+    if (ciclos > estatisticas.ciclos_max) estatisticas.ciclos_max = ciclos;
+}
+
+estatisticas_sintetizador_t sintetizador_estatisticas(void) {
+    return estatisticas;
+}
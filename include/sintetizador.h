@@ -0,0 +1,69 @@
+/**
+ * @file sintetizador.h
+ * @brief Sintetizador polifônico por tabelas de onda, renderizado em blocos.
+ *
+ * Cada voz é um acumulador de fase de 32 bits lendo uma tabela de onda com
+ * banda limitada (em flash, escolhida pela oitava da nota para não haver
+ * harmônicos acima de Nyquist), com interpolação linear e envelope ADSR.
+ * O envelope avança uma vez por bloco e é interpolado linearmente dentro
+ * dele. A saída tem o formato das amostras do ADC (12 bits, centro em 2048),
+ * para seguir o mesmo caminho até o PWM que a reprodução.
+ *
+ * Todas as funções são chamadas pelo mesmo núcleo (o do áudio).
+ */
+#ifndef SINTETIZADOR_H
+#define SINTETIZADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SINTETIZADOR_TAXA_AMOSTRAGEM 48000 // Taxa para a qual as tabelas foram geradas
+#define SINTETIZADOR_N_VOZES 8
+#define SINTETIZADOR_MAX_BLOCO 256 // Amostras por chamada de sintetizador_renderizar
+
+typedef enum {
+    FORMA_SENO,
+    FORMA_DENTE_DE_SERRA,
+    FORMA_QUADRADA,
+} forma_onda_t;
+
+typedef struct {
+    uint16_t ataque_ms;
+    uint16_t decaimento_ms;
+    uint16_t sustentacao_q15; // Nível de sustentação (Q15, 32767 = pico do ataque)
+    uint16_t liberacao_ms;    // Tempo para cair do pico até zero
+} envelope_adsr_t;
+
+typedef struct {
+    uint32_t n_blocos;
+    uint32_t ciclos_max;        // Pior bloco, com todas as etapas
+    uint64_t ciclos_total;
+    uint64_t ciclos_vozes;      // Só a renderização das vozes
+    uint64_t vozes_renderizadas; // Soma, por bloco, das vozes ativas
+} estatisticas_sintetizador_t;
+
+// Silencia todas as vozes, zera as estatísticas e liga o contador de ciclos do núcleo
+void sintetizador_iniciar(void);
+
+// Forma de onda e envelope das próximas notas (as que já soam não mudam)
+void sintetizador_configurar(forma_onda_t forma, const envelope_adsr_t *envelope);
+
+// Inicia uma nota MIDI (0..127) com velocidade 1..127. Sem voz livre, rouba a
+// voz mais silenciosa entre as que estão em liberação, ou então a mais antiga.
+void sintetizador_nota_ligar(uint8_t nota, uint8_t velocidade);
+
+// Passa para a liberação todas as vozes que tocam a nota
+void sintetizador_nota_desligar(uint8_t nota);
+
+// Libera todas as notas (o som termina com o tempo de liberação)
+void sintetizador_desligar_todas(void);
+
+// Renderiza n_amostras (<= SINTETIZADOR_MAX_BLOCO) de 12 bits em `saida`
+void sintetizador_renderizar(uint16_t *saida, size_t n_amostras);
+
+uint32_t sintetizador_vozes_ativas(void);
+
+estatisticas_sintetizador_t sintetizador_estatisticas(void);
+
+#endif
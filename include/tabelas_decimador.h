@@ -0,0 +1,29 @@
+/**
+ * @file tabelas_decimador.h
+ * @brief FIR de compensação do decimador CIC (gerado por ferramentas/gerar_tabelas.py).
+ *
+ * Não edite à mão. ADC a 384 ksps -> CIC de ordem 5
+ * decimando por 4 -> este FIR decimando por 2 ->
+ * 48000 Hz. Banda passante plana até 20000 Hz (já compensada a queda
+ * do CIC) e rejeição a partir de 28000 Hz.
+ */
+#ifndef TABELAS_DECIMADOR_H
+#define TABELAS_DECIMADOR_H
+
+#include <stdint.h>
+
+#define TABELAS_DECIMADOR_TAXA_SAIDA 48000
+#define TABELAS_DECIMADOR_FATOR 8
+#define TABELAS_DECIMADOR_FATOR_CIC 4
+#define TABELAS_DECIMADOR_ORDEM_CIC 5
+#define TABELAS_DECIMADOR_TAPS 47
+
+// Coeficientes Q15, simétricos
+static const int16_t tabela_fir_decimador[47] = {
+    -3, 15, 26, -31, -70, 53, 147, -81, -273, 112, 465, -141,
+    -749, 159, 1168, -149, -1805, 69, 2860, 225, -4976, -1571, 11404, 19073,
+    11404, -1571, -4976, 225, 2860, 69, -1805, -149, 1168, 159, -749, -141,
+    465, 112, -273, -81, 147, 53, -70, -31, 26, 15, -3,
+};
+
+#endif
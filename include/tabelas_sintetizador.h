@@ -0,0 +1,365 @@
+/**
+ * @file tabelas_sintetizador.h
+ * @brief Tabelas de onda com banda limitada e incrementos de fase das notas
+ *        (geradas por ferramentas/gerar_tabelas.py).
+ *
+ * Não edite à mão. Valem para 48000 Hz: a faixa f de cada forma de onda
+ * atende incrementos de fase abaixo de 2^(24 + f) e só tem
+ * harmônicos abaixo de Nyquist em toda a faixa.
+ */
+#ifndef TABELAS_SINTETIZADOR_H
+#define TABELAS_SINTETIZADOR_H
+
+#include <stdint.h>
+
+#define TABELAS_SINTETIZADOR_TAXA 48000
+#define TABELAS_SINTETIZADOR_TAMANHO 256
+#define TABELAS_SINTETIZADOR_FAIXAS 6
+#define TABELAS_SINTETIZADOR_OITAVA_BASE 23
+
+static const int16_t tabela_seno_sintetizador[256] = {
+    0, 764, 1527, 2290, 3051, 3811, 4568, 5322, 6073, 6821, 7564, 8303,
+    9036, 9765, 10487, 11203, 11913, 12615, 13310, 13996, 14674, 15344, 16004, 16654,
+    17295, 17925, 18544, 19152, 19748, 20333, 20905, 21465, 22012, 22546, 23066, 23572,
+    24064, 24541, 25004, 25451, 25883, 26300, 26701, 27085, 27454, 27806, 28141, 28459,
+    28760, 29044, 29310, 29558, 29789, 30002, 30197, 30373, 30531, 30671, 30793, 30895,
+    30980, 31045, 31092, 31120, 31130, 31120, 31092, 31045, 30980, 30895, 30793, 30671,
+    30531, 30373, 30197, 30002, 29789, 29558, 29310, 29044, 28760, 28459, 28141, 27806,
+    27454, 27085, 26701, 26300, 25883, 25451, 25004, 24541, 24064, 23572, 23066, 22546,
+    22012, 21465, 20905, 20333, 19748, 19152, 18544, 17925, 17295, 16654, 16004, 15344,
+    14674, 13996, 13310, 12615, 11913, 11203, 10487, 9765, 9036, 8303, 7564, 6821,
+    6073, 5322, 4568, 3811, 3051, 2290, 1527, 764, 0, -764, -1527, -2290,
+    -3051, -3811, -4568, -5322, -6073, -6821, -7564, -8303, -9036, -9765, -10487, -11203,
+    -11913, -12615, -13310, -13996, -14674, -15344, -16004, -16654, -17295, -17925, -18544, -19152,
+    -19748, -20333, -20905, -21465, -22012, -22546, -23066, -23572, -24064, -24541, -25004, -25451,
+    -25883, -26300, -26701, -27085, -27454, -27806, -28141, -28459, -28760, -29044, -29310, -29558,
+    -29789, -30002, -30197, -30373, -30531, -30671, -30793, -30895, -30980, -31045, -31092, -31120,
+    -31130, -31120, -31092, -31045, -30980, -30895, -30793, -30671, -30531, -30373, -30197, -30002,
+    -29789, -29558, -29310, -29044, -28760, -28459, -28141, -27806, -27454, -27085, -26701, -26300,
+    -25883, -25451, -25004, -24541, -24064, -23572, -23066, -22546, -22012, -21465, -20905, -20333,
+    -19748, -19152, -18544, -17925, -17295, -16654, -16004, -15344, -14674, -13996, -13310, -12615,
+    -11913, -11203, -10487, -9765, -9036, -8303, -7564, -6821, -6073, -5322, -4568, -3811,
+    -3051, -2290, -1527, -764,
+};
+
+static const int16_t tabela_serra_sintetizador[6][256] = {
+    { // Faixa 0: 127 harmônicos
+        0, 245, 489, 734, 979, 1223, 1468, 1713, 1957, 2202, 2447, 2691,
+        2936, 3181, 3425, 3670, 3915, 4159, 4404, 4649, 4893, 5138, 5383, 5627,
+        5872, 6117, 6361, 6606, 6851, 7095, 7340, 7585, 7829, 8074, 8319, 8563,
+        8808, 9053, 9297, 9542, 9787, 10031, 10276, 10521, 10765, 11010, 11255, 11499,
+        11744, 11989, 12233, 12478, 12723, 12967, 13212, 13456, 13701, 13946, 14190, 14435,
+        14680, 14924, 15169, 15413, 15658, 15903, 16147, 16392, 16637, 16881, 17126, 17370,
+        17615, 17860, 18104, 18349, 18594, 18838, 19083, 19327, 19572, 19817, 20061, 20306,
+        20550, 20795, 21040, 21284, 21529, 21773, 22018, 22263, 22507, 22752, 22996, 23241,
+        23486, 23730, 23975, 24219, 24464, 24708, 24953, 25198, 25442, 25687, 25932, 26176,
+        26421, 26665, 26910, 27154, 27400, 27643, 27889, 28132, 28379, 28620, 28869, 29108,
+        29361, 29593, 29857, 30069, 30373, 30486, 31130, 28025, 0, -28025, -31130, -30486,
+        -30373, -30069, -29857, -29593, -29361, -29108, -28869, -28620, -28379, -28132, -27889, -27643,
+        -27400, -27154, -26910, -26665, -26421, -26176, -25932, -25687, -25442, -25198, -24953, -24708,
+        -24464, -24219, -23975, -23730, -23486, -23241, -22996, -22752, -22507, -22263, -22018, -21773,
+        -21529, -21284, -21040, -20795, -20550, -20306, -20061, -19817, -19572, -19327, -19083, -18838,
+        -18594, -18349, -18104, -17860, -17615, -17370, -17126, -16881, -16637, -16392, -16147, -15903,
+        -15658, -15413, -15169, -14924, -14680, -14435, -14190, -13946, -13701, -13456, -13212, -12967,
+        -12723, -12478, -12233, -11989, -11744, -11499, -11255, -11010, -10765, -10521, -10276, -10031,
+        -9787, -9542, -9297, -9053, -8808, -8563, -8319, -8074, -7829, -7585, -7340, -7095,
+        -6851, -6606, -6361, -6117, -5872, -5627, -5383, -5138, -4893, -4649, -4404, -4159,
+        -3915, -3670, -3425, -3181, -2936, -2691, -2447, -2202, -1957, -1713, -1468, -1223,
+        -979, -734, -489, -245,
+    },
+    { // Faixa 1: 64 harmônicos
+        0, 243, 488, 733, 976, 1219, 1464, 1709, 1951, 2194, 2440, 2684,
+        2927, 3170, 3415, 3660, 3902, 4146, 4391, 4636, 4878, 5121, 5367, 5611,
+        5853, 6097, 6343, 6587, 6829, 7073, 7318, 7562, 7804, 8048, 8294, 8538,
+        8780, 9024, 9270, 9513, 9755, 9999, 10245, 10489, 10730, 10975, 11221, 11464,
+        11705, 11950, 12196, 12439, 12680, 12925, 13172, 13414, 13655, 13901, 14147, 14389,
+        14630, 14876, 15122, 15364, 15605, 15851, 16097, 16338, 16580, 16826, 17073, 17313,
+        17554, 17802, 18048, 18287, 18529, 18777, 19023, 19262, 19503, 19752, 19998, 20236,
+        20478, 20728, 20973, 21209, 21452, 21703, 21948, 22183, 22426, 22679, 22923, 23156,
+        23400, 23655, 23898, 24128, 24374, 24632, 24873, 25099, 25347, 25611, 25848, 26068,
+        26321, 26592, 26823, 27032, 27295, 27580, 27796, 27987, 28272, 28585, 28764, 28911,
+        29265, 29652, 29681, 29688, 30476, 31130, 27897, 17139, 0, -17139, -27897, -31130,
+        -30476, -29688, -29681, -29652, -29265, -28911, -28764, -28585, -28272, -27987, -27796, -27580,
+        -27295, -27032, -26823, -26592, -26321, -26068, -25848, -25611, -25347, -25099, -24873, -24632,
+        -24374, -24128, -23898, -23655, -23400, -23156, -22923, -22679, -22426, -22183, -21948, -21703,
+        -21452, -21209, -20973, -20728, -20478, -20236, -19998, -19752, -19503, -19262, -19023, -18777,
+        -18529, -18287, -18048, -17802, -17554, -17313, -17073, -16826, -16580, -16338, -16097, -15851,
+        -15605, -15364, -15122, -14876, -14630, -14389, -14147, -13901, -13655, -13414, -13172, -12925,
+        -12680, -12439, -12196, -11950, -11705, -11464, -11221, -10975, -10730, -10489, -10245, -9999,
+        -9755, -9513, -9270, -9024, -8780, -8538, -8294, -8048, -7804, -7562, -7318, -7073,
+        -6829, -6587, -6343, -6097, -5853, -5611, -5367, -5121, -4878, -4636, -4391, -4146,
+        -3902, -3660, -3415, -3170, -2927, -2684, -2440, -2194, -1951, -1709, -1464, -1219,
+        -976, -733, -488, -243,
+    },
+    { // Faixa 2: 32 harmônicos
+        0, 247, 495, 747, 1001, 1254, 1505, 1753, 2000, 2247, 2496, 2748,
+        3002, 3255, 3505, 3753, 3999, 4246, 4496, 4749, 5003, 5256, 5505, 5752,
+        5998, 6246, 6496, 6750, 7004, 7256, 7504, 7750, 7996, 8244, 8496, 8750,
+        9004, 9255, 9502, 9747, 9993, 10242, 10495, 10749, 11003, 11253, 11499, 11743,
+        11989, 12239, 12493, 12748, 13001, 13250, 13494, 13738, 13984, 14235, 14490, 14746,
+        14998, 15245, 15488, 15731, 15978, 16230, 16487, 16743, 16994, 17239, 17480, 17722,
+        17970, 18224, 18483, 18740, 18990, 19232, 19470, 19711, 19960, 20218, 20480, 20737,
+        20984, 21222, 21456, 21697, 21949, 22213, 22479, 22736, 22978, 23208, 23437, 23678,
+        23937, 24211, 24484, 24740, 24972, 25187, 25406, 25650, 25925, 26220, 26506, 26755,
+        26960, 27142, 27342, 27600, 27924, 28278, 28592, 28805, 28906, 28966, 29122, 29502,
+        30124, 30808, 31130, 30488, 28252, 23961, 17516, 9270, 0, -9270, -17516, -23961,
+        -28252, -30488, -31130, -30808, -30124, -29502, -29122, -28966, -28906, -28805, -28592, -28278,
+        -27924, -27600, -27342, -27142, -26960, -26755, -26506, -26220, -25925, -25650, -25406, -25187,
+        -24972, -24740, -24484, -24211, -23937, -23678, -23437, -23208, -22978, -22736, -22479, -22213,
+        -21949, -21697, -21456, -21222, -20984, -20737, -20480, -20218, -19960, -19711, -19470, -19232,
+        -18990, -18740, -18483, -18224, -17970, -17722, -17480, -17239, -16994, -16743, -16487, -16230,
+        -15978, -15731, -15488, -15245, -14998, -14746, -14490, -14235, -13984, -13738, -13494, -13250,
+        -13001, -12748, -12493, -12239, -11989, -11743, -11499, -11253, -11003, -10749, -10495, -10242,
+        -9993, -9747, -9502, -9255, -9004, -8750, -8496, -8244, -7996, -7750, -7504, -7256,
+        -7004, -6750, -6496, -6246, -5998, -5752, -5505, -5256, -5003, -4749, -4496, -4246,
+        -3999, -3753, -3505, -3255, -3002, -2748, -2496, -2247, -2000, -1753, -1505, -1254,
+        -1001, -747, -495, -247,
+    },
+    { // Faixa 3: 16 harmônicos
+        0, 256, 514, 774, 1037, 1303, 1572, 1843, 2114, 2385, 2654, 2920,
+        3183, 3443, 3700, 3956, 4212, 4469, 4728, 4991, 5256, 5525, 5796, 6068,
+        6339, 6608, 6874, 7136, 7395, 7651, 7906, 8160, 8416, 8674, 8936, 9201,
+        9470, 9741, 10013, 10284, 10554, 10820, 11081, 11339, 11593, 11845, 12097, 12350,
+        12606, 12866, 13131, 13400, 13672, 13946, 14219, 14489, 14755, 15016, 15271, 15521,
+        15769, 16016, 16265, 16518, 16777, 17042, 17313, 17588, 17865, 18142, 18415, 18681,
+        18941, 19192, 19436, 19676, 19915, 20157, 20405, 20661, 20927, 21203, 21486, 21774,
+        22060, 22340, 22610, 22867, 23110, 23341, 23563, 23783, 24008, 24244, 24498, 24771,
+        25064, 25373, 25691, 26007, 26310, 26591, 26840, 27054, 27237, 27397, 27549, 27713,
+        27913, 28167, 28491, 28890, 29354, 29858, 30357, 30790, 31077, 31130, 30853, 30156,
+        28957, 27192, 24824, 21848, 18292, 14221, 9729, 4941, 0, -4941, -9729, -14221,
+        -18292, -21848, -24824, -27192, -28957, -30156, -30853, -31130, -31077, -30790, -30357, -29858,
+        -29354, -28890, -28491, -28167, -27913, -27713, -27549, -27397, -27237, -27054, -26840, -26591,
+        -26310, -26007, -25691, -25373, -25064, -24771, -24498, -24244, -24008, -23783, -23563, -23341,
+        -23110, -22867, -22610, -22340, -22060, -21774, -21486, -21203, -20927, -20661, -20405, -20157,
+        -19915, -19676, -19436, -19192, -18941, -18681, -18415, -18142, -17865, -17588, -17313, -17042,
+        -16777, -16518, -16265, -16016, -15769, -15521, -15271, -15016, -14755, -14489, -14219, -13946,
+        -13672, -13400, -13131, -12866, -12606, -12350, -12097, -11845, -11593, -11339, -11081, -10820,
+        -10554, -10284, -10013, -9741, -9470, -9201, -8936, -8674, -8416, -8160, -7906, -7651,
+        -7395, -7136, -6874, -6608, -6339, -6068, -5796, -5525, -5256, -4991, -4728, -4469,
+        -4212, -3956, -3700, -3443, -3183, -2920, -2654, -2385, -2114, -1843, -1572, -1303,
+        -1037, -774, -514, -256,
+    },
+    { // Faixa 4: 8 harmônicos
+        0, 278, 556, 836, 1118, 1403, 1691, 1982, 2277, 2575, 2876, 3180,
+        3487, 3795, 4103, 4412, 4720, 5027, 5331, 5633, 5931, 6226, 6516, 6803,
+        7086, 7366, 7643, 7918, 8191, 8464, 8738, 9012, 9288, 9567, 9850, 10136,
+        10426, 10720, 11018, 11320, 11624, 11931, 12239, 12548, 12856, 13163, 13467, 13767,
+        14063, 14354, 14639, 14919, 15194, 15463, 15728, 15989, 16248, 16505, 16762, 17021,
+        17282, 17546, 17816, 18092, 18374, 18663, 18959, 19262, 19570, 19883, 20200, 20518,
+        20837, 21153, 21465, 21772, 22070, 22359, 22637, 22904, 23159, 23403, 23636, 23859,
+        24076, 24289, 24500, 24713, 24932, 25161, 25403, 25661, 25939, 26239, 26562, 26909,
+        27278, 27668, 28074, 28491, 28912, 29329, 29732, 30109, 30447, 30733, 30953, 31090,
+        31130, 31057, 30858, 30517, 30024, 29366, 28536, 27525, 26332, 24952, 23390, 21647,
+        19733, 17657, 15433, 13076, 10604, 8038, 5400, 2712, 0, -2712, -5400, -8038,
+        -10604, -13076, -15433, -17657, -19733, -21647, -23390, -24952, -26332, -27525, -28536, -29366,
+        -30024, -30517, -30858, -31057, -31130, -31090, -30953, -30733, -30447, -30109, -29732, -29329,
+        -28912, -28491, -28074, -27668, -27278, -26909, -26562, -26239, -25939, -25661, -25403, -25161,
+        -24932, -24713, -24500, -24289, -24076, -23859, -23636, -23403, -23159, -22904, -22637, -22359,
+        -22070, -21772, -21465, -21153, -20837, -20518, -20200, -19883, -19570, -19262, -18959, -18663,
+        -18374, -18092, -17816, -17546, -17282, -17021, -16762, -16505, -16248, -15989, -15728, -15463,
+        -15194, -14919, -14639, -14354, -14063, -13767, -13467, -13163, -12856, -12548, -12239, -11931,
+        -11624, -11320, -11018, -10720, -10426, -10136, -9850, -9567, -9288, -9012, -8738, -8464,
+        -8191, -7918, -7643, -7366, -7086, -6803, -6516, -6226, -5931, -5633, -5331, -5027,
+        -4720, -4412, -4103, -3795, -3487, -3180, -2876, -2575, -2277, -1982, -1691, -1403,
+        -1118, -836, -556, -278,
+    },
+    { // Faixa 5: 4 harmônicos
+        0, 326, 652, 978, 1307, 1637, 1969, 2304, 2642, 2983, 3327, 3675,
+        4027, 4382, 4741, 5104, 5471, 5841, 6215, 6591, 6970, 7352, 7735, 8119,
+        8505, 8890, 9276, 9660, 10043, 10425, 10803, 11179, 11551, 11919, 12282, 12640,
+        12994, 13341, 13683, 14018, 14348, 14672, 14989, 15301, 15607, 15908, 16204, 16496,
+        16784, 17069, 17350, 17631, 17910, 18188, 18467, 18748, 19031, 19317, 19606, 19901,
+        20200, 20506, 20818, 21138, 21465, 21801, 22144, 22496, 22856, 23223, 23599, 23982,
+        24371, 24766, 25165, 25568, 25972, 26377, 26781, 27181, 27576, 27964, 28342, 28707,
+        29058, 29391, 29704, 29994, 30258, 30493, 30695, 30863, 30994, 31083, 31129, 31130,
+        31081, 30981, 30828, 30619, 30353, 30028, 29641, 29193, 28682, 28107, 27468, 26764,
+        25997, 25166, 24271, 23315, 22299, 21223, 20091, 18904, 17665, 16377, 15042, 13665,
+        12249, 10798, 9315, 7805, 6272, 4720, 3155, 1580, 0, -1580, -3155, -4720,
+        -6272, -7805, -9315, -10798, -12249, -13665, -15042, -16377, -17665, -18904, -20091, -21223,
+        -22299, -23315, -24271, -25166, -25997, -26764, -27468, -28107, -28682, -29193, -29641, -30028,
+        -30353, -30619, -30828, -30981, -31081, -31130, -31129, -31083, -30994, -30863, -30695, -30493,
+        -30258, -29994, -29704, -29391, -29058, -28707, -28342, -27964, -27576, -27181, -26781, -26377,
+        -25972, -25568, -25165, -24766, -24371, -23982, -23599, -23223, -22856, -22496, -22144, -21801,
+        -21465, -21138, -20818, -20506, -20200, -19901, -19606, -19317, -19031, -18748, -18467, -18188,
+        -17910, -17631, -17350, -17069, -16784, -16496, -16204, -15908, -15607, -15301, -14989, -14672,
+        -14348, -14018, -13683, -13341, -12994, -12640, -12282, -11919, -11551, -11179, -10803, -10425,
+        -10043, -9660, -9276, -8890, -8505, -8119, -7735, -7352, -6970, -6591, -6215, -5841,
+        -5471, -5104, -4741, -4382, -4027, -3675, -3327, -2983, -2642, -2304, -1969, -1637,
+        -1307, -978, -652, -326,
+    },
+};
+
+static const int16_t tabela_quadrada_sintetizador[6][256] = {
+    { // Faixa 0: 127 harmônicos
+        0, 27832, 31130, 30737, 30867, 30808, 30840, 30821, 30833, 30825, 30831, 30827,
+        30830, 30828, 30830, 30828, 30830, 30829, 30830, 30829, 30830, 30829, 30830, 30830,
+        30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30831, 30831,
+        30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831,
+        30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30832, 30832,
+        30832, 30832, 30832, 30832, 30832, 30832, 30832, 30832, 30832, 30832, 30832, 30831,
+        30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831,
+        30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30831, 30830,
+        30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30830, 30829,
+        30830, 30829, 30830, 30829, 30830, 30828, 30830, 30828, 30830, 30827, 30831, 30825,
+        30833, 30821, 30840, 30808, 30867, 30737, 31130, 27832, 0, -27832, -31130, -30737,
+        -30867, -30808, -30840, -30821, -30833, -30825, -30831, -30827, -30830, -30828, -30830, -30828,
+        -30830, -30829, -30830, -30829, -30830, -30829, -30830, -30830, -30830, -30830, -30830, -30830,
+        -30830, -30830, -30830, -30830, -30830, -30830, -30831, -30831, -30831, -30831, -30831, -30831,
+        -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831,
+        -30831, -30831, -30831, -30831, -30831, -30831, -30832, -30832, -30832, -30832, -30832, -30832,
+        -30832, -30832, -30832, -30832, -30832, -30832, -30832, -30831, -30831, -30831, -30831, -30831,
+        -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30831,
+        -30831, -30831, -30831, -30831, -30831, -30831, -30831, -30830, -30830, -30830, -30830, -30830,
+        -30830, -30830, -30830, -30830, -30830, -30830, -30830, -30829, -30830, -30829, -30830, -30829,
+        -30830, -30828, -30830, -30828, -30830, -30827, -30831, -30825, -30833, -30821, -30840, -30808,
+        -30867, -30737, -31130, -27832,
+    },
+    { // Faixa 1: 64 harmônicos
+        0, 16781, 27556, 31130, 30821, 30245, 30433, 30674, 30562, 30432, 30505, 30588,
+        30537, 30481, 30519, 30560, 30532, 30501, 30524, 30549, 30531, 30512, 30527, 30543,
+        30531, 30518, 30529, 30540, 30532, 30523, 30531, 30539, 30533, 30526, 30532, 30538,
+        30534, 30529, 30533, 30538, 30534, 30531, 30534, 30538, 30535, 30532, 30535, 30538,
+        30536, 30534, 30536, 30538, 30536, 30535, 30536, 30537, 30537, 30536, 30536, 30537,
+        30537, 30536, 30536, 30537, 30537, 30537, 30536, 30536, 30537, 30537, 30536, 30536,
+        30537, 30537, 30536, 30535, 30536, 30538, 30536, 30534, 30536, 30538, 30535, 30532,
+        30535, 30538, 30534, 30531, 30534, 30538, 30533, 30529, 30534, 30538, 30532, 30526,
+        30533, 30539, 30531, 30523, 30532, 30540, 30529, 30518, 30531, 30543, 30527, 30512,
+        30531, 30549, 30524, 30501, 30532, 30560, 30519, 30481, 30537, 30588, 30505, 30432,
+        30562, 30674, 30433, 30245, 30821, 31130, 27556, 16781, 0, -16781, -27556, -31130,
+        -30821, -30245, -30433, -30674, -30562, -30432, -30505, -30588, -30537, -30481, -30519, -30560,
+        -30532, -30501, -30524, -30549, -30531, -30512, -30527, -30543, -30531, -30518, -30529, -30540,
+        -30532, -30523, -30531, -30539, -30533, -30526, -30532, -30538, -30534, -30529, -30533, -30538,
+        -30534, -30531, -30534, -30538, -30535, -30532, -30535, -30538, -30536, -30534, -30536, -30538,
+        -30536, -30535, -30536, -30537, -30537, -30536, -30536, -30537, -30537, -30536, -30536, -30537,
+        -30537, -30537, -30536, -30536, -30537, -30537, -30536, -30536, -30537, -30537, -30536, -30535,
+        -30536, -30538, -30536, -30534, -30536, -30538, -30535, -30532, -30535, -30538, -30534, -30531,
+        -30534, -30538, -30533, -30529, -30534, -30538, -30532, -30526, -30533, -30539, -30531, -30523,
+        -30532, -30540, -30529, -30518, -30531, -30543, -30527, -30512, -30531, -30549, -30524, -30501,
+        -30532, -30560, -30519, -30481, -30537, -30588, -30505, -30432, -30562, -30674, -30433, -30245,
+        -30821, -31130, -27556, -16781,
+    },
+    { // Faixa 2: 32 harmônicos
+        0, 8824, 16750, 23089, 27502, 30038, 31068, 31130, 30765, 30384, 30195, 30226,
+        30383, 30544, 30623, 30601, 30517, 30432, 30392, 30410, 30465, 30520, 30547, 30536,
+        30501, 30466, 30450, 30460, 30487, 30514, 30527, 30522, 30504, 30486, 30478, 30484,
+        30500, 30515, 30522, 30519, 30509, 30499, 30495, 30499, 30508, 30517, 30521, 30520,
+        30514, 30509, 30506, 30508, 30513, 30518, 30520, 30520, 30517, 30515, 30514, 30514,
+        30516, 30517, 30518, 30518, 30518, 30518, 30518, 30517, 30516, 30514, 30514, 30515,
+        30517, 30520, 30520, 30518, 30513, 30508, 30506, 30509, 30514, 30520, 30521, 30517,
+        30508, 30499, 30495, 30499, 30509, 30519, 30522, 30515, 30500, 30484, 30478, 30486,
+        30504, 30522, 30527, 30514, 30487, 30460, 30450, 30466, 30501, 30536, 30547, 30520,
+        30465, 30410, 30392, 30432, 30517, 30601, 30623, 30544, 30383, 30226, 30195, 30384,
+        30765, 31130, 31068, 30038, 27502, 23089, 16750, 8824, 0, -8824, -16750, -23089,
+        -27502, -30038, -31068, -31130, -30765, -30384, -30195, -30226, -30383, -30544, -30623, -30601,
+        -30517, -30432, -30392, -30410, -30465, -30520, -30547, -30536, -30501, -30466, -30450, -30460,
+        -30487, -30514, -30527, -30522, -30504, -30486, -30478, -30484, -30500, -30515, -30522, -30519,
+        -30509, -30499, -30495, -30499, -30508, -30517, -30521, -30520, -30514, -30509, -30506, -30508,
+        -30513, -30518, -30520, -30520, -30517, -30515, -30514, -30514, -30516, -30517, -30518, -30518,
+        -30518, -30518, -30518, -30517, -30516, -30514, -30514, -30515, -30517, -30520, -30520, -30518,
+        -30513, -30508, -30506, -30509, -30514, -30520, -30521, -30517, -30508, -30499, -30495, -30499,
+        -30509, -30519, -30522, -30515, -30500, -30484, -30478, -30486, -30504, -30522, -30527, -30514,
+        -30487, -30460, -30450, -30466, -30501, -30536, -30547, -30520, -30465, -30410, -30392, -30432,
+        -30517, -30601, -30623, -30544, -30383, -30226, -30195, -30384, -30765, -31130, -31068, -30038,
+        -27502, -23089, -16750, -8824,
+    },
+    { // Faixa 3: 16 harmônicos
+        0, 4463, 8809, 12926, 16719, 20110, 23043, 25489, 27444, 28926, 29975, 30647,
+        31008, 31130, 31083, 30933, 30737, 30539, 30373, 30257, 30198, 30193, 30234, 30305,
+        30392, 30478, 30553, 30607, 30637, 30642, 30626, 30596, 30559, 30521, 30489, 30468,
+        30459, 30464, 30479, 30502, 30529, 30556, 30580, 30597, 30607, 30610, 30606, 30598,
+        30587, 30576, 30567, 30561, 30558, 30559, 30564, 30570, 30577, 30584, 30590, 30595,
+        30598, 30600, 30601, 30601, 30601, 30601, 30601, 30600, 30598, 30595, 30590, 30584,
+        30577, 30570, 30564, 30559, 30558, 30561, 30567, 30576, 30587, 30598, 30606, 30610,
+        30607, 30597, 30580, 30556, 30529, 30502, 30479, 30464, 30459, 30468, 30489, 30521,
+        30559, 30596, 30626, 30642, 30637, 30607, 30553, 30478, 30392, 30305, 30234, 30193,
+        30198, 30257, 30373, 30539, 30737, 30933, 31083, 31130, 31008, 30647, 29975, 28926,
+        27444, 25489, 23043, 20110, 16719, 12926, 8809, 4463, 0, -4463, -8809, -12926,
+        -16719, -20110, -23043, -25489, -27444, -28926, -29975, -30647, -31008, -31130, -31083, -30933,
+        -30737, -30539, -30373, -30257, -30198, -30193, -30234, -30305, -30392, -30478, -30553, -30607,
+        -30637, -30642, -30626, -30596, -30559, -30521, -30489, -30468, -30459, -30464, -30479, -30502,
+        -30529, -30556, -30580, -30597, -30607, -30610, -30606, -30598, -30587, -30576, -30567, -30561,
+        -30558, -30559, -30564, -30570, -30577, -30584, -30590, -30595, -30598, -30600, -30601, -30601,
+        -30601, -30601, -30601, -30600, -30598, -30595, -30590, -30584, -30577, -30570, -30564, -30559,
+        -30558, -30561, -30567, -30576, -30587, -30598, -30606, -30610, -30607, -30597, -30580, -30556,
+        -30529, -30502, -30479, -30464, -30459, -30468, -30489, -30521, -30559, -30596, -30626, -30642,
+        -30637, -30607, -30553, -30478, -30392, -30305, -30234, -30193, -30198, -30257, -30373, -30539,
+        -30737, -30933, -31083, -31130, -31008, -30647, -29975, -28926, -27444, -25489, -23043, -20110,
+        -16719, -12926, -8809, -4463,
+    },
+    { // Faixa 4: 8 harmônicos
+        0, 2233, 4451, 6639, 8783, 10870, 12887, 14822, 16665, 18407, 20041, 21560,
+        22960, 24239, 25395, 26429, 27343, 28140, 28824, 29403, 29881, 30268, 30570, 30797,
+        30958, 31061, 31115, 31130, 31112, 31070, 31011, 30941, 30865, 30790, 30717, 30652,
+        30595, 30549, 30514, 30491, 30480, 30480, 30489, 30507, 30532, 30563, 30597, 30633,
+        30670, 30706, 30741, 30774, 30803, 30829, 30851, 30869, 30884, 30896, 30905, 30911,
+        30915, 30918, 30920, 30921, 30921, 30921, 30920, 30918, 30915, 30911, 30905, 30896,
+        30884, 30869, 30851, 30829, 30803, 30774, 30741, 30706, 30670, 30633, 30597, 30563,
+        30532, 30507, 30489, 30480, 30480, 30491, 30514, 30549, 30595, 30652, 30717, 30790,
+        30865, 30941, 31011, 31070, 31112, 31130, 31115, 31061, 30958, 30797, 30570, 30268,
+        29881, 29403, 28824, 28140, 27343, 26429, 25395, 24239, 22960, 21560, 20041, 18407,
+        16665, 14822, 12887, 10870, 8783, 6639, 4451, 2233, 0, -2233, -4451, -6639,
+        -8783, -10870, -12887, -14822, -16665, -18407, -20041, -21560, -22960, -24239, -25395, -26429,
+        -27343, -28140, -28824, -29403, -29881, -30268, -30570, -30797, -30958, -31061, -31115, -31130,
+        -31112, -31070, -31011, -30941, -30865, -30790, -30717, -30652, -30595, -30549, -30514, -30491,
+        -30480, -30480, -30489, -30507, -30532, -30563, -30597, -30633, -30670, -30706, -30741, -30774,
+        -30803, -30829, -30851, -30869, -30884, -30896, -30905, -30911, -30915, -30918, -30920, -30921,
+        -30921, -30921, -30920, -30918, -30915, -30911, -30905, -30896, -30884, -30869, -30851, -30829,
+        -30803, -30774, -30741, -30706, -30670, -30633, -30597, -30563, -30532, -30507, -30489, -30480,
+        -30480, -30491, -30514, -30549, -30595, -30652, -30717, -30790, -30865, -30941, -31011, -31070,
+        -31112, -31130, -31115, -31061, -30958, -30797, -30570, -30268, -29881, -29403, -28824, -28140,
+        -27343, -26429, -25395, -24239, -22960, -21560, -20041, -18407, -16665, -14822, -12887, -10870,
+        -8783, -6639, -4451, -2233,
+    },
+    { // Faixa 5: 4 harmônicos
+        0, 1103, 2205, 3303, 4395, 5479, 6555, 7619, 8671, 9707, 10728, 11732,
+        12716, 13679, 14621, 15539, 16434, 17303, 18146, 18961, 19749, 20508, 21239, 21940,
+        22611, 23252, 23863, 24444, 24995, 25516, 26008, 26471, 26905, 27312, 27691, 28043,
+        28369, 28671, 28948, 29203, 29435, 29647, 29838, 30011, 30166, 30305, 30428, 30537,
+        30633, 30716, 30789, 30852, 30905, 30951, 30989, 31022, 31048, 31070, 31087, 31101,
+        31112, 31120, 31125, 31129, 31130, 31129, 31125, 31120, 31112, 31101, 31087, 31070,
+        31048, 31022, 30989, 30951, 30905, 30852, 30789, 30716, 30633, 30537, 30428, 30305,
+        30166, 30011, 29838, 29647, 29435, 29203, 28948, 28671, 28369, 28043, 27691, 27312,
+        26905, 26471, 26008, 25516, 24995, 24444, 23863, 23252, 22611, 21940, 21239, 20508,
+        19749, 18961, 18146, 17303, 16434, 15539, 14621, 13679, 12716, 11732, 10728, 9707,
+        8671, 7619, 6555, 5479, 4395, 3303, 2205, 1103, 0, -1103, -2205, -3303,
+        -4395, -5479, -6555, -7619, -8671, -9707, -10728, -11732, -12716, -13679, -14621, -15539,
+        -16434, -17303, -18146, -18961, -19749, -20508, -21239, -21940, -22611, -23252, -23863, -24444,
+        -24995, -25516, -26008, -26471, -26905, -27312, -27691, -28043, -28369, -28671, -28948, -29203,
+        -29435, -29647, -29838, -30011, -30166, -30305, -30428, -30537, -30633, -30716, -30789, -30852,
+        -30905, -30951, -30989, -31022, -31048, -31070, -31087, -31101, -31112, -31120, -31125, -31129,
+        -31130, -31129, -31125, -31120, -31112, -31101, -31087, -31070, -31048, -31022, -30989, -30951,
+        -30905, -30852, -30789, -30716, -30633, -30537, -30428, -30305, -30166, -30011, -29838, -29647,
+        -29435, -29203, -28948, -28671, -28369, -28043, -27691, -27312, -26905, -26471, -26008, -25516,
+        -24995, -24444, -23863, -23252, -22611, -21940, -21239, -20508, -19749, -18961, -18146, -17303,
+        -16434, -15539, -14621, -13679, -12716, -11732, -10728, -9707, -8671, -7619, -6555, -5479,
+        -4395, -3303, -2205, -1103,
+    },
+};
+
+// Incremento de fase por amostra das notas MIDI 0..127
+static const uint32_t tabela_incremento_notas[128] = {
+    731558, 775059, 821146, 869974, 921705, 976513,
+    1034579, 1096099, 1161276, 1230329, 1303488, 1380998,
+    1463116, 1550118, 1642292, 1739948, 1843411, 1953026,
+    2069159, 2192197, 2322552, 2460658, 2606977, 2761996,
+    2926232, 3100235, 3284585, 3479896, 3686822, 3906052,
+    4138318, 4384395, 4645104, 4921317, 5213953, 5523991,
+    5852465, 6200470, 6569170, 6959793, 7373644, 7812103,
+    8276635, 8768789, 9290209, 9842633, 10427907, 11047982,
+    11704930, 12400941, 13138339, 13919586, 14747287, 15624207,
+    16553270, 17537579, 18580418, 19685267, 20855814, 22095965,
+    23409859, 24801882, 26276679, 27839171, 29494575, 31248413,
+    33106541, 35075158, 37160835, 39370534, 41711627, 44191930,
+    46819719, 49603764, 52553357, 55678342, 58989149, 62496826,
+    66213081, 70150316, 74321671, 78741067, 83423255, 88383859,
+    93639437, 99207528, 105106715, 111356685, 117978298, 124993653,
+    132426162, 140300631, 148643341, 157482134, 166846509, 176767719,
+    187278874, 198415056, 210213429, 222713370, 235956596, 249987305,
+    264852324, 280601263, 297286682, 314964268, 333693018, 353535438,
+    374557749, 396830112, 420426858, 445426740, 471913192, 499974611,
+    529704648, 561202526, 594573365, 629928537, 667386037, 707070876,
+    749115498, 793660223, 840853716, 890853480, 943826385, 999949222,
+    1059409297, 1122405052,
+};
+
+#endif
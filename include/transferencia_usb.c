@@ -0,0 +1,481 @@
+/**
+ * @file transferencia_usb.c
+ * @brief Protocolo binário de exportação/importação de gravações (ver transferencia_usb.h).
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/regs/addressmap.h"
+#include "tusb.h"
+#include "dsp_audio.h"
+#include "usb_descritores.h"
+#include "perfis_taxa.h"
+#include "banco_amostras.h"
+#include "transferencia_usb.h"
+
+#define INSTANCIA CDC_INSTANCIA_BINARIO
+
+#define MAX_CARGA_RECEBIDA (4 + 2 * CODEC_AMOSTRAS_POR_BLOCO) // Um bloco de amostras por quadro
+#define TAMANHO_MAX_QUADRO_RECEBIDO (TRANSFERENCIA_TAMANHO_CABECALHO + MAX_CARGA_RECEBIDA + TRANSFERENCIA_TAMANHO_CRC)
+#define MAX_CARGA_RESPOSTA 20
+#define TAMANHO_MAX_RESPOSTA (TRANSFERENCIA_TAMANHO_CABECALHO + MAX_CARGA_RESPOSTA + TRANSFERENCIA_TAMANHO_CRC)
+
+#define ORIGEM_RAM 0
+#define ORIGEM_FLASH 1
+
+_Static_assert(TRANSFERENCIA_CARGA_EXPORTACAO + 4 <= 0xFFFF, "o comprimento do quadro tem 16 bits");
+_Static_assert(11 + TAMANHO_NOME_PERFIL_TAXA <= MAX_CARGA_RESPOSTA, "resposta PERFIL maior que a carga de resposta");
+_Static_assert(N_TAKES_BANCO <= 0xFF, "o índice do take tem 8 bits");
+_Static_assert(TRANSFERENCIA_FREQ_MINIMA == TAXA_PERFIL_8K && TRANSFERENCIA_FREQ_MAXIMA == TAXA_PERFIL_48K,
+               "faixa do IMPORTAR difere da dos perfis de taxa");
+
+// CRC-32 refletido (polinômio 0xEDB88320) de 4 em 4 bits: 64 bytes de tabela
+// em vez de 1 KB, a ~2 consultas por byte
+static const uint32_t tabela_crc32[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+typedef enum {
+    ETAPA_CABECALHO,
+    ETAPA_CARGA,
+    ETAPA_CRC,
+} etapa_quadro_t;
+
+// Um quadro de dados sai em partes, conforme a FIFO do CDC esvazia
+static struct {
+    bool ativa;
+    const uint8_t *dados;
+    size_t total;
+    size_t posicao;    // Bytes da gravação já enfileirados
+    etapa_quadro_t etapa;
+    size_t restante;   // Bytes da carga do quadro atual ainda por enfileirar
+    uint32_t crc_quadro;
+    uint32_t crc_total;
+    uint8_t seq;
+    uint32_t inicio_us;
+} exportacao;
+
+static struct {
+    bool ativa;
+    gravacao_codificada_t *gravacao; // Take aberto no banco
+    uint32_t n_amostras;             // Anunciadas no IMPORTAR
+    uint32_t recebidas;
+} importacao;
+
+static codec_amostras_t codec_importacao;
+
+static uint8_t quadro[TAMANHO_MAX_QUADRO_RECEBIDO];
+static size_t bytes_no_quadro = 0;
+static uint16_t bloco_importado[CODEC_AMOSTRAS_POR_BLOCO];
+static estatisticas_transferencia_t estatisticas;
+
+static uint32_t crc32_atualizar(uint32_t crc, const uint8_t *dados, size_t n) {
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= dados[i];
+        crc = (crc >> 4) ^ tabela_crc32[crc & 0x0F];
+        crc = (crc >> 4) ^ tabela_crc32[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static inline void escrever_u16(uint8_t *destino, uint16_t valor) {
+    destino[0] = (uint8_t)valor;
+    destino[1] = (uint8_t)(valor >> 8);
+}
+
+static inline void escrever_u32(uint8_t *destino, uint32_t valor) {
+    escrever_u16(destino, (uint16_t)valor);
+    escrever_u16(destino + 2, (uint16_t)(valor >> 16));
+}
+
+static inline uint16_t ler_u16(const uint8_t *origem) {
+    return (uint16_t)(origem[0] | (origem[1] << 8));
+}
+
+static inline uint32_t ler_u32(const uint8_t *origem) {
+    return ler_u16(origem) | ((uint32_t)ler_u16(origem + 2) << 16);
+}
+
+static void montar_cabecalho(uint8_t *destino, uint8_t tipo, uint8_t seq, uint16_t comprimento) {
+    destino[0] = TRANSFERENCIA_SINCRONISMO_0;
+    destino[1] = TRANSFERENCIA_SINCRONISMO_1;
+    destino[2] = tipo;
+    destino[3] = seq;
+    escrever_u16(destino + 4, comprimento);
+}
+
+// Respostas curtas saem inteiras: quem chama garante TAMANHO_MAX_RESPOSTA livres na FIFO
+static void enviar_resposta(uint8_t tipo, uint8_t seq, const uint8_t *carga, size_t n) {
+    uint8_t resposta[TAMANHO_MAX_RESPOSTA];
+
+    montar_cabecalho(resposta, tipo, seq, (uint16_t)n);
+    if (n > 0) memcpy(resposta + TRANSFERENCIA_TAMANHO_CABECALHO, carga, n);
+    uint32_t crc = crc32_atualizar(0, resposta + 2, TRANSFERENCIA_TAMANHO_CABECALHO - 2 + n);
+    escrever_u32(resposta + TRANSFERENCIA_TAMANHO_CABECALHO + n, crc);
+    tud_cdc_n_write(INSTANCIA, resposta, TRANSFERENCIA_TAMANHO_CABECALHO + n + TRANSFERENCIA_TAMANHO_CRC);
+}
+
+static void enviar_ack(uint8_t seq, uint8_t comando, uint32_t valor) {
+    uint8_t carga[5] = { comando };
+    escrever_u32(carga + 1, valor);
+    enviar_resposta(TRANSFERENCIA_RESP_ACK, seq, carga, sizeof(carga));
+}
+
+static void enviar_nack(uint8_t seq, uint8_t comando, uint8_t erro, uint32_t valor) {
+    uint8_t carga[6] = { comando, erro };
+    escrever_u32(carga + 2, valor);
+    enviar_resposta(TRANSFERENCIA_RESP_NACK, seq, carga, sizeof(carga));
+}
+
+// O maior take importável: o banco inteiro, removendo os takes da arena
+static uint32_t capacidade_em_amostras(void) {
+    return (uint32_t)codec_capacidade_amostras(codec_importacao, banco_capacidade_bytes());
+}
+
+// Take selecionado no banco; com o banco vazio, uma gravação vazia
+static const gravacao_codificada_t *gravacao_selecionada(void) {
+    static gravacao_codificada_t vazia;
+    int indice = banco_selecionado();
+    if (indice < 0) {
+        vazia = (gravacao_codificada_t){ .codec = codec_importacao };
+        return &vazia;
+    }
+    return &banco_take((size_t)indice)->gravacao;
+}
+
+static void enviar_info(uint8_t seq, const gravacao_codificada_t *gravacao) {
+    uint8_t carga[MAX_CARGA_RESPOSTA];
+
+    carga[0] = (uint8_t)gravacao->codec;
+    carga[1] = ((uintptr_t)gravacao->dados < SRAM_BASE) ? ORIGEM_FLASH : ORIGEM_RAM;
+    escrever_u16(carga + 2, CODEC_AMOSTRAS_POR_BLOCO);
+    escrever_u32(carga + 4, gravacao->freq_amostragem);
+    escrever_u32(carga + 8, (uint32_t)gravacao->n_amostras);
+    escrever_u32(carga + 12, (uint32_t)gravacao->bytes_usados);
+    escrever_u32(carga + 16, capacidade_em_amostras());
+    enviar_resposta(TRANSFERENCIA_RESP_INFO, seq, carga, sizeof(carga));
+}
+
+static void enviar_perfil(uint8_t seq, indice_perfil_taxa_t indice) {
+    const perfil_taxa_t *perfil = &perfis_taxa[indice];
+    uint8_t carga[11 + TAMANHO_NOME_PERFIL_TAXA] = { (uint8_t)indice, N_PERFIS_TAXA, (uint8_t)perfis_taxa_escolhido() };
+
+    escrever_u32(carga + 3, perfil->taxa);
+    escrever_u32(carga + 7, perfil->freq_sistema_hz);
+    strncpy((char *)carga + 11, perfil->nome, TAMANHO_NOME_PERFIL_TAXA - 1);
+    enviar_resposta(TRANSFERENCIA_RESP_PERFIL, seq, carga, sizeof(carga));
+}
+
+static void enviar_take(uint8_t seq, size_t indice) {
+    const gravacao_codificada_t *gravacao = &banco_take(indice)->gravacao;
+    uint8_t carga[MAX_CARGA_RESPOSTA] = { (uint8_t)indice, (uint8_t)banco_n_takes(), (uint8_t)banco_selecionado(),
+                                          (uint8_t)gravacao->codec };
+
+    escrever_u32(carga + 4, gravacao->freq_amostragem);
+    escrever_u32(carga + 8, (uint32_t)gravacao->n_amostras);
+    escrever_u32(carga + 12, (uint32_t)gravacao->bytes_usados);
+    escrever_u32(carga + 16, (uint32_t)banco_livre_bytes());
+    enviar_resposta(TRANSFERENCIA_RESP_TAKE, seq, carga, sizeof(carga));
+}
+
+// Enfileira o quanto couber da exportação; retorna true ao enfileirar o FIM
+static bool avancar_exportacao(void) {
+    while (exportacao.ativa) {
+        uint32_t livre = tud_cdc_n_write_available(INSTANCIA);
+
+        switch (exportacao.etapa) {
+            case ETAPA_CABECALHO: {
+                if (exportacao.posicao == exportacao.total) {
+                    if (livre < TAMANHO_MAX_RESPOSTA) return false;
+
+                    uint8_t carga[8];
+                    escrever_u32(carga, (uint32_t)exportacao.total);
+                    escrever_u32(carga + 4, exportacao.crc_total);
+                    enviar_resposta(TRANSFERENCIA_RESP_FIM, exportacao.seq, carga, sizeof(carga));
+
+                    exportacao.ativa = false;
+                    estatisticas.exportacoes++;
+                    estatisticas.ultima_exportacao_us = time_us_32() - exportacao.inicio_us;
+                    estatisticas.ultima_exportacao_bytes = (uint32_t)exportacao.total;
+                    return true;
+                }
+
+                uint8_t cabecalho[TRANSFERENCIA_TAMANHO_CABECALHO + 4];
+                if (livre < sizeof(cabecalho)) return false;
+
+                size_t n = exportacao.total - exportacao.posicao;
+                if (n > TRANSFERENCIA_CARGA_EXPORTACAO) n = TRANSFERENCIA_CARGA_EXPORTACAO;
+                montar_cabecalho(cabecalho, TRANSFERENCIA_RESP_DADOS, exportacao.seq++, (uint16_t)(4 + n));
+                escrever_u32(cabecalho + TRANSFERENCIA_TAMANHO_CABECALHO, (uint32_t)exportacao.posicao);
+                tud_cdc_n_write(INSTANCIA, cabecalho, sizeof(cabecalho));
+
+                exportacao.crc_quadro = crc32_atualizar(0, cabecalho + 2, sizeof(cabecalho) - 2);
+                exportacao.restante = n;
+                exportacao.etapa = ETAPA_CARGA;
+                break;
+            }
+
+            case ETAPA_CARGA: {
+                // A carga vai da gravação (RAM ou XIP) direto para a FIFO do CDC
+                const uint8_t *origem = exportacao.dados + exportacao.posicao;
+                uint32_t n = (exportacao.restante < livre) ? (uint32_t)exportacao.restante : livre;
+                if (n > 0) n = tud_cdc_n_write(INSTANCIA, origem, n);
+                if (n == 0) return false;
+
+                exportacao.crc_quadro = crc32_atualizar(exportacao.crc_quadro, origem, n);
+                exportacao.crc_total = crc32_atualizar(exportacao.crc_total, origem, n);
+                exportacao.posicao += n;
+                exportacao.restante -= n;
+                if (exportacao.restante == 0) exportacao.etapa = ETAPA_CRC;
+                break;
+            }
+
+            case ETAPA_CRC: {
+                if (livre < TRANSFERENCIA_TAMANHO_CRC) return false;
+
+                uint8_t crc[TRANSFERENCIA_TAMANHO_CRC];
+                escrever_u32(crc, exportacao.crc_quadro);
+                tud_cdc_n_write(INSTANCIA, crc, sizeof(crc));
+                exportacao.etapa = ETAPA_CABECALHO;
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+static void iniciar_exportacao(uint8_t seq, const gravacao_codificada_t *gravacao) {
+    enviar_info(seq, gravacao);
+
+    exportacao.ativa = true;
+    exportacao.dados = gravacao->dados;
+    exportacao.total = (gravacao->dados != NULL) ? gravacao->bytes_usados : 0;
+    exportacao.posicao = 0;
+    exportacao.etapa = ETAPA_CABECALHO;
+    exportacao.crc_total = 0;
+    exportacao.seq = (uint8_t)(seq + 1);
+    exportacao.inicio_us = time_us_32();
+}
+
+// O take parcial não serve para nada: volta a ser espaço livre do banco
+static void cancelar_importacao(void) {
+    importacao.ativa = false;
+    banco_descartar_take_aberto();
+}
+
+static resultado_transferencia_t importar_amostras(uint8_t seq, const uint8_t *carga, size_t n) {
+    if (!importacao.ativa) {
+        enviar_nack(seq, TRANSFERENCIA_CMD_AMOSTRAS, TRANSFERENCIA_ERRO_ESTADO, 0);
+        return TRANSFERENCIA_OCIOSA;
+    }
+
+    uint32_t indice = (n >= 4) ? ler_u32(carga) : 0;
+    uint32_t esperadas = importacao.n_amostras - importacao.recebidas;
+    if (esperadas > CODEC_AMOSTRAS_POR_BLOCO) esperadas = CODEC_AMOSTRAS_POR_BLOCO;
+
+    if (n != 4 + 2 * esperadas) {
+        enviar_nack(seq, TRANSFERENCIA_CMD_AMOSTRAS, TRANSFERENCIA_ERRO_COMANDO, esperadas);
+    } else if (indice != importacao.recebidas) {
+        enviar_nack(seq, TRANSFERENCIA_CMD_AMOSTRAS, TRANSFERENCIA_ERRO_SEQUENCIA, importacao.recebidas);
+    } else {
+        for (uint32_t i = 0; i < esperadas; i++) {
+            uint16_t amostra = ler_u16(carga + 4 + 2 * i);
+            bloco_importado[i] = (amostra > DSP_AMOSTRA_MAX) ? DSP_AMOSTRA_MAX : amostra;
+        }
+        if (gravacao_anexar_bloco(importacao.gravacao, bloco_importado, esperadas)) {
+            importacao.recebidas += esperadas;
+            return TRANSFERENCIA_EM_CURSO;
+        }
+        enviar_nack(seq, TRANSFERENCIA_CMD_AMOSTRAS, TRANSFERENCIA_ERRO_CAPACIDADE, capacidade_em_amostras());
+    }
+
+    cancelar_importacao();
+    return TRANSFERENCIA_GRAVACAO_ALTERADA;
+}
+
+static resultado_transferencia_t tratar_comando(uint8_t tipo, uint8_t seq, const uint8_t *carga, size_t n) {
+    switch (tipo) {
+        case TRANSFERENCIA_CMD_INFO:
+            enviar_info(seq, gravacao_selecionada());
+            return TRANSFERENCIA_OCIOSA;
+
+        case TRANSFERENCIA_CMD_EXPORTAR:
+            iniciar_exportacao(seq, gravacao_selecionada());
+            return TRANSFERENCIA_EM_CURSO;
+
+        case TRANSFERENCIA_CMD_IMPORTAR: {
+            uint32_t freq = (n == 8) ? ler_u32(carga) : 0;
+            uint32_t n_amostras = (n == 8) ? ler_u32(carga + 4) : 0;
+
+            // Uma taxa fora da faixa estouraria a razão 32.32 do reamostrador ao tocar o take
+            if (freq < TRANSFERENCIA_FREQ_MINIMA || freq > TRANSFERENCIA_FREQ_MAXIMA || n_amostras == 0) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_COMANDO, TRANSFERENCIA_FREQ_MAXIMA);
+                return TRANSFERENCIA_OCIOSA;
+            }
+            if (n_amostras > capacidade_em_amostras()) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_CAPACIDADE, capacidade_em_amostras());
+                return TRANSFERENCIA_OCIOSA;
+            }
+
+            // Um IMPORTAR no meio de outro recomeça; os takes mais antigos saem se faltar espaço
+            bool havia_importacao = importacao.ativa;
+            if (havia_importacao) cancelar_importacao();
+            gravacao_codificada_t *take = NULL;
+            if (banco_reservar(codec_bytes_para_amostras(codec_importacao, n_amostras))) {
+                take = banco_abrir_take(codec_importacao, freq);
+            }
+            if (take == NULL) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_ESTADO, 0);
+                return havia_importacao ? TRANSFERENCIA_GRAVACAO_ALTERADA : TRANSFERENCIA_OCIOSA;
+            }
+            importacao.ativa = true;
+            importacao.gravacao = take;
+            importacao.n_amostras = n_amostras;
+            importacao.recebidas = 0;
+            enviar_ack(seq, tipo, n_amostras);
+            return TRANSFERENCIA_EM_CURSO;
+        }
+
+        case TRANSFERENCIA_CMD_AMOSTRAS:
+            return importar_amostras(seq, carga, n);
+
+        case TRANSFERENCIA_CMD_CONCLUIR:
+            if (!importacao.ativa) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_ESTADO, 0);
+                return TRANSFERENCIA_OCIOSA;
+            }
+            if (importacao.recebidas != importacao.n_amostras) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_SEQUENCIA, importacao.recebidas);
+                cancelar_importacao();
+                return TRANSFERENCIA_GRAVACAO_ALTERADA;
+            }
+            importacao.ativa = false;
+            banco_fechar_take(); // Passa a ser o take selecionado
+            estatisticas.importacoes++;
+            enviar_ack(seq, tipo, importacao.recebidas);
+            return TRANSFERENCIA_GRAVACAO_ALTERADA;
+
+        case TRANSFERENCIA_CMD_PERFIL: {
+            uint32_t indice = (n >= 1) ? carga[0] : (uint32_t)perfis_taxa_escolhido();
+            bool escolher = (n == 2) && carga[1] != 0;
+
+            if (n > 2 || indice >= N_PERFIS_TAXA) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_COMANDO, N_PERFIS_TAXA);
+                return TRANSFERENCIA_OCIOSA;
+            }
+            bool alterado = escolher && indice != perfis_taxa_escolhido();
+            if (escolher) perfis_taxa_escolher((indice_perfil_taxa_t)indice);
+            enviar_perfil(seq, (indice_perfil_taxa_t)indice);
+            return alterado ? TRANSFERENCIA_PERFIL_ALTERADO : TRANSFERENCIA_OCIOSA;
+        }
+
+        case TRANSFERENCIA_CMD_TAKE: {
+            int selecionado = banco_selecionado();
+            uint32_t indice = (n >= 1) ? carga[0] : (uint32_t)selecionado;
+            bool selecionar = (n == 2) && carga[1] != 0;
+
+            if (n > 2 || selecionado < 0 || indice >= banco_n_takes()) {
+                enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_COMANDO, (uint32_t)banco_n_takes());
+                return TRANSFERENCIA_OCIOSA;
+            }
+            bool alterado = selecionar && (int)indice != selecionado;
+            if (selecionar) banco_selecionar(indice);
+            enviar_take(seq, indice);
+            return alterado ? TRANSFERENCIA_TAKE_SELECIONADO : TRANSFERENCIA_OCIOSA;
+        }
+
+        default:
+            enviar_nack(seq, tipo, TRANSFERENCIA_ERRO_COMANDO, 0);
+            return TRANSFERENCIA_OCIOSA;
+    }
+}
+
+// Descarta bytes do início até o que sobrou parecer o começo de um quadro
+static void sincronizar_quadro(void) {
+    while (bytes_no_quadro > 0) {
+        bool valido = quadro[0] == TRANSFERENCIA_SINCRONISMO_0 &&
+                      (bytes_no_quadro < 2 || quadro[1] == TRANSFERENCIA_SINCRONISMO_1) &&
+                      (bytes_no_quadro < TRANSFERENCIA_TAMANHO_CABECALHO || ler_u16(quadro + 4) <= MAX_CARGA_RECEBIDA);
+        if (valido) return;
+
+        bytes_no_quadro--;
+        memmove(quadro, quadro + 1, bytes_no_quadro);
+    }
+}
+
+// Lê da FIFO só o que falta para o quadro atual; true quando ele estiver completo
+static bool completar_quadro(void) {
+    while (true) {
+        size_t necessarios = TRANSFERENCIA_TAMANHO_CABECALHO;
+        if (bytes_no_quadro >= TRANSFERENCIA_TAMANHO_CABECALHO) {
+            necessarios += ler_u16(quadro + 4) + TRANSFERENCIA_TAMANHO_CRC;
+            if (bytes_no_quadro == necessarios) return true;
+        }
+
+        uint32_t lidos = tud_cdc_n_read(INSTANCIA, quadro + bytes_no_quadro, (uint32_t)(necessarios - bytes_no_quadro));
+        if (lidos == 0) return false;
+        bytes_no_quadro += lidos;
+        sincronizar_quadro();
+    }
+}
+
+static resultado_transferencia_t receber_comandos(void) {
+    resultado_transferencia_t resultado = TRANSFERENCIA_OCIOSA;
+
+    // Cada comando pode responder: sem espaço para a resposta, fica para a próxima passada
+    while (!exportacao.ativa && tud_cdc_n_write_available(INSTANCIA) >= TAMANHO_MAX_RESPOSTA && completar_quadro()) {
+        size_t n = ler_u16(quadro + 4);
+        const uint8_t *carga = quadro + TRANSFERENCIA_TAMANHO_CABECALHO;
+        uint32_t crc = crc32_atualizar(0, quadro + 2, TRANSFERENCIA_TAMANHO_CABECALHO - 2 + n);
+        bytes_no_quadro = 0;
+
+        if (crc != ler_u32(carga + n)) {
+            estatisticas.quadros_rejeitados++;
+            enviar_nack(quadro[3], 0, TRANSFERENCIA_ERRO_CRC, 0);
+            if (importacao.ativa) {
+                cancelar_importacao();
+                resultado = TRANSFERENCIA_GRAVACAO_ALTERADA;
+            }
+            continue;
+        }
+
+        resultado_transferencia_t r = tratar_comando(quadro[2], quadro[3], carga, n);
+        if (r != TRANSFERENCIA_OCIOSA && resultado != TRANSFERENCIA_GRAVACAO_ALTERADA) resultado = r;
+    }
+    return resultado;
+}
+
+void transferencia_usb_iniciar(codec_amostras_t codec) {
+    codec_importacao = codec;
+    exportacao.ativa = false;
+    importacao.ativa = false;
+    bytes_no_quadro = 0;
+    estatisticas = (estatisticas_transferencia_t){ 0 };
+}
+
+resultado_transferencia_t transferencia_usb_servico(void) {
+    if (!tud_cdc_n_connected(INSTANCIA)) {
+        // Porta fechada no host: o que estava em curso é abandonado
+        exportacao.ativa = false;
+        bytes_no_quadro = 0;
+        if (importacao.ativa) {
+            cancelar_importacao();
+            return TRANSFERENCIA_GRAVACAO_ALTERADA;
+        }
+        return TRANSFERENCIA_OCIOSA;
+    }
+
+    resultado_transferencia_t resultado = receber_comandos();
+    bool exportou = avancar_exportacao();
+    tud_cdc_n_write_flush(INSTANCIA);
+
+    if (resultado == TRANSFERENCIA_GRAVACAO_ALTERADA) return resultado;
+    if (exportou) return TRANSFERENCIA_EXPORTADA;
+    if (exportacao.ativa || importacao.ativa || bytes_no_quadro > 0) return TRANSFERENCIA_EM_CURSO;
+    return resultado;
+}
+
+estatisticas_transferencia_t transferencia_usb_estatisticas(void) {
+    return estatisticas;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file transferencia_usb.h
+ * @brief Exportação e importação de gravações por um protocolo binário na segunda porta CDC.
+ *
+ * O console (printf) continua na primeira porta; esta só transporta quadros:
+ *
+ *     A5 5A | tipo | seq | comprimento (u16) | carga | CRC-32 (u32)
+ *
+ * Campos em little-endian. O CRC-32 é o do zlib/PKZIP e cobre de `tipo` até o
+ * fim da carga. As respostas repetem o `seq` do comando; os quadros de dados
+ * da exportação numeram-se a partir do seguinte.
+ *
+ * Comandos (host -> placa):
+ * - INFO: sem carga; responde INFO do take selecionado no banco (codec,
+ *   origem, amostras por bloco, taxa, n de amostras, bytes, capacidade de
+ *   importação em amostras).
+ * - EXPORTAR: responde INFO, DADOS (deslocamento u32 + bytes) até cobrir a
+ *   gravação e FIM (total de bytes + CRC-32 da gravação inteira). Os bytes são
+ *   os da gravação como estão guardados (no codec dela), lidos direto da RAM
+ *   ou da flash (XIP) para a FIFO do CDC, sem cópia intermediária; o host
+ *   decodifica (ver ferramentas/transferir_gravacao.py).
+ * - IMPORTAR: taxa (u32) + n de amostras (u32); abre um take no banco
+ *   (removendo os mais antigos se faltar espaço) e responde ACK ou NACK.
+ *   A taxa vai de TRANSFERENCIA_FREQ_MINIMA a _MAXIMA, a faixa dos perfis:
+ *   fora dela o passo do reamostrador não cabe nos 32.32.
+ * - AMOSTRAS: índice da primeira amostra (u32) + amostras de 12 bits (u16),
+ *   um bloco do codec por quadro (o último pode ser menor). Sem resposta;
+ *   um erro responde NACK e cancela a importação.
+ * - CONCLUIR: confere o total; responde ACK com o n de amostras ou NACK.
+ * - PERFIL: sem carga, descreve o perfil de taxa escolhido; com índice (u8)
+ *   descreve esse perfil e, com um segundo byte não nulo, o escolhe para a
+ *   próxima gravação. Responde PERFIL (índice, n de perfis, escolhido (u8),
+ *   taxa, clk_sys (u32) e nome com NUL, 8 bytes) ou NACK.
+ * - TAKE: o mesmo para os takes do banco; com o segundo byte não nulo, o
+ *   take passa a ser o reproduzido e exportado. Responde TAKE (índice, n de
+ *   takes, selecionado, codec (u8), taxa, n de amostras, bytes e espaço
+ *   livre no banco (u32)) ou NACK.
+ *
+ * A importação codifica as amostras num take novo do banco (no codec da
+ * gravação em RAM), que fica selecionado ao concluir. Tudo roda no núcleo 0, fora da
+ * gravação e da reprodução; as FIFOs do CDC são protegidas pelos mutexes do
+ * TinyUSB, que as atende no núcleo 1 (console_usb.h).
+ */
+#ifndef TRANSFERENCIA_USB_H
+#define TRANSFERENCIA_USB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec_amostras.h"
+
+#define TRANSFERENCIA_SINCRONISMO_0 0xA5
+#define TRANSFERENCIA_SINCRONISMO_1 0x5A
+#define TRANSFERENCIA_TAMANHO_CABECALHO 6
+#define TRANSFERENCIA_TAMANHO_CRC 4
+#define TRANSFERENCIA_CARGA_EXPORTACAO 4096 // Bytes de gravação por quadro de dados exportado
+#define TRANSFERENCIA_FREQ_MINIMA 8000       // Taxas aceitas pelo IMPORTAR (Hz)
+#define TRANSFERENCIA_FREQ_MAXIMA 48000
+
+// Comandos
+#define TRANSFERENCIA_CMD_INFO 0x01
+#define TRANSFERENCIA_CMD_EXPORTAR 0x02
+#define TRANSFERENCIA_CMD_IMPORTAR 0x03
+#define TRANSFERENCIA_CMD_AMOSTRAS 0x04
+#define TRANSFERENCIA_CMD_CONCLUIR 0x05
+#define TRANSFERENCIA_CMD_PERFIL 0x06
+#define TRANSFERENCIA_CMD_TAKE 0x07
+
+// Respostas
+#define TRANSFERENCIA_RESP_INFO 0x81
+#define TRANSFERENCIA_RESP_DADOS 0x82
+#define TRANSFERENCIA_RESP_FIM 0x83
+#define TRANSFERENCIA_RESP_ACK 0x84
+#define TRANSFERENCIA_RESP_NACK 0x85
+#define TRANSFERENCIA_RESP_PERFIL 0x86
+#define TRANSFERENCIA_RESP_TAKE 0x87
+
+// Códigos de erro do NACK (carga: comando u8, erro u8, valor u32)
+#define TRANSFERENCIA_ERRO_CRC 1        // Quadro corrompido (comando = 0)
+#define TRANSFERENCIA_ERRO_COMANDO 2    // Tipo ou carga inválidos (PERFIL, TAKE: valor = n de entradas; IMPORTAR: taxa máxima)
+#define TRANSFERENCIA_ERRO_ESTADO 3     // Sem importação em curso (IMPORTAR: banco sem entrada livre)
+#define TRANSFERENCIA_ERRO_CAPACIDADE 4 // Valor = capacidade em amostras
+#define TRANSFERENCIA_ERRO_SEQUENCIA 5  // Valor = índice de amostra esperado
+
+typedef enum {
+    TRANSFERENCIA_OCIOSA,
+    TRANSFERENCIA_EM_CURSO,           // Há quadros por enviar ou receber: chamar de novo logo
+    TRANSFERENCIA_EXPORTADA,          // O último quadro de uma exportação foi enfileirado
+    TRANSFERENCIA_GRAVACAO_ALTERADA,  // Importação concluída ou cancelada: o banco mudou
+    TRANSFERENCIA_PERFIL_ALTERADO,    // O host escolheu outro perfil de taxa
+    TRANSFERENCIA_TAKE_SELECIONADO,   // O host escolheu outro take do banco
+} resultado_transferencia_t;
+
+typedef struct {
+    uint32_t exportacoes;
+    uint32_t importacoes;
+    uint32_t quadros_rejeitados; // CRC ou formato inválidos
+    uint32_t ultima_exportacao_us;
+    uint32_t ultima_exportacao_bytes;
+} estatisticas_transferencia_t;
+
+// A importação grava no banco de takes (banco_amostras.h), no `codec` dado
+void transferencia_usb_iniciar(codec_amostras_t codec);
+
+// Atende o protocolo sem bloquear: envia o que couber na FIFO e trata os
+// comandos completos. INFO e EXPORTAR usam o take selecionado no banco.
+resultado_transferencia_t transferencia_usb_servico(void);
+
+estatisticas_transferencia_t transferencia_usb_estatisticas(void);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file tusb_config.h
+ * @brief Configuração do TinyUSB: dois CDC (stdio e transferência binária) + áudio UAC2.
+ *
+ * O stdio USB do SDK fica desligado: os descritores são os de
+ * usb_descritores.c e o tud_task() roda no laço do núcleo 1 (console_usb.h).
+ */
+#ifndef TUSB_CONFIG_H
+#define TUSB_CONFIG_H
+
+#ifndef CFG_TUSB_MCU
+#error CFG_TUSB_MCU deve ser definido pelo build do SDK
+#endif
+
+#define CFG_TUSB_RHPORT0_MODE OPT_MODE_DEVICE
+#ifndef CFG_TUSB_OS
+#define CFG_TUSB_OS OPT_OS_PICO
+#endif
+
+#define CFG_TUD_ENDPOINT0_SIZE 64
+
+// --- Classes ---
+#define CFG_TUD_CDC 2 // 0: console (stdio); 1: transferência de gravações (transferencia_usb.h)
+#define CFG_TUD_AUDIO 1
+#define CFG_TUD_MSC 0
+#define CFG_TUD_HID 0
+#define CFG_TUD_MIDI 0
+#define CFG_TUD_VENDOR 0
+
+// --- CDC ---
+// Os tamanhos valem para as duas instâncias. A FIFO de transmissão maior deixa
+// a exportação adiantar vários pacotes por passada do núcleo 0.
+#define CFG_TUD_CDC_RX_BUFSIZE 256
+#define CFG_TUD_CDC_TX_BUFSIZE 1024
+#define CFG_TUD_CDC_EP_BUFSIZE 64
+
+// --- Áudio: 48 kHz, 16 bits, mono nos dois sentidos ---
+#define AUDIO_USB_FREQ_AMOSTRAGEM 48000
+#define AUDIO_USB_BYTES_POR_AMOSTRA 2
+#define AUDIO_USB_BITS_POR_AMOSTRA 16
+#define AUDIO_USB_N_CANAIS 1
+
+// Controle + clock + dois caminhos (terminal de entrada -> terminal de saída)
+#define AUDIO_USB_DESC_CS_AC_LEN (TUD_AUDIO_DESC_CLK_SRC_LEN + 2 * TUD_AUDIO_DESC_INPUT_TERM_LEN + \
+                                  2 * TUD_AUDIO_DESC_OUTPUT_TERM_LEN)
+// Alternativa 0 (sem endpoints) e 1 (streaming) de cada interface de áudio
+#define AUDIO_USB_DESC_AS_LEN (TUD_AUDIO_DESC_STD_AS_INT_LEN + TUD_AUDIO_DESC_STD_AS_INT_LEN + \
+                               TUD_AUDIO_DESC_CS_AS_INT_LEN + TUD_AUDIO_DESC_TYPE_I_FORMAT_LEN + \
+                               TUD_AUDIO_DESC_STD_AS_ISO_EP_LEN + TUD_AUDIO_DESC_CS_AS_ISO_EP_LEN)
+#define AUDIO_USB_DESC_LEN (TUD_AUDIO_DESC_IAD_LEN + TUD_AUDIO_DESC_STD_AC_LEN + TUD_AUDIO_DESC_CS_AC_LEN + \
+                            AUDIO_USB_DESC_CS_AC_LEN + 2 * AUDIO_USB_DESC_AS_LEN + TUD_AUDIO_DESC_STD_AS_ISO_FB_EP_LEN)
+
+#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN AUDIO_USB_DESC_LEN
+#define CFG_TUD_AUDIO_FUNC_1_N_AS_INT 2
+#define CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ 64
+
+// Microfone (placa -> host): até 49 amostras por quadro de 1 ms
+#define CFG_TUD_AUDIO_ENABLE_EP_IN 1
+#define CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_TX AUDIO_USB_BYTES_POR_AMOSTRA
+#define CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_TX AUDIO_USB_N_CANAIS
+#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX TUD_AUDIO_EP_SIZE(AUDIO_USB_FREQ_AMOSTRAGEM, AUDIO_USB_BYTES_POR_AMOSTRA, AUDIO_USB_N_CANAIS)
+#define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ (2 * CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX)
+
+// Alto-falante (host -> placa), assíncrono com endpoint de realimentação
+#define CFG_TUD_AUDIO_ENABLE_EP_OUT 1
+#define CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP 1
+// O valor é montado em 16.16; em full speed o TinyUSB o converte para os 10.14
+// (3 bytes) que a especificação pede (USB 2.0, 5.12.4.2)
+#define CFG_TUD_AUDIO_ENABLE_FEEDBACK_FORMAT_CORRECTION 1
+#define CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX AUDIO_USB_BYTES_POR_AMOSTRA
+#define CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX AUDIO_USB_N_CANAIS
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX TUD_AUDIO_EP_SIZE(AUDIO_USB_FREQ_AMOSTRAGEM, AUDIO_USB_BYTES_POR_AMOSTRA, AUDIO_USB_N_CANAIS)
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ (4 * CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX)
+
+#endif
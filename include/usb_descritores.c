@@ -0,0 +1,148 @@
+/**
+ * @file usb_descritores.c
+ * @brief Descritores do dispositivo composto: CDC (stdio) + UAC2 (microfone e alto-falante)
+ *        + CDC (transferência binária de gravações).
+ *
+ * Substituem os descritores do stdio USB do SDK, que fica desligado (ver
+ * console_usb.h). A interface de reset do picotool
+ * deixa de existir; o BOOTSEL continua sendo o caminho para regravar.
+ */
+#include <string.h>
+#include "pico/unique_id.h"
+#include "tusb.h"
+#include "usb_descritores.h"
+
+#define USB_VID 0x2E8A // Raspberry Pi
+#define USB_PID 0x000A // O mesmo do stdio USB do SDK...
+#define USB_BCD_DISPOSITIVO 0x0200 // ...com outra versão, para o host não reaproveitar descritores em cache
+
+#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + 2 * TUD_CDC_DESC_LEN + CFG_TUD_AUDIO_FUNC_1_DESC_LEN)
+
+enum {
+    STRING_IDIOMA = 0,
+    STRING_FABRICANTE,
+    STRING_PRODUTO,
+    STRING_SERIE,
+    STRING_CDC,
+    STRING_AUDIO,
+    STRING_CDC_BINARIO,
+    N_STRINGS
+};
+
+static const tusb_desc_device_t descritor_dispositivo = {
+    .bLength = sizeof(tusb_desc_device_t),
+    .bDescriptorType = TUSB_DESC_DEVICE,
+    .bcdUSB = 0x0200,
+    // Composto com IAD
+    .bDeviceClass = TUSB_CLASS_MISC,
+    .bDeviceSubClass = MISC_SUBCLASS_COMMON,
+    .bDeviceProtocol = MISC_PROTOCOL_IAD,
+    .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor = USB_VID,
+    .idProduct = USB_PID,
+    .bcdDevice = USB_BCD_DISPOSITIVO,
+    .iManufacturer = STRING_FABRICANTE,
+    .iProduct = STRING_PRODUTO,
+    .iSerialNumber = STRING_SERIE,
+    .bNumConfigurations = 1,
+};
+
+#define ATRIBUTOS_ISO_DADOS (TUSB_XFER_ISOCHRONOUS | TUSB_ISO_EP_ATT_ASYNCHRONOUS | TUSB_ISO_EP_ATT_DATA)
+
+static const uint8_t descritor_configuracao[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0x00, 100),
+
+    TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, STRING_CDC, EP_CDC_NOTIFICACAO, 8, EP_CDC_SAIDA, EP_CDC_ENTRADA, 64),
+
+    // --- Função de áudio ---
+    TUD_AUDIO_DESC_IAD(ITF_NUM_AUDIO_CONTROLE, 3, STRING_AUDIO),
+    TUD_AUDIO_DESC_STD_AC(ITF_NUM_AUDIO_CONTROLE, 0x00, STRING_AUDIO),
+    TUD_AUDIO_DESC_CS_AC(0x0200, AUDIO_FUNC_HEADSET, AUDIO_USB_DESC_CS_AC_LEN, AUDIO_CS_AS_INTERFACE_CTRL_LATENCY_POS),
+    // Um único clock interno fixo para os dois sentidos
+    TUD_AUDIO_DESC_CLK_SRC(UAC2_ENTIDADE_CLOCK, AUDIO_CLOCK_SOURCE_ATT_INT_FIX_CLK,
+                           (AUDIO_CTRL_R << AUDIO_CLOCK_SOURCE_CTRL_CLK_FRQ_POS), 0x00, 0x00),
+    // Alto-falante: stream USB -> buzzer (sem unidade de volume: o host ajusta no software)
+    TUD_AUDIO_DESC_INPUT_TERM(UAC2_ENTIDADE_ENTRADA_USB, AUDIO_TERM_TYPE_USB_STREAMING, 0x00, UAC2_ENTIDADE_CLOCK,
+                              AUDIO_USB_N_CANAIS, AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, 0x00, 0x0000, 0x00),
+    TUD_AUDIO_DESC_OUTPUT_TERM(UAC2_ENTIDADE_SAIDA_BUZZER, AUDIO_TERM_TYPE_OUT_GENERIC_SPEAKER, 0x00,
+                               UAC2_ENTIDADE_ENTRADA_USB, UAC2_ENTIDADE_CLOCK, 0x0000, 0x00),
+    // Microfone: ADC -> stream USB
+    TUD_AUDIO_DESC_INPUT_TERM(UAC2_ENTIDADE_ENTRADA_MIC, AUDIO_TERM_TYPE_IN_GENERIC_MIC, 0x00, UAC2_ENTIDADE_CLOCK,
+                              AUDIO_USB_N_CANAIS, AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, 0x00, 0x0000, 0x00),
+    TUD_AUDIO_DESC_OUTPUT_TERM(UAC2_ENTIDADE_SAIDA_USB, AUDIO_TERM_TYPE_USB_STREAMING, 0x00,
+                               UAC2_ENTIDADE_ENTRADA_MIC, UAC2_ENTIDADE_CLOCK, 0x0000, 0x00),
+
+    // Interface do alto-falante: alternativa 0 sem banda, 1 com dados + realimentação
+    TUD_AUDIO_DESC_STD_AS_INT(ITF_NUM_AUDIO_ALTO_FALANTE, 0x00, 0x00, 0x00),
+    TUD_AUDIO_DESC_STD_AS_INT(ITF_NUM_AUDIO_ALTO_FALANTE, 0x01, 0x02, 0x00),
+    TUD_AUDIO_DESC_CS_AS_INT(UAC2_ENTIDADE_ENTRADA_USB, AUDIO_CTRL_NONE, AUDIO_FORMAT_TYPE_I, AUDIO_DATA_FORMAT_TYPE_I_PCM,
+                             AUDIO_USB_N_CANAIS, AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, 0x00),
+    TUD_AUDIO_DESC_TYPE_I_FORMAT(AUDIO_USB_BYTES_POR_AMOSTRA, AUDIO_USB_BITS_POR_AMOSTRA),
+    TUD_AUDIO_DESC_STD_AS_ISO_EP(EP_AUDIO_ALTO_FALANTE, ATRIBUTOS_ISO_DADOS, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX, 0x01),
+    TUD_AUDIO_DESC_CS_AS_ISO_EP(AUDIO_CS_AS_ISO_DATA_EP_ATT_NON_MAX_PACKETS_OK, AUDIO_CTRL_NONE,
+                                AUDIO_CS_AS_ISO_DATA_EP_LOCK_DELAY_UNIT_UNDEFINED, 0x0000),
+    TUD_AUDIO_DESC_STD_AS_ISO_FB_EP(EP_AUDIO_REALIMENTACAO, 0x01),
+
+    // Interface do microfone
+    TUD_AUDIO_DESC_STD_AS_INT(ITF_NUM_AUDIO_MICROFONE, 0x00, 0x00, 0x00),
+    TUD_AUDIO_DESC_STD_AS_INT(ITF_NUM_AUDIO_MICROFONE, 0x01, 0x01, 0x00),
+    TUD_AUDIO_DESC_CS_AS_INT(UAC2_ENTIDADE_SAIDA_USB, AUDIO_CTRL_NONE, AUDIO_FORMAT_TYPE_I, AUDIO_DATA_FORMAT_TYPE_I_PCM,
+                             AUDIO_USB_N_CANAIS, AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, 0x00),
+    TUD_AUDIO_DESC_TYPE_I_FORMAT(AUDIO_USB_BYTES_POR_AMOSTRA, AUDIO_USB_BITS_POR_AMOSTRA),
+    TUD_AUDIO_DESC_STD_AS_ISO_EP(EP_AUDIO_MICROFONE, ATRIBUTOS_ISO_DADOS, CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX, 0x01),
+    TUD_AUDIO_DESC_CS_AS_ISO_EP(AUDIO_CS_AS_ISO_DATA_EP_ATT_NON_MAX_PACKETS_OK, AUDIO_CTRL_NONE,
+                                AUDIO_CS_AS_ISO_DATA_EP_LOCK_DELAY_UNIT_UNDEFINED, 0x0000),
+
+    // Segunda porta serial, só para o protocolo binário: o log do printf não se mistura aos quadros
+    TUD_CDC_DESCRIPTOR(ITF_NUM_CDC_BINARIO, STRING_CDC_BINARIO, EP_CDC_BINARIO_NOTIFICACAO, 8,
+                       EP_CDC_BINARIO_SAIDA, EP_CDC_BINARIO_ENTRADA, 64),
+};
+
+_Static_assert(sizeof(descritor_configuracao) == CONFIG_TOTAL_LEN, "tamanho do descritor de configuração");
+
+static const char *const textos[N_STRINGS] = {
+    [STRING_FABRICANTE] = "Raspberry Pi",
+    [STRING_PRODUTO] = "Sintetizador de Audio",
+    [STRING_CDC] = "Console",
+    [STRING_AUDIO] = "Sintetizador de Audio",
+    [STRING_CDC_BINARIO] = "Transferencia",
+};
+
+const uint8_t *tud_descriptor_device_cb(void) {
+    return (const uint8_t *)&descritor_dispositivo;
+}
+
+const uint8_t *tud_descriptor_configuration_cb(uint8_t indice) {
+    (void)indice;
+    return descritor_configuracao;
+}
+
+const uint16_t *tud_descriptor_string_cb(uint8_t indice, uint16_t idioma) {
+    (void)idioma;
+    static uint16_t descritor[32];
+    static char serie[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+    size_t n;
+
+    if (indice == STRING_IDIOMA) {
+        descritor[1] = 0x0409; // Inglês (EUA)
+        n = 1;
+    } else {
+        if (indice >= N_STRINGS) return NULL;
+
+        const char *texto = textos[indice];
+        if (indice == STRING_SERIE) {
+            pico_get_unique_board_id_string(serie, sizeof(serie));
+            texto = serie;
+        }
+
+        // ASCII -> UTF-16
+        n = strlen(texto);
+        if (n > 31) n = 31;
+        for (size_t i = 0; i < n; i++) {
+            descritor[1 + i] = (uint8_t)texto[i];
+        }
+    }
+
+    descritor[0] = (uint16_t)((TUSB_DESC_STRING << 8) | (2 * n + 2));
+    return descritor;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file usb_descritores.h
+ * @brief Números de interface, endpoints e entidades do dispositivo USB composto.
+ */
+#ifndef USB_DESCRITORES_H
+#define USB_DESCRITORES_H
+
+enum {
+    ITF_NUM_CDC = 0,
+    ITF_NUM_CDC_DADOS,
+    ITF_NUM_AUDIO_CONTROLE,
+    ITF_NUM_AUDIO_ALTO_FALANTE, // Host -> placa
+    ITF_NUM_AUDIO_MICROFONE,    // Placa -> host
+    ITF_NUM_CDC_BINARIO,
+    ITF_NUM_CDC_BINARIO_DADOS,
+    ITF_NUM_TOTAL
+};
+
+#define EP_CDC_NOTIFICACAO 0x81
+#define EP_CDC_SAIDA 0x02
+#define EP_CDC_ENTRADA 0x82
+#define EP_AUDIO_ALTO_FALANTE 0x03
+#define EP_AUDIO_REALIMENTACAO 0x83
+#define EP_AUDIO_MICROFONE 0x84
+#define EP_CDC_BINARIO_NOTIFICACAO 0x85
+#define EP_CDC_BINARIO_SAIDA 0x06
+#define EP_CDC_BINARIO_ENTRADA 0x86
+
+// Instâncias do CDC no TinyUSB (na ordem dos descritores); o stdio do SDK usa a 0
+#define CDC_INSTANCIA_CONSOLE 0
+#define CDC_INSTANCIA_BINARIO 1
+
+// Entidades da função de áudio (unidades e terminais compartilham o espaço de IDs)
+#define UAC2_ENTIDADE_CLOCK 0x04
+#define UAC2_ENTIDADE_ENTRADA_USB 0x01     // Stream do host
+#define UAC2_ENTIDADE_SAIDA_BUZZER 0x03
+#define UAC2_ENTIDADE_ENTRADA_MIC 0x11
+#define UAC2_ENTIDADE_SAIDA_USB 0x13       // Stream para o host
+
+#endif
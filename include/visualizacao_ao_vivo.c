@@ -0,0 +1,178 @@
+/**
+ * @file visualizacao_ao_vivo.c
+ * @brief Desenho do osciloscópio e do medidor ao vivo (ver visualizacao_ao_vivo.h).
+ */
+#include <math.h>
+#include "indice_picos.h"
+#include "espectro_audio.h"
+#include "visualizacao_ao_vivo.h"
+
+// --- Layout: medidor na página 0, onda nas demais ---
+#define Y_BARRA_RMS 0         // Linhas 0-2
+#define Y_BARRA_PICO 4        // Linhas 4-6
+#define ALTURA_BARRA 3
+#define Y_ONDA_TOPO 10
+#define GANHO_VISUAL_ONDA_MAXIMO 8 // A escala sai da excursão visível, até este zoom
+#define DB_MINIMO_ESPECTRO -60 // Barra de espectro vazia (o piso da FFT fica perto de -70 dBFS)
+
+// --- Balística do medidor ---
+#define DB_MINIMO_MEDIDOR -48.0f                            // Início da escala (barra vazia)
+#define QUEDA_BARRA_POR_QUADRO 4                            // Pixels por quadro
+#define QUADROS_RETENCAO_PICO TAXA_QUADROS_AO_VIVO          // Marcador de pico fica 1 s
+
+static pico_t historico[ssd1306_width];
+static uint32_t proxima_coluna = 0;
+static uint32_t colunas_validas = 0;
+
+// Acumulado desde o último quadro
+static uint16_t pico_quadro = 0;
+static uint64_t soma_quadrados_quadro = 0;
+static uint32_t amostras_quadro = 0;
+
+static int barra_pico = 0;
+static int barra_rms = 0;
+static int marcador_pico = 0;
+static int quadros_desde_pico = 0;
+
+static bool modo_espectro = false;
+static int alvo_espectro[ESPECTRO_N_COLUNAS];
+static int barras_espectro[ESPECTRO_N_COLUNAS];
+
+void ao_vivo_iniciar(void) {
+    proxima_coluna = 0;
+    colunas_validas = 0;
+    pico_quadro = 0;
+    soma_quadrados_quadro = 0;
+    amostras_quadro = 0;
+    barra_pico = barra_rms = marcador_pico = 0;
+    quadros_desde_pico = 0;
+    for (int x = 0; x < ESPECTRO_N_COLUNAS; x++) {
+        alvo_espectro[x] = barras_espectro[x] = 0;
+    }
+}
+
+void ao_vivo_mostrar_espectro(bool espectro) {
+    modo_espectro = espectro;
+}
+
+void ao_vivo_consumir(const dsp_resumo_bloco_t *resumo) {
+    if (resumo->n_amostras == 0) return;
+
+    historico[proxima_coluna] = (pico_t){ .minimo = (uint8_t)(resumo->minimo >> 4), .maximo = (uint8_t)(resumo->maximo >> 4) };
+    proxima_coluna = (proxima_coluna + 1) % ssd1306_width;
+    if (colunas_validas < ssd1306_width) colunas_validas++;
+
+    // Pico e RMS a partir do nível DC do bloco: a polarização do microfone não conta como sinal
+    int centro = DSP_AMOSTRA_ZERO + resumo->soma / (int32_t)resumo->n_amostras;
+    int excursao_pos = (int)resumo->maximo - centro;
+    int excursao_neg = centro - (int)resumo->minimo;
+    int pico = (excursao_pos > excursao_neg) ? excursao_pos : excursao_neg;
+    if (pico > pico_quadro) pico_quadro = (uint16_t)pico;
+
+    soma_quadrados_quadro += dsp_resumo_energia_ac(resumo);
+    amostras_quadro += resumo->n_amostras;
+}
+
+void ao_vivo_consumir_espectro(const int8_t *colunas_dbfs) {
+    const int altura = ssd1306_height - Y_ONDA_TOPO;
+    for (int x = 0; x < ESPECTRO_N_COLUNAS; x++) {
+        int h = (colunas_dbfs[x] - DB_MINIMO_ESPECTRO) * altura / -DB_MINIMO_ESPECTRO;
+        alvo_espectro[x] = (h < 0) ? 0 : (h > altura) ? altura : h;
+    }
+}
+
+// Escala em dB relativa ao fundo de escala do ADC (2048)
+static int amplitude_para_largura(float amplitude) {
+    if (amplitude < 1.0f) return 0;
+
+    float db = 20.0f * log10f(amplitude / DSP_AMOSTRA_ZERO);
+    int largura = (int)((db - DB_MINIMO_MEDIDOR) / -DB_MINIMO_MEDIDOR * ssd1306_width);
+    if (largura < 0) largura = 0;
+    if (largura > ssd1306_width) largura = ssd1306_width;
+    return largura;
+}
+
+// Sobe imediatamente e desce no máximo QUEDA_BARRA_POR_QUADRO por quadro
+static int aplicar_balistica(int atual, int alvo) {
+    if (alvo >= atual) return alvo;
+    return (atual - QUEDA_BARRA_POR_QUADRO > alvo) ? atual - QUEDA_BARRA_POR_QUADRO : alvo;
+}
+
+static void desenhar_barra(ssd1306_framebuffer_t *framebuffer, int y, int largura) {
+    ssd1306_fill_rect(framebuffer, 0, y, largura - 1, y + ALTURA_BARRA - 1, true);
+}
+
+static void atualizar_medidores(void) {
+    float rms = (amostras_quadro > 0) ? sqrtf((float)soma_quadrados_quadro / amostras_quadro) : 0.0f;
+    int alvo_pico = amplitude_para_largura(pico_quadro);
+    int alvo_rms = amplitude_para_largura(rms);
+
+    barra_pico = aplicar_balistica(barra_pico, alvo_pico);
+    barra_rms = aplicar_balistica(barra_rms, alvo_rms);
+
+    if (alvo_pico >= marcador_pico) {
+        marcador_pico = alvo_pico;
+        quadros_desde_pico = 0;
+    } else if (++quadros_desde_pico > QUADROS_RETENCAO_PICO) {
+        marcador_pico = aplicar_balistica(marcador_pico, alvo_pico);
+    }
+
+    pico_quadro = 0;
+    soma_quadrados_quadro = 0;
+    amostras_quadro = 0;
+}
+
+// Barras crescendo de baixo para cima, com a mesma queda lenta das barras do medidor
+static void desenhar_espectro(ssd1306_framebuffer_t *framebuffer) {
+    for (int x = 0; x < ESPECTRO_N_COLUNAS; x++) {
+        barras_espectro[x] = aplicar_balistica(barras_espectro[x], alvo_espectro[x]);
+        if (barras_espectro[x] > 0) {
+            ssd1306_draw_vspan(framebuffer, x, ssd1306_height - barras_espectro[x], ssd1306_height - 1, true);
+        }
+    }
+}
+
+// Onda rolante: o bloco mais recente fica na coluna da direita
+static void desenhar_onda(ssd1306_framebuffer_t *framebuffer) {
+    const int meia_altura = (ssd1306_height - Y_ONDA_TOPO) / 2;
+    const int y_centro = Y_ONDA_TOPO + meia_altura;
+    uint32_t mais_antiga = (proxima_coluna + ssd1306_width - colunas_validas) % ssd1306_width;
+
+    // Escala pelo nível do que está na tela (as colunas válidas começam sempre na 0): a excursão
+    // visível ocupa a meia altura
+    nivel_picos_t medido = indice_picos_nivel(historico, colunas_validas);
+    int centro = medido.centro;
+    int excursao = (medido.excursao > 128 / GANHO_VISUAL_ONDA_MAXIMO) ? medido.excursao : 128 / GANHO_VISUAL_ONDA_MAXIMO;
+
+    for (uint32_t i = 0; i < colunas_validas; i++) {
+        pico_t coluna = historico[(mais_antiga + i) % ssd1306_width];
+        int x = ssd1306_width - colunas_validas + i;
+
+        int y_topo = y_centro - ((int)coluna.maximo - centro) * meia_altura / excursao;
+        int y_base = y_centro - ((int)coluna.minimo - centro) * meia_altura / excursao;
+        if (y_topo < Y_ONDA_TOPO) y_topo = Y_ONDA_TOPO;
+        if (y_topo >= ssd1306_height) y_topo = ssd1306_height - 1;
+        if (y_base < Y_ONDA_TOPO) y_base = Y_ONDA_TOPO;
+        if (y_base >= ssd1306_height) y_base = ssd1306_height - 1;
+
+        ssd1306_draw_vspan(framebuffer, x, y_topo, y_base, true);
+    }
+}
+
+void ao_vivo_desenhar(ssd1306_framebuffer_t *framebuffer) {
+    atualizar_medidores();
+    ssd1306_clear_pages(framebuffer, 0, ssd1306_n_pages - 1);
+
+    // Medidor: RMS em cima, pico embaixo e o marcador de pico retido atravessando os dois
+    desenhar_barra(framebuffer, Y_BARRA_RMS, barra_rms);
+    desenhar_barra(framebuffer, Y_BARRA_PICO, barra_pico);
+    if (marcador_pico > 0) {
+        ssd1306_draw_vspan(framebuffer, marcador_pico - 1, Y_BARRA_RMS, Y_BARRA_PICO + ALTURA_BARRA - 1, true);
+    }
+
+    if (modo_espectro) {
+        desenhar_espectro(framebuffer);
+    } else {
+        desenhar_onda(framebuffer);
+    }
+}
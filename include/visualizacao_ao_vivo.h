@@ -0,0 +1,37 @@
+/**
+ * @file visualizacao_ao_vivo.h
+ * @brief Osciloscópio rolante, espectro e medidor de pico/RMS desenhados no núcleo 1.
+ *
+ * Cada bloco de áudio chega como um dsp_resumo_bloco_t e vira uma coluna da
+ * onda (envelope mínimo/máximo); o medidor acumula os resumos recebidos entre
+ * dois quadros. O desenho de um quadro tem custo fixo (uma passada pelas
+ * colunas), independente de quantos blocos chegaram.
+ *
+ * No modo espectro, a área da onda mostra barras em dBFS (uma por coluna),
+ * atualizadas por ao_vivo_consumir_espectro; o medidor continua igual.
+ */
+#ifndef VISUALIZACAO_AO_VIVO_H
+#define VISUALIZACAO_AO_VIVO_H
+
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "dsp_audio.h"
+
+#define TAXA_QUADROS_AO_VIVO 30 // Quadros por segundo
+
+// Zera o histórico e os medidores
+void ao_vivo_iniciar(void);
+
+// Incorpora o resumo de um bloco ao histórico e aos medidores do próximo quadro
+void ao_vivo_consumir(const dsp_resumo_bloco_t *resumo);
+
+// Alterna a área abaixo do medidor entre a onda rolante e o espectro
+void ao_vivo_mostrar_espectro(bool espectro);
+
+// Novo espectro (ESPECTRO_N_COLUNAS níveis em dBFS) para as barras do próximo quadro
+void ao_vivo_consumir_espectro(const int8_t *colunas_dbfs);
+
+// Redesenha a tela inteira no framebuffer (o envio fica a cargo do chamador)
+void ao_vivo_desenhar(ssd1306_framebuffer_t *framebuffer);
+
+#endif
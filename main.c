@@ -5,7 +5,7 @@
  * @date 07/06/2025
  *
  * Este projeto captura áudio do microfone, aplica um filtro passa-baixa,
- * armazena em um buffer e o reproduz via PWM. Inclui feedback visual
+ * armazena em um buffer e o reproduz (sigma-delta no PIO ou PWM). Inclui feedback visual
  * com LED RGB e visualização da forma de onda em um display OLED.
  */
 
@@ -22,58 +22,131 @@
 #include "hardware/dma.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
-#include "inc/ssd1306.h" // Lib externa para o display OLED
+#include "include/configuracao.h"
+#include "include/interface_usuario.h"
+#include "include/captura_audio.h"
+#include "include/reproducao_audio.h"
+#include "include/dsp_audio.h"
+#include "include/codec_amostras.h"
+#include "include/armazenamento_flash.h"
+#include "include/indice_picos.h"
+#include "include/sintetizador.h"
+#include "include/cadeia_efeitos.h"
+#include "include/reamostrador.h"
+#include "include/audio_usb.h"
+#include "include/transferencia_usb.h"
+#include "include/perfil_desempenho.h"
+#include "include/eventos_sistema.h"
+#include "include/perfis_taxa.h"
+#include "include/banco_amostras.h"
+#include "include/looper_audio.h"
 
 // =================================================================================
 // Definições e Constantes do Projeto
 // =================================================================================
 
-// --- Mapeamento de Pinos ---
-#define PINO_BOTAO_GRAVAR 5
-#define PINO_BOTAO_REPRODUZIR 6
-#define PINO_LED_VERMELHO 13
-#define PINO_LED_VERDE 11
-#define PINO_LED_AZUL 12
-#define PINO_I2C_SDA 14
-#define PINO_I2C_SCL 15
-#define PINO_BUZZER_1 21
-#define PINO_BUZZER_2 10
-#define CANAL_ADC_MIC 2
-#define PINO_MICROFONE (26 + CANAL_ADC_MIC) // GP28
-
-// --- Parâmetros do Display ---
-#define DISPLAY_WIDTH 128
-#define DISPLAY_HEIGHT 64
+// O mapeamento de pinos e os parâmetros do display e do DSP ficam em include/configuracao.h
 
 // --- Parâmetros de Áudio ---
-#define TAXA_AMOSTRAGEM 48000
-#define DURACAO_GRAVACAO_S 2
-#define TAMANHO_BUFFER_AUDIO (TAXA_AMOSTRAGEM * DURACAO_GRAVACAO_S)
-#define FATOR_SUAVIZACAO 0.2f // Alpha para o filtro
-#define GANHO_SAIDA_AUDIO 1.7f
+// A taxa e o clk_sys vêm do perfil escolhido em tempo de execução (include/perfis_taxa.h)
+#define DURACAO_GRAVACAO_S 0 // 0 = grava até um novo toque em gravar ou o fim do espaço
+#define GRAVACAO_POR_DISPARO 1 // 1 = gravar arma: o take começa no som (com o pré-disparo) e termina no silêncio
+#define PRE_DISPARO_MS 60 // Histórico antes do disparo, limitado a CAPTURA_MAX_BLOCOS_RETIDOS blocos
+#define LIMIAR_DISPARO_LSB 64 // RMS do bloco que dispara (~-30 dB do fundo de escala)
+#define LIMIAR_SILENCIO_LSB 24 // RMS abaixo do qual o bloco é silêncio (~-39 dB); o intervalo é a histerese
+#define SILENCIO_FIM_GRAVACAO_MS 1000 // Silêncio contínuo que encerra um take disparado
+#define DURACAO_MINIMA_LIVRE_S 2 // Na RAM, sem duração fixa: os takes mais antigos saem até caber isto
+#define TAMANHO_BUFFER_AUDIO (48000 * 2 * sizeof(uint16_t)) // Bytes (192 KB)
+#define CODEC_GRAVACAO CODEC_PACKED12 // A 48 kHz: CODEC_PCM16 (2 s), CODEC_PACKED12 (2,6 s) ou CODEC_IMA_ADPCM (7,7 s)
+#define GRAVACAO_EM_FLASH 1 // 1 = grava na flash (minutos, persiste ao desligar); 0 = grava na RAM
+#define CODEC_GRAVACAO_FLASH CODEC_IMA_ADPCM // ~63 s; PCM16 (96 KB/s) excede a escrita sustentada da flash
+#define TAMANHO_FILA_FLASH (128u * 1024u) // Fila entre os núcleos, tomada do buffer de áudio
+#define SAIDA_AUDIO SAIDA_AUDIO_PWM // SAIDA_AUDIO_SIGMA_DELTA: PIO a 32x a taxa, ~320 ciclos/amostra (ver reproducao_audio.h)
+#define INTERPOLACAO_REPRODUCAO INTERPOLACAO_CUBICA // INTERPOLACAO_LINEAR: ~metade do custo, mais ruído
+#define AJUSTE_LATENCIA_LOOPER 0 // Amostras somadas ao alinhamento do overdub (atrasos analógicos, medidos à parte)
+
+// Os blocos de captura, codificação e reprodução precisam coincidir
+_Static_assert(TAMANHO_BLOCO_CAPTURA == CODEC_AMOSTRAS_POR_BLOCO, "bloco de captura difere do bloco do codec");
+_Static_assert(TAMANHO_BLOCO_REPRODUCAO == CODEC_AMOSTRAS_POR_BLOCO, "bloco de reprodução difere do bloco do codec");
+_Static_assert(TAMANHO_FILA_FLASH <= TAMANHO_BUFFER_AUDIO, "fila da flash maior que o buffer de áudio");
+_Static_assert(TAXA_PERFIL_PADRAO == AUDIO_USB_TAXA, "o áudio USB é anunciado na taxa do perfil padrão");
+_Static_assert(TAMANHO_BLOCO_REPRODUCAO <= AUDIO_USB_MAX_BLOCO, "bloco de reprodução maior que o do áudio USB");
+
+// --- Parâmetros do Sintetizador ---
+#define NOTA_BASE_SINTETIZADOR 60          // Dó central (MIDI)
+#define VELOCIDADE_NOTA_SINTETIZADOR 110
+#define VELOCIDADE_ACORDE_SINTETIZADOR 80
+#define TEMPO_SAIDA_SINTETIZADOR_MS 1000   // Os dois botões pressionados por este tempo encerram o modo
+#define TEMPO_ESTABILIZACAO_BOTAO_MS 20    // Debounce da leitura por polling no modo sintetizador
+
+_Static_assert(TAXA_PERFIL_PADRAO == SINTETIZADOR_TAXA_AMOSTRAGEM, "tabelas do sintetizador geradas para outra taxa");
+_Static_assert(TAMANHO_BLOCO_REPRODUCAO <= SINTETIZADOR_MAX_BLOCO, "bloco de reprodução maior que o do sintetizador");
 
 // --- Parâmetros Gerais ---
 #define TEMPO_DEBOUNCE_BOTAO_MS 200
+#define TEMPO_SEGURAR_BOTAO_MS 800 // Toque longo: troca o perfil ou pede para apagar o take; no sintetizador, abre o looper
+#define RELOGIO_OCIOSO_REDUZIDO 1 // 1 = clk_sys em 48 MHz (PLL do USB) com o áudio parado
+#define PERIODO_SERVICO_USB_MS 20 // Consulta da porta binária em espera (ela não acorda o núcleo 0)
 
 // =================================================================================
 // Variáveis Globais
 // =================================================================================
 
-// Buffers de dados
-uint16_t buffer_de_amostras[TAMANHO_BUFFER_AUDIO];
-uint8_t frame_buffer_display[DISPLAY_WIDTH * DISPLAY_HEIGHT / 8];
+// Arena do banco de takes: as amostras são guardadas já codificadas, bloco a bloco. Durante a
+// gravação na flash, o espaço livre dela é a fila entre os núcleos; no looper, o laço (em PCM16).
+uint8_t buffer_de_amostras[TAMANHO_BUFFER_AUDIO] __attribute__((aligned(BANCO_ALINHAMENTO)));
 
-// Flags de interrupção para os botões
-volatile bool flag_botao_gravar_ativado = false;
-volatile bool flag_botao_reproduzir_ativado = false;
+// Índice de picos montado durante a captura; o resumo de cada take sai dele (a gravação não é relida)
+static indice_picos_t indice_gravacao;
 
-// Controle de tempo para debounce
+// Pentatônica maior em duas oitavas: cada toque no botão de gravar avança uma nota
+static const uint8_t escala_sintetizador[] = { 0, 2, 4, 7, 9, 12, 14, 16, 19, 21 };
+
+#define N_NOTAS_ESCALA_SINTETIZADOR (sizeof(escala_sintetizador) / sizeof(escala_sintetizador[0]))
+
+// Velocidades (Q16) percorridas pelo botão de gravar durante a reprodução; tom e duração mudam juntos
+static const uint32_t velocidades_reproducao[] = { 0x10000, 0x18000, 0x20000, 0x8000, 0xC000 };
+static uint32_t indice_velocidade = 0;
+static reamostrador_t reamostrador_reproducao;
+static looper_t looper;
+
+// Estado do processamento em bloco aplicado durante a captura
+static uint16_t estado_filtro_gravacao = 0;
+static bool filtro_gravacao_iniciado = false;
+static dsp_bloqueio_dc_t bloqueio_dc_captura; // Também na entrada do looper
+static dsp_agc_t agc_gravacao;
+
+// Controle de tempo para debounce (os toques aceitos vão para a fila de eventos_sistema.h)
 static uint32_t ultimo_acionamento_gravar = 0;
 static uint32_t ultimo_acionamento_reproduzir = 0;
 
-// Configuração do DMA
-uint canal_dma_adc;
-dma_channel_config config_canal_dma;
+// Toque longo acompanhado sem bloquear: o modo age já no toque e lê o botão a cada passada
+typedef enum {
+    TOQUE_NENHUM,   // Nenhum toque sendo acompanhado
+    TOQUE_PENDENTE, // Ainda pressionado, sem completar TEMPO_SEGURAR_BOTAO_MS
+    TOQUE_CURTO,    // Acabou de ser solto antes disso
+    TOQUE_LONGO,    // Acabou de completar o tempo pressionado
+} resultado_toque_t;
+
+typedef struct {
+    uint pino;
+    uint32_t instante_us; // Do toque (interrupção)
+    bool acompanhando;
+} toque_longo_t;
+
+// Perfil de taxa cujos relógios estão aplicados
+static const perfil_taxa_t *perfil_ativo = NULL;
+
+// Do toque no botão (instante da interrupção) ao disparo da captura
+static uint32_t instante_pedido_gravacao_us = 0;
+static uint32_t latencia_inicio_gravacao_us = 0;
+
+// Gravação armada: o detector decide o disparo e, depois dele, conta o silêncio que encerra o take
+static dsp_detector_nivel_t detector_disparo;
+static uint32_t blocos_pre_disparo = 0;   // Retidos no anel antes do bloco que disparou
+static uint32_t blocos_ja_detectados = 0; // Pré-disparo e disparo: o detector já os viu
+static uint32_t blocos_em_silencio = 0;
+static uint32_t blocos_silencio_fim = 0;
 
 // =================================================================================
 // Protótipos de Funções (Declarações Antecipadas)
@@ -81,23 +154,51 @@ dma_channel_config config_canal_dma;
 
 // --- Inicialização ---
 void inicializar_perifericos_basicos();
-void inicializar_leds();
 void configurar_botoes_com_interrupcao();
 void inicializar_adc_e_dma();
-void configurar_saida_pwm(uint pino, uint32_t frequencia_base);
-void inicializar_comunicacao_i2c();
+void configurar_clock_adc(void);
+void ativar_perfil_taxa(const perfil_taxa_t *perfil);
 
 // --- Lógica Principal ---
-size_t processo_de_gravacao(uint32_t freq_amostragem, uint32_t duracao_seg);
-void processo_de_reproducao(uint pino_a, uint pino_b, uint16_t *dados, size_t n_amostras, uint32_t freq_amostragem);
+size_t processo_de_gravacao(uint32_t freq_amostragem, uint32_t duracao_seg, bool por_disparo);
+size_t processo_de_gravacao_flash(uint32_t freq_amostragem, uint32_t duracao_seg, bool por_disparo);
+bool iniciar_captura_gravacao(uint32_t freq_amostragem, bool por_disparo);
+bool aguardar_disparo(uint32_t freq_amostragem);
+bool silencio_encerra_gravacao(const uint16_t *bloco, size_t n_amostras);
+bool processo_de_reproducao(const gravacao_codificada_t *gravacao, uint32_t freq_amostragem, int32_t ganho_q12,
+                            toque_longo_t *toque);
+int32_t ganho_saida_take(const take_banco_t *take);
+void iniciar_processamento_gravacao(size_t total_de_amostras);
+void processar_bloco_gravacao(uint16_t *bloco, size_t n_amostras);
+void montar_resumo_gravacao(resumo_onda_t *resumo, size_t inicio, size_t n_amostras);
+void reconstruir_indice_picos(const gravacao_codificada_t *gravacao);
+bool processo_sintetizador(uint32_t freq_amostragem, toque_longo_t *toque);
+void processo_audio_usb(uint32_t freq_amostragem);
+size_t processo_looper(uint32_t freq_amostragem);
 
 // --- Funções de Apoio e Utilitários ---
-void definir_cor_led(bool vermelho, bool verde, bool azul);
 void tratador_interrupcao_botao(uint pino, uint32_t eventos);
-void capturar_amostras_via_dma(uint16_t *destino, size_t n_amostras);
-uint16_t suavizar_sinal_audio(uint16_t amostra_atual, uint16_t amostra_anterior, float fator);
-void mostrar_waveform_display(uint8_t *buffer_tela, uint16_t *dados_audio, size_t n_amostras);
-void apagar_tela();
+void relatar_estatisticas_flash(void);
+void relatar_estatisticas_sintetizador(void);
+void relatar_estatisticas_decimacao(void);
+void relatar_estatisticas_looper(void);
+void relatar_nivel_automatico(void);
+void relatar_cadeia_efeitos(const char *cadeia, size_t (*obter_estatisticas)(const estatisticas_etapa_t **etapas));
+void alternar_visualizacao(void);
+void alternar_velocidade(void);
+bool atender_botoes_gravacao(void);
+void atender_botoes_reproducao(void);
+void relatar_estatisticas_reamostrador(void);
+void relatar_estatisticas_audio_usb(void);
+bool concluir_importacao_usb(void);
+void mostrar_take_selecionado(void);
+bool selecionar_proximo_take(void);
+bool apagar_take_selecionado(void);
+void toque_longo_iniciar(toque_longo_t *toque, uint pino, uint32_t instante_us);
+resultado_toque_t toque_longo_atualizar(toque_longo_t *toque);
+void aguardar_soltura(uint pino);
+void relatar_exportacao_usb(void);
+void relatar_perfil_taxa(const char *prefixo, indice_perfil_taxa_t indice);
 
 // =================================================================================
 // Função Principal (main)
@@ -107,50 +208,258 @@ int main() {
     inicializar_perifericos_basicos();
 
     // --- Máquina de Estados do Sistema ---
-    enum { MODO_ESPERA, MODO_AGUARDANDO_PLAYBACK } estado_do_sistema = MODO_ESPERA;
+    enum {
+        MODO_ESPERA,
+        MODO_AGUARDANDO_PLAYBACK,
+        MODO_CONFIRMANDO_EXCLUSAO,
+        MODO_SINTETIZADOR,
+        MODO_AUDIO_USB,
+        MODO_LOOPER
+    } estado_do_sistema = MODO_ESPERA;
     size_t total_amostras_capturadas = 0;
-
-    printf("Sintetizador de Áudio iniciado. Aguardando comando.\n");
+    toque_longo_t toque_gravar = { 0 };     // Em espera pela reprodução: curto passa de take, longo troca o perfil
+    toque_longo_t toque_reproduzir = { 0 }; // Do toque que abriu o sintetizador ou a reprodução
+
+    interface_log("Sintetizador de Áudio iniciado. Aguardando comando.\n");
+    relatar_perfil_taxa("Perfil da próxima gravação", perfis_taxa_escolhido());
+
+#if GRAVACAO_EM_FLASH
+    // Uma gravação da sessão anterior continua disponível para reprodução, como take externo do banco
+    gravacao_codificada_t gravacao_flash;
+    if (armazenamento_flash_carregar(&gravacao_flash) && banco_adicionar_externo(&gravacao_flash) >= 0) {
+        interface_log("Gravação na flash: %lu amostras. Pronto para reproduzir.\n",
+                      (unsigned long)gravacao_flash.n_amostras);
+        mostrar_take_selecionado();
+        estado_do_sistema = MODO_AGUARDANDO_PLAYBACK;
+    }
+#endif
 
     while (true) {
+        // Exportação/importação pela porta binária, só com o áudio parado
+        bool transferindo = false;
+        bool parado = estado_do_sistema == MODO_ESPERA || estado_do_sistema == MODO_AGUARDANDO_PLAYBACK ||
+                      estado_do_sistema == MODO_CONFIRMANDO_EXCLUSAO;
+        if (parado) {
+            switch (transferencia_usb_servico()) {
+                case TRANSFERENCIA_EM_CURSO:
+                    transferindo = true;
+                    break;
+                case TRANSFERENCIA_EXPORTADA:
+                    relatar_exportacao_usb();
+                    break;
+                case TRANSFERENCIA_GRAVACAO_ALTERADA:
+                    interface_definir_led(0, 0, 0); // Uma exclusão pendente deixa de valer
+                    estado_do_sistema = concluir_importacao_usb() ? MODO_AGUARDANDO_PLAYBACK : MODO_ESPERA;
+                    break;
+                case TRANSFERENCIA_PERFIL_ALTERADO:
+                    relatar_perfil_taxa("Perfil escolhido pelo USB", perfis_taxa_escolhido());
+                    break;
+                case TRANSFERENCIA_TAKE_SELECIONADO:
+                    interface_definir_led(0, 0, 0);
+                    mostrar_take_selecionado();
+                    estado_do_sistema = MODO_AGUARDANDO_PLAYBACK;
+                    break;
+                case TRANSFERENCIA_OCIOSA:
+                    break;
+            }
+        }
+
+        // Toques só são lidos aqui nos modos parados; os modos de áudio os consomem por conta própria.
+        // Com uma transferência em curso o banco não pode mudar: os toques esperam por ela.
+        evento_sistema_t evento = { 0 };
+        bool houve_toque = parado && !transferindo && eventos_sistema_obter(&evento);
+
         switch (estado_do_sistema) {
             case MODO_ESPERA:
-                if (flag_botao_gravar_ativado) {
-                    flag_botao_gravar_ativado = false; // Reseta a flag
+                if (houve_toque && evento.tipo == EVENTO_BOTAO_GRAVAR) {
+                    instante_pedido_gravacao_us = evento.instante_us;
+                    ativar_perfil_taxa(&perfis_taxa[perfis_taxa_escolhido()]); // ADC, DMA e saída no clk_sys pleno
+
+                    interface_definir_led(1, 0, 0); // LED Vermelho: Gravando (amarelo enquanto armada)
+                    interface_log("Iniciando gravação...\n");
+                    interface_ao_vivo(true);
+#if GRAVACAO_EM_FLASH
+                    total_amostras_capturadas =
+                        processo_de_gravacao_flash(perfil_ativo->taxa, DURACAO_GRAVACAO_S, GRAVACAO_POR_DISPARO);
+#else
+                    total_amostras_capturadas =
+                        processo_de_gravacao(perfil_ativo->taxa, DURACAO_GRAVACAO_S, GRAVACAO_POR_DISPARO);
+#endif
+                    interface_ao_vivo(false);
+                    interface_definir_led(0, 0, 0); // LED Desligado
+                    if (total_amostras_capturadas == 0) {
+                        interface_log("Gravação não iniciada: desarmada ou sem espaço no banco de takes.\n");
+                        break;
+                    }
+                    relatar_estatisticas_decimacao();
+                    relatar_nivel_automatico();
+                    relatar_cadeia_efeitos("gravacao", cadeia_gravacao_estatisticas);
+
+                    interface_log("Gravação concluída: %lu amostras. Desenhando a onda.\n",
+                                  (unsigned long)total_amostras_capturadas);
+                    interface_log("Latência do botão à captura: %lu us\n", (unsigned long)latencia_inicio_gravacao_us);
+                    // O take novo está selecionado; o resumo sai do índice montado na captura
+                    take_banco_t *take = banco_take((size_t)banco_selecionado());
+                    montar_resumo_gravacao(&take->resumo, 0, total_amostras_capturadas);
+                    mostrar_take_selecionado();
 
-                    definir_cor_led(1, 0, 0); // LED Vermelho: Gravando
-                    printf("Iniciando gravação...\n");
-                    total_amostras_capturadas = processo_de_gravacao(TAXA_AMOSTRAGEM, DURACAO_GRAVACAO_S);
-                    definir_cor_led(0, 0, 0); // LED Desligado
-
-                    printf("Gravação concluída. Desenhando forma de onda.\n");
-                    mostrar_waveform_display(frame_buffer_display, buffer_de_amostras, total_amostras_capturadas);
-                    
                     estado_do_sistema = MODO_AGUARDANDO_PLAYBACK;
-                    printf("Pronto para reproduzir. Pressione o outro botão.\n");
+                    interface_log("Pronto para reproduzir. Pressione o outro botão (gravar passa ao próximo take; "
+                                  "segurar gravar troca o perfil, segurar reproduzir pede para apagar o take).\n");
+                } else if (houve_toque && evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+                    // Sem gravação pendente, o botão de reproduzir abre o sintetizador já no toque;
+                    // mantido pressionado, o sintetizador dá lugar ao looper
+                    toque_longo_iniciar(&toque_reproduzir, PINO_BOTAO_REPRODUZIR, evento.instante_us);
+                    estado_do_sistema = MODO_SINTETIZADOR;
+                } else if (audio_usb_microfone_ativo() || audio_usb_alto_falante_ativo()) {
+                    estado_do_sistema = MODO_AUDIO_USB;
                 }
                 break;
 
+            case MODO_AUDIO_USB:
+                ativar_perfil_taxa(&perfis_taxa[PERFIL_TAXA_PADRAO]);
+                interface_definir_led(0, 1, 1); // LED Ciano: Áudio USB
+                interface_log("Áudio USB: host conectado ao microfone/alto-falante.\n");
+                interface_ao_vivo(true);
+                processo_audio_usb(perfil_ativo->taxa);
+                interface_ao_vivo(false);
+                interface_definir_led(0, 0, 0); // LED Desligado
+                relatar_estatisticas_audio_usb();
+
+                // Um botão pressionado encerra o modo e é tratado na espera (gravar continua enviando ao host)
+                estado_do_sistema = MODO_ESPERA;
+                break;
+
+            case MODO_LOOPER: {
+                // O perfil escolhido vale também aqui: o laço é tocado na taxa em que foi gravado
+                ativar_perfil_taxa(&perfis_taxa[perfis_taxa_escolhido()]);
+                interface_definir_led(1, 0, 0); // LED Vermelho: primeira passada do laço
+                interface_log("Looper: gravar fecha o laço e depois liga/desliga o overdub; reproduzir encerra.\n");
+                interface_ao_vivo(true);
+                size_t comprimento = processo_looper(perfil_ativo->taxa);
+                interface_ao_vivo(false);
+                interface_definir_led(0, 0, 0); // LED Desligado
+                relatar_estatisticas_decimacao();
+                relatar_estatisticas_looper();
+
+                // O laço fechado fica no banco como um take comum
+                eventos_sistema_descartar();
+                if (comprimento == 0) {
+                    interface_log("Looper encerrado sem laço.\n");
+                    estado_do_sistema = MODO_ESPERA;
+                    break;
+                }
+                mostrar_take_selecionado();
+                estado_do_sistema = MODO_AGUARDANDO_PLAYBACK;
+                break;
+            }
+
+            case MODO_SINTETIZADOR: {
+                ativar_perfil_taxa(&perfis_taxa[PERFIL_TAXA_PADRAO]);
+                interface_definir_led(0, 0, 1); // LED Azul: Sintetizador
+                interface_log("Sintetizador: gravar toca a escala, reproduzir toca acordes; os dois por 1 s saem.\n");
+                interface_ao_vivo(true);
+                bool abrir_looper = processo_sintetizador(perfil_ativo->taxa, &toque_reproduzir);
+                interface_ao_vivo(false);
+                interface_definir_led(0, 0, 0); // LED Desligado
+                relatar_estatisticas_sintetizador();
+                relatar_cadeia_efeitos("reproducao", cadeia_reproducao_estatisticas);
+
+                // Os toques usados para tocar também dispararam as interrupções dos botões
+                if (abrir_looper) aguardar_soltura(PINO_BOTAO_REPRODUZIR);
+                eventos_sistema_descartar();
+                estado_do_sistema = abrir_looper ? MODO_LOOPER : MODO_ESPERA;
+                break;
+            }
+
             case MODO_AGUARDANDO_PLAYBACK:
-                if (flag_botao_reproduzir_ativado) {
-                    flag_botao_reproduzir_ativado = false; // Reseta a flag
-
-                    definir_cor_led(0, 1, 0); // LED Verde: Reproduzindo
-                    printf("Iniciando reprodução...\n");
-                    processo_de_reproducao(PINO_BUZZER_1, PINO_BUZZER_2, buffer_de_amostras, total_amostras_capturadas, TAXA_AMOSTRAGEM);
-                    definir_cor_led(0, 0, 0); // LED Desligado
-
-                    printf("Reprodução concluída. Reiniciando ciclo.\n\n");
-                    apagar_tela();
-                    
-                    // CORREÇÃO: Limpa qualquer flag de gravação que possa ter sido ativada durante a reprodução
-                    flag_botao_gravar_ativado = false; 
-                    
+                if (banco_selecionado() < 0) {
+                    estado_do_sistema = MODO_ESPERA; // Os takes saíram para dar espaço a uma importação
+                    break;
+                }
+                // Gravar: toque passa ao próximo take (depois do último, a uma gravação nova), toque
+                // longo troca o perfil da próxima gravação; os dois se decidem a cada passada, sem
+                // bloquear o laço. Reproduzir toca já no toque; mantido pressionado, pede para apagar.
+                if (houve_toque && evento.tipo == EVENTO_BOTAO_GRAVAR) {
+                    toque_longo_iniciar(&toque_gravar, PINO_BOTAO_GRAVAR, evento.instante_us);
+                }
+                switch (toque_longo_atualizar(&toque_gravar)) {
+                    case TOQUE_LONGO:
+                        perfis_taxa_escolher((indice_perfil_taxa_t)((perfis_taxa_escolhido() + 1) % N_PERFIS_TAXA));
+                        relatar_perfil_taxa("Perfil da próxima gravação", perfis_taxa_escolhido());
+                        aguardar_soltura(PINO_BOTAO_GRAVAR);
+                        break;
+                    case TOQUE_CURTO:
+                        if (!selecionar_proximo_take()) estado_do_sistema = MODO_ESPERA;
+                        break;
+                    case TOQUE_PENDENTE:
+                    case TOQUE_NENHUM:
+                        break;
+                }
+                if (estado_do_sistema == MODO_AGUARDANDO_PLAYBACK && houve_toque &&
+                    evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+                    toque_gravar.acompanhando = false;
+                    toque_longo_iniciar(&toque_reproduzir, PINO_BOTAO_REPRODUZIR, evento.instante_us);
+
+                    // Na taxa da gravação quando algum perfil a tem: sem conversão no reamostrador
+                    const take_banco_t *take = banco_take((size_t)banco_selecionado());
+                    const gravacao_codificada_t *gravacao = &take->gravacao;
+                    ativar_perfil_taxa(&perfis_taxa[perfis_taxa_para(gravacao->freq_amostragem)]);
+                    int32_t ganho_q12 = ganho_saida_take(take);
+                    interface_definir_led(0, 1, 0); // LED Verde: Reproduzindo
+                    interface_log("Iniciando reprodução (ganho %lu%%)...\n", (unsigned long)((ganho_q12 * 100 + 2048) / 4096));
+                    interface_ao_vivo(true);
+                    bool apagar = processo_de_reproducao(gravacao, perfil_ativo->taxa, ganho_q12, &toque_reproduzir);
+                    interface_ao_vivo(false);
+                    interface_definir_led(0, 0, 0); // LED Desligado
+                    relatar_cadeia_efeitos("reproducao", cadeia_reproducao_estatisticas);
+
+                    if (apagar) {
+                        // A exclusão só acontece com um segundo toque, depois de o botão ser solto
+                        aguardar_soltura(PINO_BOTAO_REPRODUZIR);
+                        interface_definir_led(1, 0, 1); // LED Magenta: confirmar a exclusão
+                        interface_log("Apagar o take %u? Reproduzir confirma, gravar cancela.\n", (unsigned)take->numero);
+                        estado_do_sistema = MODO_CONFIRMANDO_EXCLUSAO;
+                        break;
+                    }
+
+                    // O take continua no banco: volta ao resumo dele
+                    interface_log("Reprodução concluída.\n\n");
+                    mostrar_take_selecionado();
+
+                    // CORREÇÃO: Descarta qualquer toque que tenha sobrado da reprodução
+                    eventos_sistema_descartar();
+                }
+                break;
+
+            case MODO_CONFIRMANDO_EXCLUSAO:
+                if (banco_selecionado() < 0) {
+                    interface_definir_led(0, 0, 0);
                     estado_do_sistema = MODO_ESPERA;
+                    break;
+                }
+                if (!houve_toque) break;
+
+                interface_definir_led(0, 0, 0); // LED Desligado
+                if (evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+                    estado_do_sistema = apagar_take_selecionado() ? MODO_AGUARDANDO_PLAYBACK : MODO_ESPERA;
+                } else {
+                    interface_log("Exclusão cancelada.\n");
+                    mostrar_take_selecionado();
+                    estado_do_sistema = MODO_AGUARDANDO_PLAYBACK;
                 }
                 break;
         }
-        sleep_ms(10); // Pequena pausa para economizar processamento
+        // Um modo de áudio escolhido agora começa na próxima volta, sem esperar
+        parado = estado_do_sistema == MODO_ESPERA || estado_do_sistema == MODO_AGUARDANDO_PLAYBACK ||
+                 estado_do_sistema == MODO_CONFIRMANDO_EXCLUSAO;
+        if (parado && !transferindo) {
+            // Dorme até o próximo toque (a interrupção acorda o núcleo) ou a próxima consulta da porta binária
+            eventos_sistema_relogio_ocioso(true);
+            PERFIL_OCIOSO_INICIO();
+            eventos_sistema_aguardar(PERIODO_SERVICO_USB_MS);
+            PERFIL_OCIOSO_FIM();
+        }
     }
 }
 
@@ -163,32 +472,34 @@ int main() {
 // ------------------------
 
 void inicializar_perifericos_basicos() {
-    stdio_init_all();
-    sleep_ms(2000); // Pausa para permitir a conexão do terminal serial
-
-    inicializar_leds();
-    definir_cor_led(0, 0, 0); // Garante que os LEDs comecem apagados
+    // O núcleo 1 assume stdio, LEDs e display; o núcleo 0 fica com o áudio
+    PERFIL_INICIAR_NUCLEO();
+    perfis_taxa_iniciar(); // Antes do núcleo 1: o I2C dele tira a taxa do clk_peri
+    eventos_sistema_iniciar(RELOGIO_OCIOSO_REDUZIDO);
+    interface_iniciar();
 
     configurar_botoes_com_interrupcao();
     inicializar_adc_e_dma();
 
-    configurar_saida_pwm(PINO_BUZZER_1, TAXA_AMOSTRAGEM);
-    configurar_saida_pwm(PINO_BUZZER_2, TAXA_AMOSTRAGEM);
-    
-    inicializar_comunicacao_i2c();
-    ssd1306_init(); // Inicializa o controlador do display
-    apagar_tela();
-}
+    // Uma gravação da flash em outra taxa troca de perfil ao ser tocada
+    ativar_perfil_taxa(&perfis_taxa[PERFIL_TAXA_PADRAO]);
+    reproducao_inicializar(SAIDA_AUDIO, PINO_BUZZER_1, PINO_BUZZER_2);
+
+    // Gravações e importações pelo USB viram takes do banco, no codec da gravação em RAM
+    banco_iniciar(buffer_de_amostras, sizeof(buffer_de_amostras));
+    transferencia_usb_iniciar(CODEC_GRAVACAO);
 
-void inicializar_leds() {
-    gpio_init(PINO_LED_VERMELHO);
-    gpio_init(PINO_LED_VERDE);
-    gpio_init(PINO_LED_AZUL);
-    gpio_set_dir(PINO_LED_VERMELHO, GPIO_OUT);
-    gpio_set_dir(PINO_LED_VERDE, GPIO_OUT);
-    gpio_set_dir(PINO_LED_AZUL, GPIO_OUT);
+#if GRAVACAO_EM_FLASH
+    // A escrita na flash roda no núcleo 1, que não participa da captura
+    if (armazenamento_flash_inicializar()) {
+        interface_registrar_tarefa_fundo(armazenamento_flash_tarefa);
+    } else {
+        interface_log("Erro: programa invade a região de gravação da flash.\n");
+    }
+#endif
 }
 
+
 void configurar_botoes_com_interrupcao() {
     gpio_init(PINO_BOTAO_GRAVAR);
     gpio_set_dir(PINO_BOTAO_GRAVAR, GPIO_IN);
@@ -210,94 +521,709 @@ void inicializar_adc_e_dma() {
     adc_select_input(CANAL_ADC_MIC);
     adc_fifo_setup(true, true, 1, false, false); // Habilita FIFO para DMA
 
-    // DMA
-    canal_dma_adc = dma_claim_unused_channel(true);
-    config_canal_dma = dma_channel_get_default_config(canal_dma_adc);
-    channel_config_set_transfer_data_size(&config_canal_dma, DMA_SIZE_16);
-    channel_config_set_read_increment(&config_canal_dma, false);
-    channel_config_set_write_increment(&config_canal_dma, true);
-    channel_config_set_dreq(&config_canal_dma, DREQ_ADC);
+    // DMA: dois canais em ping-pong alimentando o anel de captura
+    captura_inicializar();
 }
 
-void configurar_saida_pwm(uint pino, uint32_t frequencia_base) {
-    gpio_set_function(pino, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(pino);
+// O ADC roda CAPTURA_FATOR_ADC vezes a taxa do perfil; a captura decima de volta para ela
+void configurar_clock_adc(void) {
+    // Período de conversão = 1 + divisor, inteiro em todos os perfis: a taxa sai exata
+    adc_set_clkdiv((float)(perfil_ativo->ciclos_conversao_adc - 1));
+}
 
-    uint32_t clock = clock_get_hz(clk_sys);
-    uint32_t top = clock / frequencia_base - 1;
-    if (top == 0) top = 1;
+// Troca os relógios só quando o perfil muda; sempre deixa o clk_sys pleno para o áudio
+void ativar_perfil_taxa(const perfil_taxa_t *perfil) {
+    eventos_sistema_relogio_ocioso(false);
+    if (perfil == perfil_ativo) return;
 
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_wrap(&config, top);
-    pwm_init(slice_num, &config, true);
-    pwm_set_gpio_level(pino, 0); // Inicia com o som desligado
+    perfis_taxa_aplicar_relogios(perfil);
+    eventos_sistema_definir_relogio_pleno(perfil->freq_sistema_hz);
+    reproducao_definir_taxa(perfil->topo_pwm, perfil->divisor_sigma_delta_q8);
+    perfil_ativo = perfil;
 }
 
-void inicializar_comunicacao_i2c() {
-    i2c_init(i2c1, ssd1306_i2c_clock * 1000);
-    gpio_set_function(PINO_I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(PINO_I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(PINO_I2C_SDA);
-    gpio_pull_up(PINO_I2C_SCL);
-}
+
 
 // ---------------------------
 // --- Lógica Principal ---
 // ---------------------------
 
-size_t processo_de_gravacao(uint32_t freq_amostragem, uint32_t duracao_seg) {
-    size_t total_de_amostras = freq_amostragem * duracao_seg;
-    if (total_de_amostras > TAMANHO_BUFFER_AUDIO) {
-        total_de_amostras = TAMANHO_BUFFER_AUDIO;
+size_t processo_de_gravacao(uint32_t freq_amostragem, uint32_t duracao_seg, bool por_disparo) {
+    // O take recebe todo o espaço livre do banco, com pelo menos a duração pedida (ou a mínima)
+    uint32_t segundos_livres = (duracao_seg > 0) ? duracao_seg : DURACAO_MINIMA_LIVRE_S;
+    size_t reserva = codec_bytes_para_amostras(CODEC_GRAVACAO, freq_amostragem * segundos_livres);
+    if (reserva > banco_capacidade_bytes()) reserva = banco_capacidade_bytes();
+    gravacao_codificada_t *gravacao = banco_reservar(reserva) ? banco_abrir_take(CODEC_GRAVACAO, freq_amostragem) : NULL;
+    if (gravacao == NULL) return 0;
+
+    size_t capacidade = codec_capacidade_amostras(CODEC_GRAVACAO, gravacao->capacidade_bytes);
+    size_t total_de_amostras = (duracao_seg > 0) ? freq_amostragem * duracao_seg : capacidade;
+    if (total_de_amostras > capacidade) {
+        total_de_amostras = capacidade;
+    }
+
+    // Filtra e codifica os blocos no próprio anel, à medida que o DMA os completa
+    iniciar_processamento_gravacao(total_de_amostras);
+    if (!iniciar_captura_gravacao(freq_amostragem, por_disparo)) {
+        banco_descartar_take_aberto();
+        return 0;
+    }
+    size_t amostras_gravadas = 0;
+    bool fim_por_silencio = false;
+    while (amostras_gravadas < total_de_amostras && !fim_por_silencio) {
+        if (atender_botoes_gravacao()) break; // Um novo toque em gravar encerra o take
+
+        uint16_t *bloco = captura_proximo_bloco();
+        if (bloco == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe(); // A interrupção do DMA acorda o núcleo a cada bloco
+            continue;
+        }
+        PERFIL_OCIOSO_FIM();
+
+        // O bloco seguinte continua chegando pelo DMA enquanto este é processado
+        size_t restantes = total_de_amostras - amostras_gravadas;
+        size_t n = (restantes < TAMANHO_BLOCO_CAPTURA) ? restantes : TAMANHO_BLOCO_CAPTURA;
+        fim_por_silencio = por_disparo && silencio_encerra_gravacao(bloco, n); // O bloco ainda entra no take
+        PERFIL_INICIO(marca_bloco);
+        processar_bloco_gravacao(bloco, n);
+        PERFIL_INICIO(marca_codificacao);
+        gravacao_anexar_bloco(gravacao, bloco, n);
+        PERFIL_FIM(PERFIL_CODIFICACAO, marca_codificacao);
+        captura_liberar_bloco();
+        PERFIL_FIM(PERFIL_BLOCO_GRAVACAO, marca_bloco);
+        amostras_gravadas += n;
+    }
+    captura_parar();
+    indice_picos_finalizar(&indice_gravacao);
+    eventos_sistema_descartar();
+    banco_fechar_take();
+
+    if (captura_blocos_perdidos() > 0) {
+        interface_log("Aviso: %lu blocos de captura perdidos.\n", (unsigned long)captura_blocos_perdidos());
+    }
+
+    return amostras_gravadas;
+}
+
+size_t processo_de_gravacao_flash(uint32_t freq_amostragem, uint32_t duracao_seg, bool por_disparo) {
+    size_t capacidade = armazenamento_flash_capacidade_amostras(CODEC_GRAVACAO_FLASH);
+    size_t total_de_amostras = (duracao_seg > 0) ? freq_amostragem * duracao_seg : capacidade;
+    if (total_de_amostras > capacidade) {
+        total_de_amostras = capacidade;
+    }
+
+    // O take anterior da flash vai ser regravado; o espaço livre do banco vira a fila entre a
+    // codificação (núcleo 0) e a escrita (núcleo 1), tirando takes da RAM se faltar
+    banco_remover_externos();
+    if (!banco_reservar(TAMANHO_FILA_FLASH)) return 0;
+    armazenamento_flash_iniciar_gravacao(CODEC_GRAVACAO_FLASH, freq_amostragem, banco_area_livre(), TAMANHO_FILA_FLASH);
+    while (!armazenamento_flash_pronto()) {
+        armazenamento_flash_servico_nucleo0();
+    }
+
+    // A gravação termina pela duração, pela região cheia, por um novo toque no botão de gravar ou,
+    // armada, pelo silêncio. Desarmada, a região fica vazia: o take anterior já foi apagado.
+    iniciar_processamento_gravacao(total_de_amostras);
+    bool disparada = iniciar_captura_gravacao(freq_amostragem, por_disparo);
+    size_t amostras_processadas = 0;
+    bool parar = !disparada;
+    while (amostras_processadas < total_de_amostras && !parar) {
+        armazenamento_flash_servico_nucleo0();
+        parar = atender_botoes_gravacao();
+
+        uint16_t *bloco = captura_proximo_bloco();
+        if (bloco == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe(); // Acordado pela interrupção do DMA ou pelo __sev do núcleo 1 (pausa da flash)
+            continue;
+        }
+        PERFIL_OCIOSO_FIM();
+
+        size_t restantes = total_de_amostras - amostras_processadas;
+        size_t n = (restantes < TAMANHO_BLOCO_CAPTURA) ? restantes : TAMANHO_BLOCO_CAPTURA;
+        parar = parar || (por_disparo && silencio_encerra_gravacao(bloco, n));
+        PERFIL_INICIO(marca_bloco);
+        processar_bloco_gravacao(bloco, n);
+        PERFIL_INICIO(marca_codificacao);
+        armazenamento_flash_anexar_bloco(bloco, n);
+        PERFIL_FIM(PERFIL_CODIFICACAO, marca_codificacao);
+        captura_liberar_bloco();
+        PERFIL_FIM(PERFIL_BLOCO_GRAVACAO, marca_bloco);
+        amostras_processadas += n;
+    }
+    captura_parar();
+    indice_picos_finalizar(&indice_gravacao);
+    eventos_sistema_descartar();
+
+    armazenamento_flash_finalizar_gravacao();
+    while (!armazenamento_flash_concluida()) {
+        armazenamento_flash_servico_nucleo0();
+    }
+
+    // A reprodução passa a ler a gravação direto da flash (XIP), como take externo do banco
+    gravacao_codificada_t gravacao = { 0 };
+    if (!armazenamento_flash_carregar(&gravacao) || banco_adicionar_externo(&gravacao) < 0) {
+        gravacao.n_amostras = 0;
+    }
+
+    if (captura_blocos_perdidos() > 0) {
+        interface_log("Aviso: %lu blocos de captura perdidos.\n", (unsigned long)captura_blocos_perdidos());
+    }
+    relatar_estatisticas_flash();
+
+    return gravacao.n_amostras;
+}
+
+// Blocos de captura que cobrem `ms` na taxa dada (arredondado para cima)
+static uint32_t blocos_para_ms(uint32_t ms, uint32_t freq_amostragem) {
+    uint32_t amostras = (uint32_t)(((uint64_t)ms * freq_amostragem + 999) / 1000);
+    return (amostras + TAMANHO_BLOCO_CAPTURA - 1) / TAMANHO_BLOCO_CAPTURA;
+}
+
+// Dispara a captura de um take. Armada, só retorna com o som (ou um toque em gravar) e com o
+// pré-disparo ainda no anel; false se reproduzir desarmou antes (a captura fica parada).
+bool iniciar_captura_gravacao(uint32_t freq_amostragem, bool por_disparo) {
+    eventos_sistema_descartar();
+    PERFIL_INICIO(marca_captura);
+    configurar_clock_adc();
+    captura_iniciar(NULL);
+    PERFIL_FIM(PERFIL_CAPTURA_INICIO, marca_captura);
+    latencia_inicio_gravacao_us = time_us_32() - instante_pedido_gravacao_us;
+
+    blocos_pre_disparo = 0;
+    blocos_ja_detectados = 0;
+    if (!por_disparo) return true;
+    return aguardar_disparo(freq_amostragem);
+}
+
+// Cada bloco passa pelo detector assim que chega (no máximo um bloco de latência); os anteriores
+// ficam pendentes no anel como histórico e o mais antigo é liberado quando passa do pré-disparo.
+// No disparo, o laço da gravação consome o anel a partir do histórico, na ordem normal.
+bool aguardar_disparo(uint32_t freq_amostragem) {
+    uint32_t retidos_max = blocos_para_ms(PRE_DISPARO_MS, freq_amostragem);
+    if (retidos_max > CAPTURA_MAX_BLOCOS_RETIDOS) retidos_max = CAPTURA_MAX_BLOCOS_RETIDOS;
+    blocos_silencio_fim = blocos_para_ms(SILENCIO_FIM_GRAVACAO_MS, freq_amostragem);
+    blocos_em_silencio = 0;
+    dsp_detector_nivel_iniciar(&detector_disparo, LIMIAR_DISPARO_LSB, LIMIAR_SILENCIO_LSB);
+
+    interface_definir_led(1, 1, 0); // LED Amarelo: armada
+    interface_log("Gravação armada (pré-disparo de %lu blocos): o som ou gravar dispara, reproduzir desarma.\n",
+                  (unsigned long)retidos_max);
+
+    uint32_t analisados = 0; // Pendentes que já passaram pelo detector
+    bool disparou = false;
+    while (!disparou) {
+#if GRAVACAO_EM_FLASH
+        armazenamento_flash_servico_nucleo0();
+#endif
+        evento_sistema_t evento;
+        if (eventos_sistema_obter(&evento)) {
+            if (evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+                captura_parar();
+                interface_log("Gravação desarmada.\n");
+                return false;
+            }
+            break; // Gravar dispara na hora, com o histórico que houver
+        }
+
+        uint16_t *bloco = captura_bloco_pendente(analisados);
+        if (bloco == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe(); // A interrupção do DMA acorda o núcleo a cada bloco
+            continue;
+        }
+        PERFIL_OCIOSO_FIM();
+
+        PERFIL_INICIO(marca_detector);
+        dsp_resumo_bloco_t resumo;
+        dsp_resumir_bloco(bloco, TAMANHO_BLOCO_CAPTURA, &resumo);
+        disparou = dsp_detector_nivel_atualizar(&detector_disparo, &resumo);
+        PERFIL_FIM(PERFIL_DETECTOR_DISPARO, marca_detector);
+        interface_publicar_resumo_bloco(&resumo); // O medidor mostra o nível enquanto espera
+        analisados++;
+
+        while (!disparou && analisados > retidos_max) {
+            captura_liberar_bloco();
+            analisados--;
+        }
+    }
+
+    // O bloco que disparou não conta como histórico
+    blocos_ja_detectados = analisados;
+    blocos_pre_disparo = disparou ? analisados - 1 : analisados;
+    interface_definir_led(1, 0, 0); // LED Vermelho: gravando
+    interface_log("Disparo %s: %lu blocos de pré-disparo.\n", disparou ? "pelo som" : "pelo botão",
+                  (unsigned long)blocos_pre_disparo);
+    return true;
+}
+
+// Take disparado: conta os blocos seguidos abaixo do limiar de silêncio; o pré-disparo e o bloco
+// do disparo já passaram pelo detector e não contam de novo
+bool silencio_encerra_gravacao(const uint16_t *bloco, size_t n_amostras) {
+    if (blocos_ja_detectados > 0) {
+        blocos_ja_detectados--;
+        return false;
+    }
+
+    PERFIL_INICIO(marca_detector);
+    dsp_resumo_bloco_t resumo;
+    dsp_resumir_bloco(bloco, n_amostras, &resumo);
+    bool som = dsp_detector_nivel_atualizar(&detector_disparo, &resumo);
+    PERFIL_FIM(PERFIL_DETECTOR_DISPARO, marca_detector);
+
+    blocos_em_silencio = som ? 0 : blocos_em_silencio + 1;
+    return blocos_em_silencio >= blocos_silencio_fim;
+}
+
+void iniciar_processamento_gravacao(size_t total_de_amostras) {
+    filtro_gravacao_iniciado = false;
+    dsp_bloqueio_dc_iniciar(&bloqueio_dc_captura);
+    dsp_agc_iniciar(&agc_gravacao, AGC_ALVO_LSB, AGC_TETO_LSB, AGC_PISO_LSB, AGC_GANHO_MAXIMO_Q16,
+                    (int32_t)blocos_para_ms(AGC_LIBERACAO_MS, perfil_ativo->taxa));
+    cadeia_gravacao_iniciar(perfil_ativo->taxa);
+
+    indice_picos_iniciar(&indice_gravacao, total_de_amostras);
+}
+
+void processar_bloco_gravacao(uint16_t *bloco, size_t n_amostras) {
+    if (n_amostras == 0) return;
+
+    // O host recebe a captura crua (só decimada), antes da suavização e dos efeitos
+    audio_usb_enviar_microfone(bloco, n_amostras);
+
+    // A polarização do microfone sai antes de tudo: daqui em diante o silêncio é DSP_AMOSTRA_ZERO
+    PERFIL_INICIO(marca_dc);
+    dsp_bloquear_dc_bloco(&bloqueio_dc_captura, bloco, n_amostras);
+    PERFIL_FIM(PERFIL_BLOQUEIO_DC, marca_dc);
+
+    // A primeira amostra da gravação inicializa o filtro e passa inalterada
+    if (!filtro_gravacao_iniciado) {
+        estado_filtro_gravacao = bloco[0];
+        filtro_gravacao_iniciado = true;
+    }
+
+    // Aplica o filtro passa-baixa (Q15) para suavizar o sinal
+    PERFIL_INICIO(marca_filtro);
+    estado_filtro_gravacao = dsp_suavizar_bloco(bloco, n_amostras, estado_filtro_gravacao, ALFA_SUAVIZACAO_Q15);
+    PERFIL_FIM(PERFIL_FILTRO, marca_filtro);
+
+    // Efeitos ligados em cadeia_efeitos.h (nada é feito se a cadeia estiver vazia)
+    cadeia_gravacao_processar(bloco, n_amostras);
+
+    // Nível automático por último, para que o limitador valha para o que é gravado
+    PERFIL_INICIO(marca_agc);
+    dsp_agc_bloco(&agc_gravacao, bloco, n_amostras);
+    PERFIL_FIM(PERFIL_AGC, marca_agc);
+
+    // Acumula mínimo/máximo do bloco nos níveis do índice de picos
+    indice_picos_anexar(&indice_gravacao, bloco, n_amostras);
+
+    // Resumo do bloco para o medidor ao vivo (o desenho fica com o núcleo 1)
+    dsp_resumo_bloco_t resumo;
+    dsp_resumir_bloco(bloco, n_amostras, &resumo);
+    interface_publicar_resumo_bloco(&resumo);
+    interface_publicar_bloco_espectro(bloco, n_amostras);
+}
+
+// Envelope mínimo/máximo de um trecho da gravação, uma coluna do display por vez.
+// Zoom e rolagem são apenas outros valores de início/comprimento.
+void montar_resumo_gravacao(resumo_onda_t *resumo, size_t inicio, size_t n_amostras) {
+    resumo->n_colunas = (n_amostras < DISPLAY_WIDTH) ? n_amostras : DISPLAY_WIDTH;
+    indice_picos_envelope(&indice_gravacao, inicio, n_amostras, resumo->n_colunas, resumo->picos);
+}
+
+// Recria o índice de uma gravação que não passou pela captura (flash no boot ou importação USB),
+// decodificada uma única vez: o resumo fica guardado no take
+void reconstruir_indice_picos(const gravacao_codificada_t *gravacao) {
+    uint16_t amostras[CODEC_AMOSTRAS_POR_BLOCO];
+
+    indice_picos_iniciar(&indice_gravacao, gravacao->n_amostras);
+    for (size_t i = 0; i < gravacao_numero_de_blocos(gravacao); i++) {
+        size_t n = gravacao_ler_bloco(gravacao, i, amostras);
+        indice_picos_anexar(&indice_gravacao, amostras, n);
+    }
+    indice_picos_finalizar(&indice_gravacao);
+}
+
+// Ganho que leva o pico medido do take (o resumo, tirado do índice de picos) a TETO_SAIDA_LSB.
+// A excursão conta a partir de DSP_AMOSTRA_ZERO, onde o ganho é aplicado: um take antigo com DC
+// também não satura. Os 4 bits perdidos no resumo entram a favor da folga.
+int32_t ganho_saida_take(const take_banco_t *take) {
+    if (take->resumo.n_colunas == 0) return DSP_Q12(1.0f); // Ainda sem medida
+
+    nivel_picos_t medido = indice_picos_nivel(take->resumo.picos, take->resumo.n_colunas);
+    int32_t deslocamento = (int32_t)medido.centro - 128;
+    if (deslocamento < 0) deslocamento = -deslocamento;
+    int32_t pico_lsb = (deslocamento + medido.excursao) * 16 + 16;
+
+    int32_t ganho_q12 = (TETO_SAIDA_LSB * 4096) / pico_lsb;
+    if (ganho_q12 > GANHO_SAIDA_MAXIMO_Q12) ganho_q12 = GANHO_SAIDA_MAXIMO_Q12;
+    if (ganho_q12 < DSP_Q12(1.0f)) ganho_q12 = DSP_Q12(1.0f);
+    return ganho_q12;
+}
+
+// Retorna true se o toque que abriu a reprodução virou toque longo (pedido de exclusão do take)
+bool processo_de_reproducao(const gravacao_codificada_t *gravacao, uint32_t freq_amostragem, int32_t ganho_q12,
+                            toque_longo_t *toque) {
+    // A saída (PWM ou PIO) cadencia o DMA; aqui apenas pré-calculamos as palavras bloco a bloco
+    cadeia_reproducao_iniciar(freq_amostragem);
+    reproducao_iniciar();
+    uint16_t amostras_decodificadas[TAMANHO_BLOCO_REPRODUCAO];
+
+    // A gravação é lida pelo reamostrador, que converte a taxa dela e aplica a velocidade escolhida
+    reamostrador_iniciar(&reamostrador_reproducao, gravacao, freq_amostragem, INTERPOLACAO_REPRODUCAO);
+    reamostrador_definir_velocidade(&reamostrador_reproducao, velocidades_reproducao[indice_velocidade]);
+    bool apagar = false;
+    eventos_sistema_descartar();
+    while (true) {
+        atender_botoes_reproducao();
+        if (toque_longo_atualizar(toque) == TOQUE_LONGO) {
+            apagar = true;
+            break;
+        }
+
+        uint32_t *bloco = reproducao_obter_bloco_livre();
+        if (bloco == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe(); // A interrupção do DMA acorda o núcleo quando um bloco é liberado
+            continue;
+        }
+        PERFIL_OCIOSO_FIM();
+
+        // Reamostra um bloco e o amplifica em Q12 (ganho medido no take), saturando em 12 bits
+        PERFIL_INICIO(marca_bloco);
+        size_t n = reamostrador_ler(&reamostrador_reproducao, amostras_decodificadas, TAMANHO_BLOCO_REPRODUCAO);
+        PERFIL_FIM(PERFIL_REAMOSTRAGEM, marca_bloco);
+        if (n == 0) break;
+        PERFIL_INICIO(marca_ganho);
+        dsp_ganho_bloco(amostras_decodificadas, amostras_decodificadas, n, ganho_q12);
+        PERFIL_FIM(PERFIL_GANHO, marca_ganho);
+        cadeia_reproducao_processar(amostras_decodificadas, n);
+
+        dsp_resumo_bloco_t resumo;
+        dsp_resumir_bloco(amostras_decodificadas, n, &resumo);
+        interface_publicar_resumo_bloco(&resumo);
+        interface_publicar_bloco_espectro(amostras_decodificadas, n);
+
+        PERFIL_INICIO(marca_conversao);
+        reproducao_converter_bloco(amostras_decodificadas, bloco, n);
+        PERFIL_FIM(PERFIL_CONVERSAO_SAIDA, marca_conversao);
+        reproducao_enviar_bloco(n);
+        PERFIL_FIM(PERFIL_BLOCO_REPRODUCAO, marca_bloco);
     }
 
-    float divisor_clock_adc = (float)clock_get_hz(clk_adc) / (freq_amostragem * 1.0f);
-    adc_set_clkdiv(divisor_clock_adc);
+    // Aguarda o esvaziamento da fila; os buzzers são desligados ao final
+    reproducao_finalizar();
 
-    capturar_amostras_via_dma(buffer_de_amostras, total_de_amostras);
+    if (reproducao_blocos_em_falta() > 0) {
+        interface_log("Aviso: %lu blocos de reprodução em falta.\n", (unsigned long)reproducao_blocos_em_falta());
+    }
+    relatar_estatisticas_reamostrador();
+    return apagar;
+}
 
-    // Aplica o filtro passa-baixa para suavizar o sinal
-    uint16_t amostra_suavizada = buffer_de_amostras[0];
-    for (size_t i = 1; i < total_de_amostras; ++i) {
-        amostra_suavizada = suavizar_sinal_audio(buffer_de_amostras[i], amostra_suavizada, FATOR_SUAVIZACAO);
-        buffer_de_amostras[i] = amostra_suavizada;
+// Estado de um botão lido por polling (o modo sintetizador precisa também da soltura)
+typedef struct {
+    uint pino;
+    bool pressionado;
+    uint32_t ultima_mudanca_ms;
+} botao_polling_t;
+
+// Retorna true quando o estado estável do botão muda
+static bool atualizar_botao(botao_polling_t *botao, uint32_t agora_ms) {
+    bool pressionado = !gpio_get(botao->pino); // Pull-up: pressionado em nível baixo
+    if (pressionado == botao->pressionado || agora_ms - botao->ultima_mudanca_ms < TEMPO_ESTABILIZACAO_BOTAO_MS) {
+        return false;
     }
+    botao->pressionado = pressionado;
+    botao->ultima_mudanca_ms = agora_ms;
+    return true;
+}
 
-    return total_de_amostras;
+static bool acorde_contem(const uint8_t acorde[3], uint8_t nota) {
+    return acorde[0] == nota || acorde[1] == nota || acorde[2] == nota;
 }
 
-void processo_de_reproducao(uint pino_a, uint pino_b, uint16_t *dados, size_t n_amostras, uint32_t freq_amostragem) {
-    uint32_t clock = clock_get_hz(clk_sys);
-    uint32_t valor_max_pwm = clock / freq_amostragem - 1;
-    if (valor_max_pwm == 0) valor_max_pwm = 1;
+// Renderiza um bloco, o entrega à visualização ao vivo e o enfileira na saída
+static void enviar_bloco_sintetizador(uint32_t *bloco) {
+    uint16_t amostras[TAMANHO_BLOCO_REPRODUCAO];
+    sintetizador_renderizar(amostras, TAMANHO_BLOCO_REPRODUCAO);
+    cadeia_reproducao_processar(amostras, TAMANHO_BLOCO_REPRODUCAO);
+
+    dsp_resumo_bloco_t resumo;
+    dsp_resumir_bloco(amostras, TAMANHO_BLOCO_REPRODUCAO, &resumo);
+    interface_publicar_resumo_bloco(&resumo);
+    interface_publicar_bloco_espectro(amostras, TAMANHO_BLOCO_REPRODUCAO);
 
-    for (size_t i = 0; i < n_amostras; ++i) {
-        // Amplifica o sinal e garante que não ultrapasse o limite de 12-bit (4095)
-        uint32_t amostra_amplificada = (uint32_t)(dados[i] * GANHO_SAIDA_AUDIO);
-        if (amostra_amplificada > 4095) amostra_amplificada = 4095;
-        
-        // Converte o valor da amostra (0-4095) para o nível do PWM
-        uint32_t nivel_pwm = (amostra_amplificada * valor_max_pwm) / 4095;
-        
-        pwm_set_gpio_level(pino_a, nivel_pwm);
-        pwm_set_gpio_level(pino_b, nivel_pwm);
-        
-        // Aguarda o tempo exato entre as amostras
-        sleep_us(1000000 / freq_amostragem);
+    reproducao_converter_bloco(amostras, bloco, TAMANHO_BLOCO_REPRODUCAO);
+    reproducao_enviar_bloco(TAMANHO_BLOCO_REPRODUCAO);
+}
+
+// Renderiza o sintetizador na mesma fila de blocos da reprodução; os botões são lidos a cada bloco.
+// Retorna true se o toque que abriu o modo virou toque longo sozinho (pedido do looper).
+bool processo_sintetizador(uint32_t freq_amostragem, toque_longo_t *toque) {
+    botao_polling_t botao_nota = { .pino = PINO_BOTAO_GRAVAR, .pressionado = !gpio_get(PINO_BOTAO_GRAVAR) };
+    botao_polling_t botao_acorde = { .pino = PINO_BOTAO_REPRODUZIR, .pressionado = !gpio_get(PINO_BOTAO_REPRODUZIR) };
+    size_t passo_escala = 0;
+    uint8_t nota_tocando = NOTA_BASE_SINTETIZADOR + escala_sintetizador[0]; // Raiz do acorde antes da 1ª nota
+    uint8_t acorde_tocando[3] = { 0 };
+    uint32_t ambos_desde_ms = 0;
+    bool abrir_looper = false;
+
+    sintetizador_iniciar();
+    cadeia_reproducao_iniciar(freq_amostragem);
+    reproducao_iniciar();
+    while (true) {
+        uint32_t *bloco = reproducao_obter_bloco_livre();
+        if (bloco == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe();
+            continue;
+        }
+        PERFIL_OCIOSO_FIM();
+
+        uint32_t agora = to_ms_since_boot(get_absolute_time());
+        if (atualizar_botao(&botao_nota, agora)) {
+            if (botao_nota.pressionado) {
+                nota_tocando = NOTA_BASE_SINTETIZADOR + escala_sintetizador[passo_escala];
+                passo_escala = (passo_escala + 1) % N_NOTAS_ESCALA_SINTETIZADOR;
+                sintetizador_nota_ligar(nota_tocando, VELOCIDADE_NOTA_SINTETIZADOR);
+            } else if (!botao_acorde.pressionado || !acorde_contem(acorde_tocando, nota_tocando)) {
+                sintetizador_nota_desligar(nota_tocando);
+            }
+        }
+        if (atualizar_botao(&botao_acorde, agora)) {
+            if (botao_acorde.pressionado) {
+                // Tríade maior uma oitava abaixo da última nota tocada da escala
+                uint8_t raiz = nota_tocando - 12;
+                acorde_tocando[0] = raiz;
+                acorde_tocando[1] = raiz + 4;
+                acorde_tocando[2] = raiz + 7;
+                for (int k = 0; k < 3; k++) sintetizador_nota_ligar(acorde_tocando[k], VELOCIDADE_ACORDE_SINTETIZADOR);
+            } else {
+                // A altura que a nota da escala ainda segura continua soando (as duas dividem a voz)
+                for (int k = 0; k < 3; k++) {
+                    if (!botao_nota.pressionado || acorde_tocando[k] != nota_tocando) {
+                        sintetizador_nota_desligar(acorde_tocando[k]);
+                    }
+                }
+            }
+        }
+        if (botao_nota.pressionado && botao_acorde.pressionado) {
+            if (ambos_desde_ms == 0) ambos_desde_ms = agora | 1;
+            if (agora - ambos_desde_ms >= TEMPO_SAIDA_SINTETIZADOR_MS) break;
+        } else {
+            ambos_desde_ms = 0;
+        }
+        // O botão de acorde começa pressionado pelo toque de entrada, que não toca nada até ser solto
+        if (toque_longo_atualizar(toque) == TOQUE_LONGO && !botao_nota.pressionado) {
+            abrir_looper = true;
+            break;
+        }
+
+        enviar_bloco_sintetizador(bloco);
     }
-    // Desliga os buzzers ao final
-    pwm_set_gpio_level(pino_a, 0);
-    pwm_set_gpio_level(pino_b, 0);
+
+    // Solta todas as notas e deixa as liberações terminarem antes de desligar a saída
+    sintetizador_desligar_todas();
+    while (sintetizador_vozes_ativas() > 0) {
+        uint32_t *bloco = reproducao_obter_bloco_livre();
+        if (bloco == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe();
+            continue;
+        }
+        PERFIL_OCIOSO_FIM();
+        enviar_bloco_sintetizador(bloco);
+    }
+    reproducao_finalizar();
+
+    if (reproducao_blocos_em_falta() > 0) {
+        interface_log("Aviso: %lu blocos do sintetizador em falta.\n", (unsigned long)reproducao_blocos_em_falta());
+    }
+    return abrir_looper;
+}
+
+// Captura e saída ao mesmo tempo sobre um take aberto do banco, em PCM16: a saída toca o laço e a
+// captura grava nele. Gravar fecha a primeira passada e depois liga/desliga o overdub; reproduzir
+// encerra. Retorna o comprimento do laço, que fica no banco como take novo (0 se não fechou).
+size_t processo_looper(uint32_t freq_amostragem) {
+    size_t reserva = codec_bytes_para_amostras(CODEC_PCM16, freq_amostragem * DURACAO_MINIMA_LIVRE_S);
+    if (reserva > banco_capacidade_bytes()) reserva = banco_capacidade_bytes();
+    gravacao_codificada_t *gravacao = banco_reservar(reserva) ? banco_abrir_take(CODEC_PCM16, freq_amostragem) : NULL;
+    if (gravacao == NULL) return 0;
+
+    // Em PCM16 as amostras ficam na memória do take como o DMA as entrega: o laço é o próprio take
+    size_t capacidade = codec_capacidade_amostras(CODEC_PCM16, gravacao->capacidade_bytes);
+    looper_iniciar(&looper, (uint16_t *)gravacao->dados, capacidade, REALIMENTACAO_LOOPER_Q15);
+    uint16_t amostras[TAMANHO_BLOCO_REPRODUCAO];
+
+    // A fila cheia dispara a saída; a captura parte logo depois. A diferença entre os dois
+    // disparos e o atraso do decimador alinham a entrada com o que estava tocando.
+    reproducao_iniciar();
+    for (int i = 0; i < N_BLOCOS_FILA_REPRODUCAO; i++) {
+        uint32_t *bloco = reproducao_obter_bloco_livre();
+        looper_ler_bloco(&looper, amostras, TAMANHO_BLOCO_REPRODUCAO);
+        reproducao_converter_bloco(amostras, bloco, TAMANHO_BLOCO_REPRODUCAO);
+        reproducao_enviar_bloco(TAMANHO_BLOCO_REPRODUCAO);
+    }
+    uint32_t inicio_saida_us = time_us_32();
+    dsp_bloqueio_dc_iniciar(&bloqueio_dc_captura); // Com realimentação, o DC da entrada se acumularia no laço
+    configurar_clock_adc();
+    uint32_t inicio_captura_us = time_us_32();
+    captura_iniciar(NULL);
+    uint32_t diferenca = (uint32_t)(((uint64_t)(inicio_captura_us - inicio_saida_us) * freq_amostragem + 500000u) / 1000000u);
+    looper_alinhar(&looper, (int32_t)diferenca - CAPTURA_ATRASO_AMOSTRAS + AJUSTE_LATENCIA_LOOPER);
+
+    uint32_t faltas_vistas = 0;
+    uint32_t perdidos_vistos = 0;
+    bool encerrar = false;
+    eventos_sistema_descartar();
+    while (!encerrar) {
+        evento_sistema_t evento;
+        while (eventos_sistema_obter(&evento)) {
+            if (evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+                encerrar = true;
+            } else if (!looper_fechado(&looper)) {
+                if (looper_fechar(&looper)) {
+                    interface_definir_led(0, 1, 0); // LED Verde: tocando o laço
+                    interface_log("Laço fechado: %lu amostras.\n", (unsigned long)looper.comprimento);
+                }
+            } else {
+                looper_sobrepor(&looper, !looper.sobrepondo);
+                interface_definir_led(looper.sobrepondo, 1, 0); // LED Amarelo: overdub; verde: só tocando
+            }
+        }
+
+        // Um bloco de silêncio da saída atrasa os seguintes; o laço acompanha para não desalinhar
+        uint32_t faltas = reproducao_blocos_em_falta();
+        if (faltas != faltas_vistas) {
+            looper_pular_saida(&looper, (faltas - faltas_vistas) * TAMANHO_BLOCO_REPRODUCAO);
+            faltas_vistas = faltas;
+        }
+
+        uint16_t *bloco_captura = captura_proximo_bloco();
+        if (bloco_captura != NULL) {
+            bool aberto = !looper_fechado(&looper);
+            // Blocos perdidos pelo anel antes deste: a entrada anda o mesmo, para o overdub não desalinhar
+            uint32_t perdidos = captura_perdidos_antes_do_proximo();
+            if (perdidos != perdidos_vistos) {
+                looper_pular_entrada(&looper, (perdidos - perdidos_vistos) * TAMANHO_BLOCO_CAPTURA);
+                perdidos_vistos = perdidos;
+            }
+            PERFIL_INICIO(marca_dc);
+            dsp_bloquear_dc_bloco(&bloqueio_dc_captura, bloco_captura, TAMANHO_BLOCO_CAPTURA);
+            PERFIL_FIM(PERFIL_BLOQUEIO_DC, marca_dc);
+            PERFIL_INICIO(marca_mistura);
+            looper_escrever_bloco(&looper, bloco_captura, TAMANHO_BLOCO_CAPTURA);
+            PERFIL_FIM(PERFIL_MISTURA_LOOPER, marca_mistura);
+            if (aberto && looper_fechado(&looper)) {
+                interface_definir_led(0, 1, 0);
+                interface_log("Laço fechado no fim do espaço: %lu amostras.\n", (unsigned long)looper.comprimento);
+            }
+
+            dsp_resumo_bloco_t resumo;
+            dsp_resumir_bloco(bloco_captura, TAMANHO_BLOCO_CAPTURA, &resumo);
+            interface_publicar_resumo_bloco(&resumo);
+            interface_publicar_bloco_espectro(bloco_captura, TAMANHO_BLOCO_CAPTURA);
+            captura_liberar_bloco();
+        }
+
+        uint32_t *bloco_saida = reproducao_obter_bloco_livre();
+        if (bloco_saida != NULL) {
+            PERFIL_INICIO(marca_bloco);
+            looper_ler_bloco(&looper, amostras, TAMANHO_BLOCO_REPRODUCAO);
+            PERFIL_INICIO(marca_conversao);
+            reproducao_converter_bloco(amostras, bloco_saida, TAMANHO_BLOCO_REPRODUCAO);
+            PERFIL_FIM(PERFIL_CONVERSAO_SAIDA, marca_conversao);
+            reproducao_enviar_bloco(TAMANHO_BLOCO_REPRODUCAO);
+            PERFIL_FIM(PERFIL_BLOCO_REPRODUCAO, marca_bloco);
+        }
+
+        if (bloco_captura == NULL && bloco_saida == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            __wfe(); // Acordado pelas interrupções dos dois DMAs ou pelos botões
+        } else {
+            PERFIL_OCIOSO_FIM();
+        }
+    }
+    captura_parar();
+    reproducao_finalizar();
+
+    if (!looper_fechado(&looper) || !gravacao_adotar_pcm16(gravacao, looper.comprimento)) {
+        banco_descartar_take_aberto();
+        return 0;
+    }
+    banco_fechar_take(); // O resumo é montado do take ao ser mostrado
+    return looper.comprimento;
 }
 
 // ----------------------------------------
 // --- Funções de Apoio e Utilitários ---
 // ----------------------------------------
 
-void definir_cor_led(bool vermelho, bool verde, bool azul) {
-    gpio_put(PINO_LED_VERMELHO, vermelho);
-    gpio_put(PINO_LED_VERDE, verde);
-    gpio_put(PINO_LED_AZUL, azul);
+// Liga a captura e a saída conforme o host abre cada stream; termina quando ele fecha os
+// dois ou quando um botão é pressionado
+void processo_audio_usb(uint32_t freq_amostragem) {
+    bool captura_ligada = false;
+    bool saida_ligada = false;
+
+    eventos_sistema_descartar();
+    while (!eventos_sistema_pendentes()) {
+        bool microfone = audio_usb_microfone_ativo();
+        bool alto_falante = audio_usb_alto_falante_ativo();
+        if (!microfone && !alto_falante) break;
+
+        if (microfone != captura_ligada) {
+            if (microfone) {
+                configurar_clock_adc();
+                captura_iniciar(NULL);
+            } else {
+                captura_parar();
+            }
+            captura_ligada = microfone;
+        }
+        if (alto_falante != saida_ligada) {
+            if (alto_falante) {
+                audio_usb_reiniciar_alto_falante();
+                reproducao_iniciar();
+            } else {
+                reproducao_finalizar();
+            }
+            saida_ligada = alto_falante;
+        }
+
+        uint16_t *bloco_captura = captura_ligada ? captura_proximo_bloco() : NULL;
+        if (bloco_captura != NULL) {
+            audio_usb_enviar_microfone(bloco_captura, TAMANHO_BLOCO_CAPTURA);
+
+            dsp_resumo_bloco_t resumo;
+            dsp_resumir_bloco(bloco_captura, TAMANHO_BLOCO_CAPTURA, &resumo);
+            interface_publicar_resumo_bloco(&resumo);
+            interface_publicar_bloco_espectro(bloco_captura, TAMANHO_BLOCO_CAPTURA);
+            captura_liberar_bloco();
+        }
+
+        uint32_t *bloco_saida = saida_ligada ? reproducao_obter_bloco_livre() : NULL;
+        if (bloco_saida != NULL) {
+            // Sem áudio suficiente do host, o bloco sai em silêncio e a saída não para
+            static uint16_t amostras_host[TAMANHO_BLOCO_REPRODUCAO];
+            audio_usb_receber_alto_falante(amostras_host, TAMANHO_BLOCO_REPRODUCAO);
+            reproducao_converter_bloco(amostras_host, bloco_saida, TAMANHO_BLOCO_REPRODUCAO);
+            reproducao_enviar_bloco(TAMANHO_BLOCO_REPRODUCAO);
+        }
+
+        if (bloco_captura == NULL && bloco_saida == NULL) {
+            PERFIL_OCIOSO_INICIO();
+            tight_loop_contents();
+        } else {
+            PERFIL_OCIOSO_FIM();
+        }
+    }
+
+    if (captura_ligada) captura_parar();
+    if (saida_ligada) reproducao_finalizar();
 }
 
 void tratador_interrupcao_botao(uint pino, uint32_t eventos) {
@@ -305,88 +1231,297 @@ void tratador_interrupcao_botao(uint pino, uint32_t eventos) {
 
     if (pino == PINO_BOTAO_GRAVAR) {
         if (agora - ultimo_acionamento_gravar > TEMPO_DEBOUNCE_BOTAO_MS) {
-            flag_botao_gravar_ativado = true;
+            eventos_sistema_publicar(EVENTO_BOTAO_GRAVAR);
             ultimo_acionamento_gravar = agora;
         }
     }
     if (pino == PINO_BOTAO_REPRODUZIR) {
         if (agora - ultimo_acionamento_reproduzir > TEMPO_DEBOUNCE_BOTAO_MS) {
-            flag_botao_reproduzir_ativado = true;
+            eventos_sistema_publicar(EVENTO_BOTAO_REPRODUZIR);
             ultimo_acionamento_reproduzir = agora;
         }
     }
 }
 
-void capturar_amostras_via_dma(uint16_t *destino, size_t n_amostras) {
-    adc_fifo_drain();
-    adc_run(false);
+// Durante a gravação: reproduzir alterna a visualização; retorna true se gravar pediu o fim
+bool atender_botoes_gravacao(void) {
+    bool parar = false;
+    evento_sistema_t evento;
+    while (eventos_sistema_obter(&evento)) {
+        if (evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+            alternar_visualizacao();
+        } else {
+            parar = true;
+        }
+    }
+    return parar;
+}
 
-    dma_channel_configure(canal_dma_adc, &config_canal_dma, destino, &(adc_hw->fifo), n_amostras, true);
+// Durante a reprodução: reproduzir alterna a visualização, gravar troca a velocidade
+void atender_botoes_reproducao(void) {
+    evento_sistema_t evento;
+    while (eventos_sistema_obter(&evento)) {
+        if (evento.tipo == EVENTO_BOTAO_REPRODUZIR) {
+            alternar_visualizacao();
+        } else {
+            alternar_velocidade();
+        }
+    }
+}
 
-    adc_run(true);
-    dma_channel_wait_for_finish_blocking(canal_dma_adc);
-    adc_run(false);
+// Alterna a visualização ao vivo entre onda e espectro
+void alternar_visualizacao(void) {
+    bool espectro = (interface_visualizacao() == VISUALIZACAO_ONDA);
+    interface_definir_visualizacao(espectro ? VISUALIZACAO_ESPECTRO : VISUALIZACAO_ONDA);
 }
 
-uint16_t suavizar_sinal_audio(uint16_t amostra_atual, uint16_t amostra_anterior, float fator) {
-    // Filtro IIR simples (média móvel exponencial)
-    return (uint16_t)(fator * amostra_atual + (1.0f - fator) * amostra_anterior);
+// Passa para a próxima velocidade de reprodução da lista
+void alternar_velocidade(void) {
+    indice_velocidade = (indice_velocidade + 1) % (sizeof(velocidades_reproducao) / sizeof(velocidades_reproducao[0]));
+    reamostrador_definir_velocidade(&reamostrador_reproducao, velocidades_reproducao[indice_velocidade]);
+    interface_log("Velocidade de reprodução: %lu%%\n",
+                  (unsigned long)(velocidades_reproducao[indice_velocidade] * 100u >> 16));
+}
+
+// Perdas em cada sentido do áudio USB e a última realimentação enviada ao host
+void relatar_estatisticas_audio_usb(void) {
+    estatisticas_audio_usb_t estatisticas = audio_usb_estatisticas();
+    uint32_t milesimos = (uint32_t)(((uint64_t)estatisticas.realimentacao_16_16 * 1000u) >> 16);
+
+    interface_log("Áudio USB: microfone %lu faltas, %lu amostras descartadas\n",
+                  (unsigned long)estatisticas.faltas_microfone, (unsigned long)estatisticas.amostras_descartadas_microfone);
+    interface_log("Áudio USB: alto-falante %lu faltas, %lu amostras descartadas, realimentação %lu.%03lu amostras/ms\n",
+                  (unsigned long)estatisticas.faltas_alto_falante, (unsigned long)estatisticas.amostras_descartadas_alto_falante,
+                  (unsigned long)(milesimos / 1000u), (unsigned long)(milesimos % 1000u));
 }
 
-void mostrar_waveform_display(uint8_t *buffer_tela, uint16_t *dados_audio, size_t n_amostras) {
-    memset(buffer_tela, 0, DISPLAY_WIDTH * DISPLAY_HEIGHT / 8); // Limpa o buffer
-    ssd1306_draw_string(buffer_tela, 10, 0, "Onda capturada"); // Título Alterado
+// Mostra o take que a importação criou (ainda sem resumo) ou, se ela foi cancelada, o que
+// ficou selecionado; retorna true se o banco não ficou vazio
+bool concluir_importacao_usb(void) {
+    int indice = banco_selecionado();
+    if (indice < 0) {
+        interface_log("Importação USB cancelada; banco vazio.\n");
+        interface_apagar_tela();
+        return false;
+    }
 
-    // Define a área de desenho e o centro vertical
-    int y_offset = 12; // Espaço para o título
-    int altura_desenho = DISPLAY_HEIGHT - y_offset;
-    int y_centro = y_offset + (altura_desenho / 2);
+    const take_banco_t *take = banco_take((size_t)indice);
+    if (take->resumo.n_colunas == 0) {
+        interface_log("Importação USB: %lu amostras a %lu Hz. Pronto para reproduzir.\n",
+                      (unsigned long)take->gravacao.n_amostras, (unsigned long)take->gravacao.freq_amostragem);
+    } else {
+        interface_log("Importação USB cancelada.\n");
+    }
+    mostrar_take_selecionado();
+    return true;
+}
 
-    const int ADC_ZERO = 2048; 
-    const float GANHO_VISUAL = 4.0f; // Amplifica a onda 4x no display
+// Resumo do take selecionado no display (montado na primeira vez, se ele não veio da captura)
+void mostrar_take_selecionado(void) {
+    take_banco_t *take = banco_take((size_t)banco_selecionado());
+    if (take == NULL) return;
 
-    size_t colunas_a_desenhar = (n_amostras < DISPLAY_WIDTH) ? n_amostras : DISPLAY_WIDTH;
-    for (size_t x = 0; x < colunas_a_desenhar; x++) {
-        // Reduz a amostragem para caber na tela se necessário
-        size_t indice_amostra = (n_amostras > DISPLAY_WIDTH) ? (x * n_amostras / DISPLAY_WIDTH) : x;
-        
-        // Calcula a amplitude relativa ao centro (-2047 a +2047)
-        int amplitude = (int)dados_audio[indice_amostra] - ADC_ZERO;
+    if (take->resumo.n_colunas == 0) {
+        reconstruir_indice_picos(&take->gravacao);
+        montar_resumo_gravacao(&take->resumo, 0, take->gravacao.n_amostras);
+    }
+    interface_mostrar_resumo(&take->resumo);
+    interface_log("Take %u (%d de %lu%s): %lu amostras a %lu Hz, %lu KB livres no banco\n", (unsigned)take->numero,
+                  banco_selecionado() + 1, (unsigned long)banco_n_takes(), take->externo ? ", flash" : "",
+                  (unsigned long)take->gravacao.n_amostras, (unsigned long)take->gravacao.freq_amostragem,
+                  (unsigned long)(banco_livre_bytes() / 1024u));
+}
 
-        // Mapeia a amplitude para a altura do display, aplicando o ganho visual
-        int y_final = y_centro - (int)((float)amplitude / ADC_ZERO * (altura_desenho / 2.0f) * GANHO_VISUAL);
+// Passa ao take seguinte; retorna false depois do último (a próxima ação é uma gravação nova)
+bool selecionar_proximo_take(void) {
+    size_t proximo = (size_t)(banco_selecionado() + 1);
+    if (proximo >= banco_n_takes()) {
+        banco_selecionar(0); // A volta pelos takes recomeça do primeiro
+        interface_log("Nova gravação: gravar grava, reproduzir abre o sintetizador (segurar: o looper).\n");
+        interface_apagar_tela();
+        return false;
+    }
+    banco_selecionar(proximo);
+    mostrar_take_selecionado();
+    return true;
+}
 
-        // Garante que o desenho não saia da área útil (clipping)
-        if (y_final < y_offset) y_final = y_offset;
-        if (y_final >= DISPLAY_HEIGHT) y_final = DISPLAY_HEIGHT - 1;
+// Remove o take selecionado e compacta o banco; retorna false se ele ficou vazio
+bool apagar_take_selecionado(void) {
+    take_banco_t *take = banco_take((size_t)banco_selecionado());
+    uint16_t numero = take->numero;
+    if (!banco_remover((size_t)banco_selecionado())) return true;
+
+    estatisticas_banco_t estatisticas = banco_estatisticas();
+    interface_log("Take %u apagado; compactação: %lu bytes em %lu us\n", (unsigned)numero,
+                  (unsigned long)estatisticas.ultima_compactacao_bytes, (unsigned long)estatisticas.ultima_compactacao_us);
+    if (banco_n_takes() == 0) {
+        interface_log("Banco vazio.\n");
+        interface_apagar_tela();
+        return false;
+    }
+    mostrar_take_selecionado();
+    return true;
+}
 
-        // Desenha a linha vertical do centro até a amplitude
-        if (y_final > y_centro) { // Amplitude para baixo
-            for (int y = y_centro; y <= y_final; y++) {
-                ssd1306_set_pixel(buffer_tela, x, y, true);
-            }
-        } else { // Amplitude para cima
-            for (int y = y_final; y <= y_centro; y++) {
-                ssd1306_set_pixel(buffer_tela, x, y, true);
-            }
+// Passa a acompanhar o botão a partir do toque em `instante_us`
+void toque_longo_iniciar(toque_longo_t *toque, uint pino, uint32_t instante_us) {
+    toque->pino = pino;
+    toque->instante_us = instante_us;
+    toque->acompanhando = true;
+}
+
+// Lê o botão sem esperar. TOQUE_CURTO e TOQUE_LONGO saem uma única vez e encerram o acompanhamento;
+// uma leitura solta dentro do repique do próprio toque não conta como soltura.
+resultado_toque_t toque_longo_atualizar(toque_longo_t *toque) {
+    if (!toque->acompanhando) return TOQUE_NENHUM;
+
+    uint32_t decorrido_us = time_us_32() - toque->instante_us;
+    if (gpio_get(toque->pino)) { // Pull-up: solto em nível alto
+        if (decorrido_us < TEMPO_ESTABILIZACAO_BOTAO_MS * 1000u) return TOQUE_PENDENTE;
+        toque->acompanhando = false;
+        return TOQUE_CURTO;
+    }
+    if (decorrido_us < TEMPO_SEGURAR_BOTAO_MS * 1000u) return TOQUE_PENDENTE;
+    toque->acompanhando = false;
+    return TOQUE_LONGO;
+}
+
+// Depois de um toque longo já atendido: espera o botão ficar solto e estável e descarta os
+// toques do repique da soltura
+void aguardar_soltura(uint pino) {
+    uint32_t solto_desde_us = 0;
+    while (true) {
+        uint32_t agora_us = time_us_32();
+        if (!gpio_get(pino)) {
+            solto_desde_us = 0;
+        } else if (solto_desde_us == 0) {
+            solto_desde_us = agora_us | 1;
+        } else if (agora_us - solto_desde_us >= TEMPO_ESTABILIZACAO_BOTAO_MS * 1000u) {
+            break;
         }
+        sleep_ms(2);
+    }
+    eventos_sistema_descartar();
+}
+
+// Tempo até o último quadro entrar na FIFO (o host recebe o resto em menos de 1 ms)
+void relatar_exportacao_usb(void) {
+    estatisticas_transferencia_t estatisticas = transferencia_usb_estatisticas();
+    uint32_t taxa = (estatisticas.ultima_exportacao_us > 0)
+        ? (uint32_t)((uint64_t)estatisticas.ultima_exportacao_bytes * 1000u / estatisticas.ultima_exportacao_us) : 0;
+
+    interface_log("Exportação USB: %lu bytes em %lu ms (%lu KB/s), %lu quadros rejeitados\n",
+                  (unsigned long)estatisticas.ultima_exportacao_bytes,
+                  (unsigned long)(estatisticas.ultima_exportacao_us / 1000u),
+                  (unsigned long)taxa, (unsigned long)estatisticas.quadros_rejeitados);
+}
+
+// Taxa, clk_sys e a duração máxima de uma gravação no perfil (a capacidade do codec não depende da taxa)
+void relatar_perfil_taxa(const char *prefixo, indice_perfil_taxa_t indice) {
+    const perfil_taxa_t *perfil = &perfis_taxa[indice];
+#if GRAVACAO_EM_FLASH
+    size_t capacidade = armazenamento_flash_capacidade_amostras(CODEC_GRAVACAO_FLASH);
+#else
+    size_t capacidade = codec_capacidade_amostras(CODEC_GRAVACAO, sizeof(buffer_de_amostras));
+#endif
+    uint32_t decimos_s = (uint32_t)((uint64_t)capacidade * 10u / perfil->taxa);
+
+    interface_log("%s: %s (%lu Hz, clk_sys %lu.%lu MHz), até %lu.%lu s de gravação\n", prefixo, perfil->nome,
+                  (unsigned long)perfil->taxa, (unsigned long)(perfil->freq_sistema_hz / MHZ),
+                  (unsigned long)(perfil->freq_sistema_hz / (MHZ / 10u) % 10u), (unsigned long)(decimos_s / 10u),
+                  (unsigned long)(decimos_s % 10u));
+}
+
+// Ciclos por amostra de saída do reamostrador (com a decodificação) contra o orçamento por amostra
+void relatar_estatisticas_reamostrador(void) {
+    const estatisticas_reamostrador_t *estatisticas = &reamostrador_reproducao.estatisticas;
+    if (estatisticas->n_amostras_saida == 0) return;
+
+    uint32_t decimos_por_amostra = (uint32_t)(estatisticas->ciclos_total * 10u / estatisticas->n_amostras_saida);
+    uint32_t orcamento = perfil_ativo->freq_sistema_hz / perfil_ativo->taxa;
+    interface_log("Reamostrador: %lu.%lu ciclos/amostra de %lu (max %lu por bloco), %lu blocos decodificados\n",
+                  (unsigned long)(decimos_por_amostra / 10u), (unsigned long)(decimos_por_amostra % 10u),
+                  (unsigned long)orcamento, (unsigned long)estatisticas->ciclos_max,
+                  (unsigned long)estatisticas->n_blocos_decodificados);
+}
+
+// Custo medido por bloco contra o orçamento de tempo real, e quantas vozes caberiam nele
+void relatar_estatisticas_sintetizador(void) {
+    estatisticas_sintetizador_t estatisticas = sintetizador_estatisticas();
+    if (estatisticas.n_blocos == 0) return;
+
+    uint32_t orcamento = perfil_ativo->freq_sistema_hz / perfil_ativo->taxa * TAMANHO_BLOCO_REPRODUCAO;
+    uint32_t ciclos_medios = (uint32_t)(estatisticas.ciclos_total / estatisticas.n_blocos);
+    interface_log("Sintetizador: %lu ciclos/bloco (max %lu) de %lu, %lu%%\n",
+                  (unsigned long)ciclos_medios, (unsigned long)estatisticas.ciclos_max,
+                  (unsigned long)orcamento, (unsigned long)(ciclos_medios * 100u / orcamento));
+
+    if (estatisticas.vozes_renderizadas == 0) return;
+    uint32_t ciclos_por_voz = (uint32_t)(estatisticas.ciclos_vozes / estatisticas.vozes_renderizadas);
+    uint32_t ciclos_fixos = (uint32_t)((estatisticas.ciclos_total - estatisticas.ciclos_vozes) / estatisticas.n_blocos);
+    uint32_t max_vozes = (ciclos_por_voz > 0 && orcamento > ciclos_fixos) ? (orcamento - ciclos_fixos) / ciclos_por_voz : 0;
+    interface_log("Sintetizador: %lu ciclos/voz por bloco, ~%lu vozes cabem a %lu Hz\n",
+                  (unsigned long)ciclos_por_voz, (unsigned long)max_vozes, (unsigned long)perfil_ativo->taxa);
+}
+
+// Custo da decimação na interrupção da captura, por bloco de saída e em fração do núcleo 0
+void relatar_estatisticas_decimacao(void) {
+    estatisticas_decimacao_t estatisticas = captura_estatisticas_decimacao();
+    if (estatisticas.n_partes == 0) return;
+
+    uint32_t orcamento = perfil_ativo->freq_sistema_hz / perfil_ativo->taxa * estatisticas.amostras_por_parte;
+    uint32_t ciclos_medios = (uint32_t)(estatisticas.ciclos_total / estatisticas.n_partes);
+    uint32_t partes_por_bloco = TAMANHO_BLOCO_CAPTURA / estatisticas.amostras_por_parte;
+    interface_log("Decimação x%d: %lu ciclos/bloco (max %lu por parte), %lu.%lu%% do núcleo\n", CAPTURA_FATOR_ADC,
+                  (unsigned long)(ciclos_medios * partes_por_bloco), (unsigned long)estatisticas.ciclos_max,
+                  (unsigned long)(ciclos_medios * 100u / orcamento), (unsigned long)(ciclos_medios * 1000u / orcamento % 10u));
+}
+
+// Polarização medida do microfone e o estado do AGC no fim do take
+void relatar_nivel_automatico(void) {
+    interface_log("Nível: DC do microfone em %u (centro %d), ganho do AGC no fim %lu%%, %lu blocos limitados\n",
+                  (unsigned)dsp_nivel_dc(&bloqueio_dc_captura), DSP_AMOSTRA_ZERO,
+                  (unsigned long)(((uint64_t)agc_gravacao.ganho_q16 * 100 + (1u << 15)) >> 16),
+                  (unsigned long)agc_gravacao.blocos_limitados);
+}
+
+// Comprimento do laço, alinhamento usado no overdub e os xruns das duas pontas
+void relatar_estatisticas_looper(void) {
+    uint32_t ms = (uint32_t)((uint64_t)looper.comprimento * 1000u / perfil_ativo->taxa);
+    interface_log("Looper: laço de %lu amostras (%lu ms), deslocamento %ld amostras, %lu blocos com overdub\n",
+                  (unsigned long)looper.comprimento, (unsigned long)ms, (long)looper.deslocamento,
+                  (unsigned long)looper.blocos_misturados);
+    interface_log("Looper: %lu blocos de captura perdidos, %lu blocos de saída em falta\n",
+                  (unsigned long)captura_blocos_perdidos(), (unsigned long)reproducao_blocos_em_falta());
+}
+
+// Ciclos por bloco de cada etapa ligada na cadeia de efeitos
+void relatar_cadeia_efeitos(const char *cadeia, size_t (*obter_estatisticas)(const estatisticas_etapa_t **etapas)) {
+    const estatisticas_etapa_t *etapas;
+    size_t n_etapas = obter_estatisticas(&etapas);
+    for (size_t i = 0; i < n_etapas; i++) {
+        if (etapas[i].n_blocos == 0) continue;
+        interface_log("Efeitos (%s) %s: %lu ciclos/bloco (max %lu)\n", cadeia, etapas[i].nome,
+                      (unsigned long)(etapas[i].ciclos_total / etapas[i].n_blocos), (unsigned long)etapas[i].ciclos_max);
     }
+}
 
-    // Envia o buffer desenhado para o display
-    struct render_area area_render = {
-        .start_column = 0, .end_column = ssd1306_width - 1,
-        .start_page = 0, .end_page = ssd1306_n_pages - 1
-    };
-    calculate_render_area_buffer_length(&area_render);
-    render_on_display(buffer_tela, &area_render);
-}
-
-void apagar_tela() {
-    memset(frame_buffer_display, 0, DISPLAY_WIDTH * DISPLAY_HEIGHT / 8);
-    struct render_area area_render = {
-        .start_column = 0, .end_column = ssd1306_width - 1,
-        .start_page = 0, .end_page = ssd1306_n_pages - 1
-    };
-    calculate_render_area_buffer_length(&area_render);
-    render_on_display(frame_buffer_display, &area_render);
-}
\ No newline at end of file
+// Compara a taxa média exigida pela gravação com a taxa que a flash sustenta quando ocupada
+void relatar_estatisticas_flash(void) {
+    estatisticas_flash_t estatisticas = armazenamento_flash_estatisticas();
+    if (estatisticas.tempo_gravacao_us == 0 || estatisticas.tempo_flash_us == 0) return;
+
+    uint32_t taxa_media = (uint32_t)((uint64_t)estatisticas.bytes_programados * 1000000u / estatisticas.tempo_gravacao_us);
+    uint32_t taxa_sustentada = (uint32_t)((uint64_t)estatisticas.bytes_programados * 1000000u / estatisticas.tempo_flash_us);
+    uint32_t ocupacao = (uint32_t)((uint64_t)estatisticas.tempo_flash_us * 100u / estatisticas.tempo_gravacao_us);
+
+    interface_log("Flash: %lu B/s de %lu B/s sustentados (%lu%%)\n",
+                  (unsigned long)taxa_media, (unsigned long)taxa_sustentada, (unsigned long)ocupacao);
+    interface_log("Flash: pausa max %lu us, fila max %lu B\n",
+                  (unsigned long)estatisticas.maior_pausa_us, (unsigned long)estatisticas.ocupacao_max_fila);
+    if (estatisticas.blocos_descartados > 0) {
+        interface_log("Aviso: %lu blocos descartados (fila da flash cheia).\n",
+                      (unsigned long)estatisticas.blocos_descartados);
+    }
+}